@@ -5,8 +5,12 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <popart/asyncrun.hpp>
 #include <popart/builder.hpp>
+#include <popart/cyclecountreport.hpp>
+#include <popart/dataloaderstepio.hpp>
 #include <popart/devicemanager.hpp>
+#include <popart/enginecache.hpp>
 #include <popart/error.hpp>
 #include <popart/graphtransformer.hpp>
 #include <popart/ir.hpp>
@@ -195,6 +199,78 @@ private:
   py::dict outDict = py::dict();
 };
 
+// A DataLoaderStepIO reading record files, whose anchors are written to the
+// given arrays. Its inputs are produced without the GIL, by C++ workers.
+class PyDataLoaderStepIO : public DataLoaderStepIO {
+public:
+  PyDataLoaderStepIO(std::shared_ptr<const RecordFiles> files,
+                     int64_t numSamples,
+                     std::map<TensorId, py::array> outputs_,
+                     unsigned numWorkers,
+                     unsigned queueDepth)
+      : DataLoaderStepIO(files,
+                         numSamples,
+                         getOutputData(outputs_),
+                         numWorkers,
+                         queueDepth),
+        outputs(outputs_) {}
+
+private:
+  static std::map<TensorId, MutableVoidData>
+  getOutputData(std::map<TensorId, py::array> &arrays) {
+    std::map<TensorId, MutableVoidData> data;
+    for (auto &array : arrays) {
+      // The anchors are written in place, so must not be written to a copy
+      auto a = py::array::ensure(array.second, py::array::c_style);
+      if (!a || !a.is(array.second)) {
+        throw error("The array provided for output {} must be C contiguous",
+                    array.first);
+      }
+      MutableVoidData d;
+      d.data = a.mutable_data();
+      d.info = getTensorInfo(a);
+      data.insert({array.first, d});
+    }
+    return data;
+  }
+
+  // To ensure that the arrays are persisted while the anchors are written
+  std::map<TensorId, py::array> outputs;
+};
+
+// A step started by runAsync. The step runs without the GIL, so it reads its
+// inputs through raw pointers into the input arrays, which are held until the
+// step has completed.
+class PyAsyncRunHandle {
+public:
+  PyAsyncRunHandle(Session &session, std::map<TensorId, py::array> inputs_) {
+    std::map<TensorId, ConstVoidData> data;
+    for (auto &input : inputs_) {
+      auto a = py::array::ensure(input.second, py::array::c_style);
+      if (!a) {
+        throw error("Invalid array provided for input {}", input.first);
+      }
+      data.insert({input.first, ConstVoidData(a.data(), getTensorInfo(a))});
+      inputs.insert({input.first, a});
+    }
+    stepio.reset(new HostBufferStepIO(data));
+    handle = session.runAsync(*stepio);
+  }
+
+  ~PyAsyncRunHandle() {
+    // Wait for the step before the input arrays are released
+    py::gil_scoped_release release;
+    handle.reset();
+  }
+
+  AsyncRunHandle &get() { return *handle; }
+
+private:
+  std::map<TensorId, py::array> inputs;
+  std::unique_ptr<HostBufferStepIO> stepio;
+  std::unique_ptr<AsyncRunHandle> handle;
+};
+
 void exportDataset(Builder &builder,
                    std::map<TensorId, py::iterable> inputs,
                    int64_t numElements,
@@ -504,6 +580,7 @@ PYBIND11_MODULE(popart_core, m) {
               py::arg("inputs"),
               py::arg("outputs"));
       cls.def("enableRuntimeAsserts", &PyStepIO::enableRuntimeAsserts);
+      cls.def("enableZeroCopyInputs", &PyStepIO::enableZeroCopyInputs);
     }
     {
       py::class_<PyStepIOCallback> cls(m, "PyStepIOCallback", stepio);
@@ -516,6 +593,69 @@ PYBIND11_MODULE(popart_core, m) {
               py::arg("output_callback"),
               py::arg("output_complete_callback"));
     }
+    {
+      py::class_<RecordFiles, std::shared_ptr<RecordFiles>> cls(m,
+                                                                "RecordFiles");
+      cls.def(py::init<const std::map<TensorId, std::string> &,
+                       const std::map<TensorId, TensorInfo> &>(),
+              py::arg("files"),
+              py::arg("rawInfos") = std::map<TensorId, TensorInfo>());
+      cls.def("numRecords", &RecordFiles::numRecords);
+      cls.def("sampleInfos", &RecordFiles::sampleInfos);
+    }
+    {
+      py::class_<PyDataLoaderStepIO> cls(m, "DataLoaderStepIO", stepio);
+      cls.def(py::init([](std::shared_ptr<RecordFiles> files,
+                          int64_t numSamples,
+                          std::map<TensorId, py::array> outputs,
+                          unsigned numWorkers,
+                          unsigned queueDepth) {
+                return std::unique_ptr<PyDataLoaderStepIO>(
+                    new PyDataLoaderStepIO(
+                        files, numSamples, outputs, numWorkers, queueDepth));
+              }),
+              py::arg("files"),
+              py::arg("numSamples"),
+              py::arg("outputs") = std::map<TensorId, py::array>(),
+              py::arg("numWorkers") = 4,
+              py::arg("queueDepth") = 64);
+      cls.def("enableRuntimeAsserts",
+              &PyDataLoaderStepIO::enableRuntimeAsserts);
+      cls.def("numSamplesCompleted", &PyDataLoaderStepIO::numSamplesCompleted);
+    }
+    {
+      py::class_<PyAsyncRunHandle> cls(m, "AsyncRunHandle");
+      cls.def(
+          "wait",
+          [](PyAsyncRunHandle &handle) { handle.get().wait(); },
+          py::call_guard<py::gil_scoped_release>());
+      cls.def("isReady",
+              [](PyAsyncRunHandle &handle) { return handle.get().isReady(); });
+      // The anchors are views of the session's buffers, which are valid until
+      // the handle is released
+      cls.def("anchors", [](py::object self) {
+        auto &handle = self.cast<PyAsyncRunHandle &>();
+        const std::map<TensorId, MutableVoidData> *anchors;
+        {
+          py::gil_scoped_release release;
+          anchors = &handle.get().anchors();
+        }
+        py::dict result;
+        for (const auto &anchor : *anchors) {
+          const auto &info = anchor.second.info;
+          result[py::str(anchor.first)] =
+              py::array(py::dtype(info.data_type_lcase()),
+                        info.shape(),
+                        anchor.second.data,
+                        self);
+        }
+        return result;
+      });
+      cls.def(
+          "release",
+          [](PyAsyncRunHandle &handle) { handle.get().release(); },
+          py::call_guard<py::gil_scoped_release>());
+    }
     {
       py::class_<PyWeightsIO> cls(m, "PyWeightsIO", weightsio);
       cls.def(py::init<std::map<TensorId, py::array>>(), py::arg("weights"));
@@ -530,6 +670,31 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def("id", &AnchorReturnType::id);
     cls.def("rp", &AnchorReturnType::rp);
   }
+  {
+    py::class_<CycleCountReport> cls(m, "CycleCountReport");
+    py::class_<CycleCountReport::OpEntry>(cls, "OpEntry")
+        .def_readonly("opId", &CycleCountReport::OpEntry::opId)
+        .def_readonly("graphId", &CycleCountReport::OpEntry::graphId)
+        .def_readonly("opType", &CycleCountReport::OpEntry::opType)
+        .def_readonly("debugName", &CycleCountReport::OpEntry::debugName)
+        .def_readonly("cycles", &CycleCountReport::OpEntry::cycles)
+        .def_readonly("executions", &CycleCountReport::OpEntry::executions);
+    py::class_<CycleCountReport::PipelineStageEntry>(cls, "PipelineStageEntry")
+        .def_readonly("pipelineStage",
+                      &CycleCountReport::PipelineStageEntry::pipelineStage)
+        .def_readonly("cycles", &CycleCountReport::PipelineStageEntry::cycles)
+        .def_readonly("executions",
+                      &CycleCountReport::PipelineStageEntry::executions);
+    cls.def_readonly("ops", &CycleCountReport::ops);
+    cls.def_readonly("pipelineStages", &CycleCountReport::pipelineStages);
+    cls.def("cyclesPerOpType", &CycleCountReport::cyclesPerOpType);
+    cls.def("toJson", &CycleCountReport::toJson);
+    cls.def("__str__", [](const CycleCountReport &report) {
+      std::stringstream ss;
+      ss << report;
+      return ss.str();
+    });
+  }
   {
     py::class_<DataFlow> cls(m, "DataFlow");
     cls.def(py::init<int, const std::map<TensorId, AnchorReturnType> &>(),
@@ -621,6 +786,33 @@ PYBIND11_MODULE(popart_core, m) {
                 py::arg("loss_scaling") = 1.0f);
       }
     }
+
+    {
+      py::enum_<AdamMode> en(m, "AdamMode");
+      en.value("Adam", AdamMode::Adam);
+      en.value("AdamW", AdamMode::AdamW);
+      en.value("Lamb", AdamMode::Lamb);
+    }
+
+    {
+      py::class_<Adam> adam(m, "Adam", optimizer);
+      adam.def(py::init([](py::dict pyd, AdamMode mode) {
+                 auto cppm = getOptimizerValueDictionary(pyd);
+                 return Adam(cppm, mode);
+               }),
+               py::arg("values"),
+               py::arg("mode") = AdamMode::Adam);
+      adam.def("insertSpecific", [](Adam &self, TensorId id, py::dict pyd) {
+        self.insertSpecific(id, getOptimizerValueDictionary(pyd));
+      });
+
+      adam.def("getMode", &Adam::getMode);
+      adam.def("learningRates", &Adam::learningRates);
+      adam.def("weightDecays", &Adam::weightDecays);
+      adam.def("beta1s", &Adam::beta1s);
+      adam.def("beta2s", &Adam::beta2s);
+      adam.def("epss", &Adam::epss);
+    }
   }
   {
     py::class_<SessionOptions> cls(m, "SessionOptions");
@@ -630,16 +822,22 @@ PYBIND11_MODULE(popart_core, m) {
                       &SessionOptions::exportPoplarComputationGraph);
     cls.def_readwrite("exportPoplarVertexGraph",
                       &SessionOptions::exportPoplarVertexGraph);
+    cls.def_readwrite("enableCompileProfiling",
+                      &SessionOptions::enableCompileProfiling);
     cls.def_readwrite("syntheticDataMode", &SessionOptions::syntheticDataMode);
     cls.def_readwrite("instrumentWithHardwareCycleCounter",
                       &SessionOptions::instrumentWithHardwareCycleCounter);
     cls.def_readwrite("hardwareInstrumentations",
                       &SessionOptions::hardwareInstrumentations);
+    cls.def_readwrite("hardwareInstrumentationOpFilter",
+                      &SessionOptions::hardwareInstrumentationOpFilter);
     cls.def_readwrite("disableGradAccumulationTensorStreams",
                       &SessionOptions::disableGradAccumulationTensorStreams);
     cls.def_readwrite("enableOutlining", &SessionOptions::enableOutlining);
     cls.def_readwrite("enableOutliningCopyCostPruning",
                       &SessionOptions::enableOutliningCopyCostPruning);
+    cls.def_readwrite("enableHierarchicalOutlining",
+                      &SessionOptions::enableHierarchicalOutlining);
     cls.def_readwrite("outlineThreshold", &SessionOptions::outlineThreshold);
     cls.def_readwrite("accumulationFactor",
                       &SessionOptions::accumulationFactor);
@@ -648,7 +846,13 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def_readwrite("enableNonStableSoftmax",
                       &SessionOptions::enableNonStableSoftmax);
     cls.def_readwrite("enablePipelining", &SessionOptions::enablePipelining);
+    cls.def_readwrite("autoVirtualGraphType",
+                      &SessionOptions::autoVirtualGraphType);
+    cls.def_readwrite("autoVirtualGraphMemoryCap",
+                      &SessionOptions::autoVirtualGraphMemoryCap);
     cls.def_readwrite("autoRecomputation", &SessionOptions::autoRecomputation);
+    cls.def_readwrite("autoRecomputationMemoryBudget",
+                      &SessionOptions::autoRecomputationMemoryBudget);
     cls.def_readwrite("mergeVarUpdate", &SessionOptions::mergeVarUpdate);
     cls.def_readwrite("mergeVarUpdateMemThreshold",
                       &SessionOptions::mergeVarUpdateMemThreshold);
@@ -686,6 +890,10 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def_readwrite("cachePath", &SessionOptions::cachePath);
     cls.def_readwrite("enableEngineCaching",
                       &SessionOptions::enableEngineCaching);
+    cls.def_readwrite("engineCacheMaxBytes",
+                      &SessionOptions::engineCacheMaxBytes);
+    cls.def_readwrite("enableScheduleCaching",
+                      &SessionOptions::enableScheduleCaching);
     cls.def_readwrite("enableFloatingPointChecks",
                       &SessionOptions::enableFloatingPointChecks);
     cls.def_readwrite("enableStochasticRounding",
@@ -707,6 +915,10 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def_readwrite("hostWeightUpdate", &SessionOptions::hostWeightUpdate);
     cls.def_readwrite("hostAllReduceRemoteBuffer",
                       &SessionOptions::hostAllReduceRemoteBuffer);
+    cls.def_readwrite("hostAllReduceEngine",
+                      &SessionOptions::hostAllReduceEngine);
+    cls.def_readwrite("hostAllReduceBucketSize",
+                      &SessionOptions::hostAllReduceBucketSize);
     cls.def_readwrite("hostWeightUpdate", &SessionOptions::hostWeightUpdate);
 
     cls.def_readwrite("kahnTieBreaker", &SessionOptions::kahnTieBreaker);
@@ -725,6 +937,23 @@ PYBIND11_MODULE(popart_core, m) {
                       &SessionOptions::globalReplicaOffset);
     cls.def_readwrite("ipuSystemType", &SessionOptions::ipuSystemType);
     cls.def_readwrite("groupHostSync", &SessionOptions::groupHostSync);
+    cls.def_readwrite("asyncAnchorBufferSets",
+                      &SessionOptions::asyncAnchorBufferSets);
+  }
+  {
+    py::class_<EngineCache> cls(m, "EngineCache");
+    cls.def(py::init<const std::string &>(), py::arg("cachePath"));
+    cls.def("list", [](const EngineCache &cache) {
+      // (key, bytes, lastUsed) tuples, the most recently used first
+      std::vector<std::tuple<std::string, std::uintmax_t, std::time_t>> result;
+      for (auto &entry : cache.list()) {
+        result.push_back({entry.key, entry.bytes, entry.lastUsed});
+      }
+      return result;
+    });
+    cls.def("size", &EngineCache::size);
+    cls.def("remove", &EngineCache::remove, py::arg("key"));
+    cls.def("prune", &EngineCache::prune, py::arg("maxBytes"));
   }
   {
     py::enum_<PatternsLevel> en(m, "PatternsLevel");
@@ -746,6 +975,7 @@ PYBIND11_MODULE(popart_core, m) {
     en.value("Standard", RecomputationType::Standard);
     en.value("NormOnly", RecomputationType::NormOnly);
     en.value("Pipeline", RecomputationType::Pipeline);
+    en.value("CheckpointSolver", RecomputationType::CheckpointSolver);
   }
   {
     py::enum_<RecomputeType> en(m, "RecomputeType");
@@ -780,6 +1010,11 @@ PYBIND11_MODULE(popart_core, m) {
     en.value("Auto", VirtualGraphMode::Auto);
     en.value("PingPong", VirtualGraphMode::PingPong);
   }
+  {
+    py::enum_<AutoVirtualGraphType> en(m, "AutoVirtualGraphType");
+    en.value("Subgraph", AutoVirtualGraphType::Subgraph);
+    en.value("ComputeBalanced", AutoVirtualGraphType::ComputeBalanced);
+  }
   {
     py::enum_<SyntheticDataMode> en(m, "SyntheticDataMode");
     en.value("Off", SyntheticDataMode::Off);
@@ -794,6 +1029,8 @@ PYBIND11_MODULE(popart_core, m) {
     py::enum_<Instrumentation> en(m, "Instrumentation");
     en.value("Outer", Instrumentation::Outer);
     en.value("Inner", Instrumentation::Inner);
+    en.value("Op", Instrumentation::Op);
+    en.value("Stage", Instrumentation::Stage);
   }
   {
     py::enum_<PreAliasPatternType> en(m, "PreAliasPatternType");
@@ -947,9 +1184,21 @@ PYBIND11_MODULE(popart_core, m) {
             py::arg("seedValue"));
     cls.def(
         "getCycleCount", &InferenceSession::getCycleCount, py::arg("id") = "");
+    cls.def("getCycleCountReport", &InferenceSession::getCycleCountReport);
     cls.def("weightsFromHost", &InferenceSession::weightsFromHost);
     cls.def("writeWeights", &TrainingSession::writeWeights);
     cls.def("run", &InferenceSession::run);
+    cls.def(
+        "runAsync",
+        [](InferenceSession &session, std::map<TensorId, py::array> inputs) {
+          return std::unique_ptr<PyAsyncRunHandle>(
+              new PyAsyncRunHandle(session, inputs));
+        },
+        py::arg("inputs"),
+        py::keep_alive<0, 1>());
+    cls.def("waitForAsyncRuns",
+            &InferenceSession::waitForAsyncRuns,
+            py::call_guard<py::gil_scoped_release>());
     cls.def("modelToHost", &InferenceSession::modelToHost);
     cls.def("getInfo", &InferenceSession::getInfo);
     cls.def("getSummaryReport",
@@ -1033,6 +1282,7 @@ PYBIND11_MODULE(popart_core, m) {
         "setRandomSeed", &TrainingSession::setRandomSeed, py::arg("seedValue"));
     cls.def(
         "getCycleCount", &TrainingSession::getCycleCount, py::arg("id") = "");
+    cls.def("getCycleCountReport", &TrainingSession::getCycleCountReport);
     cls.def("weightsToHost", &TrainingSession::weightsToHost);
     cls.def("weightsFromHost", &TrainingSession::weightsFromHost);
     cls.def("readWeights", &TrainingSession::readWeights);
@@ -1048,6 +1298,17 @@ PYBIND11_MODULE(popart_core, m) {
               exportInputs(session, inputs, num_elements, outputFilename);
             });
     cls.def("run", &TrainingSession::run);
+    cls.def(
+        "runAsync",
+        [](TrainingSession &session, std::map<TensorId, py::array> inputs) {
+          return std::unique_ptr<PyAsyncRunHandle>(
+              new PyAsyncRunHandle(session, inputs));
+        },
+        py::arg("inputs"),
+        py::keep_alive<0, 1>());
+    cls.def("waitForAsyncRuns",
+            &TrainingSession::waitForAsyncRuns,
+            py::call_guard<py::gil_scoped_release>());
     cls.def("modelToHost", &TrainingSession::modelToHost);
     cls.def("getInfo", &TrainingSession::getInfo);
     cls.def("getSummaryReport",
@@ -0,0 +1,177 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE AutoVirtualGraphComputeBalancedTest0
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/error.hpp>
+#include <popart/filereader.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/op/matmul.hpp>
+#include <popart/testdevice.hpp>
+#include <popart/transforms/auto_virtual_graph.hpp>
+
+using namespace popart;
+using namespace popart::autovirtualgraph;
+
+namespace {
+
+// The max stage time and total copy cost of some stage starts, as defined by
+// partitionStages, or infinity if a stage is over the memory cap
+std::pair<double, double> evaluate(const std::vector<double> &compute,
+                                   const std::vector<int64_t> &memory,
+                                   const std::vector<double> &cutCost,
+                                   const std::vector<size_t> &starts,
+                                   int64_t memoryCap) {
+  const double inf = std::numeric_limits<double>::infinity();
+  double maxTime   = 0.0;
+  double copies    = 0.0;
+  for (size_t stage = 0; stage + 1 < starts.size(); ++stage) {
+    double time = 0.0;
+    int64_t mem = 0;
+    for (size_t i = starts[stage]; i < starts[stage + 1]; ++i) {
+      time += compute[i];
+      mem += memory[i];
+    }
+    if (starts[stage + 1] < compute.size()) {
+      time += cutCost[starts[stage + 1]];
+      copies += cutCost[starts[stage + 1]];
+    }
+    if (memoryCap > 0 && mem > memoryCap) {
+      return {inf, inf};
+    }
+    maxTime = std::max(maxTime, time);
+  }
+  return {maxTime, copies};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(PartitionStagesMatchesExhaustiveSearch) {
+  std::mt19937 gen(1011);
+  std::uniform_real_distribution<double> computeDis(0.0, 10.0);
+  std::uniform_real_distribution<double> cutDis(0.0, 4.0);
+  std::uniform_int_distribution<int64_t> memoryDis(0, 20);
+
+  for (int trial = 0; trial < 200; ++trial) {
+    const size_t n      = 3 + trial % 8;
+    const size_t stages = 2 + trial % 3;
+    if (n < stages) {
+      continue;
+    }
+    std::vector<double> compute(n);
+    std::vector<int64_t> memory(n);
+    std::vector<double> cutCost(n + 1, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+      compute[i] = computeDis(gen);
+      memory[i]  = memoryDis(gen);
+      cutCost[i] = i > 0 ? cutDis(gen) : 0.0;
+    }
+    int64_t memoryCap = trial % 2 == 0 ? 0 : 40;
+
+    // All ways of choosing the starts of the stages after the first
+    double bestTime = std::numeric_limits<double>::infinity();
+    std::vector<std::pair<double, double>> all;
+    std::vector<bool> chosen(n - 1, false);
+    std::fill(chosen.begin(), chosen.begin() + (stages - 1), true);
+    do {
+      std::vector<size_t> starts{0};
+      for (size_t i = 0; i + 1 < n; ++i) {
+        if (chosen[i]) {
+          starts.push_back(i + 1);
+        }
+      }
+      starts.push_back(n);
+      all.push_back(evaluate(compute, memory, cutCost, starts, memoryCap));
+      bestTime = std::min(bestTime, all.back().first);
+    } while (std::prev_permutation(chosen.begin(), chosen.end()));
+
+    if (bestTime == std::numeric_limits<double>::infinity()) {
+      BOOST_CHECK_THROW(
+          partitionStages(compute, memory, cutCost, stages, memoryCap),
+          error);
+      continue;
+    }
+
+    double bestCopies = std::numeric_limits<double>::infinity();
+    for (auto &time_copies : all) {
+      if (time_copies.first == bestTime) {
+        bestCopies = std::min(bestCopies, time_copies.second);
+      }
+    }
+
+    auto partition =
+        partitionStages(compute, memory, cutCost, stages, memoryCap);
+    BOOST_CHECK_EQUAL(partition.stageStarts.size(), stages + 1);
+    auto result = evaluate(
+        compute, memory, cutCost, partition.stageStarts, memoryCap);
+    BOOST_CHECK_CLOSE(result.first, bestTime, 1e-6);
+    BOOST_CHECK_CLOSE(partition.maxStageTime, bestTime, 1e-6);
+    BOOST_CHECK_LE(result.second, bestCopies + 1e-9);
+    BOOST_CHECK_CLOSE(partition.totalCopyCost, result.second, 1e-6);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PartitionStagesTooFewOps) {
+  BOOST_CHECK_THROW(partitionStages({1.0}, {1}, {0.0, 0.0}, 2, 0), error);
+}
+
+// model: four 64x64 MatMuls in a chain
+//
+//  in -- MatMul -- MatMul -- MatMul -- MatMul -- out
+//
+// The MatMuls are the same, so balancing compute on 2 IPUs puts 2 on each
+BOOST_AUTO_TEST_CASE(ComputeBalancedMatMulChain) {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+
+  TensorInfo inInfo{"FLOAT", std::vector<int64_t>{4, 64}};
+  TensorInfo wInfo{"FLOAT", std::vector<int64_t>{64, 64}};
+  std::vector<float> wVals(64 * 64, 0.0f);
+  ConstVoidData wData{wVals.data(), wInfo};
+
+  auto act = builder->addInputTensor(inInfo);
+  for (int layer = 0; layer < 4; ++layer) {
+    auto w = builder->addInitializedInputTensor(wData);
+    act    = aiOnnx.matmul({act, w});
+  }
+  builder->addOutputTensor(act);
+
+  auto device = createTestDevice(TEST_TARGET, 2);
+
+  SessionOptions opts;
+  opts.virtualGraphMode     = VirtualGraphMode::Auto;
+  opts.autoVirtualGraphType = AutoVirtualGraphType::ComputeBalanced;
+
+  Ir ir;
+  ir.prepare({io::getModelFromString(builder->getModelProto()),
+              InputShapeInfo(),
+              DataFlow(1, {{act, AnchorReturnType("All")}}),
+              {},
+              {},
+              *device,
+              opts,
+              Patterns(PatternsLevel::NoPatterns)});
+
+  std::vector<int> matmulsPerIpu(2, 0);
+  VGraphId previous = 0;
+  for (Op *op : ir.getMainGraph().getOpSchedule({})) {
+    if (dynamic_cast<MatMulOp *>(op)) {
+      auto vgid = op->getVirtualGraphId();
+      // The stages are contiguous in the schedule
+      BOOST_CHECK_GE(vgid, previous);
+      previous = vgid;
+      ++matmulsPerIpu.at(vgid);
+    }
+  }
+  BOOST_CHECK_EQUAL(matmulsPerIpu[0], 2);
+  BOOST_CHECK_EQUAL(matmulsPerIpu[1], 2);
+}
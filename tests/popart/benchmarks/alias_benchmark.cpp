@@ -0,0 +1,125 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/devicemanager.hpp>
+#include <popart/filereader.hpp>
+#include <popart/graph.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/tensors.hpp>
+
+// Reports the time taken to update the aliases of an Ir with thousands of
+// view-changing ops: each layer is a reshape, a transpose, two slices and a
+// concat, all of which are inplaced. Every `block' layers a MatMul, which
+// is not inplaced, starts a new alias component.
+//
+// Reported are the time of Ir::prepare with inplacing, which updates the
+// aliases several times, the time to recompute all of the aliases from
+// scratch, as Ir::updateAliases did before it was incremental, and the time
+// of an Ir::updateAliases call when no Op has changed.
+//
+// Usage: alias_benchmark [layers [block [repeats]]]
+
+using namespace popart;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+std::string getModel(int layers, int block) {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+
+  const int64_t rows = 8;
+  const int64_t cols = 16;
+
+  std::vector<int64_t> transposedShape{cols, rows};
+  auto transposed =
+      aiOnnx.constant({transposedShape.data(), {"INT64", Shape{2}}});
+
+  std::vector<float> weights(cols * cols, 1.0f / cols);
+  auto w = aiOnnx.constant({weights.data(), {"FLOAT", Shape{cols, cols}}});
+
+  auto x = builder->addInputTensor({"FLOAT", Shape{rows, cols}});
+  for (int layer = 0; layer < layers; ++layer) {
+    // (8,16) -> (16,8) -> (8,16) -> 2 x (4,16) -> (8,16)
+    auto y = aiOnnx.reshape({x, transposed});
+    y      = aiOnnx.transpose({y}, {1, 0});
+    auto a = aiOnnx.slice({y}, {rows / 2, cols}, {0, 0});
+    auto b = aiOnnx.slice({y}, {rows, cols}, {rows / 2, 0});
+    x      = aiOnnx.concat({b, a}, 0);
+    if (layer % block == block - 1) {
+      x = aiOnnx.matmul({x, w});
+    }
+  }
+  builder->addOutputTensor(x);
+  return builder->getModelProto();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int layers  = argc > 1 ? std::atoi(argv[1]) : 1000;
+  const int block   = argc > 2 ? std::atoi(argv[2]) : 16;
+  const int repeats = argc > 3 ? std::atoi(argv[3]) : 3;
+
+  auto proto    = io::getModelFromString(getModel(layers, block));
+  auto device   = DeviceManager::createDeviceManager().createCpuDevice();
+  auto output   = proto.graph().output(0).name();
+  auto dataFlow = DataFlow(1, {{output, AnchorReturnType("All")}});
+
+  double prepare = 0.0;
+  double full    = 0.0;
+  double noop    = 0.0;
+  int64_t nOps   = 0;
+
+  for (int r = 0; r < repeats; ++r) {
+    auto t0 = Clock::now();
+    Ir ir;
+    ir.prepare({proto,
+                InputShapeInfo(),
+                dataFlow,
+                {},
+                nullptr,
+                *device,
+                {},
+                Patterns(PatternsLevel::Default).enableInPlace(true)});
+    prepare += secondsSince(t0);
+    nOps = ir.getMainGraph().getOps().size();
+
+    t0 = Clock::now();
+    for (auto &id_graph : ir.getGraphs()) {
+      id_graph.second->getTensors().clearAliases();
+    }
+    ir.updateAliases();
+    full += secondsSince(t0);
+
+    t0 = Clock::now();
+    ir.updateAliases();
+    noop += secondsSince(t0);
+  }
+
+  std::cout << layers << " layers, " << nOps << " ops, a MatMul every "
+            << block << " layers, mean of " << repeats << std::endl;
+  auto report = [repeats](const std::string &name, double seconds) {
+    std::cout << std::left << std::setw(40) << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(2)
+              << 1e3 * seconds / repeats << " ms" << std::endl;
+  };
+  report("Ir::prepare", prepare);
+  report("updateAliases, from scratch", full);
+  report("updateAliases, nothing changed", noop);
+  return 0;
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/devicemanager.hpp>
+#include <popart/filereader.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/session.hpp>
+#include <popart/sessionoptions.hpp>
+
+// Compares cold and warm start times of an InferenceSession with engine and
+// schedule caching enabled: the first run starts with an empty cache, the
+// second one with the cache written by the first.
+//
+// Reported, for each run, are the time to compute the cache key of the
+// inputs of Ir::prepare (std::hash<IrBundle>), the time to create the
+// session, which prepares or restores the Ir, and the time of prepareDevice.
+//
+// The poplar::Executable, and the prepared Ir with it, are only cached for IPU
+// hardware, where the warm start skips Ir::prepare and the growing of the
+// poplar graph. With the default IpuModel device the warm start only skips
+// the scheduler's annealing. Pass "ipu" as the last argument to run on an IPU.
+//
+// Usage: compile_cache_benchmark [layers [cachePath [ipumodel|ipu]]]
+
+using namespace popart;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+std::string getModel(int layers) {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+
+  const int64_t size = 16;
+  std::vector<float> weights(size * size, 1.0f / size);
+
+  auto x = builder->addInputTensor({"FLOAT", Shape{size, size}});
+  for (int layer = 0; layer < layers; ++layer) {
+    auto w = aiOnnx.constant({weights.data(), {"FLOAT", Shape{size, size}}});
+    x      = aiOnnx.relu({aiOnnx.matmul({x, w})});
+  }
+  builder->addOutputTensor(x);
+  return builder->getModelProto();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int layers       = argc > 1 ? std::atoi(argv[1]) : 200;
+  const std::string path = argc > 2 ? argv[2] : "compile_cache_benchmark";
+  const bool useIpu      = argc > 3 && std::string(argv[3]) == "ipu";
+
+  auto model    = getModel(layers);
+  auto proto    = io::getModelFromString(model);
+  auto output   = proto.graph().output(0).name();
+  auto dataFlow = DataFlow(1, {{output, AnchorReturnType("All")}});
+
+  SessionOptions opts;
+  opts.enableEngineCaching   = true;
+  opts.enableScheduleCaching = true;
+  opts.cachePath             = path;
+
+  boost::filesystem::remove_all(path);
+  boost::filesystem::remove_all(path + ".schedules");
+
+  std::cout << layers << " layers, cache at " << path << std::endl;
+  auto report = [](const std::string &name, double seconds) {
+    std::cout << std::left << std::setw(40) << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(2)
+              << 1e3 * seconds << " ms" << std::endl;
+  };
+
+  for (auto run : {"cold", "warm"}) {
+    std::shared_ptr<DeviceInfo> device;
+    if (useIpu) {
+      device = DeviceManager::createDeviceManager().acquireAvailableDevice();
+      if (!device) {
+        std::cerr << "No IPU available" << std::endl;
+        return 1;
+      }
+    } else {
+      std::map<std::string, std::string> deviceOpts{{"numIPUs", "1"}};
+      device =
+          DeviceManager::createDeviceManager().createIpuModelDevice(deviceOpts);
+    }
+
+    auto patterns = Patterns(PatternsLevel::Default);
+
+    auto t0 = Clock::now();
+    std::hash<IrBundle>{}(
+        {proto, {}, dataFlow, {}, nullptr, *device, opts, patterns});
+    auto hash = secondsSince(t0);
+
+    t0           = Clock::now();
+    auto session = InferenceSession::createFromOnnxModel(
+        model, dataFlow, device, InputShapeInfo(), opts, patterns);
+    auto create = secondsSince(t0);
+
+    t0 = Clock::now();
+    session->prepareDevice();
+    auto prepareDevice = secondsSince(t0);
+
+    std::cout << run << " start, the Ir was "
+              << (session->getIr().isPreparedFromSerialized() ? "restored"
+                                                              : "prepared")
+              << std::endl;
+    report("  std::hash<IrBundle>", hash);
+    report("  createFromOnnxModel", create);
+    report("  prepareDevice", prepareDevice);
+    report("  total", create + prepareDevice);
+  }
+  return 0;
+}
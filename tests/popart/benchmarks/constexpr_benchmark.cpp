@@ -0,0 +1,140 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/devicemanager.hpp>
+#include <popart/filereader.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/tensorinfo.hpp>
+
+// Reports the time taken to prepare an Ir whose constant subgraphs are
+// folded by the ces/ ops: elementwise ops with and without broadcasting,
+// transposes, and several independent constant chains (which are folded in
+// parallel). The preparation of an Ir with nothing to fold is reported for
+// comparison.
+//
+// Usage: constexpr_benchmark [size [repeats]]
+// where the constant tensors have size x size elements.
+
+using namespace popart;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Builds the constants and the ops to fold, returning the tensor which is
+// added to the model's input.
+using Body = std::function<TensorId(Builder &, int64_t)>;
+
+TensorId constant(Builder &builder, const Shape &shape) {
+  auto aiOnnx = builder.aiOnnxOpset9();
+  TensorInfo info{"FLOAT", shape};
+  std::vector<float> values(info.nelms());
+  for (uint64_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<float>(i % 97) + 1.0f;
+  }
+  return aiOnnx.constant({values.data(), info});
+}
+
+double prepareSeconds(const Body &body, int64_t size, int repeats) {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+  auto folded  = body(*builder, size);
+  auto in      = builder->addInputTensor({"FLOAT", {size, size}});
+  auto out     = aiOnnx.add({folded, in});
+  builder->addOutputTensor(out);
+  auto proto = io::getModelFromString(builder->getModelProto());
+
+  auto device   = DeviceManager::createDeviceManager().createCpuDevice();
+  auto dataFlow = DataFlow(1, {{out, AnchorReturnType("All")}});
+
+  double best = std::numeric_limits<double>::max();
+  for (int r = 0; r < repeats; ++r) {
+    auto t0 = Clock::now();
+    Ir ir;
+    ir.prepare({proto,
+                InputShapeInfo(),
+                dataFlow,
+                {},
+                nullptr,
+                *device,
+                {},
+                Patterns(PatternsLevel::NoPatterns)});
+    auto t1 = Clock::now();
+    best    = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int64_t size = argc > 1 ? std::atoll(argv[1]) : 1024;
+  int repeats  = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  std::vector<std::pair<std::string, Body>> benchmarks{
+      {"nothing to fold",
+       [](Builder &b, int64_t n) { return constant(b, {n, n}); }},
+      {"add",
+       [](Builder &b, int64_t n) {
+         auto x = constant(b, {n, n});
+         auto y = constant(b, {n, n});
+         return b.aiOnnxOpset9().add({x, y});
+       }},
+      {"mul, broadcast row",
+       [](Builder &b, int64_t n) {
+         return b.aiOnnxOpset9().mul({constant(b, {n, n}), constant(b, {n})});
+       }},
+      {"sub, broadcast column",
+       [](Builder &b, int64_t n) {
+         auto x = constant(b, {n, n});
+         auto y = constant(b, {n, 1});
+         return b.aiOnnxOpset9().sub({x, y});
+       }},
+      {"div, broadcast outer product",
+       [](Builder &b, int64_t n) {
+         return b.aiOnnxOpset9().div({constant(b, {n, 1}), constant(b, {n})});
+       }},
+      {"transpose 2-d",
+       [](Builder &b, int64_t n) {
+         return b.aiOnnxOpset9().transpose({constant(b, {n, n})}, {1, 0});
+       }},
+      {"transpose 3-d, reshape",
+       [](Builder &b, int64_t n) {
+         auto aiOnnx = b.aiOnnxOpset9();
+         auto t = aiOnnx.transpose({constant(b, {n / 8, 8, n})}, {2, 0, 1});
+         std::vector<int64_t> shape{n, n};
+         auto s = aiOnnx.constant({shape.data(), {"INT64", {2}}});
+         return aiOnnx.reshape({t, s});
+       }},
+      {"8 independent chains",
+       [](Builder &b, int64_t n) {
+         auto aiOnnx = b.aiOnnxOpset9();
+         std::vector<TensorId> chains;
+         for (int i = 0; i < 8; ++i) {
+           auto x = aiOnnx.mul({constant(b, {n, n}), constant(b, {n})});
+           chains.push_back(aiOnnx.add({x, constant(b, {n, 1})}));
+         }
+         return aiOnnx.sum(chains);
+       }},
+  };
+
+  std::cout << "Ir::prepare with " << size << " x " << size
+            << " constants, best of " << repeats << std::endl;
+  for (const auto &benchmark : benchmarks) {
+    auto seconds = prepareSeconds(benchmark.second, size, repeats);
+    std::cout << std::left << std::setw(32) << benchmark.first << std::right
+              << std::setw(10) << std::fixed << std::setprecision(2)
+              << 1e3 * seconds << " ms" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <poprithms/schedule/anneal/graph.hpp>
+#include <popart/dynamictoposort.hpp>
+
+// Compares the two ways the Inplace pattern can check that the topological
+// constraints of an inplacing candidate do not create a cycle:
+//   1) Graph::isSchedulable, which builds and checks a poprithms Graph for
+//      every candidate, and
+//   2) DynamicTopoSort, which is updated incrementally.
+//
+// The synthetic graph is a chain of layers of `width' ops, where each op
+// consumes 2 random ops of the previous layer. Each candidate is 2
+// constraints between ops a few layers apart, in a random direction, so that
+// roughly half of them are rejected.
+//
+// Usage: cyclecheck_benchmark [nOps [nCandidates [width]]]
+
+namespace {
+
+using Clock    = std::chrono::steady_clock;
+using RithmicG = poprithms::schedule::anneal::Graph;
+using Edge     = popart::DynamicTopoSort::Edge;
+
+double secondsSince(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const uint32_t nOps        = argc > 1 ? std::atoi(argv[1]) : 20000;
+  const uint32_t nCandidates = argc > 2 ? std::atoi(argv[2]) : 2000;
+  const uint32_t width       = argc > 3 ? std::atoi(argv[3]) : 8;
+
+  std::mt19937 rng(1011);
+  std::vector<Edge> edges;
+  for (uint32_t op = width; op < nOps; ++op) {
+    uint32_t layerStart = (op / width - 1) * width;
+    for (int i = 0; i < 2; ++i) {
+      edges.push_back({layerStart + rng() % width, op});
+    }
+  }
+
+  std::vector<std::vector<Edge>> candidates(nCandidates);
+  for (auto &candidate : candidates) {
+    for (int i = 0; i < 2; ++i) {
+      uint32_t a = rng() % (nOps - 4 * width);
+      uint32_t b = a + width + rng() % (3 * width);
+      candidate.push_back(rng() % 2 ? Edge{a, b} : Edge{b, a});
+    }
+  }
+
+  // 1) Rebuild the whole graph for every candidate, as isSchedulable does.
+  // Only a subset of the candidates is checked, as this is slow.
+  const uint32_t nFull = std::min<uint32_t>(nCandidates, 50);
+  std::vector<Edge> accepted;
+  auto t0 = Clock::now();
+  for (uint32_t c = 0; c < nFull; ++c) {
+    RithmicG g;
+    for (uint32_t op = 0; op < nOps; ++op) {
+      g.insertOp({}, {}, "op");
+    }
+    for (auto &e : edges) {
+      g.insertConstraint(e.first, e.second);
+    }
+    for (auto &e : accepted) {
+      g.insertConstraint(e.first, e.second);
+    }
+    for (auto &e : candidates[c]) {
+      g.insertConstraint(e.first, e.second);
+    }
+    g.finalize();
+    if (g.isSchedulable()) {
+      auto &candidate = candidates[c];
+      accepted.insert(accepted.end(), candidate.begin(), candidate.end());
+    }
+  }
+  double fullSeconds     = secondsSince(t0);
+  uint64_t nFullAccepted = accepted.size() / 2;
+
+  // 2) Incremental. The construction time is included.
+  t0 = Clock::now();
+  popart::DynamicTopoSort topoSort;
+  for (uint32_t op = 0; op < nOps; ++op) {
+    topoSort.insertNode();
+  }
+  for (auto &e : edges) {
+    topoSort.tryInsertEdge(e.first, e.second);
+  }
+  uint64_t nAccepted        = 0;
+  uint64_t nAcceptedOfFirst = 0;
+  for (uint32_t c = 0; c < nCandidates; ++c) {
+    if (topoSort.tryInsertEdges(candidates[c])) {
+      ++nAccepted;
+      if (c < nFull) {
+        ++nAcceptedOfFirst;
+      }
+    }
+  }
+  double incrementalSeconds = secondsSince(t0);
+
+  if (nAcceptedOfFirst != nFullAccepted) {
+    std::cerr << "The two approaches disagree on the first " << nFull
+              << " candidates: " << nFullAccepted << " vs "
+              << nAcceptedOfFirst << " accepted" << std::endl;
+    return 1;
+  }
+
+  std::cout << nOps << " ops, " << edges.size() << " edges, " << nCandidates
+            << " candidates (" << nAccepted << " accepted)" << std::endl;
+  std::cout << "isSchedulable per candidate  : " << 1e6 * fullSeconds / nFull
+            << " us (measured over " << nFull << " candidates)" << std::endl;
+  std::cout << "DynamicTopoSort per candidate: "
+            << 1e6 * incrementalSeconds / nCandidates
+            << " us (including construction)" << std::endl;
+  std::cout << "Estimated total              : "
+            << fullSeconds / nFull * nCandidates << " s vs "
+            << incrementalSeconds << " s" << std::endl;
+  return 0;
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/devicemanager.hpp>
+#include <popart/filereader.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/mappedregion.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensordata.hpp>
+#include <popart/tensorinfo.hpp>
+
+// Reports the time taken and the memory used to load a model whose weights
+// are stored in an external data file, up to the point where the weights are
+// ready to be uploaded: parsing the ModelProto, and preparing an Ir (which
+// creates the TensorData of the weights).
+//
+// Externally stored weights are memory mapped unless the environment variable
+// POPART_MMAP_EXTERNAL_DATA is 0, so run this twice to compare:
+//   external_data_benchmark [megabytes [layers]]
+//   POPART_MMAP_EXTERNAL_DATA=0 external_data_benchmark [megabytes [layers]]
+
+using namespace popart;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// A field of /proc/self/status, in kB
+int64_t procStatusKb(const std::string &field) {
+  std::ifstream ifs("/proc/self/status");
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.compare(0, field.size() + 1, field + ":") == 0) {
+      return std::stoll(line.substr(field.size() + 1));
+    }
+  }
+  return -1;
+}
+
+// Reset the peak RSS (VmHWM) to the current RSS, where supported
+void resetPeakRss() {
+  std::ofstream ofs("/proc/self/clear_refs");
+  ofs << "5";
+}
+
+// Write a model of `layers' matmuls, whose weights total `megabytes' MB and
+// are stored in `dir'/weights.bin, returning the model's file name and its
+// output
+std::pair<std::string, TensorId>
+writeModel(const boost::filesystem::path &dir, int64_t megabytes, int layers) {
+  int64_t n = 1;
+  while ((2 * n) * (2 * n) * sizeof(float) * layers <= megabytes << 20) {
+    n *= 2;
+  }
+
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+  TensorInfo weightInfo{"FLOAT", std::vector<int64_t>{n, n}};
+  std::vector<float> weightData(weightInfo.nelms(), 0.5f);
+
+  auto x = builder->addInputTensor({"FLOAT", std::vector<int64_t>{1, n}});
+  std::vector<TensorId> weights;
+  for (int i = 0; i < layers; ++i) {
+    weights.push_back(
+        builder->addInitializedInputTensor({weightData.data(), weightInfo}));
+    x = aiOnnx.matmul({x, weights.back()});
+  }
+  builder->addOutputTensor(x);
+
+  auto weightsFn = (dir / "weights.bin").string();
+  auto modelFn   = (dir / "model.onnx").string();
+  builder->saveInitializersExternally(weights, weightsFn);
+  builder->saveModelProto(modelFn);
+
+  std::cout << layers << " weights of " << n << " x " << n << ", "
+            << boost::filesystem::file_size(weightsFn) / (1 << 20)
+            << " MB in total" << std::endl;
+  return {modelFn, x};
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int64_t megabytes = argc > 1 ? std::atoll(argv[1]) : 1024;
+  int layers        = argc > 2 ? std::atoi(argv[2]) : 8;
+
+  auto dir = boost::filesystem::temp_directory_path() /
+             boost::filesystem::unique_path("popart_external_%%%%%%%%");
+  boost::filesystem::create_directories(dir);
+
+  auto model    = writeModel(dir, megabytes, layers);
+  auto device   = DeviceManager::createDeviceManager().createCpuDevice();
+  auto dataFlow = DataFlow(1, {{model.second, AnchorReturnType("All")}});
+
+  resetPeakRss();
+  auto rssBefore = procStatusKb("VmRSS");
+  auto t0        = Clock::now();
+
+  auto proto = io::getModelFromFile(model.first);
+  auto t1    = Clock::now();
+
+  Ir ir;
+  ir.prepare({proto,
+              InputShapeInfo(),
+              dataFlow,
+              {},
+              nullptr,
+              *device,
+              {},
+              Patterns(PatternsLevel::NoPatterns)});
+  auto t2 = Clock::now();
+
+  auto seconds = [](Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double>(b - a).count();
+  };
+  std::cout << "external data "
+            << (MappedRegion::enabled() ? "mapped" : "copied") << std::endl;
+  std::cout << "parse model:     " << 1e3 * seconds(t0, t1) << " ms"
+            << std::endl;
+  std::cout << "prepare Ir:      " << 1e3 * seconds(t1, t2) << " ms"
+            << std::endl;
+  std::cout << "RSS before load: " << rssBefore / 1024 << " MB" << std::endl;
+  std::cout << "peak RSS:        " << procStatusKb("VmHWM") / 1024 << " MB"
+            << std::endl;
+  std::cout << "anonymous RSS:   " << procStatusKb("RssAnon") / 1024 << " MB"
+            << std::endl;
+
+  // Touch every weight, as uploading them does
+  auto t3         = Clock::now();
+  double checksum = 0.0;
+  for (auto type : {TensorType::Variable, TensorType::Const}) {
+    for (auto id : ir.getTensorIds(type)) {
+      auto tensor = ir.getTensor(id);
+      auto data   = static_cast<const float *>(tensor->tensorData()->data());
+      for (int64_t i = 0; i < tensor->info.nelms(); ++i) {
+        checksum += data[i];
+      }
+    }
+  }
+  auto t4 = Clock::now();
+  std::cout << "read weights:    " << 1e3 * seconds(t3, t4) << " ms"
+            << " (checksum " << checksum << ")" << std::endl;
+  std::cout << "anonymous RSS:   " << procStatusKb("RssAnon") / 1024 << " MB"
+            << std::endl;
+
+  boost::filesystem::remove_all(dir);
+  return 0;
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <popart/half.hpp>
+#include <popart/hostconversion.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/threadpool.hpp>
+
+// Reports the throughput, in GB/s of source data, of each host conversion.
+//
+// Usage: hostconversion_benchmark [nelms [repeats]]
+
+using namespace popart;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F> double bestSeconds(int repeats, F f) {
+  double best = std::numeric_limits<double>::max();
+  for (int r = 0; r < repeats; ++r) {
+    auto t0 = Clock::now();
+    f();
+    auto t1 = Clock::now();
+    best    = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+  }
+  return best;
+}
+
+void report(const std::string &name, int64_t bytes, double seconds) {
+  std::cout << std::left << std::setw(36) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(2)
+            << static_cast<double>(bytes) / seconds / 1e9 << " GB/s"
+            << std::endl;
+}
+
+void benchmarkConvert(DataType src, DataType dst, int64_t nelms, int repeats) {
+  auto &srcInfo = getDataTypeInfoMap().at(src);
+  auto &dstInfo = getDataTypeInfoMap().at(dst);
+
+  // Small integers are valid in every type
+  std::vector<char> in(nelms * srcInfo.nbytes(), 0);
+  std::vector<char> out(nelms * dstInfo.nbytes());
+
+  auto seconds = bestSeconds(repeats, [&]() {
+    hostconversion::convert(src, in.data(), dst, out.data(), nelms);
+  });
+  report(srcInfo.name() + " -> " + dstInfo.name(),
+         static_cast<int64_t>(in.size()),
+         seconds);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int64_t nelms = argc > 1 ? std::atoll(argv[1]) : (int64_t{1} << 24);
+  int repeats   = argc > 2 ? std::atoi(argv[2]) : 10;
+
+  std::cout << "Converting " << nelms << " elements, best of " << repeats
+            << " runs, " << ThreadPool::global().size() + 1 << " threads"
+            << std::endl;
+
+  benchmarkConvert(DataType::FLOAT, DataType::FLOAT16, nelms, repeats);
+  benchmarkConvert(DataType::FLOAT16, DataType::FLOAT, nelms, repeats);
+  benchmarkConvert(DataType::INT64, DataType::INT32, nelms, repeats);
+  benchmarkConvert(DataType::INT32, DataType::INT64, nelms, repeats);
+  benchmarkConvert(DataType::DOUBLE, DataType::FLOAT, nelms, repeats);
+  benchmarkConvert(DataType::DOUBLE, DataType::FLOAT16, nelms, repeats);
+  benchmarkConvert(DataType::FLOAT, DataType::FLOAT, nelms, repeats);
+
+  // The single threaded bulk kernels, and converting one value at a time
+  // through popart::Half, for comparison
+  std::vector<float> floats(nelms, 1.5f);
+  std::vector<uint16_t> halfs(nelms);
+  auto bytes = static_cast<int64_t>(nelms * sizeof(float));
+
+  auto bulk = bestSeconds(repeats, [&]() {
+    hostconversion::floatToHalf(floats.data(), halfs.data(), nelms);
+  });
+  report("FLOAT -> FLOAT16 (1 thread)", bytes, bulk);
+
+  std::vector<Half> halfObjects(nelms);
+  auto scalar = bestSeconds(repeats, [&]() {
+    for (int64_t i = 0; i < nelms; ++i) {
+      halfObjects[i] = floats[i];
+    }
+  });
+  report("FLOAT -> FLOAT16 (popart::Half)", bytes, scalar);
+
+  // The bulk popart::Half conversions
+  auto halfBulk = bestSeconds(repeats, [&]() {
+    floatToHalf(floats.data(), halfObjects.data(), nelms);
+  });
+  report("FLOAT -> FLOAT16 (Half bulk)", bytes, halfBulk);
+
+  auto halfBytes   = static_cast<int64_t>(nelms * sizeof(Half));
+  auto toFloatBulk = bestSeconds(repeats, [&]() {
+    halfToFloat(halfObjects.data(), floats.data(), nelms);
+  });
+  report("FLOAT16 -> FLOAT (Half bulk)", halfBytes, toFloatBulk);
+
+  auto toFloatScalar = bestSeconds(repeats, [&]() {
+    for (int64_t i = 0; i < nelms; ++i) {
+      floats[i] = halfObjects[i];
+    }
+  });
+  report("FLOAT16 -> FLOAT (popart::Half)", halfBytes, toFloatScalar);
+
+  return 0;
+}
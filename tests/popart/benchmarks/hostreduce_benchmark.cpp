@@ -0,0 +1,153 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <popart/hostreduceengine.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/threadpool.hpp>
+
+// Reports the throughput of the HostReduceEngine, in GB/s of gradient data
+// received from all replicas, without devices. One thread per replica streams
+// every gradient to the engine, as the stream callbacks of a replicated
+// session do, while the main thread sends each sum back as soon as all
+// replicas have been received.
+//
+// Usage: hostreduce_benchmark [nGradients [gradientBytes [replicas [repeats]]]]
+
+using namespace popart;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+  int64_t nGradients;
+  int64_t gradientBytes;
+  unsigned nReplicas;
+  int repeats;
+};
+
+// The number of replicas which have been received, per gradient
+class Arrivals {
+public:
+  explicit Arrivals(int64_t nGradients) : counts(nGradients, 0) {}
+
+  void arrive(int64_t gradient) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++counts[gradient];
+    }
+    condition.notify_all();
+  }
+
+  void waitFor(int64_t gradient, unsigned n) {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock,
+                   [this, gradient, n]() { return counts[gradient] == n; });
+  }
+
+private:
+  std::vector<unsigned> counts;
+  std::mutex mutex;
+  std::condition_variable condition;
+};
+
+double runStep(HostReduceEngine &engine,
+               const Config &config,
+               const std::vector<std::vector<char>> &replicaData,
+               std::vector<char> &sum) {
+  Arrivals arrivals(config.nGradients);
+
+  auto t0 = Clock::now();
+  std::vector<std::thread> replicas;
+  for (unsigned r = 0; r < config.nReplicas; ++r) {
+    replicas.emplace_back([&, r]() {
+      for (int64_t g = 0; g < config.nGradients; ++g) {
+        engine.receive(std::to_string(g), r, replicaData[r].data());
+        arrivals.arrive(g);
+      }
+    });
+  }
+  for (int64_t g = 0; g < config.nGradients; ++g) {
+    arrivals.waitFor(g, config.nReplicas);
+    engine.send(std::to_string(g), sum.data());
+  }
+  auto t1 = Clock::now();
+
+  for (auto &replica : replicas) {
+    replica.join();
+  }
+  return std::chrono::duration<double>(t1 - t0).count();
+}
+
+void benchmark(const std::string &name,
+               DataType type,
+               const Config &config,
+               int64_t bucketBytes,
+               ThreadPool &pool) {
+  auto elementBytes = type == DataType::FLOAT ? 4 : 2;
+  TensorInfo info(type, {config.gradientBytes / elementBytes});
+
+  HostReduceEngine engine(config.nReplicas, bucketBytes, pool);
+  for (int64_t g = 0; g < config.nGradients; ++g) {
+    engine.addGradient(std::to_string(g), info, config.nReplicas);
+  }
+
+  // Zeros are valid in both types
+  std::vector<std::vector<char>> replicaData(
+      config.nReplicas, std::vector<char>(info.nbytes(), 0));
+  std::vector<char> sum(info.nbytes());
+
+  double best = std::numeric_limits<double>::max();
+  for (int r = 0; r < config.repeats; ++r) {
+    best = std::min(best, runStep(engine, config, replicaData, sum));
+  }
+
+  auto bytes = static_cast<double>(config.nGradients * info.nbytes() *
+                                   config.nReplicas);
+  std::cout << std::left << std::setw(40) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(2)
+            << bytes / best / 1e9 << " GB/s" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Config config;
+  config.nGradients    = argc > 1 ? std::atoll(argv[1]) : 64;
+  config.gradientBytes = argc > 2 ? std::atoll(argv[2]) : (int64_t{4} << 20);
+  config.nReplicas     = argc > 3 ? std::atoi(argv[3]) : 4;
+  config.repeats       = argc > 4 ? std::atoi(argv[4]) : 5;
+
+  auto &pool = ThreadPool::global();
+  std::cout << "Reducing " << config.nGradients << " gradients of "
+            << config.gradientBytes << " bytes from " << config.nReplicas
+            << " replicas, best of " << config.repeats << " runs, "
+            << pool.size() << " pool threads" << std::endl;
+
+  // Without a pool, each gradient is summed in one piece on the thread which
+  // receives its last replica
+  ThreadPool serial(0);
+  benchmark("FLOAT (serial)",
+            DataType::FLOAT,
+            config,
+            std::numeric_limits<int64_t>::max(),
+            serial);
+
+  for (int64_t bucketBytes : {int64_t{256} << 10, int64_t{1} << 20}) {
+    auto suffix = " (" + std::to_string(bucketBytes >> 10) + " KiB buckets)";
+    benchmark("FLOAT" + suffix, DataType::FLOAT, config, bucketBytes, pool);
+    benchmark("FLOAT16" + suffix, DataType::FLOAT16, config, bucketBytes, pool);
+  }
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "../subgraph_tests/blip.hpp"
+#include "../subgraph_tests/validate.hpp"
+#include <popart/subgraph/outliner.hpp>
+
+// Compares the time taken to find the sub-graphs to outline, and the size of
+// the outlined schedule, of ALGO0, ALGO1 and the hierarchical ALGO2, on
+// schedules of repeated layers, such as those of transformers.
+//
+// The outlined size is the number of nodes and calls in the main schedule and
+// in all of the sub-graphs, as computed by getOutlinedSize. Smaller is better.
+//
+// ALGO0 is only run on the shorter schedules, as it is much slower.
+//
+// Usage: outlining_benchmark [maxLayers [layerLength]]
+
+namespace {
+
+using namespace fwtools::subgraph;
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// A layer with repeated sequences within it, like the heads and the
+// feed-forward sub-layers of a transformer layer
+std::vector<blip::Type> getLayerTypes(int layerLength) {
+  std::vector<blip::Type> types;
+  for (int i = 0; i < layerLength; ++i) {
+    types.push_back(i % 3 == 2 ? 100 + i : i % 7);
+  }
+  return types;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int maxLayers   = argc > 1 ? std::atoi(argv[1]) : 32;
+  const int layerLength = argc > 2 ? std::atoi(argv[2]) : 96;
+  const float threshold = 1.0f;
+
+  std::cout << "layers  nodes  algo   time [s]  #matches  outlined size"
+            << std::endl;
+
+  for (int nLayers = 4; nLayers <= maxLayers; nLayers *= 2) {
+    auto blips =
+        blip::getLayeredBlips(getLayerTypes(layerLength), nLayers, 11, 7);
+    std::vector<const blip::Blip *> sched;
+    for (auto &b : blips) {
+      sched.push_back(b.get());
+    }
+
+    for (auto algo : {OutlinerAlgorithm::ALGO0,
+                      OutlinerAlgorithm::ALGO1,
+                      OutlinerAlgorithm::ALGO2}) {
+      if (algo == OutlinerAlgorithm::ALGO0 && sched.size() > 1000) {
+        continue;
+      }
+      auto t0      = Clock::now();
+      auto matches = getRinseMatches<const blip::Blip>(sched, threshold, algo);
+      auto seconds = secondsSince(t0);
+      if (!isValid(matches, sched)) {
+        std::cerr << "Invalid matches" << std::endl;
+        return 1;
+      }
+      std::cout << nLayers << "  " << sched.size() << "  ALGO"
+                << static_cast<int>(algo) << "  " << seconds << "  "
+                << matches.size() << "  "
+                << getOutlinedSize(matches, static_cast<int>(sched.size()))
+                << std::endl;
+    }
+  }
+  return 0;
+}
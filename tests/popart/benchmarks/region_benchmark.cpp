@@ -0,0 +1,156 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <popart/region.hpp>
+
+// Reports the time per call of the view::Region operations used by the alias
+// analysis, the inplacing checks and AliasZeroCopy, on random 4-d Regions.
+//
+// Usage: region_benchmark [nRegions [repeats]]
+// where nRegions is the size of the sets of Regions which are subtracted,
+// merged and tested for overlap.
+
+using namespace popart;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const Shape shape{8, 16, 32, 64};
+
+view::Region randomRegion(std::mt19937 &rng) {
+  std::vector<int64_t> lower;
+  std::vector<int64_t> upper;
+  for (auto dim : shape) {
+    int64_t a = rng() % (dim + 1);
+    int64_t b = rng() % (dim + 1);
+    lower.push_back(std::min(a, b));
+    upper.push_back(std::max(a, b));
+  }
+  return view::Region(lower, upper);
+}
+
+view::Regions randomRegions(std::mt19937 &rng, int n) {
+  view::Regions regions;
+  for (int i = 0; i < n; ++i) {
+    regions.push_back(randomRegion(rng));
+  }
+  return regions;
+}
+
+// The best time of `repeats' runs of `calls' calls to f, in ns per call. The
+// sum of the results of f is kept so that the calls are not optimised away.
+int64_t sink = 0;
+double nsPerCall(const std::function<int64_t(int)> &f, int calls, int repeats) {
+  double best = std::numeric_limits<double>::max();
+  for (int r = 0; r < repeats; ++r) {
+    auto t0 = Clock::now();
+    for (int i = 0; i < calls; ++i) {
+      sink += f(i);
+    }
+    auto t1 = Clock::now();
+    best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+  }
+  return 1e9 * best / calls;
+}
+
+void report(const std::string &name, double ns) {
+  std::cout << std::left << std::setw(44) << name << std::right
+            << std::setw(12) << std::fixed << std::setprecision(1) << ns
+            << " ns" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int nRegions = argc > 1 ? std::atoi(argv[1]) : 64;
+  const int repeats  = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  std::mt19937 rng(1011);
+  const int nQueries = 256;
+  auto queries       = randomRegions(rng, nQueries);
+  auto others        = randomRegions(rng, nQueries);
+  auto rhs           = randomRegions(rng, nRegions);
+  auto full          = view::Region::getFull(shape);
+  auto flat          = view::Region::getFull({8 * 16, 32 * 64});
+
+  // Sets of Regions which do not overlap, in the two halves of dimension 0,
+  // so that every pair of Regions is tested
+  auto lowerHalf = view::Region({0, 0, 0, 0}, {4, 16, 32, 64});
+  auto upperHalf = view::Region({4, 0, 0, 0}, {8, 16, 32, 64});
+  view::Regions lowerRegions;
+  view::Regions upperRegions;
+  for (auto &r : randomRegions(rng, nRegions)) {
+    lowerRegions.push_back(r.intersect(lowerHalf));
+    upperRegions.push_back(r.intersect(upperHalf));
+  }
+
+  auto n = std::to_string(nRegions);
+
+  struct Benchmark {
+    std::string name;
+    int calls;
+    std::function<int64_t(int)> f;
+  };
+
+  std::vector<Benchmark> benchmarks{
+      {"copy",
+       100000,
+       [&](int i) {
+         view::Region r = queries[i % nQueries];
+         return r.rank();
+       }},
+      {"intersect",
+       100000,
+       [&](int i) {
+         return queries[i % nQueries].intersect(others[i % nQueries]).nelms();
+       }},
+      {"overlaps",
+       100000,
+       [&](int i) {
+         return int64_t{queries[i % nQueries].overlaps(others[i % nQueries])};
+       }},
+      {"sub",
+       20000,
+       [&](int i) {
+         auto subs = queries[i % nQueries].sub(others[i % nQueries]);
+         return static_cast<int64_t>(subs.size());
+       }},
+      {"sub, " + n + " Regions",
+       20,
+       [&](int) { return static_cast<int64_t>(full.sub(rhs).size()); }},
+      {"overlaps, " + n + " x " + n + " disjoint Regions",
+       1000,
+       [&](int) {
+         return int64_t{view::overlaps(lowerRegions, upperRegions)};
+       }},
+      {"mergeRegions, " + n + " Regions",
+       20,
+       [&](int) {
+         return static_cast<int64_t>(view::mergeRegions(rhs).size());
+       }},
+      {"reshape 4-d to 2-d",
+       200,
+       [&](int i) {
+         auto reshaped = queries[i % nQueries].reshape(full, flat);
+         return static_cast<int64_t>(reshaped.size());
+       }},
+  };
+
+  std::cout << "Regions of shape " << view::Bounds(shape) << ", sets of "
+            << nRegions << " Regions, best of " << repeats << std::endl;
+  for (const auto &benchmark : benchmarks) {
+    report(benchmark.name, nsPerCall(benchmark.f, benchmark.calls, repeats));
+  }
+
+  return sink == 42 ? 1 : 0;
+}
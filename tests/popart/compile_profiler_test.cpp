@@ -0,0 +1,196 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE CompileProfilerTest
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <popart/builder.hpp>
+#include <popart/compileprofiler.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/filereader.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/optimizer.hpp>
+#include <popart/testdevice.hpp>
+
+using namespace popart;
+
+namespace {
+
+struct TmpDir {
+  TmpDir()
+      : path(boost::filesystem::temp_directory_path() /
+             boost::filesystem::unique_path("popart_profile_%%%%%%%%")) {
+    boost::filesystem::create_directories(path);
+  }
+  ~TmpDir() { boost::filesystem::remove_all(path); }
+  boost::filesystem::path path;
+};
+
+std::string readFile(const boost::filesystem::path &path) {
+  std::ifstream ifs(path.string());
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  return ss.str();
+}
+
+const CompileProfiler::Event *
+findEvent(const std::vector<CompileProfiler::Event> &events,
+          const std::string &name) {
+  auto found = std::find_if(
+      events.begin(), events.end(), [&](const CompileProfiler::Event &e) {
+        return e.name == name;
+      });
+  return found == events.end() ? nullptr : &*found;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(CompileProfiler_Disabled) {
+  CompileProfiler profiler;
+  {
+    CompileProfiler::Scope scope(profiler, "ir", "stage");
+    scope.addArg("graph", "");
+  }
+  BOOST_CHECK(!profiler.isEnabled());
+  BOOST_CHECK(profiler.getEvents().empty());
+}
+
+BOOST_AUTO_TEST_CASE(CompileProfiler_NestedScopes) {
+  CompileProfiler profiler;
+  profiler.enable();
+  {
+    CompileProfiler::Scope outer(profiler, "transform", "outer");
+    for (int i = 0; i < 2; ++i) {
+      CompileProfiler::Scope inner(profiler, "schedule", "inner");
+      inner.addArg("graph", "g\"" + std::to_string(i));
+    }
+  }
+
+  auto events = profiler.getEvents();
+  BOOST_REQUIRE(events.size() == 3);
+  auto outer = findEvent(events, "outer");
+  BOOST_REQUIRE(outer);
+  for (auto &event : events) {
+    BOOST_CHECK(event.thread == 0);
+    BOOST_CHECK(event.start >= outer->start);
+    BOOST_CHECK(event.start + event.duration <=
+                outer->start + outer->duration);
+  }
+  BOOST_CHECK(findEvent(events, "inner")->args.at("graph") == "g\"0");
+  BOOST_CHECK(outer->opsBefore == -1);
+
+  // The enclosing stage first, and the arguments escaped
+  auto trace = profiler.toChromeTrace();
+  BOOST_CHECK(trace.find("\"traceEvents\"") != std::string::npos);
+  BOOST_CHECK(trace.find("\"outer\"") < trace.find("\"inner\""));
+  BOOST_CHECK(trace.find("\"graph\":\"g\\\"1\"") != std::string::npos);
+  BOOST_CHECK(trace.find("opsBefore") == std::string::npos);
+
+  // One row for each name
+  auto summary = profiler.getSummary();
+  std::istringstream iss(summary);
+  std::string line;
+  std::vector<std::string> lines;
+  while (std::getline(iss, line)) {
+    lines.push_back(line);
+  }
+  BOOST_REQUIRE(lines.size() == 3);
+  BOOST_CHECK(lines[1].find("outer") != std::string::npos);
+  std::istringstream row(lines[2]);
+  std::string category, name;
+  int count;
+  row >> category >> name >> count;
+  BOOST_CHECK(category == "schedule");
+  BOOST_CHECK(name == "inner");
+  BOOST_CHECK(count == 2);
+}
+
+BOOST_AUTO_TEST_CASE(CompileProfiler_AddEvent) {
+  CompileProfiler profiler;
+  profiler.addEvent("patterns", "p::matches", std::chrono::milliseconds(2));
+  BOOST_CHECK(profiler.getEvents().empty());
+
+  profiler.enable();
+  profiler.addEvent("patterns",
+                    "p::matches",
+                    std::chrono::milliseconds(2),
+                    {{"calls", "3"}});
+  auto events = profiler.getEvents();
+  BOOST_REQUIRE(events.size() == 1);
+  BOOST_CHECK(events[0].duration == 2000);
+  BOOST_CHECK(events[0].args.at("calls") == "3");
+  BOOST_CHECK(events[0].opsBefore == -1);
+}
+
+BOOST_AUTO_TEST_CASE(CompileProfiler_IrPrepare) {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+  TensorInfo info{"FLOAT", std::vector<int64_t>{4, 4}};
+  std::vector<float> vals(16, 1.0f);
+  auto w   = builder->addInitializedInputTensor({vals.data(), info});
+  auto in  = builder->addInputTensor(info);
+  auto out = aiOnnx.relu({aiOnnx.matmul({in, w})});
+  auto l1  = builder->aiGraphcoreOpset1().l1loss({out}, 0.1);
+
+  auto proto  = io::getModelFromString(builder->getModelProto());
+  auto device = createTestDevice(TEST_TARGET);
+  auto opt    = ConstSGD(0.01);
+
+  TmpDir dir;
+  SessionOptions opts;
+  opts.enableCompileProfiling = true;
+  opts.logDir                 = dir.path.string();
+
+  Ir ir;
+  ir.prepare({proto,
+              InputShapeInfo(),
+              DataFlow(1, {{out, AnchorReturnType("All")}}),
+              l1,
+              &opt,
+              *device,
+              opts,
+              Patterns(PatternsLevel::Default)});
+
+  auto events  = ir.getCompileProfiler().getEvents();
+  auto prepare = findEvent(events, "Ir::prepare");
+  BOOST_REQUIRE(prepare);
+  BOOST_CHECK(prepare->opsBefore == 0);
+  BOOST_CHECK(prepare->opsAfter > 0);
+  BOOST_CHECK(prepare->tensorsAfter > 0);
+
+  for (auto name : {"Prune",
+                    "InterIpuCopy",
+                    "PreAliasPatterns",
+                    "constructBackwards",
+                    "updateVertices",
+                    "getOpSchedule"}) {
+    BOOST_CHECK_MESSAGE(findEvent(events, name), name);
+  }
+
+  // The backwards pass adds Ops
+  auto backwards = findEvent(events, "constructBackwards");
+  BOOST_CHECK(backwards->opsAfter > backwards->opsBefore);
+
+  // Each pre-alias Pattern which is applied, and its calls to matches()
+  auto matMul = findEvent(events, "MatMulOp");
+  BOOST_REQUIRE(matMul);
+  BOOST_CHECK(matMul->category == "patterns");
+  BOOST_CHECK(matMul->opsBefore >= 0);
+  auto matMulMatches = findEvent(events, "MatMulOp::matches");
+  BOOST_REQUIRE(matMulMatches);
+  BOOST_CHECK(std::stoi(matMulMatches->args.at("calls")) > 0);
+
+  auto trace = readFile(dir.path / "compile_trace.json");
+  BOOST_CHECK(trace.find("\"name\":\"Ir::prepare\"") != std::string::npos);
+  auto summary = readFile(dir.path / "compile_summary.txt");
+  BOOST_CHECK(summary.find("Ir::prepare") != std::string::npos);
+  BOOST_CHECK(summary.find("MatMulOp::matches") != std::string::npos);
+}
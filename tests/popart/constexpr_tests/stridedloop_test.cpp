@@ -0,0 +1,153 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE StridedLoopTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <popart/ces/stridedloop.hpp>
+#include <popart/error.hpp>
+
+using namespace popart;
+
+namespace {
+
+int64_t nelms(const Shape &shape) {
+  return std::accumulate(
+      shape.begin(), shape.end(), int64_t{1}, std::multiplies<int64_t>());
+}
+
+// The multi-dimensional index of element `i' of a tensor of shape `shape'
+std::vector<int64_t> unflatten(int64_t i, const Shape &shape) {
+  std::vector<int64_t> index(shape.size());
+  for (auto d = shape.size(); d-- > 0;) {
+    index[d] = i % shape[d];
+    i /= shape[d];
+  }
+  return index;
+}
+
+// Visit every element with StridedLoop, recording the input offsets read
+// for each output element
+template <std::size_t N>
+std::vector<std::array<int64_t, N>>
+stridedOffsets(const Shape &shape,
+               const std::array<std::vector<int64_t>, N> &strides,
+               bool parallel) {
+  std::vector<std::array<int64_t, N>> result(nelms(shape));
+  StridedLoop<N> loop(shape, strides);
+  BOOST_CHECK_EQUAL(loop.nRows() * loop.rowSize(), nelms(shape));
+  auto record = [&](int64_t outOffset,
+                    const typename StridedLoop<N>::Offsets &in) {
+    for (int64_t j = 0; j < loop.rowSize(); ++j) {
+      for (uint64_t k = 0; k < N; ++k) {
+        result[outOffset + j][k] = in[k] + j * loop.rowStrides()[k];
+      }
+    }
+  };
+  if (parallel) {
+    loop.parallelForRows(record);
+  } else {
+    loop.forRows(0, loop.nRows(), record);
+  }
+  return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(StridedLoop_Broadcast) {
+  std::mt19937 gen(1011);
+  for (int test = 0; test < 200; ++test) {
+    // A random output shape, and two inputs which broadcast to it
+    auto rank = std::uniform_int_distribution<int>(0, 5)(gen);
+    Shape outShape, shape0, shape1;
+    for (int d = 0; d < rank; ++d) {
+      outShape.push_back(std::uniform_int_distribution<int>(1, 4)(gen));
+    }
+    for (auto inShape : {&shape0, &shape1}) {
+      auto inRank = std::uniform_int_distribution<int>(0, rank)(gen);
+      for (int d = rank - inRank; d < rank; ++d) {
+        bool broadcast = std::uniform_int_distribution<int>(0, 2)(gen) == 0;
+        inShape->push_back(broadcast ? 1 : outShape[d]);
+      }
+    }
+
+    auto offsets = stridedOffsets<2>(outShape,
+                                     {broadcastStrides(shape0, outShape),
+                                      broadcastStrides(shape1, outShape)},
+                                     test % 2 == 0);
+
+    for (int64_t i = 0; i < nelms(outShape); ++i) {
+      auto outIndex = unflatten(i, outShape);
+      for (int k = 0; k < 2; ++k) {
+        const auto &inShape = k == 0 ? shape0 : shape1;
+        // numpy broadcasting: align trailing dimensions, size 1 is repeated
+        int64_t expected = 0;
+        auto offset      = outShape.size() - inShape.size();
+        for (uint64_t d = 0; d < inShape.size(); ++d) {
+          auto index = inShape[d] == 1 ? 0 : outIndex[offset + d];
+          expected   = expected * inShape[d] + index;
+        }
+        BOOST_CHECK_EQUAL(offsets[i][k], expected);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(StridedLoop_Permute) {
+  std::mt19937 gen(1012);
+  for (int test = 0; test < 100; ++test) {
+    auto rank = std::uniform_int_distribution<int>(1, 5)(gen);
+    Shape inShape;
+    for (int d = 0; d < rank; ++d) {
+      inShape.push_back(std::uniform_int_distribution<int>(1, 5)(gen));
+    }
+    std::vector<int64_t> perm(rank);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), gen);
+    Shape outShape;
+    for (auto p : perm) {
+      outShape.push_back(inShape[p]);
+    }
+
+    auto offsets = stridedOffsets<1>(
+        outShape, {permutedStrides(inShape, perm)}, test % 2 == 0);
+
+    for (int64_t i = 0; i < nelms(outShape); ++i) {
+      auto outIndex = unflatten(i, outShape);
+      std::vector<int64_t> inIndex(rank);
+      for (int d = 0; d < rank; ++d) {
+        inIndex[perm[d]] = outIndex[d];
+      }
+      int64_t expected = 0;
+      for (int d = 0; d < rank; ++d) {
+        expected = expected * inShape[d] + inIndex[d];
+      }
+      BOOST_CHECK_EQUAL(offsets[i][0], expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(StridedLoop_MergesDimensions) {
+  // Contiguous inputs collapse to a single row
+  Shape shape{2, 3, 4};
+  StridedLoop<2> loop(
+      shape, {broadcastStrides(shape, shape), broadcastStrides({1}, shape)});
+  BOOST_CHECK_EQUAL(loop.nRows(), 1);
+  BOOST_CHECK_EQUAL(loop.rowSize(), 24);
+  BOOST_CHECK_EQUAL(loop.rowStrides()[0], 1);
+  BOOST_CHECK_EQUAL(loop.rowStrides()[1], 0);
+
+  // Broadcasting a row vector leaves the rows separate
+  StridedLoop<2> rows(
+      shape, {broadcastStrides(shape, shape), broadcastStrides({4}, shape)});
+  BOOST_CHECK_EQUAL(rows.nRows(), 6);
+  BOOST_CHECK_EQUAL(rows.rowSize(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(StridedLoop_InvalidBroadcast) {
+  BOOST_CHECK_THROW(broadcastStrides({3}, {2, 4}), error);
+  BOOST_CHECK_THROW(broadcastStrides({2, 1, 4}, {1, 4}), error);
+}
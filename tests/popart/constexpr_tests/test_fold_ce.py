@@ -0,0 +1,158 @@
+# Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+import numpy as np
+import popart
+import pytest
+import json
+
+# importing test_session requires adding to sys.path
+import sys
+from pathlib import Path
+sys.path.append(str(Path(__file__).resolve().parent.parent))
+from test_session import PopartTestSession
+
+
+def run_folded(op_type, build_folded, ref, input_shape):
+    """Build `data0 + build_folded(builder)`, where build_folded only uses
+    constants, and check that the op of type `op_type` was folded and the
+    result matches `data0 + ref`."""
+    np.random.seed(1)
+    input_data = np.random.rand(*input_shape).astype(np.float32)
+
+    def init_builder(builder):
+        d0 = builder.addInputTensor(input_data, 'data0')
+        x = build_folded(builder)
+        x = builder.aiOnnx.add([d0, x])
+        builder.addOutputTensor(x)
+        return [x]
+
+    session = PopartTestSession()
+    anchors = session.prepare_and_run(init_builder)
+
+    ir = json.loads(
+        session._session._serializeIr(popart.IrSerializationFormat.JSON))
+    types = [op['type'] for op in ir['maingraph']]
+    assert op_type not in types
+    # only the (possibly inplace) add of the input remains
+    assert len(types) == 1
+
+    result = list(anchors.values())[0]
+    assert np.allclose(result, input_data + ref, rtol=1e-5, atol=1e-6)
+
+
+# positive values, so that every unary op is defined
+const_data = (np.random.RandomState(0).rand(3, 4) + 0.5).astype(np.float32)
+
+
+@pytest.mark.parametrize(
+    "op_type,ref", [
+        ("Abs", np.abs),
+        ("Ceil", np.ceil),
+        ("Cos", np.cos),
+        ("Exp", np.exp),
+        ("Log", np.log),
+        ("Neg", np.negative),
+        ("Reciprocal", np.reciprocal),
+        ("Relu", lambda x: np.maximum(x, 0)),
+        ("Sigmoid", lambda x: 1 / (1 + np.exp(-x))),
+        ("Sign", np.sign),
+        ("Sin", np.sin),
+        ("Sqrt", np.sqrt),
+        ("Tanh", np.tanh),
+    ])
+def test_unary_ce(op_type, ref):
+    def build(builder):
+        c0 = builder.aiOnnx.constant(const_data)
+        return getattr(builder.aiOnnx, op_type.lower())([c0])
+
+    run_folded(op_type, build, ref(const_data), const_data.shape)
+
+
+def test_square_ce():
+    # Square is only in the ai.graphcore domain
+    def build(builder):
+        c0 = builder.aiOnnx.constant(const_data)
+        return builder.customOp(opName="Square",
+                                opVersion=1,
+                                domain="ai.graphcore",
+                                inputs=[c0],
+                                attributes={})[0]
+
+    run_folded("Square", build, np.square(const_data), const_data.shape)
+
+
+def test_pow_ce():
+    exponent = np.array([1.0, 2.0, 0.5, 3.0], dtype=np.float32)
+
+    def build(builder):
+        c0 = builder.aiOnnx.constant(const_data)
+        c1 = builder.aiOnnx.constant(exponent)
+        return builder.aiOnnx.pow([c0, c1])
+
+    run_folded("Pow", build, np.power(const_data, exponent), const_data.shape)
+
+
+def test_expand_ce():
+    data = np.arange(4, dtype=np.float32).reshape(4, 1)
+    shape = np.array([2, 4, 3], dtype=np.int64)
+
+    def build(builder):
+        c0 = builder.aiOnnx.constant(data)
+        c1 = builder.aiOnnx.constant(shape)
+        return builder.aiOnnx.expand([c0, c1])
+
+    ref = data * np.ones(shape, dtype=np.float32)
+    run_folded("Expand", build, ref, ref.shape)
+
+
+def test_tile_ce():
+    repeats = np.array([2, 3], dtype=np.int64)
+
+    def build(builder):
+        c0 = builder.aiOnnx.constant(const_data)
+        c1 = builder.aiOnnx.constant(repeats)
+        return builder.aiOnnx.tile([c0, c1])
+
+    ref = np.tile(const_data, repeats)
+    run_folded("Tile", build, ref, ref.shape)
+
+
+@pytest.mark.parametrize("mode", ["constant", "edge", "reflect"])
+def test_pad_ce(mode):
+    pads = [1, 2, 2, 0]
+
+    def build(builder):
+        c0 = builder.aiOnnx.constant(const_data)
+        return builder.aiOnnx.pad([c0], pads=pads, mode=mode, value=1.5)
+
+    np_pads = [(pads[0], pads[2]), (pads[1], pads[3])]
+    if mode == "constant":
+        ref = np.pad(const_data, np_pads, mode=mode, constant_values=1.5)
+    else:
+        ref = np.pad(const_data, np_pads, mode=mode)
+    run_folded("Pad", build, ref, ref.shape)
+
+
+@pytest.mark.parametrize(
+    "op_type,ref", [
+        ("ReduceSum", np.sum),
+        ("ReduceMean", np.mean),
+        ("ReduceMax", np.max),
+        ("ReduceMin", np.min),
+        ("ReduceProd", np.prod),
+        ("ReduceSumSquare", lambda x, **kw: np.sum(x * x, **kw)),
+        ("ReduceL1", lambda x, **kw: np.sum(np.abs(x), **kw)),
+        ("ReduceL2", lambda x, **kw: np.sqrt(np.sum(x * x, **kw))),
+    ])
+@pytest.mark.parametrize("axes,keepdims", [([0], 0), ([1, 2], 1),
+                                           ([0, 2], 0)])
+def test_reduce_ce(op_type, ref, axes, keepdims):
+    data = np.random.RandomState(2).rand(2, 3, 4).astype(np.float32)
+
+    def build(builder):
+        c0 = builder.aiOnnx.constant(data)
+        return getattr(builder.aiOnnx, op_type.lower())([c0],
+                                                        axes=axes,
+                                                        keepdims=keepdims)
+
+    expected = ref(data, axis=tuple(axes), keepdims=bool(keepdims))
+    run_folded(op_type, build, expected, expected.shape)
@@ -1,4 +1,5 @@
 # Copyright (c) 2019 Graphcore Ltd. All rights reserved.
+import json
 import numpy as np
 import popart
 import pytest
@@ -112,3 +113,132 @@ def test_get_cycle_count_requires_instrumentation_option():
         cycles = session.getCycleCount()
     assert e_info.value.args[0].startswith(
         "SessionOption 'instrumentWithHardwareCycleCounter' must be")
+
+
+def run_instrumented_model(opFilter=""):
+    builder = popart.Builder()
+    d0 = builder.addInputTensor(popart.TensorInfo("FLOAT", [200, 200]))
+    out = builder.aiOnnx.sin([d0])
+    out = builder.aiOnnx.exp([out])
+    out = builder.aiOnnx.matmul([out, out])
+
+    opts = popart.SessionOptions()
+    opts.instrumentWithHardwareCycleCounter = True
+    opts.hardwareInstrumentations = {
+        popart.Instrumentation.Outer, popart.Instrumentation.Op
+    }
+    opts.hardwareInstrumentationOpFilter = opFilter
+
+    bps = 4
+    session = popart.InferenceSession(
+        fnModel=builder.getModelProto(),
+        dataFlow=popart.DataFlow(bps, {out: popart.AnchorReturnType("All")}),
+        userOptions=opts,
+        deviceInfo=tu.create_test_device(),
+        patterns=popart.Patterns(popart.PatternsLevel.NoPatterns))
+
+    session.prepareDevice()
+    stepio = popart.PyStepIO(
+        {d0: np.random.rand(bps, 200, 200).astype(np.float32)},
+        session.initAnchorArrays())
+    session.run(stepio)
+    return session, bps
+
+
+@tu.requires_ipu
+def test_cycle_count_report_per_op():
+    session, bps = run_instrumented_model()
+    report = session.getCycleCountReport()
+    print(report)
+
+    assert sorted(e.opType for e in report.ops) == ["Exp", "MatMul", "Sin"]
+    for entry in report.ops:
+        # Each Op is run once per batch
+        assert entry.executions == bps
+        assert entry.cycles > 0
+    # The Op with the most cycles first
+    cycles = [e.cycles for e in report.ops]
+    assert cycles == sorted(cycles, reverse=True)
+
+    # The Ops are a part of the main program
+    assert sum(cycles) < session.getCycleCount()
+
+    perType = dict(report.cyclesPerOpType())
+    assert perType["MatMul"] == [
+        e.cycles for e in report.ops if e.opType == "MatMul"
+    ][0]
+
+    json_report = json.loads(report.toJson())
+    assert len(json_report["ops"]) == 3
+    assert json_report["ops"][0]["cycles"] == cycles[0]
+    assert json_report["pipelineStages"] == []
+
+
+@tu.requires_ipu
+def test_cycle_count_report_op_filter():
+    session, _ = run_instrumented_model(opFilter="^(Sin|MatMul)$")
+    report = session.getCycleCountReport()
+    assert sorted(e.opType for e in report.ops) == ["MatMul", "Sin"]
+
+
+def test_cycle_count_report_invalid_op_filter():
+    builder = popart.Builder()
+    d0 = builder.addInputTensor(popart.TensorInfo("FLOAT", [1]))
+    p = builder.aiOnnx.exp([d0])
+
+    opts = popart.SessionOptions()
+    opts.instrumentWithHardwareCycleCounter = True
+    opts.hardwareInstrumentations = {popart.Instrumentation.Op}
+    opts.hardwareInstrumentationOpFilter = "(Exp"
+
+    with pytest.raises(popart.popart_exception) as e_info:
+        popart.InferenceSession(fnModel=builder.getModelProto(),
+                                dataFlow=popart.DataFlow(
+                                    1, {p: popart.AnchorReturnType("All")}),
+                                userOptions=opts,
+                                deviceInfo=tu.create_test_device())
+    assert e_info.value.args[0].startswith(
+        "Invalid hardwareInstrumentationOpFilter '(Exp'")
+
+
+@tu.requires_ipu
+def test_cycle_count_report_per_pipeline_stage():
+    builder = popart.Builder()
+    d0 = builder.addInputTensor(popart.TensorInfo("FLOAT", [200, 200]))
+    with builder.virtualGraph(0), builder.pipelineStage(0):
+        out = builder.aiOnnx.sin([d0])
+    with builder.virtualGraph(1), builder.pipelineStage(1):
+        out = builder.aiOnnx.matmul([out, out])
+
+    opts = popart.SessionOptions()
+    opts.enablePipelining = True
+    opts.virtualGraphMode = popart.VirtualGraphMode.Manual
+    opts.instrumentWithHardwareCycleCounter = True
+    opts.hardwareInstrumentations = {
+        popart.Instrumentation.Outer, popart.Instrumentation.Stage
+    }
+
+    bps = 4
+    session = popart.InferenceSession(
+        fnModel=builder.getModelProto(),
+        dataFlow=popart.DataFlow(bps, {out: popart.AnchorReturnType("All")}),
+        userOptions=opts,
+        deviceInfo=tu.create_test_device(numIpus=2),
+        patterns=popart.Patterns(popart.PatternsLevel.NoPatterns))
+
+    session.prepareDevice()
+    stepio = popart.PyStepIO(
+        {d0: np.random.rand(bps, 200, 200).astype(np.float32)},
+        session.initAnchorArrays())
+    session.run(stepio)
+    report = session.getCycleCountReport()
+    print(report)
+
+    assert report.ops == []
+    assert [e.pipelineStage for e in report.pipelineStages] == [0, 1]
+    for entry in report.pipelineStages:
+        # Each stage is run once per batch
+        assert entry.executions == bps
+        assert entry.cycles > 0
+    stageCycles = sum(e.cycles for e in report.pipelineStages)
+    assert stageCycles < session.getCycleCount()
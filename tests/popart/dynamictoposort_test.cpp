@@ -0,0 +1,112 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE DynamicTopoSortTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+#include <popart/dynamictoposort.hpp>
+
+using namespace popart;
+
+namespace {
+
+// Return true if `to' is reachable from `from', by a depth first search over
+// the adjacency lists `outs'
+bool bruteForceReaches(const std::vector<std::vector<int>> &outs,
+                       int from,
+                       int to) {
+  std::vector<bool> seen(outs.size(), false);
+  std::vector<int> toVisit{from};
+  while (!toVisit.empty()) {
+    int n = toVisit.back();
+    toVisit.pop_back();
+    if (n == to) {
+      return true;
+    }
+    for (int w : outs[n]) {
+      if (!seen[w]) {
+        seen[w] = true;
+        toVisit.push_back(w);
+      }
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(DynamicTopoSort_basic) {
+  DynamicTopoSort topoSort;
+  auto a = topoSort.insertNode();
+  auto b = topoSort.insertNode();
+  auto c = topoSort.insertNode();
+
+  // c -> b -> a disagrees with the initial order, so the nodes are reordered
+  BOOST_CHECK(topoSort.tryInsertEdge(c, b));
+  BOOST_CHECK(topoSort.tryInsertEdge(b, a));
+  BOOST_CHECK(topoSort.position(c) < topoSort.position(b));
+  BOOST_CHECK(topoSort.position(b) < topoSort.position(a));
+  BOOST_CHECK(topoSort.reaches(c, a));
+  BOOST_CHECK(!topoSort.reaches(a, c));
+
+  // Cycles are rejected
+  BOOST_CHECK(!topoSort.tryInsertEdge(a, c));
+  BOOST_CHECK(!topoSort.tryInsertEdge(a, a));
+}
+
+BOOST_AUTO_TEST_CASE(DynamicTopoSort_rollback) {
+  DynamicTopoSort topoSort;
+  auto a = topoSort.insertNode();
+  auto b = topoSort.insertNode();
+  auto c = topoSort.insertNode();
+
+  // The first edge is fine on its own, but the pair forms a cycle, so
+  // neither is inserted
+  BOOST_CHECK(!topoSort.tryInsertEdges({{c, a}, {a, c}}));
+  BOOST_CHECK(!topoSort.reaches(c, a));
+  BOOST_CHECK(!topoSort.reaches(a, c));
+  BOOST_CHECK(topoSort.position(a) < topoSort.position(b));
+  BOOST_CHECK(topoSort.position(b) < topoSort.position(c));
+
+  BOOST_CHECK(topoSort.tryInsertEdges({{c, a}, {b, c}}));
+  BOOST_CHECK(topoSort.reaches(b, a));
+}
+
+BOOST_AUTO_TEST_CASE(DynamicTopoSort_random) {
+  // Compare against a brute force search for cycles on random graphs
+  std::mt19937 rng(1011);
+  for (int trial = 0; trial < 50; ++trial) {
+    const int nNodes = 2 + rng() % 40;
+    DynamicTopoSort topoSort;
+    for (int i = 0; i < nNodes; ++i) {
+      topoSort.insertNode();
+    }
+    std::vector<std::vector<int>> outs(nNodes);
+
+    for (int i = 0; i < 100; ++i) {
+      std::vector<DynamicTopoSort::Edge> edges;
+      auto candidate = outs;
+      bool cyclic    = false;
+      for (int j = 0; j < 1 + rng() % 3; ++j) {
+        int from = rng() % nNodes;
+        int to   = rng() % nNodes;
+        edges.push_back({from, to});
+        cyclic |= bruteForceReaches(candidate, to, from);
+        candidate[from].push_back(to);
+      }
+
+      BOOST_CHECK_EQUAL(topoSort.tryInsertEdges(edges), !cyclic);
+      if (!cyclic) {
+        outs = candidate;
+      }
+
+      for (int from = 0; from < nNodes; ++from) {
+        for (int to : outs[from]) {
+          BOOST_CHECK(topoSort.position(from) < topoSort.position(to));
+        }
+      }
+    }
+  }
+}
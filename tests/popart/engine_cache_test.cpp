@@ -0,0 +1,162 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE EngineCacheTest
+
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <popart/enginecache.hpp>
+
+using namespace popart;
+
+namespace {
+
+struct TmpDir {
+  TmpDir()
+      : path(boost::filesystem::temp_directory_path() /
+             boost::filesystem::unique_path("popart_engines_%%%%%%%%")) {}
+  ~TmpDir() { boost::filesystem::remove_all(path); }
+  boost::filesystem::path path;
+};
+
+std::function<void(std::ostream &)> writeBytes(int n) {
+  return [n](std::ostream &os) { os << std::string(n, 'x'); };
+}
+
+// Set the time an entry was last used to `secondsAgo' seconds ago
+void setLastUsed(const EngineCache &cache,
+                 const std::string &key,
+                 std::time_t secondsAgo) {
+  boost::filesystem::last_write_time(cache.getPopartPath(key),
+                                     std::time(nullptr) - secondsAgo);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(EngineCache_StoreAndList) {
+  TmpDir dir;
+  // The directory is created by the first store
+  EngineCache cache(dir.path.string());
+  BOOST_CHECK(cache.list().empty());
+
+  auto key0 = EngineCache::getKey(1);
+  auto key1 = EngineCache::getKey(2);
+  BOOST_CHECK(key0 != key1);
+
+  BOOST_CHECK(cache.store(key0, writeBytes(100), writeBytes(10)));
+  BOOST_CHECK(cache.store(key1, writeBytes(200), writeBytes(10)));
+  setLastUsed(cache, key0, 100);
+
+  // The most recently used first
+  auto entries = cache.list();
+  BOOST_REQUIRE(entries.size() == 2);
+  BOOST_CHECK(entries[0].key == key1);
+  BOOST_CHECK(entries[0].bytes == 210);
+  BOOST_CHECK(entries[1].key == key0);
+  BOOST_CHECK(entries[1].bytes == 110);
+  BOOST_CHECK(cache.size() == 320);
+
+  // Storing an existing key replaces the entry
+  BOOST_CHECK(cache.store(key0, writeBytes(50), writeBytes(10)));
+  BOOST_CHECK(cache.size() == 270);
+
+  // No temporary files are left
+  int nFiles = 0;
+  for (boost::filesystem::directory_iterator it(dir.path), end; it != end;
+       ++it) {
+    ++nFiles;
+  }
+  BOOST_CHECK(nFiles == 4);
+
+  BOOST_CHECK(cache.remove(key0));
+  BOOST_CHECK(!cache.remove(key0));
+  BOOST_CHECK(cache.list().size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(EngineCache_PruneLeastRecentlyUsed) {
+  TmpDir dir;
+  EngineCache cache(dir.path.string());
+
+  auto key0 = EngineCache::getKey(1);
+  auto key1 = EngineCache::getKey(2);
+  auto key2 = EngineCache::getKey(3);
+  cache.store(key0, writeBytes(100), writeBytes(10));
+  cache.store(key1, writeBytes(100), writeBytes(10));
+  cache.store(key2, writeBytes(100), writeBytes(10));
+  setLastUsed(cache, key0, 300);
+  setLastUsed(cache, key1, 200);
+  setLastUsed(cache, key2, 100);
+
+  // Using key0 makes key1 the least recently used
+  cache.touch(key0);
+
+  BOOST_CHECK(cache.prune(1000) == 0);
+  BOOST_CHECK(cache.prune(300) == 1);
+  auto entries = cache.list();
+  BOOST_REQUIRE(entries.size() == 2);
+  BOOST_CHECK(entries[0].key == key0);
+  BOOST_CHECK(entries[1].key == key2);
+
+  BOOST_CHECK(cache.prune(0) == 2);
+  BOOST_CHECK(cache.list().empty());
+}
+
+BOOST_AUTO_TEST_CASE(EngineCache_IncompleteEntries) {
+  TmpDir dir;
+  EngineCache cache(dir.path.string());
+
+  auto key0 = EngineCache::getKey(1);
+  cache.store(key0, writeBytes(100), writeBytes(10));
+
+  // An entry without its .poplar file, and a temporary file, are not listed
+  auto key1 = EngineCache::getKey(2);
+  cache.store(key1, writeBytes(100), writeBytes(10));
+  boost::filesystem::remove(cache.getPoplarPath(key1));
+  std::ofstream(cache.getPopartPath(key0) + ".tmp-0000-0000") << "x";
+
+  auto entries = cache.list();
+  BOOST_REQUIRE(entries.size() == 1);
+  BOOST_CHECK(entries[0].key == key0);
+}
+
+BOOST_AUTO_TEST_CASE(EngineCache_PruneIncompleteEntries) {
+  TmpDir dir;
+  EngineCache cache(dir.path.string());
+
+  auto setAge = [](const std::string &path, std::time_t secondsAgo) {
+    boost::filesystem::last_write_time(path, std::time(nullptr) - secondsAgo);
+  };
+
+  // .poplar files whose .popart file was never written, and a .popart file
+  // whose .poplar file was removed
+  auto key0 = EngineCache::getKey(1);
+  auto key1 = EngineCache::getKey(2);
+  auto key2 = EngineCache::getKey(3);
+  for (auto &key : {key0, key1, key2}) {
+    cache.store(key, writeBytes(100), writeBytes(10));
+  }
+  boost::filesystem::remove(cache.getPopartPath(key0));
+  boost::filesystem::remove(cache.getPopartPath(key1));
+  boost::filesystem::remove(cache.getPoplarPath(key2));
+  setAge(cache.getPoplarPath(key0), 7200);
+  setAge(cache.getPopartPath(key2), 7200);
+
+  // A complete entry
+  auto key3 = EngineCache::getKey(4);
+  cache.store(key3, writeBytes(100), writeBytes(10));
+  setLastUsed(cache, key3, 7200);
+
+  BOOST_CHECK(cache.prune(1000) == 0);
+  BOOST_CHECK(!boost::filesystem::exists(cache.getPoplarPath(key0)));
+  BOOST_CHECK(!boost::filesystem::exists(cache.getPopartPath(key2)));
+  // The .poplar file of an entry may be written a while before its .popart
+  // file, so recent ones are kept
+  BOOST_CHECK(boost::filesystem::exists(cache.getPoplarPath(key1)));
+  BOOST_CHECK(boost::filesystem::exists(cache.getPoplarPath(key3)));
+  BOOST_CHECK(cache.list().size() == 1);
+}
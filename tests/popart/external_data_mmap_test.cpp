@@ -0,0 +1,158 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE ExternalDataMmapTest
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <popart/error.hpp>
+#include <popart/onnxutil.hpp>
+#include <popart/tensordata.hpp>
+
+using namespace popart;
+
+namespace {
+
+struct TmpDir {
+  TmpDir()
+      : path(boost::filesystem::temp_directory_path() /
+             boost::filesystem::unique_path("popart_mmap_%%%%%%%%")) {
+    boost::filesystem::create_directories(path);
+  }
+  ~TmpDir() { boost::filesystem::remove_all(path); }
+  boost::filesystem::path path;
+};
+
+void writeFile(const std::string &fn, const std::vector<char> &bytes) {
+  std::ofstream ofs(fn, std::ofstream::binary);
+  ofs.write(bytes.data(), bytes.size());
+}
+
+std::vector<char> readFile(const std::string &fn) {
+  std::ifstream ifs(fn, std::ifstream::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(ifs),
+                           std::istreambuf_iterator<char>());
+}
+
+// A FLOAT TensorProto of `nelms' elements stored at byte `offset' of `fn'
+ONNX_NAMESPACE::TensorProto
+externalTensor(const std::string &fn, int64_t offset, int64_t nelms) {
+  ONNX_NAMESPACE::TensorProto tp;
+  tp.set_name("t");
+  tp.set_data_type(ONNX_NAMESPACE::TensorProto::FLOAT);
+  tp.add_dims(nelms);
+  tp.set_data_location(ONNX_NAMESPACE::TensorProto::EXTERNAL);
+  auto add = [&tp](const std::string &key, const std::string &value) {
+    auto *entry = tp.mutable_external_data()->Add();
+    entry->set_key(key);
+    entry->set_value(value);
+  };
+  add("location", fn);
+  add("offset", std::to_string(offset));
+  add("length", std::to_string(nelms * sizeof(float)));
+  return tp;
+}
+
+std::vector<char> floatBytes(const std::vector<float> &values, int pad) {
+  std::vector<char> bytes(pad, 0);
+  bytes.resize(pad + values.size() * sizeof(float));
+  std::memcpy(
+      bytes.data() + pad, values.data(), values.size() * sizeof(float));
+  return bytes;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ExternalDataMmap_ReadsWithoutCopying) {
+  TmpDir tmp;
+  auto fn = (tmp.path / "weights.bin").string();
+  std::vector<float> values{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  writeFile(fn, floatBytes(values, 8));
+
+  TensorData a(externalTensor(fn, 8, 4));
+  TensorData b(externalTensor(fn, 16, 4));
+  BOOST_CHECK(a.isMapped());
+  BOOST_CHECK(b.isMapped());
+  BOOST_CHECK_EQUAL(a.size(), 4 * sizeof(float));
+  BOOST_CHECK(a.copyDataAs<float>(4) ==
+              std::vector<float>(values.begin(), values.begin() + 4));
+  BOOST_CHECK(b.copyDataAs<float>(4) ==
+              std::vector<float>(values.begin() + 2, values.end()));
+}
+
+BOOST_AUTO_TEST_CASE(ExternalDataMmap_WritesAreNotShared) {
+  TmpDir tmp;
+  auto fn = (tmp.path / "weights.bin").string();
+  std::vector<float> values{1.0f, 2.0f, 3.0f, 4.0f};
+  auto bytes = floatBytes(values, 0);
+  writeFile(fn, bytes);
+
+  TensorData a(externalTensor(fn, 0, 4));
+  TensorData b(externalTensor(fn, 0, 4));
+  std::vector<float> update{9.0f, 8.0f, 7.0f, 6.0f};
+  a.resetData(TensorInfo{DataType::FLOAT, {4}}, update.data());
+
+  BOOST_CHECK(a.copyDataAs<float>(4) == update);
+  // Neither the file nor other mappings of it see the write
+  BOOST_CHECK(readFile(fn) == bytes);
+  BOOST_CHECK(b.copyDataAs<float>(4) == values);
+}
+
+BOOST_AUTO_TEST_CASE(ExternalDataMmap_ReplacedFile) {
+  TmpDir tmp;
+  auto fn = (tmp.path / "weights.bin").string();
+  std::vector<float> values{1.0f, 2.0f};
+  writeFile(fn, floatBytes(values, 0));
+  TensorData a(externalTensor(fn, 0, 2));
+
+  // Replace the file, as saveInitializersExternally does
+  auto tmpFn = fn + ".tmp";
+  std::vector<float> newValues{3.0f, 4.0f};
+  writeFile(tmpFn, floatBytes(newValues, 0));
+  boost::filesystem::rename(tmpFn, fn);
+
+  TensorData b(externalTensor(fn, 0, 2));
+  BOOST_CHECK(a.copyDataAs<float>(2) == values);
+  BOOST_CHECK(b.copyDataAs<float>(2) == newValues);
+}
+
+BOOST_AUTO_TEST_CASE(ExternalDataMmap_MisalignedIsCopied) {
+  TmpDir tmp;
+  auto fn = (tmp.path / "weights.bin").string();
+  std::vector<float> values{1.0f, 2.0f, 3.0f};
+  writeFile(fn, floatBytes(values, 2));
+
+  TensorData a(externalTensor(fn, 2, 3));
+  BOOST_CHECK(!a.isMapped());
+  BOOST_CHECK(a.copyDataAs<float>(3) == values);
+}
+
+BOOST_AUTO_TEST_CASE(ExternalDataMmap_OutOfRange) {
+  TmpDir tmp;
+  auto fn = (tmp.path / "weights.bin").string();
+  writeFile(fn, floatBytes({1.0f, 2.0f}, 0));
+  BOOST_CHECK_THROW(TensorData(externalTensor(fn, 4, 2)), error);
+}
+
+BOOST_AUTO_TEST_CASE(ExternalDataMmap_NoElements) {
+  TmpDir tmp;
+  auto fn = (tmp.path / "weights.bin").string();
+  writeFile(fn, floatBytes({1.0f, 2.0f}, 0));
+
+  // A region of 0 bytes is not mapped, the data is empty
+  auto tp = externalTensor(fn, 4, 0);
+  TensorData a(tp);
+  BOOST_CHECK(!a.isMapped());
+  BOOST_CHECK(a.size() == 0);
+  BOOST_CHECK(onnxutil::getConstData(tp).info.nbytes() == 0);
+
+  // A missing length is only valid for a tensor with no elements
+  auto noLength = externalTensor(fn, 0, 2);
+  noLength.mutable_external_data()->RemoveLast();
+  BOOST_CHECK_THROW(TensorData{noLength}, error);
+  BOOST_CHECK_THROW(onnxutil::getConstData(noLength), error);
+}
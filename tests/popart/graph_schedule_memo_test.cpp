@@ -0,0 +1,110 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE GraphScheduleMemoTest
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/filereader.hpp>
+#include <popart/graph.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/op.hpp>
+#include <popart/sessionoptions.hpp>
+#include <popart/testdevice.hpp>
+#include <popart/topocons.hpp>
+
+using namespace popart;
+
+namespace {
+
+void prepare(Ir &ir) {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+  TensorInfo info{"FLOAT", std::vector<int64_t>{4, 4}};
+  auto in0 = builder->addInputTensor(info);
+  auto in1 = builder->addInputTensor(info);
+  auto a   = aiOnnx.add({in0, in1});
+  auto b   = aiOnnx.mul({in0, in1});
+  auto c   = aiOnnx.sub({a, b});
+  auto out = aiOnnx.relu({c});
+  builder->addOutputTensor(out);
+
+  auto proto  = io::getModelFromString(builder->getModelProto());
+  auto df     = DataFlow(1, {{out, AnchorReturnType("All")}});
+  auto device = createTestDevice(TEST_TARGET);
+
+  ir.prepare({proto,
+              InputShapeInfo(),
+              df,
+              {},
+              nullptr,
+              *device,
+              {},
+              Patterns(PatternsLevel::NoPatterns)});
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(GraphScheduleMemo_RepeatedScheduleIsMemoized) {
+  Ir ir;
+  prepare(ir);
+  auto &graph = ir.getMainGraph();
+
+  auto before   = graph.getScheduleMemoCounters();
+  auto schedule = graph.getOpSchedule({});
+  auto again    = graph.getOpSchedule({});
+  BOOST_CHECK(schedule == again);
+
+  auto after = graph.getScheduleMemoCounters();
+  BOOST_CHECK_EQUAL(after.scheduleHits, before.scheduleHits + 1);
+  BOOST_CHECK_EQUAL(after.scheduleMisses, before.scheduleMisses);
+
+  graph.getLiveSets(schedule);
+  graph.getLiveSets(schedule);
+  after = graph.getScheduleMemoCounters();
+  BOOST_CHECK_EQUAL(after.liveSetsHits, before.liveSetsHits + 1);
+}
+
+BOOST_AUTO_TEST_CASE(GraphScheduleMemo_MutationsInvalidate) {
+  Ir ir;
+  prepare(ir);
+  auto &graph = ir.getMainGraph();
+
+  auto schedule = graph.getOpSchedule({});
+  BOOST_REQUIRE_GE(schedule.size(), 2);
+  auto misses = graph.getScheduleMemoCounters().scheduleMisses;
+
+  // A topological constraint changes the mutation epoch
+  auto epoch = graph.getMutationEpoch();
+  graph.topoCons->insert(schedule.front(), schedule.back());
+  BOOST_CHECK_GT(graph.getMutationEpoch(), epoch);
+  graph.getOpSchedule({});
+  BOOST_CHECK_EQUAL(graph.getScheduleMemoCounters().scheduleMisses,
+                    misses + 1);
+
+  // A scheduling setting changes no epoch, but is compared
+  schedule.back()->settings.schedulePriority += 1.0;
+  graph.getOpSchedule({});
+  BOOST_CHECK_EQUAL(graph.getScheduleMemoCounters().scheduleMisses,
+                    misses + 2);
+
+  // Different extra constraints are memoized separately. The Add and Mul
+  // are independent, so either may be scheduled before the other
+  auto findOp = [&schedule](const std::string &type) {
+    return *std::find_if(schedule.begin(), schedule.end(), [&type](Op *op) {
+      return op->opid.type == type;
+    });
+  };
+  graph.getOpSchedule({{findOp("Add"), {findOp("Mul")}}});
+  BOOST_CHECK_EQUAL(graph.getScheduleMemoCounters().scheduleMisses,
+                    misses + 3);
+  graph.getOpSchedule({});
+  BOOST_CHECK_EQUAL(graph.getScheduleMemoCounters().scheduleMisses,
+                    misses + 3);
+}
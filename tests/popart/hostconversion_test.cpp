@@ -0,0 +1,184 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE HostConversionTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <popart/half.hpp>
+#include <popart/hostconversion.hpp>
+#include <popart/threadpool.hpp>
+
+using namespace popart;
+
+namespace {
+uint32_t bits(float f) {
+  uint32_t u;
+  std::memcpy(&u, &f, sizeof(u));
+  return u;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(HostConversion_floatToHalfRounding) {
+  // Exactly representable values
+  BOOST_CHECK_EQUAL(hostconversion::floatToHalf(0.0f), 0x0000);
+  BOOST_CHECK_EQUAL(hostconversion::floatToHalf(-0.0f), 0x8000);
+  BOOST_CHECK_EQUAL(hostconversion::floatToHalf(1.0f), 0x3c00);
+  BOOST_CHECK_EQUAL(hostconversion::floatToHalf(-2.0f), 0xc000);
+  BOOST_CHECK_EQUAL(hostconversion::floatToHalf(65504.0f), 0x7bff);
+
+  // Ties round to even: 1 + 2^-11 is half way between 1 and 1 + 2^-10
+  BOOST_CHECK_EQUAL(hostconversion::floatToHalf(1.0f + std::ldexp(1.0f, -11)),
+                    0x3c00);
+  BOOST_CHECK_EQUAL(
+      hostconversion::floatToHalf(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3c02);
+
+  // Overflow, subnormals and underflow
+  BOOST_CHECK_EQUAL(hostconversion::floatToHalf(65520.0f), 0x7c00);
+  BOOST_CHECK_EQUAL(hostconversion::floatToHalf(std::ldexp(1.0f, -24)),
+                    0x0001);
+  BOOST_CHECK_EQUAL(hostconversion::floatToHalf(std::ldexp(1.0f, -25)),
+                    0x0000);
+  BOOST_CHECK_EQUAL(
+      hostconversion::floatToHalf(std::numeric_limits<float>::infinity()),
+      0x7c00);
+  BOOST_CHECK(
+      (hostconversion::floatToHalf(std::numeric_limits<float>::quiet_NaN()) &
+       0x7fff) > 0x7c00);
+}
+
+BOOST_AUTO_TEST_CASE(HostConversion_halfRoundTrip) {
+  // Every half value (other than NaNs) survives a round trip through float,
+  // and the bulk conversions agree with the scalar ones.
+  std::vector<uint16_t> halfs(1 << 16);
+  for (uint32_t i = 0; i < halfs.size(); ++i) {
+    halfs[i] = static_cast<uint16_t>(i);
+  }
+  std::vector<float> floats(halfs.size());
+  std::vector<uint16_t> result(halfs.size());
+  hostconversion::convert(DataType::FLOAT16,
+                          halfs.data(),
+                          DataType::FLOAT,
+                          floats.data(),
+                          halfs.size());
+  hostconversion::convert(DataType::FLOAT,
+                          floats.data(),
+                          DataType::FLOAT16,
+                          result.data(),
+                          floats.size());
+
+  for (uint32_t i = 0; i < halfs.size(); ++i) {
+    BOOST_CHECK_EQUAL(bits(floats[i]),
+                      bits(hostconversion::halfToFloat(halfs[i])));
+    bool isNan = (halfs[i] & 0x7c00) == 0x7c00 && (halfs[i] & 0x3ff) != 0;
+    if (!isNan) {
+      BOOST_CHECK_EQUAL(result[i], halfs[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(HostConversion_integerAndDouble) {
+  // An odd length, to exercise the scalar tails of the vector kernels
+  const int64_t n = 1001;
+
+  std::vector<int64_t> i64(n);
+  std::vector<double> f64(n);
+  for (int64_t i = 0; i < n; ++i) {
+    i64[i] = (i - n / 2) * 7919;
+    f64[i] = static_cast<double>(i) / 3.0;
+  }
+
+  std::vector<int32_t> i32(n);
+  hostconversion::convert(
+      DataType::INT64, i64.data(), DataType::INT32, i32.data(), n);
+  std::vector<int64_t> i64Back(n);
+  hostconversion::convert(
+      DataType::INT32, i32.data(), DataType::INT64, i64Back.data(), n);
+  std::vector<float> f32(n);
+  hostconversion::convert(
+      DataType::DOUBLE, f64.data(), DataType::FLOAT, f32.data(), n);
+
+  for (int64_t i = 0; i < n; ++i) {
+    BOOST_CHECK_EQUAL(i32[i], static_cast<int32_t>(i64[i]));
+    BOOST_CHECK_EQUAL(i64Back[i], i64[i]);
+    BOOST_CHECK_EQUAL(f32[i], static_cast<float>(f64[i]));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(HostConversion_doubleToHalfRounding) {
+  // 1 + 2^-11 + 2^-40 is just above the tie between 1 and 1 + 2^-10, so
+  // rounds up, but rounding it to float first would make it a tie which
+  // rounds down to even
+  std::vector<double> f64{1.0 + std::ldexp(1.0, -11) + std::ldexp(1.0, -40),
+                          1.0 + std::ldexp(1.0, -11),
+                          -0.1,
+                          65504.0,
+                          1e6};
+  std::vector<uint16_t> f16(f64.size());
+  hostconversion::convert(DataType::DOUBLE,
+                          f64.data(),
+                          DataType::FLOAT16,
+                          f16.data(),
+                          f64.size());
+
+  BOOST_CHECK_EQUAL(f16[0], 0x3c01);
+  BOOST_CHECK_EQUAL(f16[1], 0x3c00);
+  for (std::size_t i = 2; i < f64.size(); ++i) {
+    BOOST_CHECK_EQUAL(f16[i],
+                      hostconversion::floatToHalf(static_cast<float>(f64[i])));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(HostConversion_halfBulk) {
+  // An odd length, to exercise the scalar tails of the vector kernels
+  std::vector<float> floats(1001);
+  for (std::size_t i = 0; i < floats.size(); ++i) {
+    floats[i] = static_cast<float>(i) / 7.0f - 50.0f;
+  }
+
+  auto halfs = floatToHalf(floats);
+  auto back  = halfToFloat(halfs);
+  BOOST_REQUIRE_EQUAL(halfs.size(), floats.size());
+  BOOST_REQUIRE_EQUAL(back.size(), floats.size());
+  for (std::size_t i = 0; i < floats.size(); ++i) {
+    Half h(floats[i]);
+    BOOST_CHECK(halfs[i] == h);
+    BOOST_CHECK_EQUAL(back[i], static_cast<float>(h));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(HostConversion_unsupported) {
+  BOOST_CHECK(hostconversion::canConvert(DataType::INT8, DataType::INT8));
+  BOOST_CHECK(!hostconversion::canConvert(DataType::FLOAT, DataType::INT32));
+
+  float src = 1.0f;
+  int32_t dst;
+  BOOST_CHECK_THROW(hostconversion::convert(
+                        DataType::FLOAT, &src, DataType::INT32, &dst, 1),
+                    popart::error);
+}
+
+BOOST_AUTO_TEST_CASE(HostConversion_threadPool) {
+  ThreadPool pool(3);
+  std::vector<int> counts(100000, 0);
+  pool.parallelFor(counts.size(), 1000, [&counts](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      ++counts[i];
+    }
+  });
+  for (auto c : counts) {
+    BOOST_CHECK_EQUAL(c, 1);
+  }
+
+  BOOST_CHECK_THROW(pool.parallelFor(100,
+                                     1,
+                                     [](int64_t begin, int64_t) {
+                                       if (begin > 0) {
+                                         throw popart::error("chunk failed");
+                                       }
+                                     }),
+                    popart::error);
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE HostReduceEngineTest
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+#include <popart/error.hpp>
+#include <popart/hostconversion.hpp>
+#include <popart/hostreduceengine.hpp>
+#include <popart/threadpool.hpp>
+
+using namespace popart;
+
+BOOST_AUTO_TEST_CASE(HostReduceEngine_sumFloat) {
+  const unsigned nReplicas = 4;
+  const int64_t nelms      = 10007;
+
+  // Small buckets, so each gradient is reduced by several tasks
+  ThreadPool pool(3);
+  HostReduceEngine engine(nReplicas, 1000, pool);
+  engine.addGradient("g0", {DataType::FLOAT, {nelms}}, nReplicas);
+  engine.addGradient("g1", {DataType::FLOAT, {7, 3}}, nReplicas);
+
+  std::vector<std::vector<float>> g0(nReplicas, std::vector<float>(nelms));
+  std::vector<std::vector<float>> g1(nReplicas, std::vector<float>(21));
+
+  for (int step = 0; step < 3; ++step) {
+    for (unsigned r = 0; r < nReplicas; ++r) {
+      for (int64_t i = 0; i < nelms; ++i) {
+        g0[r][i] = static_cast<float>(step + r + i);
+      }
+      for (int64_t i = 0; i < 21; ++i) {
+        g1[r][i] = static_cast<float>(r * i);
+      }
+    }
+
+    // Replicas are received concurrently, as by the stream callbacks
+    std::vector<std::thread> replicas;
+    for (unsigned r = 0; r < nReplicas; ++r) {
+      replicas.emplace_back([&engine, &g0, &g1, r]() {
+        engine.receive("g0", r, g0[r].data());
+        engine.receive("g1", r, g1[r].data());
+      });
+    }
+    for (auto &replica : replicas) {
+      replica.join();
+    }
+
+    std::vector<float> sum0(nelms);
+    std::vector<float> sum1(21);
+    engine.send("g1", sum1.data());
+    engine.send("g0", sum0.data());
+
+    for (int64_t i = 0; i < nelms; ++i) {
+      BOOST_CHECK_EQUAL(sum0[i], static_cast<float>(4 * (step + i) + 6));
+    }
+    for (int64_t i = 0; i < 21; ++i) {
+      BOOST_CHECK_EQUAL(sum1[i], static_cast<float>(6 * i));
+    }
+  }
+
+  BOOST_CHECK_EQUAL(engine.getBytesReceived(),
+                    3 * nReplicas * (nelms + 21) * sizeof(float));
+}
+
+BOOST_AUTO_TEST_CASE(HostReduceEngine_sumHalf) {
+  // 2048 + 1 + 1 + 1 is 2050 with FLOAT accumulation, but 2048 if accumulated
+  // in FLOAT16, where the spacing of values at 2048 is 2
+  const unsigned nReplicas = 4;
+  const int64_t nelms      = 3000;
+
+  ThreadPool pool(2);
+  HostReduceEngine engine(nReplicas, 512, pool);
+  engine.addGradient("g", {DataType::FLOAT16, {nelms}}, nReplicas);
+
+  std::vector<std::vector<uint16_t>> g(nReplicas,
+                                       std::vector<uint16_t>(nelms));
+  for (unsigned r = 0; r < nReplicas; ++r) {
+    auto value = hostconversion::floatToHalf(r == 0 ? 2048.0f : 1.0f);
+    std::fill(g[r].begin(), g[r].end(), value);
+    engine.receive("g", r, g[r].data());
+  }
+
+  std::vector<uint16_t> sum(nelms);
+  engine.send("g", sum.data());
+  for (auto s : sum) {
+    BOOST_CHECK_EQUAL(hostconversion::halfToFloat(s), 2050.0f);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(HostReduceEngine_reducedOnDevice) {
+  // A gradient already reduced on the device is taken from replica 0
+  ThreadPool pool(0);
+  HostReduceEngine engine(2, 1 << 20, pool);
+  engine.addGradient("g", {DataType::FLOAT, {4}}, 1);
+
+  std::vector<float> g0{1, 2, 3, 4};
+  std::vector<float> g1{5, 6, 7, 8};
+  engine.receive("g", 1, g1.data());
+  engine.receive("g", 0, g0.data());
+
+  std::vector<float> sum(4);
+  engine.send("g", sum.data());
+  BOOST_CHECK_EQUAL_COLLECTIONS(sum.begin(), sum.end(), g0.begin(), g0.end());
+}
+
+BOOST_AUTO_TEST_CASE(HostReduceEngine_errors) {
+  ThreadPool pool(0);
+  HostReduceEngine engine(2, 1 << 20, pool);
+  engine.addGradient("g", {DataType::FLOAT, {4}}, 2);
+
+  BOOST_CHECK_THROW(engine.addGradient("g", {DataType::FLOAT, {4}}, 2),
+                    error);
+  BOOST_CHECK_THROW(engine.addGradient("i", {DataType::INT32, {4}}, 2), error);
+  BOOST_CHECK_THROW(engine.addGradient("h", {DataType::FLOAT, {4}}, 3), error);
+
+  std::vector<float> g(4, 1.0f);
+  std::vector<float> sum(4);
+  BOOST_CHECK_THROW(engine.receive("unknown", 0, g.data()), error);
+  BOOST_CHECK_THROW(engine.receive("g", 2, g.data()), error);
+
+  // Not all replicas have been received
+  engine.receive("g", 0, g.data());
+  BOOST_CHECK_THROW(engine.receive("g", 0, g.data()), error);
+  BOOST_CHECK_THROW(engine.send("g", sum.data()), error);
+
+  engine.receive("g", 1, g.data());
+  engine.send("g", sum.data());
+  BOOST_CHECK_EQUAL(sum[0], 2.0f);
+}
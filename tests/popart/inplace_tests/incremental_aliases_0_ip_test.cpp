@@ -0,0 +1,139 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE IncrementalAliases0InplaceTest
+
+#include <boost/test/unit_test.hpp>
+#include <map>
+#include <vector>
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/filereader.hpp>
+#include <popart/graph.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/op.hpp>
+#include <popart/region.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/tensornames.hpp>
+#include <popart/tensors.hpp>
+#include <popart/testdevice.hpp>
+
+using namespace popart;
+
+namespace {
+
+// The elements of a Tensor of Shape `shape' which are in any of `regions'.
+// The same elements can be covered by different Regions, so these are
+// compared instead of the Regions.
+std::vector<bool> covered(const view::Regions &regions, const Shape &shape) {
+  auto full = view::Region::getFull(shape);
+  std::vector<bool> elements(full.nelms(), false);
+  for (int64_t i = 0; i < full.nelms(); ++i) {
+    auto index = full.dimIndex(i);
+    for (auto &region : regions) {
+      if (!region.isEmpty() && region.contains(index)) {
+        elements[i] = true;
+      }
+    }
+  }
+  return elements;
+}
+
+using AliasMap =
+    std::map<std::pair<TensorId, TensorId>, std::vector<std::vector<bool>>>;
+
+AliasMap getAliases(Ir &ir) {
+  AliasMap aliases;
+  for (auto &id_graph : ir.getGraphs()) {
+    auto &tensors = id_graph.second->getTensors();
+    for (auto &from : tensors.getAllTensorIds()) {
+      for (auto &to : tensors.getAllTensorIds()) {
+        auto t0 = tensors.get(from);
+        auto t1 = tensors.get(to);
+        aliases[{from, to}].push_back(
+            covered(tensors.getAliasRegions(t0, t1), t1->info.shape()));
+      }
+    }
+  }
+  return aliases;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(Inplace_incrementalAliases0) {
+
+  //              |- [Slice] - [Transpose] - [Reshape] -|
+  //  in0 (4,6) --|                                     |- [Add] - [Reshape]
+  //              |- [Reshape] - [Transpose] - [Slice] -|
+  //
+  // The aliases are updated incrementally while the Ops are inplaced. They
+  // should be the same as those recomputed from scratch.
+
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+
+  TensorInfo shape0{"FLOAT", std::vector<int64_t>{4, 6}};
+  auto in0 = builder->addInputTensor(shape0);
+
+  std::vector<int64_t> s23{2, 3};
+  std::vector<int64_t> s6{6};
+  std::vector<int64_t> s324{3, 2, 4};
+  auto shape23  = aiOnnx.constant({s23.data(), {"INT64", Shape{2}}});
+  auto shape6   = aiOnnx.constant({s6.data(), {"INT64", Shape{1}}});
+  auto shape324 = aiOnnx.constant({s324.data(), {"INT64", Shape{3}}});
+
+  // (2,3) -> (3,2) -> (6)
+  auto a = aiOnnx.slice({in0}, {2, 3}, {0, 0});
+  a      = aiOnnx.transpose({a}, {1, 0});
+  a      = aiOnnx.reshape({a, shape6});
+
+  // (4,6) -> (3,2,4) -> (4,2,3) -> (1,2,3) -> (6)
+  auto b = aiOnnx.reshape({in0, shape324});
+  b      = aiOnnx.transpose({b}, {2, 1, 0});
+  b      = aiOnnx.slice({b}, {2, 2, 3}, {1, 0, 0});
+  b      = aiOnnx.reshape({b, shape6});
+
+  auto sum = aiOnnx.add({a, b});
+  auto out = aiOnnx.reshape({sum, shape23});
+  builder->addOutputTensor(out);
+
+  auto proto      = builder->getModelProto();
+  auto modelProto = io::getModelFromString(proto);
+
+  auto dataFlow = DataFlow(1, {{out, AnchorReturnType("All")}});
+  auto device   = createTestDevice(TEST_TARGET);
+
+  Ir ir;
+  ir.prepare({modelProto,
+              InputShapeInfo(),
+              dataFlow,
+              {},
+              nullptr,
+              *device,
+              {},
+              Patterns(PatternsLevel::Default).enableInPlace(true)});
+
+  BOOST_REQUIRE(!ir.opsOfType(Onnx::CustomOperators::SliceInplace).empty());
+
+  auto incremental = getAliases(ir);
+
+  // Nothing has changed, so nothing is recomputed
+  ir.updateAliases();
+  BOOST_CHECK(getAliases(ir) == incremental);
+
+  // Recompute from scratch
+  for (auto &id_graph : ir.getGraphs()) {
+    id_graph.second->getTensors().clearAliases();
+  }
+  ir.updateAliases();
+  auto full = getAliases(ir);
+  BOOST_CHECK(full == incremental);
+
+  // The output of each SliceInplace aliases part of the input
+  auto &tensors = ir.getMainGraph().getTensors();
+  for (auto op : ir.opsOfType(Onnx::CustomOperators::SliceInplace)) {
+    auto slice   = op->outTensor(0);
+    auto regions = tensors.getAliasRegions(slice, tensors.get(in0));
+    BOOST_CHECK(!regions.front().isEmpty());
+  }
+}
@@ -1,13 +1,16 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
 #define BOOST_TEST_MODULE IrHashTest
 
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
 
 #include <popart/builder.hpp>
 #include <popart/dataflow.hpp>
+#include <popart/devicemanager.hpp>
 #include <popart/filereader.hpp>
 #include <popart/graphtransformer.hpp>
 #include <popart/ir.hpp>
@@ -128,3 +131,133 @@ BOOST_AUTO_TEST_CASE(test0) {
   BOOST_CHECK(irHash0_0 != irHash6); // Different user opts, different hash (1)
   BOOST_CHECK(irHash0_0 != irHash7); // Different user opts, different hash (2)
 }
+
+// The IrBundle hash is computed from the inputs of Ir::prepare, before the Ir
+// is prepared, for the engine cache
+BOOST_AUTO_TEST_CASE(test1) {
+  auto proto   = getProto();
+  auto isi     = InputShapeInfo();
+  auto outId   = proto.graph().output()[0].name();
+  auto df0     = DataFlow(1, {{outId, AnchorReturnType("All")}});
+  auto df1     = DataFlow(2, {{outId, AnchorReturnType("All")}});
+  auto opt0    = ConstSGD(0.01);
+  auto device0 = createTestDevice(TEST_TARGET, 1, 20);
+  auto device1 = createTestDevice(TEST_TARGET, 1, 40);
+
+  SessionOptions uopt0;
+  uopt0.enableEngineCaching = true;
+  SessionOptions uopt1      = uopt0;
+  uopt1.syntheticDataMode   = SyntheticDataMode::Zeros;
+
+  auto hash = [&](const DataFlow &df,
+                  DeviceInfo &device,
+                  const SessionOptions &uopts,
+                  const Patterns &patterns) {
+    return std::hash<IrBundle>{}(
+        {proto, isi, df, outId, &opt0, device, uopts, patterns});
+  };
+
+  auto hash0_0 = hash(df0, *device0, uopt0, Patterns());
+  auto hash0_1 = hash(df0, *device0, uopt0, Patterns());
+  auto hash1   = hash(df1, *device0, uopt0, Patterns());
+  auto hash2   = hash(df0, *device1, uopt0, Patterns());
+  auto hash3   = hash(df0, *device0, uopt1, Patterns());
+  auto hash4   = hash(df0, *device0, uopt0, Patterns().enableInPlace(false));
+
+  BOOST_CHECK(hash0_0 == hash0_1); // IrBundle hashing is deterministic
+  BOOST_CHECK(hash0_0 != hash1);   // Different b.p.s, different hash
+  BOOST_CHECK(hash0_0 != hash2);   // Different device opts, different hash
+  BOOST_CHECK(hash0_0 != hash3);   // Different user opts, different hash
+  BOOST_CHECK(hash0_0 != hash4);   // Different patterns, different hash
+
+  // The prepared Ir has the hash of its IrBundle, if engine caching is enabled
+  Ir ir0;
+  ir0.prepare({proto, isi, df0, outId, &opt0, *device0, uopt0, Patterns()});
+  BOOST_CHECK(ir0.getIrBundleHash() == hash0_0);
+
+  Ir ir1;
+  ir1.prepare({proto, isi, df0, outId, &opt0, *device0, {}, Patterns()});
+  BOOST_CHECK(ir1.getIrBundleHash() == 0);
+}
+
+// The constant optimizer values are a part of the Ir, so they change the
+// IrBundle hash. The initial values of the non-constant ones do not
+BOOST_AUTO_TEST_CASE(test2) {
+  auto proto  = getProto();
+  auto isi    = InputShapeInfo();
+  auto outId  = proto.graph().output()[0].name();
+  auto df     = DataFlow(1, {{outId, AnchorReturnType("All")}});
+  auto device = createTestDevice(TEST_TARGET, 1, 20);
+
+  auto hash = [&](const Optimizer &opt) {
+    return std::hash<IrBundle>{}(
+        {proto, isi, df, outId, &opt, *device, {}, Patterns()});
+  };
+
+  auto constLr = [](float lr) {
+    return SGD({{"defaultLearningRate", {lr, true}},
+                {"defaultWeightDecay", {0.1f, true}}});
+  };
+  auto variableLr = [](float lr) {
+    return SGD({{"defaultLearningRate", {lr, false}},
+                {"defaultWeightDecay", {0.1f, true}}});
+  };
+  auto adam = [](float b1, bool constB1, AdamMode mode) {
+    return Adam({{"defaultBeta1", {b1, constB1}}}, mode);
+  };
+
+  auto withSpecific = constLr(0.01f);
+  withSpecific.insertSpecific(proto.graph().initializer(0).name(),
+                              {{"learningRate", {0.02f, true}}});
+
+  BOOST_CHECK(hash(constLr(0.01f)) == hash(constLr(0.01f)));
+  BOOST_CHECK(hash(constLr(0.01f)) != hash(constLr(0.02f)));
+  BOOST_CHECK(hash(ConstSGD(0.01f)) != hash(ConstSGD(0.02f)));
+  BOOST_CHECK(hash(constLr(0.01f)) != hash(variableLr(0.01f)));
+  BOOST_CHECK(hash(constLr(0.01f)) != hash(withSpecific));
+  BOOST_CHECK(hash(variableLr(0.01f)) == hash(variableLr(0.02f)));
+
+  BOOST_CHECK(hash(adam(0.9f, true, AdamMode::Adam)) !=
+              hash(adam(0.8f, true, AdamMode::Adam)));
+  BOOST_CHECK(hash(adam(0.9f, false, AdamMode::Adam)) ==
+              hash(adam(0.8f, false, AdamMode::Adam)));
+  BOOST_CHECK(hash(adam(0.9f, false, AdamMode::Adam)) !=
+              hash(adam(0.9f, false, AdamMode::Lamb)));
+}
+
+// The parts of the IrBundle hash are combined, rather than XORed, so that
+// bundles which differ in how their parts are arranged have different hashes
+BOOST_AUTO_TEST_CASE(test3) {
+  auto proto = getProto();
+  auto isi   = InputShapeInfo();
+  auto wId   = proto.graph().initializer(0).name();
+  auto outId = proto.graph().output()[0].name();
+  auto opt   = ConstSGD(0.01);
+
+  auto hash = [&](const DataFlow &df, DeviceInfo &device) {
+    return std::hash<IrBundle>{}(
+        {proto, isi, df, outId, &opt, device, {}, Patterns()});
+  };
+
+  // The return types of two anchors swapped
+  auto df0 = DataFlow(
+      1, {{outId, AnchorReturnType("All")}, {wId, AnchorReturnType("Final")}});
+  auto df1 = DataFlow(
+      1, {{outId, AnchorReturnType("Final")}, {wId, AnchorReturnType("All")}});
+
+  // The numbers of IPUs and of tiles of each IPU swapped
+  auto ipuModel = [](const std::string &numIPUs,
+                     const std::string &tilesPerIPU) {
+    std::map<std::string, std::string> deviceOpts{{"numIPUs", numIPUs},
+                                                  {"tilesPerIPU", tilesPerIPU}};
+    return DeviceManager::createDeviceManager().createIpuModelDevice(
+        deviceOpts);
+  };
+  auto device0 = ipuModel("2", "4");
+  auto device1 = ipuModel("4", "2");
+
+  BOOST_CHECK(hash(df0, *device0) != hash(df1, *device0));
+  BOOST_CHECK(hash(df0, *device0) != hash(df0, *device1));
+  BOOST_CHECK(std::hash<DeviceInfo>{}(*device0) !=
+              std::hash<DeviceInfo>{}(*device1));
+}
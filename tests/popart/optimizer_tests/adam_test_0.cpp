@@ -0,0 +1,348 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE AdamTest0
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/devicemanager.hpp>
+#include <popart/error.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/ndarraywrapper.hpp>
+#include <popart/optimizer.hpp>
+#include <popart/session.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/tensors.hpp>
+#include <popart/testdevice.hpp>
+
+using namespace popart;
+
+namespace {
+
+constexpr int nSteps = 3;
+
+// How the model below is run
+struct RunSettings {
+  // The number of weights, and of elements in each weight
+  int64_t nWeights{1};
+  int64_t nelms{1};
+  int64_t accumulationFactor{1};
+  MergeVarUpdateType mergeVarUpdate{MergeVarUpdateType::None};
+  // With more than 1 replica the weights are sharded across the replicas, in
+  // the PingPong mode. This needs 2 IPUs for each replica.
+  int64_t replicas{1};
+};
+
+// The initial value of element i of weight k. The elements differ, so that
+// the LAMB trust ratio depends on the norms of the whole weights
+float initialValue(int64_t k, int64_t i) {
+  return 100.0f + 10.0f * static_cast<float>(k) + static_cast<float>(i);
+}
+
+// The update equations of a weight, see optimizer.hpp. Each element of the
+// gradient of the model below is grad.
+void referenceUpdate(std::vector<float> &w,
+                     std::vector<float> &m,
+                     std::vector<float> &v,
+                     float grad,
+                     int step,
+                     AdamMode mode,
+                     float lr,
+                     float wd,
+                     float b1,
+                     float b2,
+                     float eps) {
+  std::vector<float> u(w.size());
+  float wNormSq = 0.0f;
+  float uNormSq = 0.0f;
+  for (size_t i = 0; i < w.size(); ++i) {
+    float g = grad;
+    if (mode == AdamMode::Adam) {
+      g += wd * w[i];
+    }
+    m[i]     = b1 * m[i] + (1.0f - b1) * g;
+    v[i]     = b2 * v[i] + (1.0f - b2) * g * g;
+    float mc = m[i] / (1.0f - std::pow(b1, static_cast<float>(step)));
+    float vc = v[i] / (1.0f - std::pow(b2, static_cast<float>(step)));
+    u[i]     = mc / (std::sqrt(vc) + eps);
+    if (mode != AdamMode::Adam) {
+      u[i] += wd * w[i];
+    }
+    wNormSq += w[i] * w[i];
+    uNormSq += u[i] * u[i];
+  }
+  float r = 1.0f;
+  if (mode == AdamMode::Lamb && wNormSq != 0.0f && uNormSq != 0.0f) {
+    r = std::sqrt(wNormSq / uNormSq);
+  }
+  for (size_t i = 0; i < w.size(); ++i) {
+    w[i] -= lr * r * u[i];
+  }
+}
+
+// Model
+// -----
+//
+// loss = l1_loss(input + w_0 + ... + w_{nWeights - 1})
+//
+// where input and the weights are positive. Returns the weights after nSteps
+// updates.
+std::vector<std::vector<float>> getResult(const Adam &opt,
+                                          const RunSettings &settings) {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+
+  TensorInfo info{"FLOAT", std::vector<int64_t>{settings.nelms}};
+  auto input0 = builder->addInputTensor(info, "input0");
+
+  std::vector<std::vector<float>> weights(settings.nWeights);
+  std::vector<std::vector<float>> readBacks(settings.nWeights);
+  std::vector<TensorId> weightIds;
+  WeightsIO weightsRead;
+  TensorId sum = input0;
+  for (int64_t k = 0; k < settings.nWeights; ++k) {
+    for (int64_t i = 0; i < settings.nelms; ++i) {
+      weights[k].push_back(initialValue(k, i));
+    }
+    readBacks[k].assign(settings.nelms, -777.0f);
+    ConstVoidData cvd({weights[k].data(), info});
+    auto wId = builder->addInitializedInputTensor(cvd);
+    weightsRead.insert(wId, {readBacks[k].data(), info});
+    weightIds.push_back(wId);
+
+    sum = aiOnnx.add({wId, sum});
+    if (settings.replicas > 1) {
+      builder->pingPongPhase(sum, k % 2);
+    }
+  }
+
+  auto l1 = builder->aiGraphcoreOpset1().l1loss({sum}, 1.0, ReductionType::Sum);
+
+  auto proto    = builder->getModelProto();
+  auto dataFlow = DataFlow(1);
+
+  SessionOptions opts;
+  opts.enableOutlining = false;
+  opts.mergeVarUpdate  = settings.mergeVarUpdate;
+  if (settings.accumulationFactor > 1) {
+    opts.enableGradientAccumulation = true;
+    opts.accumulationFactor         = settings.accumulationFactor;
+  }
+
+  std::shared_ptr<DeviceInfo> device;
+  if (settings.replicas > 1) {
+    opts.enableReplicatedGraphs                 = true;
+    opts.replicatedGraphCount                   = settings.replicas;
+    opts.replicatedWeightSharding               = true;
+    opts.replicatedWeightShardingMinNumElements = 0;
+    opts.virtualGraphMode                       = VirtualGraphMode::PingPong;
+    opts.pingPongPhases                         = 2;
+    opts.autoRecomputation                      = RecomputationType::None;
+    opts.explicitRecomputation                  = false;
+
+    device = createTestDevice(TestDeviceType::Hw, 2 * settings.replicas);
+  } else {
+    device = DeviceManager::createDeviceManager().createIpuModelDevice(
+        std::map<std::string, std::string>{{"numIPUs", "1"}});
+  }
+
+  auto session = TrainingSession::createFromOnnxModel(
+      proto,
+      dataFlow,
+      l1,
+      opt,
+      device,
+      InputShapeInfo(),
+      opts,
+      Patterns(PatternsLevel::Default));
+
+  session->prepareDevice();
+
+  if (settings.replicas > 1) {
+    for (auto &wId : weightIds) {
+      BOOST_CHECK(session->getIr()
+                      .getMainGraphTensors()
+                      .get(wId)
+                      ->cacheInfo.isSharded());
+    }
+  }
+
+  // One sample for each micro batch of each replica
+  std::vector<int64_t> inputShape;
+  for (auto dim : {settings.accumulationFactor, settings.replicas}) {
+    if (dim > 1) {
+      inputShape.push_back(dim);
+    }
+  }
+  inputShape.push_back(settings.nelms);
+  std::vector<float> v_input_x(
+      settings.accumulationFactor * settings.replicas * settings.nelms,
+      3.1415f);
+  NDArrayWrapper<float> input_x_wrapper(v_input_x.data(), inputShape);
+  std::map<TensorId, IArray &> inputs = {{input0, input_x_wrapper}};
+  StepIO stepio(inputs, {});
+
+  session->weightsFromHost();
+  for (int i = 0; i < nSteps; ++i) {
+    session->run(stepio);
+  }
+  session->weightsToHost();
+  session->readWeights(weightsRead);
+
+  return readBacks;
+}
+
+void checkAgainstReference(AdamMode mode,
+                           bool constValues,
+                           const RunSettings &settings = {}) {
+  float lr  = 0.1f;
+  float wd  = 0.01f;
+  float b1  = 0.9f;
+  float b2  = 0.999f;
+  float eps = 1e-6f;
+
+  Adam opt({{"defaultLearningRate", {lr, constValues}},
+            {"defaultWeightDecay", {wd, constValues}},
+            {"defaultBeta1", {b1, constValues}},
+            {"defaultBeta2", {b2, constValues}},
+            {"defaultEps", {eps, constValues}},
+            {"lossScaling", {1.0f, constValues}}},
+           mode);
+
+  // The gradients of the micro batches are summed, and those of the replicas
+  // averaged
+  float grad = static_cast<float>(settings.accumulationFactor);
+
+  auto observed = getResult(opt, settings);
+  for (int64_t k = 0; k < settings.nWeights; ++k) {
+    std::vector<float> w;
+    for (int64_t i = 0; i < settings.nelms; ++i) {
+      w.push_back(initialValue(k, i));
+    }
+    std::vector<float> m(w.size(), 0.0f);
+    std::vector<float> v(w.size(), 0.0f);
+    for (int step = 1; step <= nSteps; ++step) {
+      referenceUpdate(w, m, v, grad, step, mode, lr, wd, b1, b2, eps);
+    }
+
+    for (int64_t i = 0; i < settings.nelms; ++i) {
+      BOOST_CHECK_MESSAGE(std::abs(w[i] - observed[k][i]) <
+                              1e-4f * std::abs(w[i]),
+                          opt.type_s() << " weight " << k << " element " << i
+                                       << ": expected=" << w[i]
+                                       << ", observed=" << observed[k][i]);
+    }
+  }
+}
+
+bool ipu_available(boost::unit_test::test_unit_id) {
+  auto devices =
+      popart::DeviceManager::createDeviceManager().enumerateDevices();
+  return devices.size() >= 4;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(AdamTest0_values) {
+
+  // the defaults are those of the reference implementations
+  Adam opt0(std::map<std::string, std::pair<float, bool>>{});
+  BOOST_CHECK(opt0.learningRates().getDefault().val() == 0.001f);
+  BOOST_CHECK(opt0.beta1s().getDefault().val() == 0.9f);
+  BOOST_CHECK(opt0.beta2s().getDefault().val() == 0.999f);
+  BOOST_CHECK(opt0.getMode() == AdamMode::Adam);
+
+  // unrecognised keys and invalid values
+  BOOST_CHECK_THROW(Adam({{"defaultMomentum", {0.9f, true}}}), error);
+  BOOST_CHECK_THROW(Adam({{"defaultBeta1", {1.0f, true}}}), error);
+  BOOST_CHECK_THROW(Adam({{"defaultBeta2", {-0.1f, true}}}), error);
+  BOOST_CHECK_THROW(Adam({{"defaultEps", {-1.0f, true}}}), error);
+  BOOST_CHECK_THROW(Adam({{"defaultWeightDecay", {-1.0f, true}}}), error);
+  BOOST_CHECK_THROW(opt0.insertSpecific("foo", {{"momentum", {0.9f, true}}}),
+                    error);
+}
+
+BOOST_AUTO_TEST_CASE(AdamTest0_replacement) {
+
+  Adam opt0({{"defaultLearningRate", {0.1f, false}},
+             {"defaultBeta1", {0.9f, false}},
+             {"lossScaling", {1.0f, false}}});
+
+  BOOST_CHECK(opt0.validReplacement(Adam(opt0)));
+
+  // non-const values can change
+  BOOST_CHECK(
+      opt0.validReplacement(Adam({{"defaultLearningRate", {0.2f, false}},
+                                  {"defaultBeta1", {0.8f, false}},
+                                  {"lossScaling", {2.0f, false}}})));
+
+  // but not to constant values
+  BOOST_CHECK(
+      !opt0.validReplacement(Adam({{"defaultLearningRate", {0.1f, true}},
+                                   {"defaultBeta1", {0.9f, false}},
+                                   {"lossScaling", {1.0f, false}}})));
+
+  // the mode cannot change
+  BOOST_CHECK(
+      !opt0.validReplacement(Adam({{"defaultLearningRate", {0.1f, false}},
+                                   {"defaultBeta1", {0.9f, false}},
+                                   {"lossScaling", {1.0f, false}}},
+                                  AdamMode::AdamW)));
+
+  // nor can it be replaced by a different Optimizer
+  BOOST_CHECK(
+      !opt0.validReplacement(SGD({{"defaultLearningRate", {0.1f, false}},
+                                  {"lossScaling", {1.0f, false}}})));
+}
+
+BOOST_AUTO_TEST_CASE(AdamTest0_updates) {
+  for (auto mode : {AdamMode::Adam, AdamMode::AdamW, AdamMode::Lamb}) {
+    for (bool constValues : {true, false}) {
+      checkAgainstReference(mode, constValues);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(AdamTest0_gradientAccumulation) {
+  RunSettings settings;
+  settings.nelms              = 4;
+  settings.accumulationFactor = 3;
+  for (auto mode : {AdamMode::Adam, AdamMode::AdamW, AdamMode::Lamb}) {
+    for (bool constValues : {true, false}) {
+      checkAgainstReference(mode, constValues, settings);
+    }
+  }
+}
+
+// The Adam and AdamW updates of the weights are merged, the LAMB updates are
+// not, as the trust ratio of each weight is computed from its own norms
+BOOST_AUTO_TEST_CASE(AdamTest0_mergeVarUpdates) {
+  RunSettings settings;
+  settings.nWeights       = 3;
+  settings.nelms          = 4;
+  settings.mergeVarUpdate = MergeVarUpdateType::All;
+  for (auto mode : {AdamMode::Adam, AdamMode::AdamW, AdamMode::Lamb}) {
+    for (bool constValues : {true, false}) {
+      checkAgainstReference(mode, constValues, settings);
+    }
+    settings.accumulationFactor = 2;
+    checkAgainstReference(mode, false, settings);
+    settings.accumulationFactor = 1;
+  }
+}
+
+// The norms of the sharded weights are reduced across the replicas
+BOOST_AUTO_TEST_CASE(AdamTest0_shardedLamb,
+                     *boost::unit_test::precondition(ipu_available)) {
+  RunSettings settings;
+  settings.nWeights = 2;
+  settings.nelms    = 6;
+  settings.replicas = 2;
+  for (bool constValues : {true, false}) {
+    checkAgainstReference(AdamMode::Lamb, constValues, settings);
+  }
+  checkAgainstReference(AdamMode::AdamW, false, settings);
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE PatternRewriterTest
+
+#include <boost/test/unit_test.hpp>
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/filereader.hpp>
+#include <popart/graph.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/op/negate.hpp>
+#include <popart/op/relu.hpp>
+#include <popart/patterns/pattern.hpp>
+#include <popart/patterns/patterns.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensorindex.hpp>
+#include <popart/testdevice.hpp>
+
+using namespace popart;
+
+namespace {
+
+int64_t reluMatchCalls  = 0;
+int64_t otherMatchCalls = 0;
+
+// Replaces the last ReluOp of a chain of ReluOps with a NegateOp. Each
+// replacement makes the ReluOp before it match, so sweeping over all of the
+// Ops after each replacement would take a quadratic number of calls to
+// matches()
+class ReplaceTailRelu : public PreAliasPattern {
+public:
+  bool matches(Op *op) const override {
+    if (!matchesOpType(op)) {
+      ++otherMatchCalls;
+      return false;
+    }
+    ++reluMatchCalls;
+    auto out = op->outTensor(ReluOp::getOutIndex());
+    for (auto consumer : out->consumers.getOps()) {
+      if (consumer->isConvertibleTo<ReluOp>()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool matchesOpType(const Op *op) const override {
+    return op->isConvertibleTo<ReluOp>();
+  }
+
+  std::vector<const Tensor *> touches(Op *) const override { return {}; }
+
+  bool apply(Op *op) const override {
+    auto negOp = makeReplacementOpInIr(Onnx::Operators::Neg_6, op);
+
+    auto inputId  = op->inId(ReluOp::getInIndex());
+    auto outputId = op->outId(ReluOp::getOutIndex());
+    op->disconnectAllInputs();
+    op->disconnectAllOutputs();
+    op->getGraph().eraseOp(op->id);
+
+    negOp->connectInTensor(NegateOp::getInIndex(), inputId);
+    negOp->connectOutTensor(NegateOp::getOutIndex(), outputId);
+    negOp->setup();
+
+    return true;
+  }
+};
+
+static PatternCreator<ReplaceTailRelu> creator("ReplaceTailRelu", false);
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(PatternRewriter_worklist0) {
+  // in -> [Relu] -> ... -> [Relu] -> out
+  //
+  // All of the Relus are replaced, revisiting only the Ops next to the
+  // replaced ones, and matches() is only called for Relus.
+
+  const int64_t nRelus = 50;
+
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+
+  auto x = builder->addInputTensor({"FLOAT", std::vector<int64_t>{4}});
+  for (int64_t i = 0; i < nRelus; ++i) {
+    x = aiOnnx.relu({x});
+  }
+  builder->addOutputTensor(x);
+
+  auto modelProto = io::getModelFromString(builder->getModelProto());
+  auto dataFlow   = DataFlow(1, {{x, AnchorReturnType("All")}});
+  auto device     = createTestDevice(TEST_TARGET);
+
+  Ir ir;
+  ir.prepare({modelProto,
+              InputShapeInfo(),
+              dataFlow,
+              {},
+              nullptr,
+              *device,
+              {},
+              Patterns::create({"ReplaceTailRelu"})});
+
+  BOOST_CHECK(ir.opsOfType(Onnx::Operators::Relu_6).empty());
+  auto negs = ir.opsOfType(Onnx::Operators::Neg_6);
+  BOOST_CHECK(static_cast<int64_t>(negs.size()) == nRelus);
+
+  BOOST_CHECK(otherMatchCalls == 0);
+  // One sweep, and one more call for each Relu once the Relu after it is
+  // replaced, rather than n * (n + 1) / 2 calls
+  BOOST_CHECK(reluMatchCalls <= 2 * nRelus);
+}
@@ -0,0 +1,272 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE PreparedIrTest
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/devicemanager.hpp>
+#include <popart/error.hpp>
+#include <popart/filereader.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/ndarraywrapper.hpp>
+#include <popart/optimizer.hpp>
+#include <popart/session.hpp>
+#include <popart/stepio.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensordata.hpp>
+#include <popart/tensors.hpp>
+#include <popart/testdevice.hpp>
+
+using namespace popart;
+
+namespace {
+
+struct TmpDir {
+  TmpDir()
+      : path(boost::filesystem::temp_directory_path() /
+             boost::filesystem::unique_path("popart_prepared_%%%%%%%%")) {}
+  ~TmpDir() { boost::filesystem::remove_all(path); }
+  boost::filesystem::path path;
+};
+
+SGD getOptimizer() {
+  return SGD({{"defaultLearningRate", {0.1f, false}},
+              {"defaultMomentum", {0.9f, true}}});
+}
+
+// A matmul with a dropout, trained with momentum: the Ir has Variables which
+// are not in the model (the accumulators), optimizer and seed streams
+struct Model {
+  Model() {
+    auto builder = Builder::create();
+    auto aiOnnx  = builder->aiOnnxOpset9();
+    TensorInfo info{"FLOAT", std::vector<int64_t>{4, 4}};
+    std::vector<float> vals(16);
+    for (size_t i = 0; i < vals.size(); ++i) {
+      vals[i] = 0.1f * static_cast<float>(i);
+    }
+    weight = builder->addInitializedInputTensor({vals.data(), info});
+    input  = builder->addInputTensor(info);
+    out    = aiOnnx.matmul({input, weight});
+    auto d = aiOnnx.dropout({out}, 1, 0.5f)[0];
+    loss   = builder->aiGraphcoreOpset1().l1loss({d}, 0.1);
+    proto  = builder->getModelProto();
+  }
+
+  TensorId weight;
+  TensorId input;
+  TensorId out;
+  TensorId loss;
+  std::string proto;
+};
+
+// The arguments of an IrBundle, which only holds references to them
+struct BundleArgs {
+  BundleArgs(const Model &model)
+      : proto(io::getModelFromString(model.proto)),
+        dataFlow(1, {{model.out, AnchorReturnType("All")}}),
+        optimizer(getOptimizer()),
+        device(createTestDevice(TEST_TARGET)),
+        patterns(PatternsLevel::Default) {
+    opts.enableEngineCaching = true;
+  }
+
+  IrBundle get(const Model &model) {
+    return IrBundle(proto,
+                    inputShapeInfo,
+                    dataFlow,
+                    model.loss,
+                    &optimizer,
+                    *device,
+                    opts,
+                    patterns);
+  }
+
+  ONNX_NAMESPACE::ModelProto proto;
+  InputShapeInfo inputShapeInfo;
+  DataFlow dataFlow;
+  SGD optimizer;
+  std::shared_ptr<DeviceInfo> device;
+  SessionOptions opts;
+  Patterns patterns;
+};
+
+std::vector<TensorId> sortedIds(const std::vector<Tensor *> &tensors) {
+  std::vector<TensorId> ids;
+  for (auto tensor : tensors) {
+    ids.push_back(tensor->id);
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+bool sameData(const Tensor *a, const Tensor *b) {
+  return a->info == b->info &&
+         std::memcmp(a->tensorData()->data(),
+                     b->tensorData()->data(),
+                     a->info.nbytes()) == 0;
+}
+
+bool ipu_available(boost::unit_test::test_unit_id) {
+  return DeviceManager::createDeviceManager().enumerateDevices().size() > 0;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(PreparedIr_RoundTrip) {
+  Model model;
+  BundleArgs args(model);
+  auto bundle = args.get(model);
+
+  Ir prepared;
+  prepared.prepare(bundle);
+  BOOST_REQUIRE(prepared.canSerializePrepared());
+  std::stringstream ss;
+  prepared.serializePrepared(ss);
+
+  Ir restored;
+  BOOST_REQUIRE(restored.prepareFromSerialized(bundle, ss));
+  BOOST_CHECK(restored.isPreparedFromSerialized());
+  BOOST_CHECK(!prepared.isPreparedFromSerialized());
+  BOOST_CHECK(restored.getIrBundleHash() == prepared.getIrBundleHash());
+  BOOST_CHECK(restored.getMainGraph().getOps().empty());
+  BOOST_CHECK(restored.additionalModelProtoTensors ==
+              prepared.additionalModelProtoTensors);
+
+  // The Variables, with their values, including those not in the model
+  auto variableIds = prepared.getTensorIds(TensorType::Variable);
+  BOOST_CHECK(variableIds.size() > 1);
+  std::sort(variableIds.begin(), variableIds.end());
+  auto restoredIds = restored.getTensorIds(TensorType::Variable);
+  std::sort(restoredIds.begin(), restoredIds.end());
+  BOOST_REQUIRE(restoredIds == variableIds);
+  for (auto &id : variableIds) {
+    BOOST_CHECK_MESSAGE(
+        sameData(restored.getTensor(id), prepared.getTensor(id)), id);
+  }
+
+  // The streams
+  BOOST_CHECK(!prepared.optimizerTensors().empty());
+  BOOST_CHECK(sortedIds(restored.optimizerTensors()) ==
+              sortedIds(prepared.optimizerTensors()));
+  for (auto tensor : prepared.optimizerTensors()) {
+    BOOST_CHECK_MESSAGE(sameData(restored.getTensor(tensor->id), tensor),
+                        tensor->id);
+  }
+  BOOST_CHECK(sortedIds(restored.dataStreamTensors()) ==
+              sortedIds(prepared.dataStreamTensors()));
+  BOOST_CHECK(prepared.requiresRandomSeed());
+  BOOST_CHECK(restored.requiresRandomSeed());
+
+  // The anchors
+  for (auto &id : args.dataFlow.anchors()) {
+    BOOST_CHECK(restored.getTensor(id)->info == prepared.getTensor(id)->info);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PreparedIr_InvalidRecord) {
+  Model model;
+  BundleArgs args(model);
+  auto bundle = args.get(model);
+
+  std::string record;
+  {
+    Ir prepared;
+    prepared.prepare(bundle);
+    std::ostringstream oss;
+    prepared.serializePrepared(oss);
+    record = oss.str();
+  }
+
+  // A record which cannot be read leaves the Ir unchanged, to be prepared
+  for (auto invalid : {std::string("not a prepared ir\n"),
+                       std::string(),
+                       record.substr(0, record.size() / 2)}) {
+    Ir ir;
+    std::istringstream iss(invalid);
+    BOOST_CHECK(!ir.prepareFromSerialized(bundle, iss));
+    BOOST_CHECK(!ir.isPreparedFromSerialized());
+    ir.prepare(bundle);
+    BOOST_CHECK(!ir.getMainGraph().getOps().empty());
+  }
+
+  // Only an Ir which is not prepared can be restored
+  Ir ir;
+  ir.prepare(bundle);
+  std::istringstream iss(record);
+  BOOST_CHECK_THROW(ir.prepareFromSerialized(bundle, iss), error);
+}
+
+// Executables are only cached on IPU hardware
+BOOST_AUTO_TEST_CASE(PreparedIr_Session,
+                     *boost::unit_test::precondition(ipu_available)) {
+  Model model;
+  TmpDir dir;
+
+  auto train = [&](bool expectRestored) {
+    SessionOptions opts;
+    opts.enableEngineCaching = true;
+    opts.cachePath           = dir.path.string();
+
+    auto device = createTestDevice(TestDeviceType::Hw);
+    auto opt    = getOptimizer();
+    DataFlow dataFlow(1, {{model.out, AnchorReturnType("All")}});
+    auto session =
+        TrainingSession::createFromOnnxModel(model.proto,
+                                             dataFlow,
+                                             model.loss,
+                                             opt,
+                                             device,
+                                             InputShapeInfo(),
+                                             opts,
+                                             Patterns(PatternsLevel::Default));
+    BOOST_CHECK(session->getIr().isPreparedFromSerialized() ==
+                expectRestored);
+
+    session->prepareDevice();
+    if (expectRestored) {
+      // There is neither an Ir nor a Poplar graph to inspect
+      BOOST_CHECK_THROW(session->serializeIr(IrSerializationFormat::JSON),
+                        error);
+      BOOST_CHECK_THROW(session->getTensorTileMap(), error);
+    }
+    session->setRandomSeed(1);
+    session->weightsFromHost();
+
+    std::vector<float> inputData(16, 1.0f);
+    NDArrayWrapper<float> inputWrapper(inputData.data(), {4, 4});
+    std::vector<float> outData(16);
+    NDArrayWrapper<float> outWrapper(outData.data(), {4, 4});
+    std::map<TensorId, IArray &> inputs  = {{model.input, inputWrapper}};
+    std::map<TensorId, IArray &> anchors = {{model.out, outWrapper}};
+    StepIO stepio(inputs, anchors);
+    for (int i = 0; i < 3; ++i) {
+      session->run(stepio);
+    }
+
+    std::vector<float> weightData(16);
+    TensorInfo weightInfo{"FLOAT", std::vector<int64_t>{4, 4}};
+    WeightsIO weightsRead;
+    weightsRead.insert(model.weight, {weightData.data(), weightInfo});
+    session->weightsToHost();
+    session->readWeights(weightsRead);
+
+    return std::make_pair(outData, weightData);
+  };
+
+  auto compiled = train(false);
+  auto restored = train(true);
+  BOOST_CHECK(compiled == restored);
+}
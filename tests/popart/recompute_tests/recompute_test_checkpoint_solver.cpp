@@ -0,0 +1,142 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE RecomputeTestCheckpointSolver
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <popart/error.hpp>
+#include <popart/recompute.hpp>
+
+using namespace popart;
+using namespace popart::recompute;
+
+namespace {
+
+// The predicted peak liveness and recompute cost of some checkpoints, as
+// defined by solveCheckpoints
+std::pair<int64_t, double> evaluate(const std::vector<int64_t> &memory,
+                                    const std::vector<double> &cost,
+                                    const std::vector<bool> &checkpoint) {
+  int64_t checkpoints = 0;
+  int64_t segment     = 0;
+  int64_t maxSegment  = 0;
+  double recompute    = 0.0;
+  for (int i = 0; i < memory.size(); ++i) {
+    if (checkpoint[i]) {
+      checkpoints += memory[i];
+      segment = 0;
+    } else {
+      segment += memory[i];
+      recompute += cost[i];
+      maxSegment = std::max(maxSegment, segment);
+    }
+  }
+  return {checkpoints + maxSegment, recompute};
+}
+
+// The least recompute cost of all checkpoints within a budget
+double leastCost(const std::vector<int64_t> &memory,
+                 const std::vector<double> &cost,
+                 int64_t budget) {
+  double least = std::numeric_limits<double>::max();
+  for (uint32_t mask = 0; mask < (1u << memory.size()); ++mask) {
+    std::vector<bool> checkpoint(memory.size());
+    for (int i = 0; i < memory.size(); ++i) {
+      checkpoint[i] = (mask >> i) & 1;
+    }
+    auto peak_cost = evaluate(memory, cost, checkpoint);
+    if (peak_cost.first <= budget) {
+      least = std::min(least, peak_cost.second);
+    }
+  }
+  return least;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(CheckpointSolver_SolutionIsConsistent) {
+  std::vector<int64_t> memory{4, 4, 4, 4, 4, 4, 4, 4, 4};
+  std::vector<double> cost(memory.size(), 1.0);
+
+  auto solution = solveCheckpoints(memory, cost, 0);
+  BOOST_REQUIRE_EQUAL(solution.checkpoint.size(), memory.size());
+  auto peak_cost = evaluate(memory, cost, solution.checkpoint);
+  BOOST_CHECK_EQUAL(solution.peakLiveness, peak_cost.first);
+  BOOST_CHECK_EQUAL(solution.recomputeCost, peak_cost.second);
+
+  // The least peak of a chain of 9 equal Ops is with 2 checkpoints, splitting
+  // it into 3 segments of 2 or 3 Ops
+  BOOST_CHECK_EQUAL(solution.peakLiveness, 20);
+  BOOST_CHECK_LT(solution.peakLiveness, 36);
+}
+
+BOOST_AUTO_TEST_CASE(CheckpointSolver_GenerousBudgetRecomputesNothing) {
+  std::vector<int64_t> memory{10, 20, 30};
+  std::vector<double> cost{1.0, 2.0, 3.0};
+
+  auto solution = solveCheckpoints(memory, cost, 1000);
+  BOOST_CHECK(std::all_of(solution.checkpoint.begin(),
+                          solution.checkpoint.end(),
+                          [](bool c) { return c; }));
+  BOOST_CHECK_EQUAL(solution.peakLiveness, 60);
+  BOOST_CHECK_EQUAL(solution.recomputeCost, 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(CheckpointSolver_ExpensiveOpsAreCheckpointed) {
+  // The large Ops are cheap to recompute, and the small ones expensive
+  std::vector<int64_t> memory{100, 1, 100, 1, 100, 1};
+  std::vector<double> cost{1.0, 50.0, 1.0, 50.0, 1.0, 50.0};
+
+  auto solution = solveCheckpoints(memory, cost, 110);
+  BOOST_CHECK_LE(solution.peakLiveness, 110);
+  BOOST_CHECK(solution.checkpoint[1] && solution.checkpoint[3] &&
+              solution.checkpoint[5]);
+  BOOST_CHECK_EQUAL(solution.recomputeCost, 3.0);
+}
+
+BOOST_AUTO_TEST_CASE(CheckpointSolver_MatchesExhaustiveSearch) {
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int64_t> memDist(0, 64);
+  std::uniform_int_distribution<int> costDist(0, 16);
+
+  for (int trial = 0; trial < 50; ++trial) {
+    std::vector<int64_t> memory(12);
+    std::vector<double> cost(memory.size());
+    for (int i = 0; i < memory.size(); ++i) {
+      memory[i] = memDist(gen);
+      cost[i]   = costDist(gen);
+    }
+    int64_t total = std::accumulate(memory.begin(), memory.end(), int64_t{0});
+    int64_t budget = total / 2;
+
+    auto solution  = solveCheckpoints(memory, cost, budget);
+    auto peak_cost = evaluate(memory, cost, solution.checkpoint);
+    BOOST_CHECK_EQUAL(solution.peakLiveness, peak_cost.first);
+    BOOST_CHECK_EQUAL(solution.recomputeCost, peak_cost.second);
+
+    if (peak_cost.first <= budget) {
+      // The memory of the checkpoints is rounded up, but with budgets this
+      // small the units are single bytes, so the solution is optimal
+      BOOST_CHECK_EQUAL(solution.recomputeCost,
+                        leastCost(memory, cost, budget));
+    } else {
+      // The budget is below the least peak, which is used instead
+      BOOST_CHECK_EQUAL(leastCost(memory, cost, budget),
+                        std::numeric_limits<double>::max());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CheckpointSolver_InvalidArguments) {
+  BOOST_CHECK_THROW(solveCheckpoints({1, 2}, {1.0}, 0), error);
+  BOOST_CHECK_THROW(solveCheckpoints({-1}, {1.0}, 0), error);
+
+  auto solution = solveCheckpoints({}, {}, 0);
+  BOOST_CHECK(solution.checkpoint.empty());
+  BOOST_CHECK_EQUAL(solution.peakLiveness, 0);
+}
@@ -0,0 +1,153 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE ScheduleCacheTest
+
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/filereader.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/ir.hpp>
+#include <popart/op.hpp>
+#include <popart/scheduler.hpp>
+#include <popart/sessionoptions.hpp>
+#include <popart/testdevice.hpp>
+
+using namespace popart;
+
+namespace {
+
+ONNX_NAMESPACE::ModelProto getProto() {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+  TensorInfo info{"FLOAT", std::vector<int64_t>{4, 4}};
+  auto in0 = builder->addInputTensor(info);
+  auto in1 = builder->addInputTensor(info);
+  auto a   = aiOnnx.add({in0, in1});
+  auto b   = aiOnnx.mul({in0, in1});
+  auto c   = aiOnnx.sub({a, b});
+  auto d   = aiOnnx.relu({c});
+  auto out = aiOnnx.matmul({d, a});
+  builder->addOutputTensor(out);
+  return io::getModelFromString(builder->getModelProto());
+}
+
+// The names of the scheduled Ops, which identify the schedule across Irs.
+std::vector<std::string> getScheduleString(const std::string &cachePath,
+                                           bool enableScheduleCaching) {
+  auto proto  = getProto();
+  auto outId  = proto.graph().output(0).name();
+  auto df     = DataFlow(1, {{outId, AnchorReturnType("All")}});
+  auto device = createTestDevice(TEST_TARGET);
+
+  SessionOptions opts;
+  opts.cachePath             = cachePath;
+  opts.enableScheduleCaching = enableScheduleCaching;
+
+  Ir ir;
+  ir.prepare({proto,
+              InputShapeInfo(),
+              df,
+              {},
+              nullptr,
+              *device,
+              opts,
+              Patterns(PatternsLevel::NoPatterns)});
+
+  std::vector<std::string> schedule;
+  for (auto op : ir.getOpSchedule({})) {
+    schedule.push_back(op->str());
+  }
+  return schedule;
+}
+
+struct TmpDir {
+  TmpDir()
+      : path(boost::filesystem::temp_directory_path() /
+             boost::filesystem::unique_path("popart_schedule_%%%%%%%%")) {
+    boost::filesystem::create_directories(path);
+  }
+  ~TmpDir() { boost::filesystem::remove_all(path); }
+  boost::filesystem::path path;
+};
+
+std::vector<boost::filesystem::path>
+cacheFiles(const boost::filesystem::path &dir) {
+  std::vector<boost::filesystem::path> files;
+  if (boost::filesystem::exists(dir)) {
+    for (const auto &entry : boost::filesystem::directory_iterator(dir)) {
+      files.push_back(entry.path());
+    }
+  }
+  return files;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ScheduleCache_HitAfterMiss) {
+  TmpDir tmp;
+  auto cachePath = (tmp.path / "model").string();
+  auto cacheDir  = tmp.path / "model.schedules";
+
+  Scheduler::resetPersistentCacheCounters();
+  auto reference = getScheduleString(cachePath, false);
+  BOOST_CHECK(cacheFiles(cacheDir).empty());
+  BOOST_CHECK_EQUAL(Scheduler::getPersistentCacheCounters().misses, 0);
+
+  auto first    = getScheduleString(cachePath, true);
+  auto counters = Scheduler::getPersistentCacheCounters();
+  BOOST_CHECK(counters.misses > 0);
+  BOOST_CHECK(!cacheFiles(cacheDir).empty());
+  BOOST_CHECK(first == reference);
+
+  Scheduler::resetPersistentCacheCounters();
+  auto second = getScheduleString(cachePath, true);
+  counters    = Scheduler::getPersistentCacheCounters();
+  BOOST_CHECK(counters.hits > 0);
+  BOOST_CHECK_EQUAL(counters.misses, 0);
+  BOOST_CHECK(second == reference);
+}
+
+BOOST_AUTO_TEST_CASE(ScheduleCache_RejectsInvalidEntries) {
+  TmpDir tmp;
+  auto cachePath = (tmp.path / "model").string();
+  auto cacheDir  = tmp.path / "model.schedules";
+
+  auto reference = getScheduleString(cachePath, true);
+  auto files     = cacheFiles(cacheDir);
+  BOOST_CHECK(!files.empty());
+
+  // Corrupt every entry: a schedule which lists the first Op for every
+  // position must be rejected, and the schedule recomputed.
+  for (const auto &file : files) {
+    std::string header, check;
+    uint64_t nOps;
+    {
+      std::ifstream ifs(file.string());
+      ifs >> header >> check >> nOps;
+    }
+    std::ofstream ofs(file.string());
+    ofs << header << ' ' << check << ' ' << nOps << '\n';
+    for (uint64_t i = 0; i < nOps; ++i) {
+      ofs << 0 << '\n';
+    }
+  }
+
+  Scheduler::resetPersistentCacheCounters();
+  auto schedule = getScheduleString(cachePath, true);
+  auto counters = Scheduler::getPersistentCacheCounters();
+  BOOST_CHECK_EQUAL(counters.hits, 0);
+  BOOST_CHECK(counters.rejections > 0);
+  BOOST_CHECK(schedule == reference);
+
+  // The recomputed schedules replace the invalid entries
+  Scheduler::resetPersistentCacheCounters();
+  getScheduleString(cachePath, true);
+  BOOST_CHECK(Scheduler::getPersistentCacheCounters().hits > 0);
+  BOOST_CHECK_EQUAL(Scheduler::getPersistentCacheCounters().rejections, 0);
+}
@@ -0,0 +1,226 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE DataLoaderStepIOTest
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <popart/dataloaderstepio.hpp>
+#include <popart/error.hpp>
+
+using namespace popart;
+
+namespace {
+
+struct TmpDir {
+  TmpDir()
+      : path(boost::filesystem::temp_directory_path() /
+             boost::filesystem::unique_path("popart_records_%%%%%%%%")) {
+    boost::filesystem::create_directories(path);
+  }
+  ~TmpDir() { boost::filesystem::remove_all(path); }
+  std::string file(const std::string &name) const {
+    return (path / name).string();
+  }
+  boost::filesystem::path path;
+};
+
+template <typename T>
+void writeRaw(const std::string &fn, const std::vector<T> &values) {
+  std::ofstream ofs(fn, std::ofstream::binary);
+  ofs.write(reinterpret_cast<const char *>(values.data()),
+            values.size() * sizeof(T));
+}
+
+// Write a version 1 NPY file, as numpy.save does
+template <typename T>
+void writeNpy(const std::string &fn,
+              const std::string &descr,
+              const std::string &shape,
+              const std::vector<T> &values) {
+  std::string header = "{'descr': '" + descr +
+                       "', 'fortran_order': False, 'shape': (" + shape +
+                       "), }";
+  // The header is padded with spaces, and ends with a newline, so that the
+  // data is 64 byte aligned
+  header.resize((header.size() + 10 + 1 + 63) / 64 * 64 - 10 - 1, ' ');
+  header += '\n';
+
+  std::ofstream ofs(fn, std::ofstream::binary);
+  ofs.write("\x93NUMPY\x01\x00", 8);
+  uint16_t length = static_cast<uint16_t>(header.size());
+  ofs.put(static_cast<char>(length & 0xff));
+  ofs.put(static_cast<char>(length >> 8));
+  ofs << header;
+  ofs.write(reinterpret_cast<const char *>(values.data()),
+            values.size() * sizeof(T));
+}
+
+template <typename T> T readScalar(const ConstVoidData &data) {
+  T value;
+  std::memcpy(&value, data.data, sizeof(T));
+  return value;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(DataLoaderStepIO_InputsStayInStep) {
+  TensorInfo floatInfo(DataType::FLOAT, {2});
+  TensorInfo intInfo(DataType::INT32, {1});
+  auto producer = [](int64_t index,
+                     const std::map<TensorId, MutableVoidData> &buffers) {
+    auto f = static_cast<float *>(buffers.at("f").data);
+    f[0]   = static_cast<float>(index);
+    f[1]   = static_cast<float>(-index);
+    *static_cast<int32_t *>(buffers.at("i").data) =
+        static_cast<int32_t>(2 * index);
+  };
+
+  const int64_t numSamples = 1000;
+  DataLoaderStepIO stepio(
+      {{"f", floatInfo}, {"i", intInfo}}, producer, numSamples, {}, 3, 4);
+
+  for (int64_t s = 0; s < numSamples; ++s) {
+    // Read the inputs in a different order each sample, and let "i" prefetch
+    // the next sample before "f" has completed this one
+    auto f = stepio.in("f", 2, false);
+    BOOST_CHECK_EQUAL(readScalar<float>(f), static_cast<float>(s));
+    BOOST_CHECK_EQUAL(static_cast<const float *>(f.data)[1],
+                      static_cast<float>(-s));
+    auto i = stepio.in("i", 1, false);
+    BOOST_CHECK_EQUAL(readScalar<int32_t>(i), 2 * s);
+    stepio.inComplete("i", 1);
+    if (s + 1 < numSamples) {
+      auto next = stepio.in("i", 1, true);
+      if (next.data) {
+        BOOST_CHECK_EQUAL(readScalar<int32_t>(next), 2 * (s + 1));
+      }
+    }
+    stepio.inComplete("f", 2);
+  }
+  BOOST_CHECK_EQUAL(stepio.numSamplesCompleted(), numSamples);
+
+  // Every sample has been read
+  BOOST_CHECK(!stepio.in("f", 2, true).data);
+  BOOST_CHECK_THROW(stepio.in("f", 2, false), error);
+}
+
+BOOST_AUTO_TEST_CASE(DataLoaderStepIO_BoundedQueue) {
+  std::atomic<int64_t> produced{0};
+  auto producer = [&produced](int64_t,
+                              const std::map<TensorId, MutableVoidData> &) {
+    ++produced;
+  };
+
+  {
+    DataLoaderStepIO stepio(
+        {{"x", TensorInfo(DataType::FLOAT, {1})}}, producer, -1, {}, 2, 8);
+    // The workers fill the queue, and then wait for it to drain
+    stepio.in("x", 1, false);
+    while (produced < 8) {
+      std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    BOOST_CHECK_EQUAL(produced, 8);
+
+    stepio.inComplete("x", 1);
+    stepio.in("x", 1, false);
+    while (produced < 9) {
+      std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    BOOST_CHECK_EQUAL(produced, 9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DataLoaderStepIO_ProducerErrors) {
+  auto producer = [](int64_t index,
+                     const std::map<TensorId, MutableVoidData> &) {
+    if (index == 1) {
+      throw error("Failed to produce sample {}", index);
+    }
+  };
+  DataLoaderStepIO stepio(
+      {{"x", TensorInfo(DataType::FLOAT, {1})}}, producer, 2, {}, 1, 2);
+
+  stepio.in("x", 1, false);
+  stepio.inComplete("x", 1);
+  // A prefetch leaves the error to the fetch
+  BOOST_CHECK(!stepio.in("x", 1, true).data);
+  BOOST_CHECK_THROW(stepio.in("x", 1, false), error);
+}
+
+BOOST_AUTO_TEST_CASE(DataLoaderStepIO_InvalidArguments) {
+  auto producer = [](int64_t, const std::map<TensorId, MutableVoidData> &) {};
+  std::map<TensorId, TensorInfo> inputs{{"x", {DataType::FLOAT, {2}}}};
+  BOOST_CHECK_THROW(DataLoaderStepIO({}, producer, 1), error);
+  BOOST_CHECK_THROW(DataLoaderStepIO(inputs, producer, 1, {}, 0), error);
+  BOOST_CHECK_THROW(DataLoaderStepIO(inputs, producer, 1, {}, 1, 1), error);
+
+  DataLoaderStepIO stepio(inputs, producer, 1);
+  BOOST_CHECK_THROW(stepio.in("x", 3, false), error);
+  BOOST_CHECK_THROW(stepio.in("y", 2, false), error);
+}
+
+BOOST_AUTO_TEST_CASE(DataLoaderStepIO_RecordFiles) {
+  TmpDir tmp;
+  // 3 records of 2x2 floats, and of 1 int64
+  std::vector<float> floats(12);
+  for (std::size_t i = 0; i < floats.size(); ++i) {
+    floats[i] = 0.5f * i;
+  }
+  std::vector<int64_t> labels{7, 8, 9};
+  writeNpy(tmp.file("data.npy"), "<f4", "3, 2, 2", floats);
+  writeRaw(tmp.file("labels.bin"), labels);
+
+  auto files = std::make_shared<RecordFiles>(
+      std::map<TensorId, std::string>{{"data", tmp.file("data.npy")},
+                                      {"label", tmp.file("labels.bin")}},
+      std::map<TensorId, TensorInfo>{{"label", {DataType::INT64, {1}}}});
+  BOOST_CHECK_EQUAL(files->numRecords(), 3);
+  BOOST_CHECK(files->sampleInfos().at("data") ==
+              TensorInfo(DataType::FLOAT, {2, 2}));
+
+  // Two epochs
+  DataLoaderStepIO stepio(files, 6, {}, 2, 4);
+  for (int64_t s = 0; s < 6; ++s) {
+    auto data  = stepio.in("data", 4, false);
+    auto label = stepio.in("label", 1, false);
+    BOOST_CHECK(data.info == TensorInfo(DataType::FLOAT, {2, 2}));
+    BOOST_CHECK(std::memcmp(data.data,
+                            floats.data() + 4 * (s % 3),
+                            4 * sizeof(float)) == 0);
+    BOOST_CHECK_EQUAL(readScalar<int64_t>(label), labels[s % 3]);
+    stepio.inComplete("data", 4);
+    stepio.inComplete("label", 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DataLoaderStepIO_InvalidRecordFiles) {
+  TmpDir tmp;
+  writeNpy(tmp.file("a.npy"), "<f4", "3,", std::vector<float>(3));
+  writeNpy(tmp.file("b.npy"), "<f4", "2,", std::vector<float>(2));
+  writeNpy(tmp.file("big.npy"), ">f4", "2,", std::vector<float>(2));
+  writeRaw(tmp.file("c.bin"), std::vector<float>(5));
+
+  using Files = std::map<TensorId, std::string>;
+  // Different numbers of records
+  BOOST_CHECK_THROW(
+      RecordFiles(Files{{"a", tmp.file("a.npy")}, {"b", tmp.file("b.npy")}}),
+      error);
+  // Big endian
+  BOOST_CHECK_THROW(RecordFiles(Files{{"a", tmp.file("big.npy")}}), error);
+  // No info for a raw file, or one which does not divide it
+  BOOST_CHECK_THROW(RecordFiles(Files{{"c", tmp.file("c.bin")}}), error);
+  BOOST_CHECK_THROW(RecordFiles(Files{{"c", tmp.file("c.bin")}},
+                                {{"c", {DataType::FLOAT, {2}}}}),
+                    error);
+  BOOST_CHECK_THROW(RecordFiles(Files{{"d", tmp.file("missing.npy")}}), error);
+}
@@ -175,3 +175,331 @@ def test_stepio_callbackinput(tmpdir):
 
     expected_result = i1_data + i2_data
     assert (np.allclose(anchors[o], expected_result))
+
+
+@pytest.mark.parametrize("zero_copy", [False, True])
+def test_stepio_zerocopyinput(zero_copy):
+
+    builder = popart.Builder()
+    shape = popart.TensorInfo("FLOAT", [2])
+
+    i1 = builder.addInputTensor(shape)
+    i2 = builder.addInputTensor(popart.TensorInfo("INT32", [2]))
+    o = builder.aiOnnx.add([i1, builder.aiOnnx.cast([i2], "FLOAT")])
+    builder.addOutputTensor(o)
+
+    proto = builder.getModelProto()
+
+    batches_per_step = 4
+
+    dataFlow = popart.DataFlow(batches_per_step,
+                               {o: popart.AnchorReturnType("All")})
+
+    session = popart.InferenceSession(fnModel=proto,
+                                      dataFlow=dataFlow,
+                                      deviceInfo=tu.create_test_device())
+
+    session.prepareDevice()
+
+    anchors = session.initAnchorArrays()
+
+    # i1 can be streamed without a copy. i2 is provided as INT64, so it must
+    # fall back to the converting callback.
+    i1_data = np.random.rand(batches_per_step, 2).astype(np.float32)
+    i2_data = np.random.randint(0, 10, [batches_per_step, 2]).astype(np.int64)
+
+    stepio = popart.PyStepIO({i1: i1_data, i2: i2_data}, anchors)
+    stepio.enableZeroCopyInputs(zero_copy)
+
+    # Run twice to check the streams restart from the start of the buffers.
+    for _ in range(2):
+        session.run(stepio)
+        assert np.allclose(anchors[o], i1_data + i2_data)
+
+
+def test_stepio_zerocopyinput_wrong_size():
+    builder = popart.Builder()
+    i1 = builder.addInputTensor(popart.TensorInfo("FLOAT", [2]))
+    o = builder.aiOnnx.relu([i1])
+    builder.addOutputTensor(o)
+
+    batches_per_step = 4
+
+    dataFlow = popart.DataFlow(batches_per_step,
+                               {o: popart.AnchorReturnType("All")})
+
+    session = popart.InferenceSession(fnModel=builder.getModelProto(),
+                                      dataFlow=dataFlow,
+                                      deviceInfo=tu.create_test_device())
+
+    session.prepareDevice()
+
+    anchors = session.initAnchorArrays()
+
+    i1_data = np.random.rand(batches_per_step, 2).astype(np.float32)
+    stepio = popart.PyStepIO({i1: i1_data}, anchors)
+    stepio.enableZeroCopyInputs(True)
+    session.run(stepio)
+
+    # The sizes are checked on every run for a zero-copy buffer, not only on
+    # the first run as for the copying callbacks. This buffer holds whole
+    # tensors, but only half of a step
+    short_data = np.random.rand(batches_per_step // 2, 2).astype(np.float32)
+    stepio = popart.PyStepIO({i1: short_data}, anchors)
+    stepio.enableZeroCopyInputs(True)
+    with pytest.raises(popart.popart_exception) as e_info:
+        session.run(stepio)
+
+    assert e_info.value.args[0].startswith(
+        "Unexpected number of input elements for Tensor " + i1)
+
+
+def test_stepio_convertinput():
+    # FLOAT and INT64 arrays are converted on the host when streamed to FLOAT16
+    # and INT32 tensors.
+    builder = popart.Builder()
+
+    i1 = builder.addInputTensor(popart.TensorInfo("FLOAT16", [2]))
+    i2 = builder.addInputTensor(popart.TensorInfo("INT32", [2]))
+    o = builder.aiOnnx.add([i1, builder.aiOnnx.cast([i2], "FLOAT16")])
+    builder.addOutputTensor(o)
+
+    proto = builder.getModelProto()
+
+    batches_per_step = 3
+
+    dataFlow = popart.DataFlow(batches_per_step,
+                               {o: popart.AnchorReturnType("All")})
+
+    session = popart.InferenceSession(fnModel=proto,
+                                      dataFlow=dataFlow,
+                                      deviceInfo=tu.create_test_device())
+
+    session.prepareDevice()
+
+    anchors = session.initAnchorArrays()
+
+    i1_data = np.random.rand(batches_per_step, 2).astype(np.float32)
+    i2_data = np.random.randint(0, 10, [batches_per_step, 2]).astype(np.int64)
+
+    stepio = popart.PyStepIO({i1: i1_data, i2: i2_data}, anchors)
+    session.run(stepio)
+
+    expected = i1_data.astype(np.float16) + i2_data.astype(np.float16)
+    assert anchors[o].dtype == np.float16
+    assert np.allclose(anchors[o], expected)
+
+
+def _async_session(batches_per_step, nBufferSets):
+    builder = popart.Builder()
+    i1 = builder.addInputTensor(popart.TensorInfo("FLOAT", [2]))
+    i2 = builder.addInputTensor(popart.TensorInfo("FLOAT", [2]))
+    o = builder.aiOnnx.add([i1, i2])
+    builder.addOutputTensor(o)
+
+    dataFlow = popart.DataFlow(batches_per_step, {
+        o: popart.AnchorReturnType("All"),
+        i1: popart.AnchorReturnType("Final")
+    })
+
+    opts = popart.SessionOptions()
+    opts.asyncAnchorBufferSets = nBufferSets
+
+    session = popart.InferenceSession(fnModel=builder.getModelProto(),
+                                      dataFlow=dataFlow,
+                                      userOptions=opts,
+                                      deviceInfo=tu.create_test_device())
+    session.prepareDevice()
+    return session, i1, i2, o
+
+
+def test_stepio_runasync():
+    batches_per_step = 3
+    session, i1, i2, o = _async_session(batches_per_step, 2)
+
+    steps = []
+    for _ in range(6):
+        steps.append({
+            i1: np.random.rand(batches_per_step, 2).astype(np.float32),
+            i2: np.random.rand(batches_per_step, 2).astype(np.float32)
+        })
+
+    # Keep one step in flight while consuming the anchors of the previous one
+    handle = session.runAsync(steps[0])
+    for k in range(len(steps)):
+        next_handle = None
+        if k + 1 < len(steps):
+            next_handle = session.runAsync(steps[k + 1])
+        anchors = handle.anchors()
+        assert anchors[o].shape == (batches_per_step, 2)
+        assert np.allclose(anchors[o], steps[k][i1] + steps[k][i2])
+        assert anchors[i1].shape == (2, )
+        assert np.allclose(anchors[i1], steps[k][i1][-1])
+        handle.release()
+        handle = next_handle
+
+    # The asynchronous steps share the session with run
+    anchors = session.initAnchorArrays()
+    session.run(popart.PyStepIO(steps[0], anchors))
+    assert np.allclose(anchors[o], steps[0][i1] + steps[0][i2])
+
+
+def test_stepio_runasync_buffersets_in_use():
+    session, i1, i2, o = _async_session(1, 1)
+    inputs = {
+        i1: np.ones([2], dtype=np.float32),
+        i2: np.ones([2], dtype=np.float32)
+    }
+
+    handle = session.runAsync(inputs)
+    with pytest.raises(popart.popart_exception) as e_info:
+        session.runAsync(inputs)
+    assert "sets of anchor buffers are in use" in e_info.value.args[0]
+
+    handle.wait()
+    assert handle.isReady()
+    handle.release()
+    handle = session.runAsync(inputs)
+    assert np.allclose(handle.anchors()[o], 2)
+
+
+def test_stepio_runasync_update_optimizer():
+    builder = popart.Builder()
+    i1 = builder.addInputTensor(popart.TensorInfo("FLOAT", [2]))
+    w = builder.addInitializedInputTensor(np.ones([2], dtype=np.float32))
+    o = builder.aiOnnx.mul([i1, w])
+    loss = builder.aiGraphcore.l1loss([o], 1.0, popart.ReductionType.Sum)
+
+    session = popart.TrainingSession(
+        fnModel=builder.getModelProto(),
+        dataFlow=popart.DataFlow(1, {o: popart.AnchorReturnType("All")}),
+        loss=loss,
+        optimizer=popart.SGD({"defaultLearningRate": (0.1, False)}),
+        deviceInfo=tu.create_test_device())
+    session.prepareDevice()
+    session.weightsFromHost()
+
+    # The optimizer is only updated once the step in flight has completed,
+    # so that step is run with the first learning rate
+    inputs = {i1: np.ones([2], dtype=np.float32)}
+    handle = session.runAsync(inputs)
+    session.updateOptimizerFromHost(
+        popart.SGD({"defaultLearningRate": (0.0, False)}))
+    assert handle.isReady()
+    handle.release()
+
+    weights = {w: np.empty([2], dtype=np.float32)}
+    weightsio = popart.PyWeightsIO(weights)
+    session.weightsToHost()
+    session.readWeights(weightsio)
+    assert np.allclose(weights[w], 0.9)
+
+    # The following steps are run with the new learning rate
+    handle = session.runAsync(inputs)
+    handle.wait()
+    handle.release()
+    session.weightsToHost()
+    session.readWeights(weightsio)
+    assert np.allclose(weights[w], 0.9)
+
+
+def test_stepio_dataloader(tmpdir):
+    # Inputs are read from record files by C++ workers: an NPY file of 4
+    # records for i1, and a raw file of the same records for i2
+    batches_per_step = 3
+    builder = popart.Builder()
+    i1 = builder.addInputTensor(popart.TensorInfo("FLOAT", [2]))
+    i2 = builder.addInputTensor(popart.TensorInfo("FLOAT", [2]))
+    o = builder.aiOnnx.add([i1, i2])
+    builder.addOutputTensor(o)
+
+    dataFlow = popart.DataFlow(batches_per_step,
+                               {o: popart.AnchorReturnType("All")})
+    session = popart.InferenceSession(fnModel=builder.getModelProto(),
+                                      dataFlow=dataFlow,
+                                      deviceInfo=tu.create_test_device())
+    session.prepareDevice()
+
+    i1_data = np.random.rand(4, 2).astype(np.float32)
+    i2_data = np.random.rand(4, 2).astype(np.float32)
+    i1_file = str(tmpdir / "i1.npy")
+    i2_file = str(tmpdir / "i2.bin")
+    np.save(i1_file, i1_data)
+    i2_data.tofile(i2_file)
+
+    files = popart.RecordFiles({
+        i1: i1_file,
+        i2: i2_file
+    }, {i2: popart.TensorInfo("FLOAT", [2])})
+    assert files.numRecords() == 4
+
+    # Two steps, reading the records again once they are exhausted
+    anchors = session.initAnchorArrays()
+    stepio = popart.DataLoaderStepIO(files,
+                                     numSamples=2 * batches_per_step,
+                                     outputs=anchors,
+                                     numWorkers=2)
+    expected = np.tile(i1_data + i2_data, (2, 1))
+    for step in range(2):
+        session.run(stepio)
+        begin = step * batches_per_step
+        assert np.allclose(anchors[o],
+                           expected[begin:begin + batches_per_step])
+    assert stepio.numSamplesCompleted() == 2 * batches_per_step
+
+
+def test_stepio_dataloader_unknown_input(tmpdir):
+    builder = popart.Builder()
+    i1 = builder.addInputTensor(popart.TensorInfo("FLOAT", [2]))
+    o = builder.aiOnnx.relu([i1])
+    builder.addOutputTensor(o)
+
+    session = popart.InferenceSession(
+        fnModel=builder.getModelProto(),
+        dataFlow=popart.DataFlow(1, {o: popart.AnchorReturnType("All")}),
+        deviceInfo=tu.create_test_device())
+    session.prepareDevice()
+
+    # An input which the Ir does not read would stop the workers once its
+    # queue is full, so is rejected
+    data = np.random.rand(2, 2).astype(np.float32)
+    files = {}
+    for k, name in enumerate([i1, "not_an_input"]):
+        files[name] = str(tmpdir / "input{}.npy".format(k))
+        np.save(files[name], data)
+    stepio = popart.DataLoaderStepIO(popart.RecordFiles(files, {}),
+                                     numSamples=1,
+                                     outputs=session.initAnchorArrays())
+    with pytest.raises(popart.popart_exception) as e_info:
+        session.run(stepio)
+    message = e_info.value.args[0]
+    assert "not_an_input, which is not an input of the Ir" in message
+
+
+def test_stepio_dataloader_variable_input(tmpdir):
+    builder = popart.Builder()
+    i1 = builder.addInputTensor(popart.TensorInfo("FLOAT", [2]))
+    w = builder.addInitializedInputTensor(np.ones([2], np.float32))
+    o = builder.aiOnnx.mul([i1, w])
+    builder.addOutputTensor(o)
+
+    session = popart.InferenceSession(
+        fnModel=builder.getModelProto(),
+        dataFlow=popart.DataFlow(1, {o: popart.AnchorReturnType("All")}),
+        deviceInfo=tu.create_test_device())
+    session.prepareDevice()
+
+    # The weight is in the Ir, but is not read from a stream, so the
+    # DataLoaderStepIO would never consume its samples
+    data = np.random.rand(2, 2).astype(np.float32)
+    files = {}
+    for k, name in enumerate([i1, w]):
+        files[name] = str(tmpdir / "input{}.npy".format(k))
+        np.save(files[name], data)
+    stepio = popart.DataLoaderStepIO(popart.RecordFiles(files, {}),
+                                     numSamples=1,
+                                     outputs=session.initAnchorArrays())
+    with pytest.raises(popart.popart_exception) as e_info:
+        session.run(stepio)
+    message = e_info.value.args[0]
+    assert "{}, which is a Variable Tensor".format(w) in message
@@ -3,6 +3,7 @@
 #define GUARD_NEURALNET_BLIP_HPP
 
 #include <map>
+#include <memory>
 #include <set>
 #include <vector>
 #include <popart/subgraph/algo0.hpp>
@@ -85,6 +86,44 @@ struct Edge {
   InIndex inIndex;
 };
 
+// A schedule of nLayers repeated layers, between a prologue and an epilogue
+// of distinct Blips. Each layer is a chain of Blips of layerTypes, with a
+// residual connection from the input of the layer to its last Blip. The
+// value of a Blip is 10 + its type.
+inline std::vector<std::unique_ptr<Blip>>
+getLayeredBlips(const std::vector<Type> &layerTypes,
+                int nLayers,
+                int nPrologue,
+                int nEpilogue) {
+  std::vector<std::unique_ptr<Blip>> blips;
+  auto append = [&blips](Type t) {
+    blips.emplace_back(new Blip(t, 10.0f + t, {}));
+    if (blips.size() > 1) {
+      auto prev = blips[blips.size() - 2].get();
+      blips.back()->addIn(0, prev, 0);
+      prev->addOut(blips.back().get(), 0);
+    }
+  };
+
+  for (int i = 0; i < nPrologue; ++i) {
+    append(1000 + i);
+  }
+  for (int layer = 0; layer < nLayers; ++layer) {
+    Blip *layerIn = blips.empty() ? nullptr : blips.back().get();
+    for (auto t : layerTypes) {
+      append(t);
+    }
+    if (layerIn) {
+      blips.back()->addIn(1, layerIn, 0);
+      layerIn->addOut(blips.back().get(), 0);
+    }
+  }
+  for (int i = 0; i < nEpilogue; ++i) {
+    append(2000 + i);
+  }
+  return blips;
+}
+
 class ModThreeCostModel {
 public:
   float value(int64_t begin,
@@ -0,0 +1,91 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE Hierarchical0SubgraphTest
+
+// tests of hierarchical matching (ALGO2)
+
+#include "blip.hpp"
+#include "validate.hpp"
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include <popart/subgraph/algo2.hpp>
+#include <popart/subgraph/outliner.hpp>
+
+using namespace fwtools::subgraph;
+using namespace blip;
+
+namespace {
+
+// A layer with some repeated sequences within it
+const std::vector<Type> layerTypes{0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 6, 7,
+                                   8, 0, 1, 2, 3, 9, 10, 11, 4, 5, 6, 12};
+
+std::vector<const Blip *> getSchedule(std::vector<std::unique_ptr<Blip>> &b) {
+  std::vector<const Blip *> sched;
+  for (auto &blip : b) {
+    sched.push_back(blip.get());
+  }
+  return sched;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(Hierarchical0_ChunkStarts) {
+  // repeated sequences are chunked in the same way, away from their ends
+  std::vector<int> intSched;
+  for (int i = 0; i < 20; ++i) {
+    intSched.insert(intSched.end(), layerTypes.begin(), layerTypes.end());
+  }
+  auto starts = algo2::getChunkStarts(intSched, 8);
+  BOOST_CHECK_EQUAL(starts.front(), 0);
+  BOOST_CHECK_EQUAL(starts.back(), intSched.size());
+  std::vector<Start> inLayer1;
+  std::vector<Start> inLayer10;
+  int length = static_cast<int>(layerTypes.size());
+  for (auto s : starts) {
+    if (s >= length && s < 2 * length) {
+      inLayer1.push_back(s - length);
+    }
+    if (s >= 10 * length && s < 11 * length) {
+      inLayer10.push_back(s - 10 * length);
+    }
+  }
+  BOOST_CHECK(inLayer1 == inLayer10);
+}
+
+BOOST_AUTO_TEST_CASE(Hierarchical0_Layers) {
+  const int nLayers = 30;
+  auto blips        = getLayeredBlips(layerTypes, nLayers, 7, 5);
+  auto sched        = getSchedule(blips);
+
+  auto matches =
+      getRinseMatches<const Blip>(sched, 1.0f, OutlinerAlgorithm::ALGO2);
+  BOOST_CHECK(isValid(matches, sched));
+
+  // a block of the length of a layer, with an instance in every layer
+  bool foundBlock = false;
+  for (auto &m : matches) {
+    if (m.length == layerTypes.size() && m.starts.size() == nLayers) {
+      foundBlock = true;
+    }
+  }
+  BOOST_CHECK(foundBlock);
+
+  // which outlines as well as ALGO1
+  auto algo1Matches =
+      getRinseMatches<const Blip>(sched, 1.0f, OutlinerAlgorithm::ALGO1);
+  auto size1 = getOutlinedSize(algo1Matches, sched.size());
+  auto size2 = getOutlinedSize(matches, sched.size());
+  BOOST_TEST_MESSAGE("Outlined size ALGO1: " << size1 << ", ALGO2: " << size2);
+  BOOST_CHECK_LE(size2, size1);
+}
+
+BOOST_AUTO_TEST_CASE(Hierarchical0_Short) {
+  // short schedules are matched with ALGO1
+  auto blips = getLayeredBlips(layerTypes, 3, 2, 2);
+  auto sched = getSchedule(blips);
+  auto matches1 =
+      getRinseMatches<const Blip>(sched, 1.0f, OutlinerAlgorithm::ALGO1);
+  auto matches2 =
+      getRinseMatches<const Blip>(sched, 1.0f, OutlinerAlgorithm::ALGO2);
+  BOOST_CHECK(matches1 == matches2);
+}
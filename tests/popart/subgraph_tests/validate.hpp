@@ -84,4 +84,49 @@ bool isValid(const std::vector<fwtools::subgraph::Match> &matches,
   return true;
 }
 
+// The number of nodes and calls in the main schedule and in all of the
+// sub-graphs, after outlining the matches
+inline int getOutlinedSize(const std::vector<fwtools::subgraph::Match> &matches,
+                           int schedule_size) {
+
+  using namespace fwtools::subgraph;
+
+  // the matches starting at each index, longest first
+  std::vector<std::vector<const Match *>> startingAt(schedule_size);
+  for (auto &m : matches) {
+    for (auto s : m.starts) {
+      startingAt[s].push_back(&m);
+    }
+  }
+  for (auto &ms : startingAt) {
+    std::sort(ms.begin(), ms.end(), [](const Match *a, const Match *b) {
+      return a->length > b->length;
+    });
+  }
+
+  // the size of [begin, end), with the matches within it outlined
+  auto size = [&startingAt](int begin, int end) {
+    int count = 0;
+    int i     = begin;
+    while (i < end) {
+      int step = 1;
+      for (auto m : startingAt[i]) {
+        if (i + m->length <= end && m->length < end - begin) {
+          step = m->length;
+          break;
+        }
+      }
+      ++count;
+      i += step;
+    }
+    return count;
+  };
+
+  int total = size(0, schedule_size);
+  for (auto &m : matches) {
+    total += size(m.starts[0], m.starts[0] + m.length);
+  }
+  return total;
+}
+
 #endif
@@ -2,6 +2,10 @@
 #define BOOST_TEST_MODULE Region0Test
 
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
 #include <vector>
 #include <popart/region.hpp>
 
@@ -202,3 +206,133 @@ BOOST_AUTO_TEST_CASE(Region_AccessType0) {
       view::combine({view::AccessType::Write, view::AccessType::ReadWrite}) ==
       view::AccessType::ReadWrite);
 }
+
+namespace {
+
+// The flat indices of the elements of a Shape in any of the regions
+std::set<int64_t> elements(const view::Regions &regions, const Shape &shape) {
+  auto full = view::Region::getFull(shape);
+  std::set<int64_t> result;
+  for (int64_t i = 0; i < full.nelms(); ++i) {
+    for (auto &r : regions) {
+      if (r.contains(full.dimIndex(i))) {
+        result.insert(i);
+      }
+    }
+  }
+  return result;
+}
+
+view::Region randomRegion(std::mt19937 &rng, const Shape &shape) {
+  std::vector<int64_t> lower;
+  std::vector<int64_t> upper;
+  for (auto dim : shape) {
+    int64_t a = rng() % (dim + 1);
+    int64_t b = rng() % (dim + 1);
+    lower.push_back(std::min(a, b));
+    upper.push_back(std::max(a, b));
+  }
+  return view::Region(lower, upper);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(Region_SubRandom0) {
+  // Subtraction and overlap against the elements of the Regions, with enough
+  // Regions for the interval index to be used
+  std::mt19937 rng(1011);
+  Shape shape{5, 4, 6};
+  for (int test = 0; test < 50; ++test) {
+    auto r0 = randomRegion(rng, shape);
+    view::Regions rhs;
+    for (int i = 0; i < 1 + test % 20; ++i) {
+      rhs.push_back(randomRegion(rng, shape));
+    }
+
+    auto e0   = elements({r0}, shape);
+    auto eRhs = elements(rhs, shape);
+
+    std::set<int64_t> expected;
+    std::set_difference(e0.begin(),
+                        e0.end(),
+                        eRhs.begin(),
+                        eRhs.end(),
+                        std::inserter(expected, expected.end()));
+
+    auto subs = r0.sub(rhs);
+    BOOST_CHECK(elements(subs, shape) == expected);
+
+    // The Regions are disjoint, and sorted
+    int64_t nelms = 0;
+    for (auto &r : subs) {
+      nelms += r.nelms();
+    }
+    BOOST_CHECK(nelms == static_cast<int64_t>(expected.size()));
+    auto lowerLess = [](const view::Region &a, const view::Region &b) {
+      return a.getLower() < b.getLower();
+    };
+    BOOST_CHECK(std::is_sorted(subs.begin(), subs.end(), lowerLess));
+
+    std::set<int64_t> common;
+    std::set_intersection(e0.begin(),
+                          e0.end(),
+                          eRhs.begin(),
+                          eRhs.end(),
+                          std::inserter(common, common.end()));
+    BOOST_CHECK(view::overlaps({r0}, rhs) == !common.empty());
+    BOOST_CHECK(view::overlaps(rhs, {r0}) == !common.empty());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Region_MergeRandom0) {
+  // Merged Regions are disjoint, and cover the elements of the Regions
+  std::mt19937 rng(1012);
+  Shape shape{5, 4, 6};
+  for (int test = 0; test < 50; ++test) {
+    view::Regions regions;
+    for (int i = 0; i < 1 + test % 20; ++i) {
+      regions.push_back(randomRegion(rng, shape));
+    }
+    auto merged   = view::mergeRegions(regions);
+    auto expected = elements(regions, shape);
+    BOOST_CHECK(elements(merged, shape) == expected);
+
+    int64_t nelms = 0;
+    for (auto &r : merged) {
+      nelms += r.nelms();
+    }
+    BOOST_CHECK(nelms == static_cast<int64_t>(expected.size()));
+  }
+
+  // A pinwheel, which can not be merged pairwise, fills a box
+  view::Regions pinwheel{view::Region({0, 0}, {2, 1}),
+                         view::Region({2, 0}, {3, 2}),
+                         view::Region({1, 2}, {3, 3}),
+                         view::Region({0, 1}, {1, 3}),
+                         view::Region({1, 1}, {2, 2})};
+  auto merged = view::mergeRegions(pinwheel);
+  BOOST_CHECK(merged.size() == 1);
+  BOOST_CHECK(merged.front() == view::Region({0, 0}, {3, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(Region_Bounds0) {
+  // Bounds of more than Bounds::inlineRank dimensions are stored on the heap
+  std::vector<int64_t> small{1, 2, 3};
+  std::vector<int64_t> large{1, 2, 3, 4, 5, 6, 7, 8};
+
+  view::Bounds b0(small);
+  view::Bounds b1(large);
+  BOOST_CHECK(static_cast<std::vector<int64_t>>(b0) == small);
+  BOOST_CHECK(static_cast<std::vector<int64_t>>(b1) == large);
+  BOOST_CHECK(b0 < b1);
+
+  auto b2 = b1;
+  b2[7]   = 9;
+  BOOST_CHECK(b1[7] == 8 && b2[7] == 9);
+
+  view::Region r0(view::Bounds(large.size(), 0), large);
+  view::Region r1 = r0;
+  BOOST_CHECK(r0 == r1);
+  BOOST_CHECK(r0.nelms() == 40320);
+  BOOST_CHECK(r0.contains(r1.getUpper()) == false);
+}
@@ -0,0 +1,42 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE TensorIdInternerTest
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <popart/error.hpp>
+#include <popart/tensoridinterner.hpp>
+
+using namespace popart;
+
+BOOST_AUTO_TEST_CASE(TensorIdInterner_DenseHandles) {
+  TensorIdInterner interner;
+  BOOST_CHECK_EQUAL(interner.find("a"), unusedTensorHandle);
+
+  BOOST_CHECK_EQUAL(interner.intern("a"), 0);
+  BOOST_CHECK_EQUAL(interner.intern("Gradient___a"), 1);
+  BOOST_CHECK_EQUAL(interner.intern("a"), 0);
+  BOOST_CHECK_EQUAL(interner.size(), 2);
+
+  BOOST_CHECK_EQUAL(interner.find("Gradient___a"), 1);
+  BOOST_CHECK_EQUAL(interner.getId(0), "a");
+  BOOST_CHECK_EQUAL(interner.getId(1), "Gradient___a");
+  BOOST_CHECK_THROW(interner.getId(2), error);
+}
+
+BOOST_AUTO_TEST_CASE(TensorIdInterner_IdsSurviveRehashing) {
+  TensorIdInterner interner;
+  const TensorId &first = interner.getId(interner.intern("first"));
+
+  std::vector<TensorHandle> handles;
+  for (int i = 0; i < 10000; ++i) {
+    handles.push_back(interner.intern("t" + std::to_string(i)));
+  }
+  BOOST_CHECK_EQUAL(first, "first");
+  for (int i = 0; i < 10000; ++i) {
+    BOOST_CHECK_EQUAL(handles[i], i + 1);
+    BOOST_CHECK_EQUAL(interner.getId(handles[i]), "t" + std::to_string(i));
+  }
+}
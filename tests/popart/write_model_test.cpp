@@ -0,0 +1,173 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE WriteModelTest
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <popart/error.hpp>
+#include <popart/filereader.hpp>
+#include <popart/hostconversion.hpp>
+#include <popart/voiddata.hpp>
+
+using namespace popart;
+
+namespace {
+
+struct TmpFile {
+  TmpFile()
+      : path((boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("popart_model_%%%%%%%%.onnx"))
+                 .string()) {}
+  ~TmpFile() { boost::filesystem::remove(path); }
+  std::string path;
+};
+
+ONNX_NAMESPACE::ModelProto makeModel() {
+  ONNX_NAMESPACE::ModelProto model;
+  model.set_ir_version(6);
+  model.set_producer_name("write_model_test");
+  model.add_opset_import()->set_version(11);
+
+  auto graph = model.mutable_graph();
+  graph->set_name("g");
+  graph->add_input()->set_name("x");
+  auto node = graph->add_node();
+  node->set_op_type("MatMul");
+  node->add_input("x");
+  node->add_input("w");
+  node->add_output("y");
+  graph->add_output()->set_name("y");
+
+  auto w = graph->add_initializer();
+  w->set_name("w");
+  w->set_data_type(ONNX_NAMESPACE::TensorProto::FLOAT);
+  w->add_dims(3);
+  for (float v : {1.0f, 2.0f, 3.0f}) {
+    w->add_float_data(v);
+  }
+
+  auto c = graph->add_initializer();
+  c->set_name("c");
+  c->set_data_type(ONNX_NAMESPACE::TensorProto::INT64);
+  c->add_dims(2);
+  c->add_int64_data(5);
+  c->add_int64_data(6);
+
+  auto h = graph->add_initializer();
+  h->set_name("h");
+  h->set_data_type(ONNX_NAMESPACE::TensorProto::FLOAT16);
+  h->add_dims(2);
+  h->set_raw_data(std::string(2 * sizeof(uint16_t), '\0'));
+
+  return model;
+}
+
+template <typename T>
+bool rawDataEquals(const ONNX_NAMESPACE::TensorProto &tp,
+                   const std::vector<T> &expected) {
+  return tp.raw_data().size() == expected.size() * sizeof(T) &&
+         std::memcmp(tp.raw_data().data(),
+                     expected.data(),
+                     tp.raw_data().size()) == 0;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(WriteModel_WeightsReplaceInitializerData) {
+  TmpFile tmp;
+  auto model = makeModel();
+
+  std::vector<float> w{7.0f, 8.0f, 9.0f};
+  std::map<TensorId, ConstVoidData> weights{
+      {"w", ConstVoidData(w.data(), TensorInfo(DataType::FLOAT, {3}))}};
+  io::writeModel(model, weights, tmp.path);
+
+  auto result = io::getModelFromFile(tmp.path);
+  BOOST_CHECK_EQUAL(result.producer_name(), "write_model_test");
+  BOOST_CHECK_EQUAL(result.opset_import_size(), 1);
+  BOOST_CHECK_EQUAL(result.graph().node_size(), 1);
+  BOOST_CHECK_EQUAL(result.graph().input(0).name(), "x");
+  BOOST_CHECK_EQUAL(result.graph().output(0).name(), "y");
+
+  // The initializers keep their order, and those without weights their data
+  const auto &inits = result.graph().initializer();
+  BOOST_REQUIRE_EQUAL(inits.size(), 3);
+  BOOST_CHECK_EQUAL(inits.Get(0).name(), "w");
+  BOOST_CHECK_EQUAL(inits.Get(0).float_data_size(), 0);
+  BOOST_CHECK(rawDataEquals(inits.Get(0), w));
+  BOOST_CHECK_EQUAL(inits.Get(1).name(), "c");
+  BOOST_CHECK_EQUAL(inits.Get(1).int64_data(1), 6);
+  BOOST_CHECK_EQUAL(inits.Get(2).name(), "h");
+}
+
+BOOST_AUTO_TEST_CASE(WriteModel_WeightsAreConverted) {
+  TmpFile tmp;
+  auto model = makeModel();
+
+  std::vector<float> h{1.5f, -2.0f};
+  std::map<TensorId, ConstVoidData> weights{
+      {"h", ConstVoidData(h.data(), TensorInfo(DataType::FLOAT, {2}))}};
+  io::writeModel(model, weights, tmp.path);
+
+  auto result = io::getModelFromFile(tmp.path);
+  const auto &tp = result.graph().initializer(2);
+  BOOST_CHECK_EQUAL(tp.data_type(), ONNX_NAMESPACE::TensorProto::FLOAT16);
+  BOOST_CHECK(rawDataEquals(tp,
+                            std::vector<uint16_t>{
+                                hostconversion::floatToHalf(1.5f),
+                                hostconversion::floatToHalf(-2.0f)}));
+}
+
+BOOST_AUTO_TEST_CASE(WriteModel_NewWeightsAreAppended) {
+  TmpFile tmp;
+  auto model = makeModel();
+
+  std::vector<int32_t> e{1, 2, 3, 4};
+  std::map<TensorId, ConstVoidData> weights{
+      {"e", ConstVoidData(e.data(), TensorInfo(DataType::INT32, {2, 2}))}};
+  io::writeModel(model, weights, tmp.path);
+
+  auto result = io::getModelFromFile(tmp.path);
+  BOOST_REQUIRE_EQUAL(result.graph().initializer_size(), 4);
+  const auto &tp = result.graph().initializer(3);
+  BOOST_CHECK_EQUAL(tp.name(), "e");
+  BOOST_CHECK_EQUAL(tp.data_type(), ONNX_NAMESPACE::TensorProto::INT32);
+  BOOST_CHECK_EQUAL(tp.dims_size(), 2);
+  BOOST_CHECK(rawDataEquals(tp, e));
+}
+
+BOOST_AUTO_TEST_CASE(WriteModel_LargeWeightsAreChunked) {
+  TmpFile tmp;
+  auto model = makeModel();
+
+  std::vector<float> big(10 << 20);
+  for (std::size_t i = 0; i < big.size(); ++i) {
+    big[i] = static_cast<float>(i % 1000);
+  }
+  auto b = model.mutable_graph()->add_initializer();
+  b->set_name("b");
+  b->set_data_type(ONNX_NAMESPACE::TensorProto::FLOAT);
+  b->add_dims(big.size());
+
+  TensorInfo info(DataType::FLOAT, {static_cast<int64_t>(big.size())});
+  std::map<TensorId, ConstVoidData> weights{
+      {"b", ConstVoidData(big.data(), info)}};
+  io::writeModel(model, weights, tmp.path);
+
+  auto result = io::getModelFromFile(tmp.path);
+  BOOST_CHECK(rawDataEquals(result.graph().initializer(3), big));
+}
+
+BOOST_AUTO_TEST_CASE(WriteModel_MismatchedWeight) {
+  TmpFile tmp;
+  auto model = makeModel();
+
+  std::vector<float> w{7.0f, 8.0f};
+  std::map<TensorId, ConstVoidData> weights{
+      {"w", ConstVoidData(w.data(), TensorInfo(DataType::FLOAT, {2}))}};
+  BOOST_CHECK_THROW(io::writeModel(model, weights, tmp.path), error);
+}
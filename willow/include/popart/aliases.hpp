@@ -2,6 +2,7 @@
 #ifndef GUARD_NEURALNET_ALIASES_HPP
 #define GUARD_NEURALNET_ALIASES_HPP
 
+#include <set>
 #include <unordered_map>
 #include <vector>
 #include <popart/chains.hpp>
@@ -17,6 +18,9 @@ public:
   ~Aliases() = default;
 
   void clearAliases();
+  // Remove all Chains to and from the Tensors in ts. To keep the model
+  // consistent, ts should be closed under aliasing (see getAliasComponent)
+  void clearAliases(const std::set<Tensor *> &ts);
   void updateAliases(Tensor *t1,
                      Tensor *t2,
                      view::Regions inRegions,
@@ -24,8 +28,14 @@ public:
                      view::RegMap bwdMap,
                      std::string fwdLinkName = "None",
                      std::string bwdLinkName = "None");
+  // The Regions of "to" aliased by all of "from". These are cached per
+  // (from, to) pair when the Chains between them change, so this is a lookup
   view::Regions getAliasRegions(Tensor *from, Tensor *to) const;
 
+  // The Tensors connected to ts by Chains, directly or through other
+  // Tensors, including ts
+  std::set<Tensor *> getAliasComponent(const std::vector<Tensor *> &ts) const;
+
   // all non-empty alias Chains to "to"
   // returned map M will always have M[to] = "the identity chain"
   //......"from"...."chains"............................"to"
@@ -56,6 +66,15 @@ private:
   std::unordered_map<Tensor *, std::unordered_map<Tensor *, view::Chains>>
       aliasChainsFromKey;
 
+  // aliasChainsFromKey[from][to] applied to the full Region of "from"
+  //                "from"......................."to"......"regions"
+  //                 ^                            ^         ^
+  std::unordered_map<Tensor *, std::unordered_map<Tensor *, view::Regions>>
+      aliasRegionsFromKey;
+
+  // set aliasChainsFromKey[from][to], and its mirror and cached Regions
+  void setChains(Tensor *from, Tensor *to, const view::Chains &);
+
   // return M[t], but with guaranteed identity Chains from t
   std::unordered_map<Tensor *, view::Chains> getAliasChains(
       const std::unordered_map<Tensor *,
@@ -0,0 +1,140 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_ASYNCRUN_HPP
+#define GUARD_NEURALNET_ASYNCRUN_HPP
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <popart/istepio.hpp>
+#include <popart/names.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/threadpool.hpp>
+#include <popart/voiddata.hpp>
+
+namespace popart {
+
+namespace popx {
+class Devicex;
+}
+
+class AsyncRunner;
+
+// An IStepIO which reads every input from a host buffer holding the data for
+// one whole step, as returned by IStepIO::inZeroCopy. It has no anchors: it
+// is intended for Session::runAsync, which provides its own.
+class HostBufferStepIO : public IStepIO {
+public:
+  explicit HostBufferStepIO(std::map<TensorId, ConstVoidData> inputs);
+
+  ConstVoidData in(TensorId id, int64_t numElements, bool prefetch) final;
+  void inComplete(TensorId id, int64_t numElements) final;
+  ConstVoidData inZeroCopy(TensorId id, int64_t numElements) final;
+  MutableVoidData out(TensorId id, int64_t numElements) final;
+  void assertNumElements(const Ir &) const final;
+
+private:
+  struct Input {
+    ConstVoidData data;
+    int64_t offset;
+  };
+  std::map<TensorId, Input> inputs;
+};
+
+// A step started by Session::runAsync. The anchors of the step are written to
+// a set of buffers owned by the session, which are returned to the session
+// when the handle is released or destroyed. Destroying a handle waits for its
+// step to complete. A handle must not outlive the session which created it.
+class AsyncRunHandle {
+public:
+  ~AsyncRunHandle();
+
+  AsyncRunHandle(const AsyncRunHandle &) = delete;
+  AsyncRunHandle &operator=(const AsyncRunHandle &) = delete;
+
+  // Block until the step has completed, rethrowing any error it raised.
+  void wait();
+
+  // True if the step has completed (successfully or not).
+  bool isReady() const;
+
+  // The anchors written by the step, one buffer per anchor holding the data
+  // of the whole step, shaped as Session::run's anchor arrays are. Waits for
+  // the step to complete. The data is valid until the handle is released.
+  const std::map<TensorId, MutableVoidData> &anchors();
+
+  // Wait for the step to complete, and return its anchor buffers to the
+  // session for reuse by a later step. Errors raised by the step are not
+  // rethrown.
+  void release();
+
+private:
+  friend class AsyncRunner;
+  AsyncRunHandle(AsyncRunner &runner,
+                 unsigned bufferSet,
+                 std::shared_future<void> done);
+
+  AsyncRunner &runner;
+  unsigned bufferSet;
+  std::shared_future<void> done;
+  bool released{false};
+};
+
+// Runs the steps of a Session one after another on a dedicated thread, so
+// that the host can consume the anchors of step k while step k+1 runs. The
+// anchors of each step are written to one of nBufferSets sets of buffers,
+// which are reused once the handle of the step using them is released.
+class AsyncRunner {
+public:
+  AsyncRunner(popx::Devicex &device, unsigned nBufferSets);
+  // Waits for every step which has been started to complete
+  ~AsyncRunner();
+
+  // Start a step which reads its inputs from `inputs', which must remain
+  // valid until the step has completed. Throws if every set of anchor
+  // buffers is held by a handle which has not been released, as no step
+  // could then ever complete.
+  std::unique_ptr<AsyncRunHandle> run(IStepIO &inputs);
+
+  // Block until every step which has been started has completed. Errors are
+  // reported by the steps' handles, not here.
+  void waitForAll();
+
+  unsigned getNumBufferSets() const {
+    return static_cast<unsigned>(bufferSets.size());
+  }
+
+private:
+  friend class AsyncRunHandle;
+
+  struct AnchorBuffer {
+    std::vector<char> data;
+    TensorInfo info;
+    // Where the next write of the step goes, in bytes
+    int64_t offset;
+  };
+
+  struct BufferSet {
+    std::map<TensorId, AnchorBuffer> buffers;
+    std::map<TensorId, MutableVoidData> anchors;
+    bool inUse{false};
+  };
+
+  class StepIO;
+
+  void releaseBufferSet(unsigned bufferSet);
+
+  popx::Devicex &device;
+  std::vector<BufferSet> bufferSets;
+  std::mutex mutex;
+  std::shared_future<void> lastStep;
+  // A single worker, so that steps are run in the order they are started.
+  // Declared last, so that it is joined before the buffers are destroyed.
+  ThreadPool worker{1};
+};
+
+} // namespace popart
+
+#endif
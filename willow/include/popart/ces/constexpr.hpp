@@ -18,7 +18,8 @@ class ConstExprOp {
 public:
   ConstExprOp(Op *);
   virtual ~ConstExprOp() = default;
-  // compute the output data of the op
+  // compute the output data of the op. This may be called concurrently for
+  // different Ops, so must only read the Op and its input Tensors.
   virtual std::vector<char> compute() = 0;
 
 protected:
@@ -61,10 +62,14 @@ public:
   // process a ConstExprOp "op", modfying the Ir pointed to by "ir"
   static void processOp(Op *op, Graph &);
 
-  // Compute all ops possible
+  // Compute all ops possible. Independent ops are computed in parallel.
   static void foldConstants(Graph &);
 
 private:
+  // replace "op" by a constInit tensor with the data of its output
+  static void
+  replaceWithConstInit(Op *op, const std::vector<char> &data, Graph &);
+
   // make the tensor `name` into a constInit tensor
   static void
   makeTensorConstInit(const TensorId name, const void *data, Graph &);
@@ -36,6 +36,12 @@ public:
   std::vector<char> compute() final;
 };
 
+class ConstExprPow : public ConstExprOp {
+public:
+  ConstExprPow(Op *op);
+  std::vector<char> compute() final;
+};
+
 } // namespace popart
 
 #endif
@@ -0,0 +1,17 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_CONSTEXPRS_EXPANDCE_HPP
+#define GUARD_NEURALNET_CONSTEXPRS_EXPANDCE_HPP
+
+#include <popart/ces/constexpr.hpp>
+
+namespace popart {
+
+class ConstExprExpand : public ConstExprOp {
+public:
+  ConstExprExpand(Op *);
+  std::vector<char> compute() final;
+};
+
+} // namespace popart
+
+#endif
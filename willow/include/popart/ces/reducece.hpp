@@ -0,0 +1,17 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_CONSTEXPRS_REDUCECE_HPP
+#define GUARD_NEURALNET_CONSTEXPRS_REDUCECE_HPP
+
+#include <popart/ces/constexpr.hpp>
+
+namespace popart {
+
+class ConstExprReduce : public ConstExprOp {
+public:
+  ConstExprReduce(Op *);
+  std::vector<char> compute() final;
+};
+
+} // namespace popart
+
+#endif
@@ -0,0 +1,184 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_CONSTEXPRS_STRIDEDLOOP_HPP
+#define GUARD_NEURALNET_CONSTEXPRS_STRIDEDLOOP_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <popart/error.hpp>
+#include <popart/names.hpp>
+#include <popart/threadpool.hpp>
+
+namespace popart {
+
+// The strides, in elements, with which to read a row-major tensor of shape
+// `inShape' when it is broadcast (with numpy rules) to `outShape'. Broadcast
+// dimensions have stride 0. The returned vector has the rank of outShape.
+inline std::vector<int64_t> broadcastStrides(const Shape &inShape,
+                                             const Shape &outShape) {
+  if (inShape.size() > outShape.size()) {
+    throw error("Cannot broadcast shape of rank {} to rank {}",
+                inShape.size(),
+                outShape.size());
+  }
+  std::vector<int64_t> strides(outShape.size(), 0);
+  auto offset    = outShape.size() - inShape.size();
+  int64_t stride = 1;
+  for (auto d = inShape.size(); d-- > 0;) {
+    if (inShape[d] == outShape[offset + d]) {
+      strides[offset + d] = stride;
+    } else if (inShape[d] != 1) {
+      throw error("Cannot broadcast dimension {} of size {} to size {}",
+                  d,
+                  inShape[d],
+                  outShape[offset + d]);
+    }
+    stride *= inShape[d];
+  }
+  return strides;
+}
+
+// The strides of a row-major tensor of shape `shape', permuted so that
+// dimension d of the result is dimension perm[d] of the tensor.
+inline std::vector<int64_t> permutedStrides(const Shape &shape,
+                                            const std::vector<int64_t> &perm) {
+  std::vector<int64_t> strides(shape.size());
+  int64_t stride = 1;
+  for (auto d = shape.size(); d-- > 0;) {
+    strides[d] = stride;
+    stride *= shape[d];
+  }
+  std::vector<int64_t> result;
+  result.reserve(perm.size());
+  for (auto p : perm) {
+    result.push_back(strides.at(p));
+  }
+  return result;
+}
+
+// A loop nest over the elements of a contiguous output tensor, where each of
+// N inputs is read with its own strides (see broadcastStrides and
+// permutedStrides). Dimensions of size 1 are dropped and adjacent dimensions
+// are merged wherever every input allows it, so that the innermost loop is as
+// long as possible.
+//
+// The innermost dimension is handed to a callback as a "row", so that its
+// loop can be written with simple pointer arithmetic which the compiler can
+// vectorize. No memory is allocated per element.
+template <std::size_t N> class StridedLoop {
+public:
+  using Offsets = std::array<int64_t, N>;
+
+  StridedLoop(const Shape &shape,
+              const std::array<std::vector<int64_t>, N> &strides) {
+    for (const auto &s : strides) {
+      if (s.size() != shape.size()) {
+        throw internal_error("StridedLoop strides of rank {} for a shape of "
+                             "rank {}",
+                             s.size(),
+                             shape.size());
+      }
+    }
+    for (uint64_t d = 0; d < shape.size(); ++d) {
+      if (shape[d] == 1) {
+        continue;
+      }
+      Offsets dStrides;
+      for (uint64_t i = 0; i < N; ++i) {
+        dStrides[i] = strides[i][d];
+      }
+      // dimension d can be merged into the previous one if, for every input,
+      // stepping once in the previous dimension is the same as stepping
+      // shape[d] times in dimension d
+      bool mergeable = !sizes.empty();
+      for (uint64_t i = 0; mergeable && i < N; ++i) {
+        mergeable = dimStrides.back()[i] == dStrides[i] * shape[d];
+      }
+      if (mergeable) {
+        sizes.back() *= shape[d];
+        dimStrides.back() = dStrides;
+      } else {
+        sizes.push_back(shape[d]);
+        dimStrides.push_back(dStrides);
+      }
+    }
+    if (sizes.empty()) {
+      sizes.push_back(1);
+      dimStrides.push_back(Offsets{});
+    }
+    nRows_ = 1;
+    for (uint64_t d = 0; d + 1 < sizes.size(); ++d) {
+      nRows_ *= sizes[d];
+    }
+  }
+
+  // The number of elements in each row, and the number of rows
+  int64_t rowSize() const { return sizes.back(); }
+  int64_t nRows() const { return nRows_; }
+
+  // The stride of each input along a row
+  const Offsets &rowStrides() const { return dimStrides.back(); }
+
+  // Call f(outOffset, inOffsets) for each row in [rowBegin, rowEnd), where
+  // outOffset is the offset of the first element of the row in the output,
+  // and inOffsets are the offsets of its first element in each input.
+  template <typename F>
+  void forRows(int64_t rowBegin, int64_t rowEnd, const F &f) const {
+    if (rowBegin >= rowEnd) {
+      return;
+    }
+    const int64_t nOuter = static_cast<int64_t>(sizes.size()) - 1;
+    std::vector<int64_t> index(nOuter, 0);
+    Offsets offsets{};
+    int64_t rem = rowBegin;
+    for (int64_t d = nOuter - 1; d >= 0; --d) {
+      index[d] = rem % sizes[d];
+      rem /= sizes[d];
+      for (uint64_t i = 0; i < N; ++i) {
+        offsets[i] += index[d] * dimStrides[d][i];
+      }
+    }
+
+    for (int64_t row = rowBegin; row < rowEnd; ++row) {
+      f(row * rowSize(), offsets);
+      for (int64_t d = nOuter - 1; d >= 0; --d) {
+        ++index[d];
+        for (uint64_t i = 0; i < N; ++i) {
+          offsets[i] += dimStrides[d][i];
+        }
+        if (index[d] < sizes[d]) {
+          break;
+        }
+        for (uint64_t i = 0; i < N; ++i) {
+          offsets[i] -= dimStrides[d][i] * sizes[d];
+        }
+        index[d] = 0;
+      }
+    }
+  }
+
+  // As forRows over all rows, split across ThreadPool::global() when there
+  // are enough elements for it to be worthwhile.
+  template <typename F> void parallelForRows(const F &f) const {
+    if (rowSize() == 0) {
+      return;
+    }
+    constexpr int64_t minElementsPerThread = 1 << 16;
+    auto grain = std::max<int64_t>(1, minElementsPerThread / rowSize());
+    ThreadPool::global().parallelFor(
+        nRows_, grain, [this, &f](int64_t begin, int64_t end) {
+          forRows(begin, end, f);
+        });
+  }
+
+private:
+  std::vector<int64_t> sizes;
+  std::vector<Offsets> dimStrides;
+  int64_t nRows_;
+};
+
+} // namespace popart
+
+#endif
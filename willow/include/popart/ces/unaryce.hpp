@@ -0,0 +1,51 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_CONSTEXPRS_UNARYCE_HPP
+#define GUARD_NEURALNET_CONSTEXPRS_UNARYCE_HPP
+
+#include <popart/ces/constexpr.hpp>
+
+namespace popart {
+
+// The elementwise unary operations, defined in unaryce.cpp
+namespace unaryce {
+class Abs;
+class Ceil;
+class Cos;
+class Exp;
+class Log;
+class Neg;
+class Reciprocal;
+class Relu;
+class Sigmoid;
+class Sign;
+class Sin;
+class Sqrt;
+class Square;
+class Tanh;
+} // namespace unaryce
+
+// Elementwise unary ops. The output has the type and shape of the input.
+template <typename OPERATION> class ConstExprUnary : public ConstExprOp {
+public:
+  ConstExprUnary(Op *op);
+  std::vector<char> compute() final;
+};
+
+using ConstExprAbs        = ConstExprUnary<unaryce::Abs>;
+using ConstExprCeil       = ConstExprUnary<unaryce::Ceil>;
+using ConstExprCos        = ConstExprUnary<unaryce::Cos>;
+using ConstExprExp        = ConstExprUnary<unaryce::Exp>;
+using ConstExprLog        = ConstExprUnary<unaryce::Log>;
+using ConstExprNeg        = ConstExprUnary<unaryce::Neg>;
+using ConstExprReciprocal = ConstExprUnary<unaryce::Reciprocal>;
+using ConstExprRelu       = ConstExprUnary<unaryce::Relu>;
+using ConstExprSigmoid    = ConstExprUnary<unaryce::Sigmoid>;
+using ConstExprSign       = ConstExprUnary<unaryce::Sign>;
+using ConstExprSin        = ConstExprUnary<unaryce::Sin>;
+using ConstExprSqrt       = ConstExprUnary<unaryce::Sqrt>;
+using ConstExprSquare     = ConstExprUnary<unaryce::Square>;
+using ConstExprTanh       = ConstExprUnary<unaryce::Tanh>;
+
+} // namespace popart
+
+#endif
@@ -0,0 +1,109 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_COMPILEPROFILER_HPP
+#define GUARD_NEURALNET_COMPILEPROFILER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace popart {
+
+class Ir;
+
+// Records the time spent in the stages of the preparation of an Ir and of its
+// Poplar graph: the Transforms, the Pattern passes, the scheduler and the
+// growing of the Opxs. Enabled with SessionOptions::enableCompileProfiling.
+//
+// The stages are written to SessionOptions::logDir, as a Chrome trace
+// (chrome://tracing or https://ui.perfetto.dev) and as a summary table.
+class CompileProfiler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Event {
+    std::string category;
+    std::string name;
+    // Microseconds since the profiler was enabled
+    int64_t start;
+    int64_t duration;
+    // A small integer for each thread which recorded an event
+    int64_t thread;
+    // Shown with the event in the trace, for example the OpId of an Opx
+    std::map<std::string, std::string> args;
+    // The numbers of Ops and Tensors in the Ir before and after the stage, or
+    // -1 if they were not counted
+    int64_t opsBefore{-1};
+    int64_t opsAfter{-1};
+    int64_t tensorsBefore{-1};
+    int64_t tensorsAfter{-1};
+  };
+
+  // Records the time from its construction to its destruction as an event,
+  // if the profiler is enabled. If an Ir is given, the numbers of its Ops
+  // and Tensors are recorded too.
+  class Scope {
+  public:
+    Scope(CompileProfiler &,
+          const std::string &category,
+          const std::string &name,
+          const Ir *ir = nullptr);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    void addArg(const std::string &key, const std::string &value);
+
+  private:
+    CompileProfiler &profiler;
+    const Ir *ir;
+    bool enabled;
+    Clock::time_point start;
+    Event event;
+  };
+
+  // Start recording. The times of the events are relative to this call
+  void enable();
+  bool isEnabled() const { return enabled; }
+
+  // Record a stage which ended now and took the given time. For stages whose
+  // time is accumulated over many calls too short to record one by one, such
+  // as the calls to Pattern::matches(). Does nothing if the profiler is not
+  // enabled
+  void addEvent(const std::string &category,
+                const std::string &name,
+                Clock::duration,
+                const std::map<std::string, std::string> &args = {});
+
+  std::vector<Event> getEvents() const;
+
+  // The events in the Chrome trace event format, as complete ("X") events
+  std::string toChromeTrace() const;
+
+  // A table with a row for each category and name of event, the stage which
+  // took the longest first. The times of stages include those of the stages
+  // nested within them, for example of the schedules computed by a Transform
+  std::string getSummary() const;
+
+  // Write compile_trace.json and compile_summary.txt to the directory,
+  // replacing the files of earlier calls
+  void write(const std::string &directory) const;
+
+private:
+  void addEvent(Event);
+
+  bool enabled{false};
+  Clock::time_point epoch;
+
+  mutable std::mutex mutex;
+  std::vector<Event> events;
+  std::map<std::thread::id, int64_t> threads;
+};
+
+} // namespace popart
+
+#endif
@@ -12,19 +12,21 @@
 namespace popart {
 
 class SGD;
+class Adam;
 
-// Base helper class for scalars composed of other scalars
-class CompoundScalarHelper {
+// Base helper class for scalars composed of other scalars, of an Optimizer of
+// type T
+template <class T> class CompoundScalarHelper {
 
 public:
   CompoundScalarHelper()                             = default;
   virtual ~CompoundScalarHelper()                    = default;
   CompoundScalarHelper(const CompoundScalarHelper &) = default;
 
-  OptimizerValue getFromWeightId(const TensorId &weightId, const SGD &) const;
+  OptimizerValue getFromWeightId(const TensorId &weightId, const T &) const;
 
   OptimizerValue getFromScalarId(const TensorId &compoundScalarId,
-                                 const SGD &) const;
+                                 const T &) const;
 
   // remove specific prefix to obtain the TensorId of the weight
   TensorId getWeightId(const TensorId &compoundScalarId) const;
@@ -32,21 +34,21 @@ public:
   // Does the name of optId match the default or specific prefix
   bool idMatch(const TensorId &optId) const;
 
-  virtual float val(const TensorId &weightId, const SGD &) const    = 0;
-  virtual bool isConst(const TensorId &weightId, const SGD &) const = 0;
+  virtual float val(const TensorId &weightId, const T &) const    = 0;
+  virtual bool isConst(const TensorId &weightId, const T &) const = 0;
 
   // prepend appropriate prefix, which depends on if it is default or specific
-  TensorId getScalarId(const Tensor &weight, const SGD &) const;
+  TensorId getScalarId(const Tensor &weight, const T &) const;
 
   // As above, but returns "" if the OptimizerValue is const
-  TensorId getScalarIdIfNonConst(const Tensor &weight, const SGD &) const;
+  TensorId getScalarIdIfNonConst(const Tensor &weight, const T &) const;
 
 private:
   virtual std::string defaultPrefix() const  = 0;
   virtual std::string specificPrefix() const = 0;
 };
 
-class WeightDecayScaleFactor0Helper : public CompoundScalarHelper {
+class WeightDecayScaleFactor0Helper : public CompoundScalarHelper<SGD> {
 public:
   float val(const TensorId &weightId, const SGD &) const final;
   bool isConst(const TensorId &weightId, const SGD &) const final;
@@ -63,7 +65,7 @@ private:
   }
 };
 
-class ScaledLearningRate0Helper : public CompoundScalarHelper {
+class ScaledLearningRate0Helper : public CompoundScalarHelper<SGD> {
 public:
   float val(const TensorId &weightId, const SGD &) const final;
   bool isConst(const TensorId &weightId, const SGD &) const final;
@@ -80,7 +82,7 @@ private:
   }
 };
 
-class ScaledWeightDecay1Helper : public CompoundScalarHelper {
+class ScaledWeightDecay1Helper : public CompoundScalarHelper<SGD> {
 public:
   float val(const TensorId &weightId, const SGD &) const final;
   bool isConst(const TensorId &weightId, const SGD &) const final;
@@ -97,7 +99,7 @@ private:
   }
 };
 
-class ScaledLearningRate1Helper : public CompoundScalarHelper {
+class ScaledLearningRate1Helper : public CompoundScalarHelper<SGD> {
 public:
   float val(const TensorId &weightId, const SGD &) const final;
   bool isConst(const TensorId &weightId, const SGD &) const final;
@@ -114,7 +116,7 @@ private:
   }
 };
 
-class DampeningScaleFactor1Helper : public CompoundScalarHelper {
+class DampeningScaleFactor1Helper : public CompoundScalarHelper<SGD> {
 public:
   float val(const TensorId &weightId, const SGD &) const final;
   bool isConst(const TensorId &weightId, const SGD &) const final;
@@ -131,7 +133,7 @@ private:
   }
 };
 
-class ScaledMomentum1Helper : public CompoundScalarHelper {
+class ScaledMomentum1Helper : public CompoundScalarHelper<SGD> {
 public:
   float val(const TensorId &weightId, const SGD &) const final;
   bool isConst(const TensorId &weightId, const SGD &) const final;
@@ -146,6 +148,102 @@ private:
   }
 };
 
+// The scalars of the Adam optimizers (see optimizer.hpp). Except for the
+// gradient scale, they are the atomic scalars, sent to the device unchanged.
+
+class AdamLearningRateHelper : public CompoundScalarHelper<Adam> {
+public:
+  float val(const TensorId &weightId, const Adam &) const final;
+  bool isConst(const TensorId &weightId, const Adam &) const final;
+
+private:
+  std::string defaultPrefix() const final {
+    return reservedDefaultAdamLearningRatePrefix();
+  }
+  std::string specificPrefix() const final {
+    return reservedSpecificAdamLearningRatePrefix();
+  }
+};
+
+class AdamWeightDecayHelper : public CompoundScalarHelper<Adam> {
+public:
+  float val(const TensorId &weightId, const Adam &) const final;
+  bool isConst(const TensorId &weightId, const Adam &) const final;
+
+private:
+  std::string defaultPrefix() const final {
+    return reservedDefaultAdamWeightDecayPrefix();
+  }
+  std::string specificPrefix() const final {
+    return reservedSpecificAdamWeightDecayPrefix();
+  }
+};
+
+class AdamBeta1Helper : public CompoundScalarHelper<Adam> {
+public:
+  float val(const TensorId &weightId, const Adam &) const final;
+  bool isConst(const TensorId &weightId, const Adam &) const final;
+
+private:
+  std::string defaultPrefix() const final {
+    return reservedDefaultAdamBeta1Prefix();
+  }
+  std::string specificPrefix() const final {
+    return reservedSpecificAdamBeta1Prefix();
+  }
+};
+
+class AdamBeta2Helper : public CompoundScalarHelper<Adam> {
+public:
+  float val(const TensorId &weightId, const Adam &) const final;
+  bool isConst(const TensorId &weightId, const Adam &) const final;
+
+private:
+  std::string defaultPrefix() const final {
+    return reservedDefaultAdamBeta2Prefix();
+  }
+  std::string specificPrefix() const final {
+    return reservedSpecificAdamBeta2Prefix();
+  }
+};
+
+class AdamEpsHelper : public CompoundScalarHelper<Adam> {
+public:
+  float val(const TensorId &weightId, const Adam &) const final;
+  bool isConst(const TensorId &weightId, const Adam &) const final;
+
+private:
+  std::string defaultPrefix() const final {
+    return reservedDefaultAdamEpsPrefix();
+  }
+  std::string specificPrefix() const final {
+    return reservedSpecificAdamEpsPrefix();
+  }
+};
+
+// The scale of the gradient, 1 / (ls * rf), with ls the loss scaling and rf
+// the replication factor. The reductions sum the gradients of the replicas,
+// so dividing by rf averages them over the replicas. It deliberately does not
+// divide by the accumulation factor: the gradients of the accumulation steps
+// are summed, as the loss of a step is the sum of the losses of its micro
+// batches.
+class AdamGradientScaleHelper : public CompoundScalarHelper<Adam> {
+public:
+  float val(const TensorId &weightId, const Adam &) const final;
+  bool isConst(const TensorId &weightId, const Adam &) const final;
+  float val(float ls, int64_t rf) const {
+    return 1.0f / (ls * static_cast<float>(rf));
+  }
+
+private:
+  std::string defaultPrefix() const final {
+    return reservedDefaultAdamGradientScalePrefix();
+  }
+  std::string specificPrefix() const final {
+    return reservedSpecificAdamGradientScalePrefix();
+  }
+};
+
 } // namespace popart
 
 #endif
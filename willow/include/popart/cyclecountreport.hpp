@@ -0,0 +1,57 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_CYCLECOUNTREPORT_HPP
+#define GUARD_NEURALNET_CYCLECOUNTREPORT_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <popart/names.hpp>
+
+namespace popart {
+
+// The hardware cycle counts of the Ops and pipeline stages instrumented with
+// Instrumentation::Op and Instrumentation::Stage, in the last run of the main
+// program. Each count is the total over all executions in the run, for
+// example over all batches per step.
+//
+// An Op of a subgraph is counted once, over all of the call sites of the
+// subgraph. The cycles of each call site are those of its CallOp.
+class CycleCountReport {
+public:
+  struct OpEntry {
+    OpId opId;
+    // The id of the Graph of the Op, empty for the main Graph
+    std::string graphId;
+    std::string opType;
+    std::string debugName;
+    uint64_t cycles;
+    uint64_t executions;
+  };
+
+  struct PipelineStageEntry {
+    PipelineStage pipelineStage;
+    uint64_t cycles;
+    uint64_t executions;
+  };
+
+  // The instrumented Ops, the Op with the most cycles first
+  std::vector<OpEntry> ops;
+
+  // The instrumented pipeline stages, in order
+  std::vector<PipelineStageEntry> pipelineStages;
+
+  // The total cycles of the Ops of each type, the type with the most cycles
+  // first
+  std::vector<std::pair<std::string, uint64_t>> cyclesPerOpType() const;
+
+  // The report as a JSON object with the members "ops" and "pipelineStages"
+  std::string toJson() const;
+};
+
+// A table of the report, the Ops with the most cycles first
+std::ostream &operator<<(std::ostream &, const CycleCountReport &);
+
+} // namespace popart
+
+#endif
@@ -0,0 +1,171 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_DATALOADERSTEPIO_HPP
+#define GUARD_NEURALNET_DATALOADERSTEPIO_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <popart/istepio.hpp>
+#include <popart/names.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/threadpool.hpp>
+#include <popart/voiddata.hpp>
+
+namespace popart {
+
+class MappedRegion;
+
+// Input samples read from record files, one file per input. A file is either
+// an NPY file (little endian, C order) whose first dimension indexes the
+// records and whose other dimensions are the shape of a sample, or a flat
+// file of raw records, for which the type and shape of a sample must be
+// given. All files must hold the same number of records. The files are
+// memory mapped, so any number of threads may read records at once.
+class RecordFiles {
+public:
+  // Files ending in ".npy" are read as NPY files, any others as raw files
+  // with the sample info given for them in `rawInfos'.
+  RecordFiles(const std::map<TensorId, std::string> &files,
+              const std::map<TensorId, TensorInfo> &rawInfos = {});
+  ~RecordFiles();
+
+  RecordFiles(const RecordFiles &) = delete;
+  RecordFiles &operator=(const RecordFiles &) = delete;
+
+  int64_t numRecords() const { return nRecords; }
+
+  // The type and shape of one record of each input
+  std::map<TensorId, TensorInfo> sampleInfos() const;
+
+  // Copy record `index' (modulo numRecords(), so that the records are read
+  // again for each epoch) of every input into `buffers'.
+  void read(int64_t index,
+            const std::map<TensorId, MutableVoidData> &buffers) const;
+
+private:
+  struct File {
+    TensorInfo info;
+    std::unique_ptr<MappedRegion> region;
+    // The offset of the first record in region
+    int64_t dataOffset;
+  };
+
+  std::map<TensorId, File> files;
+  int64_t nRecords{0};
+};
+
+// An IStepIO whose inputs are produced ahead of the device by a pool of
+// worker threads, so that reading a stream never waits on the thread running
+// the step (or on Python). Each input has a ring buffer of `queueDepth'
+// samples, where a sample is the data of one call to in(), that is the data
+// of the input's tensor for one replica and one micro batch.
+//
+// Samples are produced in order by the workers, each worker filling every
+// input of a sample at once, so inputs stay in step with each other. A slot
+// of the ring buffers is reused once every input has completed the sample
+// it holds.
+//
+// Anchors, if any, are written to buffers holding the data of a whole step,
+// as with StepIO. A DataLoaderStepIO with no anchors may be used with
+// Session::runAsync, which provides its own.
+class DataLoaderStepIO : public IStepIO {
+public:
+  // Write sample `index' of each input to its buffer. Called concurrently
+  // from the workers, for different samples.
+  using Producer =
+      std::function<void(int64_t index,
+                         const std::map<TensorId, MutableVoidData> &buffers)>;
+
+  // Produce `numSamples' samples (without limit if negative) of `inputs',
+  // each of the type and shape given, with `producer'. `queueDepth' must be
+  // at least 2, so that a stream can prefetch a sample while the previous
+  // one is still in use by the other streams.
+  DataLoaderStepIO(std::map<TensorId, TensorInfo> inputs,
+                   Producer producer,
+                   int64_t numSamples,
+                   std::map<TensorId, MutableVoidData> outputs = {},
+                   unsigned numWorkers                         = 4,
+                   unsigned queueDepth                         = 64);
+
+  // Produce `numSamples' samples of the records in `files'. The records are
+  // read again from the start once they are exhausted.
+  DataLoaderStepIO(std::shared_ptr<const RecordFiles> files,
+                   int64_t numSamples,
+                   std::map<TensorId, MutableVoidData> outputs = {},
+                   unsigned numWorkers                         = 4,
+                   unsigned queueDepth                         = 64);
+
+  // Stops the workers, once they have finished the samples in progress
+  ~DataLoaderStepIO() override;
+
+  DataLoaderStepIO(const DataLoaderStepIO &) = delete;
+  DataLoaderStepIO &operator=(const DataLoaderStepIO &) = delete;
+
+  // Block until the next sample of `id' has been produced, unless
+  // prefetching, in which case no data is returned if it is not ready yet.
+  // Errors thrown by the producer are rethrown here.
+  ConstVoidData in(TensorId id, int64_t numElements, bool prefetch) final;
+  void inComplete(TensorId id, int64_t numElements) final;
+
+  MutableVoidData out(TensorId id, int64_t numElements) final;
+
+  // Also checks that every input is a data stream of the Ir, as the samples
+  // of an input which is never read are never completed
+  void assertNumElements(const Ir &) const final;
+
+  // The number of samples every input has completed
+  int64_t numSamplesCompleted() const;
+
+private:
+  struct Input {
+    TensorInfo info;
+    // queueDepth samples of info
+    std::vector<char> ring;
+    // The next sample to be read
+    int64_t cursor{0};
+  };
+
+  struct Slot {
+    // The sample held, or -1 if none
+    int64_t index{-1};
+    bool ready{false};
+    std::exception_ptr error;
+  };
+
+  struct Output {
+    MutableVoidData data;
+    // Where the next write of the step goes, in bytes
+    int64_t offset;
+  };
+
+  void workerLoop();
+  int64_t minCursor() const;
+
+  std::map<TensorId, Input> inputs;
+  std::map<TensorId, Output> outputs;
+  Producer producer;
+  int64_t numSamples;
+  std::vector<Slot> slots;
+
+  // Guards inputs' cursors, slots, nextSample and stopping
+  mutable std::mutex mutex;
+  // Notified when a sample is produced or a slot is freed
+  std::condition_variable condition;
+  int64_t nextSample{0};
+  bool stopping{false};
+
+  // Declared last, so that the workers are joined before anything they use
+  // is destroyed
+  ThreadPool workers;
+};
+
+} // namespace popart
+
+#endif
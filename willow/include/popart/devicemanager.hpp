@@ -249,19 +249,9 @@ std::ostream &operator<<(std::ostream &os, const DeviceConnectionType &dct);
 
 namespace std {
 template <> struct hash<popart::DeviceInfo> {
-  std::size_t operator()(const popart::DeviceInfo &di) const {
-    // Hash based on all the DeviceManager attributes that
-    // can affect compiled program
-
-    std::stringstream ss;
-    ss << di.getType() << di.getConnectionType();
-
-    return std::hash<std::string>()(ss.str()) ^
-           std::hash<std::string>()(di.getVersion()) ^
-           std::hash<int>()(di.getNumIpus()) ^
-           std::hash<int>()(di.getTilesPerIpu()) ^
-           std::hash<int>()(di.getNumWorkerContexts());
-  }
+  // Hash based on all the DeviceManager attributes that
+  // can affect compiled program
+  std::size_t operator()(const popart::DeviceInfo &di) const;
 };
 }; // namespace std
 
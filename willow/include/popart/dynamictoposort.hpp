@@ -0,0 +1,86 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_DYNAMICTOPOSORT_HPP
+#define GUARD_NEURALNET_DYNAMICTOPOSORT_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace popart {
+
+// A directed acyclic graph which maintains a topological order of its nodes
+// as edges are inserted, using the algorithm of Pearce and Kelly ("A Dynamic
+// Topological Sort Algorithm for Directed Acyclic Graphs", 2006).
+//
+// Inserting an edge which agrees with the current order is O(1). Otherwise
+// only the nodes whose position lies between the edge's endpoints are
+// visited, so checking whether a few new edges would create a cycle is much
+// cheaper than re-sorting the whole graph.
+class DynamicTopoSort {
+public:
+  using Node = uint32_t;
+  using Edge = std::pair<Node, Node>;
+
+  // Add a node with no edges, placed last in the order.
+  Node insertNode();
+
+  uint64_t nNodes() const { return ord.size(); }
+
+  // Insert the edges `from -> to', unless doing so would create a cycle.
+  // Returns true if the edges were inserted. If any edge would create a cycle
+  // (taking into account the other edges in `edges'), none of them are
+  // inserted and false is returned.
+  bool tryInsertEdges(const std::vector<Edge> &edges);
+
+  // Insert the edge `from -> to'. Equivalent to tryInsertEdges({{from, to}})
+  bool tryInsertEdge(Node from, Node to);
+
+  // The position of `node' in the current topological order. Positions are
+  // unique but not necessarily contiguous.
+  int64_t position(Node node) const { return ord.at(node); }
+
+  // Return true if there is a path from `from' to `to'.
+  bool reaches(Node from, Node to) const;
+
+private:
+  // Insert one edge, recording any changes in `undoLog'. Returns false, with
+  // no changes made, if the edge would create a cycle.
+  bool insertEdge(Node from, Node to);
+
+  // Depth first searches bounded by position, collecting the visited nodes
+  // in `visited'. The forward search returns false if it reaches `stop'.
+  bool searchForward(Node start, int64_t upper, Node stop);
+  void searchBackward(Node start, int64_t lower);
+
+  // Reassign the positions of the nodes collected by the searches, so that
+  // the backward set is ordered before the forward set.
+  void reorder();
+
+  // Revert the changes in undoLog
+  void undo();
+
+  std::vector<int64_t> ord;
+  int64_t nextOrd{0};
+  std::vector<std::vector<Node>> outs;
+  std::vector<std::vector<Node>> ins;
+
+  // Scratch space for the searches
+  std::vector<bool> marked;
+  std::vector<Node> forwardSet;
+  std::vector<Node> backwardSet;
+  std::vector<Node> stack;
+
+  // Changes made by tryInsertEdges, so that they can be reverted. An entry
+  // is either an inserted edge, or the previous position of a node.
+  struct UndoEntry {
+    bool isEdge;
+    Node node;
+    Node to;
+    int64_t oldOrd;
+  };
+  std::vector<UndoEntry> undoLog;
+};
+
+} // namespace popart
+
+#endif
@@ -0,0 +1,74 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_ENGINECACHE_HPP
+#define GUARD_NEURALNET_ENGINECACHE_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace popart {
+
+// A directory of cached executables, shared by all the sessions with the same
+// SessionOptions::cachePath. Each entry is a pair of files named by its key,
+// which is the hash of the IrBundle the executable was compiled from:
+//
+//   <key>.popart : the hashes of the IrBundle and of the prepared Ir
+//   <key>.poplar : the serialized poplar::Executable
+//
+// Entries are written to temporary files which are then renamed, the
+// .popart file last, so that processes sharing the directory never see a
+// partially written entry. The modification time of the .popart file is the
+// time the entry was last used, and the least recently used entries are
+// evicted by prune. Failures to read or write the directory are logged, but
+// are not errors.
+class EngineCache {
+public:
+  struct Entry {
+    std::string key;
+    // The total size of the files of the entry
+    std::uintmax_t bytes;
+    std::time_t lastUsed;
+  };
+
+  explicit EngineCache(const std::string &directory);
+
+  const std::string &getDirectory() const { return directory; }
+
+  static std::string getKey(std::size_t irBundleHash);
+
+  std::string getPopartPath(const std::string &key) const;
+  std::string getPoplarPath(const std::string &key) const;
+
+  // All complete entries, the most recently used first
+  std::vector<Entry> list() const;
+
+  // The total size of all entries
+  std::uintmax_t size() const;
+
+  // Write the entry `key', replacing any existing entry with that key. The
+  // files are written by the functions. Returns true if successful
+  bool store(const std::string &key,
+             const std::function<void(std::ostream &)> &writePoplar,
+             const std::function<void(std::ostream &)> &writePopart) const;
+
+  // Mark the entry `key' as used now
+  void touch(const std::string &key) const;
+
+  // Remove the entry `key'. Returns true if it existed
+  bool remove(const std::string &key) const;
+
+  // Evict the least recently used entries until the total size is at most
+  // maxBytes, and remove the temporary files and the files of incomplete
+  // entries left by failed writes. Returns the number of entries evicted
+  int64_t prune(std::uintmax_t maxBytes) const;
+
+private:
+  std::string directory;
+};
+
+} // namespace popart
+
+#endif
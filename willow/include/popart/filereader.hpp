@@ -3,8 +3,11 @@
 #define GUARD_NEURALNET_FILEREADER_HPP
 
 #include <onnx/onnx_pb.h>
+#include <functional>
+#include <map>
 #include <sstream>
 #include <popart/names.hpp>
+#include <popart/voiddata.hpp>
 
 namespace popart {
 namespace io {
@@ -35,6 +38,23 @@ ONNX_NAMESPACE::ModelProto getModelFromString(const std::string &modelProto);
 void writeModel(const ONNX_NAMESPACE::ModelProto &model,
                 const std::string &filename);
 
+// serialize a ModelProto to a binary protobuf file, taking the data of the
+// initializers named in `weights' from the buffers they map to, rather than
+// from the model. The data is written straight from the buffers (converted to
+// the type of the initializer where they differ), a chunk at a time, so
+// neither the model nor the serialized model is copied into memory. Weights
+// which are not initializers of the model are appended to its initializers.
+// Initializers in `weights' must not be stored externally.
+void writeModel(const ONNX_NAMESPACE::ModelProto &model,
+                const std::map<TensorId, ConstVoidData> &weights,
+                const std::string &filename);
+
+// Call write(chunk, nbytes) on consecutive chunks of the data of `src',
+// converted to dstType. The chunks are no larger than a few MB.
+void forEachDataChunk(const ConstVoidData &src,
+                      DataType dstType,
+                      const std::function<void(const char *, int64_t)> &write);
+
 // getNode function from previous versions has been removed
 
 // load TensorProto
@@ -18,12 +18,26 @@ namespace popart {
 
 class BackwardPassCreator;
 
+// Counters of the schedules and live sets of a Graph which were returned from
+// its memo, and of those which had to be computed
+struct ScheduleMemoCounters {
+  int64_t scheduleHits{0};
+  int64_t scheduleMisses{0};
+  int64_t liveSetsHits{0};
+  int64_t liveSetsMisses{0};
+  // The time it took to compute the results which were later returned from
+  // the memo, summed over the hits
+  double secondsSaved{0.0};
+};
+
 class Graph {
   friend class BackwardPassCreator;
 
 public:
   Graph(Ir &, const GraphId &);
 
+  ~Graph();
+
   Graph()              = delete;
   Graph(const Graph &) = delete;
 
@@ -87,6 +101,10 @@ public:
   // with additional constrains imposed through the input paramater.
   // Ops which are ready to be inserted have an insertion "priority",
   // set elsewhere.
+  //
+  // Schedules are memoized until the mutation epoch of the Graph, or the
+  // scheduling settings (priority, ping-pong phase, pipeline stage or
+  // batch-serialized phase) of one of its Ops, changes.
   std::vector<Op *> getOpSchedule(const OpsBeforeKey &) const;
 
   // Do all the Ops with all their dependencies form a DAG?
@@ -106,9 +124,18 @@ public:
   // Note : if topoOps is just the forward pass, the grad-op
   // consumers of a tensor do not appear in "ops". This agrees
   // with the definition.
+  //
+  // Live sets are memoized until the mutation epoch of the Graph changes.
   std::vector<std::set<Op *>>
   getLiveSets(const std::vector<Op *> &topoOps) const;
 
+  // A counter which is incremented by every change to the Ops, Tensors,
+  // producers, consumers or topological constraints of the Graph
+  uint64_t getMutationEpoch() const;
+  void incrementMutationEpoch() { ++mutationEpoch; }
+
+  const ScheduleMemoCounters &getScheduleMemoCounters() const;
+
   const std::vector<TensorId> &getInputIds() const { return graph_inputs; }
   void addInput(const TensorId &, const TensorInfo &);
   // Mark an existing tensor as a graph input.
@@ -154,6 +181,10 @@ private:
   std::unique_ptr<Scheduler> scheduler;
   std::vector<GradInOutMapper> gradInInfo;
 
+  class ScheduleMemo;
+  std::unique_ptr<ScheduleMemo> scheduleMemo;
+  uint64_t mutationEpoch{0};
+
   Ir &ir;
   TensorId loss;
 
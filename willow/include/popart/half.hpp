@@ -2,16 +2,21 @@
 #ifndef GUARD_NEURALNET_HALF_HPP
 #define GUARD_NEURALNET_HALF_HPP
 #include <cstdint>
+#include <ostream>
+#include <type_traits>
+#include <vector>
 
 namespace popart {
 
+// An IEEE half precision value. Converting one value at a time is slow; use
+// the bulk conversions below for buffers of values.
 class Half {
 
 public:
   Half();
-  ~Half();
+  ~Half() = default;
 
-  Half(const Half &other);
+  Half(const Half &other) = default;
   Half(float f);
 
   // Catch all arithmetic types and handle the explicit cast to float
@@ -20,7 +25,7 @@ public:
       typename = typename std::enable_if<std::is_arithmetic<T>::value, T>::type>
   explicit Half(T f) : Half(static_cast<float>(f)) {}
 
-  Half &operator=(const Half &rhs);
+  Half &operator=(const Half &rhs) = default;
   Half &operator=(const float rhs);
 
   bool operator==(const Half &rhs);
@@ -36,6 +41,22 @@ private:
 
 using float16_t = Half;
 
+// A Half has the layout of its bit pattern, so buffers of Half can be used as
+// buffers of FLOAT16 data
+static_assert(sizeof(Half) == sizeof(uint16_t) &&
+                  std::is_trivially_copyable<Half>::value,
+              "Half must be layout compatible with uint16_t");
+
+// Bulk conversions between Half and float. Conversions to Half round to
+// nearest, ties to even, as a single conversion does. These use F16C
+// instructions where the host supports them (otherwise a scalar fallback),
+// and split large buffers across ThreadPool::global(). The buffers must not
+// overlap.
+void halfToFloat(const Half *src, float *dst, int64_t nelms);
+void floatToHalf(const float *src, Half *dst, int64_t nelms);
+std::vector<float> halfToFloat(const std::vector<Half> &src);
+std::vector<Half> floatToHalf(const std::vector<float> &src);
+
 std::ostream &operator<<(std::ostream &ss, const Half &v);
 
 } // namespace popart
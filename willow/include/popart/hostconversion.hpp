@@ -0,0 +1,44 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_HOSTCONVERSION_HPP
+#define GUARD_NEURALNET_HOSTCONVERSION_HPP
+
+#include <cstdint>
+
+#include <popart/tensorinfo.hpp>
+
+namespace popart {
+namespace hostconversion {
+
+// Element type conversions of host buffers, used where user provided data
+// does not have the type of the corresponding Tensor (stream callbacks,
+// weight upload and download).
+//
+// Conversions to FLOAT16 round to nearest, ties to even. Narrowing integer
+// conversions truncate, as static_cast does. Where supported by the host CPU,
+// the kernels use F16C / AVX2 instructions, chosen at runtime. Large buffers
+// are split across ThreadPool::global().
+
+// Return true if convert(src, ..., dst, ...) is supported. Conversion between
+// identical types is always supported, and is a copy.
+bool canConvert(DataType src, DataType dst);
+
+// Convert nelms elements at `src', of type srcType, to dstType, writing them
+// to `dst'. The buffers must not overlap. Throws an error if the conversion is
+// not supported.
+void convert(DataType srcType,
+             const void *src,
+             DataType dstType,
+             void *dst,
+             int64_t nelms);
+
+// Single threaded conversions between IEEE half (as its bit pattern) and
+// float, for small buffers and scalars.
+uint16_t floatToHalf(float f);
+float halfToFloat(uint16_t h);
+void floatToHalf(const float *src, uint16_t *dst, int64_t nelms);
+void halfToFloat(const uint16_t *src, float *dst, int64_t nelms);
+
+} // namespace hostconversion
+} // namespace popart
+
+#endif
@@ -0,0 +1,103 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_HOSTREDUCEENGINE_HPP
+#define GUARD_NEURALNET_HOSTREDUCEENGINE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <popart/names.hpp>
+#include <popart/tensorinfo.hpp>
+
+namespace popart {
+
+class ThreadPool;
+
+// Sums the gradients streamed to the host by the replicas of a
+// hostAllReduce session, and returns the sums to the device.
+//
+// Each gradient has preallocated buffers, one per replica, which receive()
+// copies a replica's stream data into. When the last replica of a gradient
+// has been received, the gradient is split into buckets of at most
+// bucketBytes, and the buckets are summed concurrently on the ThreadPool. So
+// the reduction of one gradient overlaps the copies of the following ones.
+// send() waits for the reduction of a gradient and copies the sum out.
+//
+// FLOAT gradients are summed in FLOAT. FLOAT16 gradients are summed in FLOAT,
+// and rounded to FLOAT16 once, when all replicas have been added.
+//
+// receive() and send() may be called concurrently, for different gradients.
+// For each gradient, every replica must be received before send() is called,
+// and the next step's receive() calls must follow send().
+class HostReduceEngine {
+public:
+  HostReduceEngine(unsigned nReplicas, int64_t bucketBytes, ThreadPool &pool);
+  ~HostReduceEngine();
+
+  HostReduceEngine(const HostReduceEngine &) = delete;
+  HostReduceEngine &operator=(const HostReduceEngine &) = delete;
+
+  // Allocate the buffers of a gradient. Only the first nContributions
+  // replicas are summed, the data received from other replicas is ignored. An
+  // nContributions of 1 is for gradients which are already reduced on the
+  // device, whose sum is the data of replica 0. All gradients must be added
+  // before the first call to receive().
+  void addGradient(const TensorId &,
+                   const TensorInfo &,
+                   unsigned nContributions);
+
+  // Copy the gradient data of `replica' from `src'. The size of src must be
+  // the size of the gradient.
+  void receive(const TensorId &, unsigned replica, const void *src);
+
+  // Wait for the reduction of the gradient, and copy it to `dst'. Rethrows
+  // any error from the reduction.
+  void send(const TensorId &, void *dst);
+
+  unsigned getNumReplicas() const { return nReplicas; }
+  int64_t getBucketBytes() const { return bucketBytes; }
+  bool hasGradient(const TensorId &id) const;
+
+  // The number of bytes received, summed over replicas, since construction
+  int64_t getBytesReceived() const;
+
+private:
+  struct Gradient;
+
+  Gradient &getGradient(const TensorId &);
+  void startReduction(Gradient &);
+
+  const unsigned nReplicas;
+  const int64_t bucketBytes;
+  ThreadPool &pool;
+
+  std::map<TensorId, std::unique_ptr<Gradient>> gradients;
+  std::atomic<int64_t> bytesReceived{0};
+};
+
+namespace hostreduce {
+
+// The reduction kernels. Sum the nelms elements of each of the nSrcs buffers
+// in `srcs', writing the sum to `dst'. dst may be one of the srcs. Where
+// supported by the host CPU, AVX and F16C instructions are used, chosen at
+// runtime.
+void sumFloat(const float *const *srcs,
+              unsigned nSrcs,
+              float *dst,
+              int64_t nelms);
+
+// FLOAT16 data, as its bit pattern, accumulated in FLOAT
+void sumHalf(const uint16_t *const *srcs,
+             unsigned nSrcs,
+             uint16_t *dst,
+             int64_t nelms);
+
+} // namespace hostreduce
+
+} // namespace popart
+
+#endif
@@ -6,6 +6,7 @@
 #include <memory>
 #include <set>
 
+#include <popart/compileprofiler.hpp>
 #include <popart/dataflow.hpp>
 #include <popart/devicemanager.hpp>
 #include <popart/inputshapeinfo.hpp>
@@ -13,6 +14,7 @@
 #include <popart/opidentifier.hpp>
 #include <popart/patterns/patterns.hpp>
 #include <popart/sessionoptions.hpp>
+#include <popart/tensoridinterner.hpp>
 #include <popart/tensorindex.hpp>
 #include <popart/transforms/transform.hpp>
 
@@ -183,6 +185,24 @@ public:
   // Prepare the IR based on the IrBundle configuration
   void prepare(const IrBundle &);
 
+  // The engine cache stores the prepared Ir with the poplar::Executable, so
+  // that a later session with an equal IrBundle hash need not prepare it.
+  //
+  // Only the Tensors which Devicex connects to host streams are stored: the
+  // Variables (with the data of those which are not initializers of the
+  // model), the Streams and the anchors. The Ops are not, so a restored Ir can
+  // only be run with the cached executable, it cannot grow a Poplar graph.
+  //
+  // Irs with remote buffers, host reductions or hardware cycle counters, which
+  // Devicex connects to state created while growing the graph, are not stored
+  bool canSerializePrepared() const;
+  void serializePrepared(std::ostream &) const;
+
+  // Restore an Ir written by serializePrepared, from an IrBundle with the same
+  // hash. Returns false, with the Ir unchanged, if the record cannot be read
+  bool prepareFromSerialized(const IrBundle &, std::istream &);
+  bool isPreparedFromSerialized() const { return preparedFromSerialized; }
+
   // Reset the weights with data from an ONNX model
   void resetWeights(
       const ONNX_NAMESPACE::ModelProto &modelProto,
@@ -259,14 +279,30 @@ public:
 
   const SessionOptions &getSessionOptions() const { return userOptions; }
 
+  // The hash of the IrBundle this Ir was prepared from, see
+  // std::hash<IrBundle>. It is only computed if engine caching is enabled,
+  // and is 0 otherwise
+  std::size_t getIrBundleHash() const { return irBundleHash; }
+
   std::vector<TensorId> getTensorIds(TensorType) const;
   Tensor *getTensor(const TensorId &) const;
+  Tensor *getTensor(TensorHandle) const;
   bool containsTensor(const TensorId &) const;
+  bool containsTensor(TensorHandle) const;
   std::vector<TensorId> getGraphInputIds() const;
 
   const Graph &getMainGraph() const;
   Graph &getMainGraph();
 
+  // The table of the TensorIds of all Graphs. Interning a TensorId does not
+  // change the Ir, so the table may be used through a const Ir
+  TensorIdInterner &getTensorIdInterner() const { return tensorIdInterner; }
+
+  // The times of the stages of the preparation of the Ir and of its Poplar
+  // graph. Recording an event does not change the Ir, so the profiler may be
+  // used through a const Ir
+  CompileProfiler &getCompileProfiler() const { return compileProfiler; }
+
   // Returns all graphs in `graphs' in an unscheduled order
   std::vector<const Graph *> getAllGraphs() const;
 
@@ -346,6 +382,7 @@ public:
   // For all vertices set the phase, and whether or not
   // there is a path to vertex in whose phase is BWD.
   void updateVertices();
+  // Bring the aliases of all Graphs up to date, see Tensors::updateAliases
   void updateAliases();
 
   // Ensure that all virtual graph IDs are not set.
@@ -356,6 +393,11 @@ public:
   // modify the Ir using all the registered pre-alias patterns
   void applyPreAliasPatterns(Graph &);
 
+  // Can the pattern be applied at op? It must match op, op must not be
+  // excluded from it, and it must not touch an anchor (or, before the final
+  // loss is constructed, the loss)
+  bool canApplyPreAliasPattern(const PreAliasPattern *, Op *op) const;
+
   void applyUpdateInplacePrioritiesForIpu();
 
   void applyInplacePattern(Graph &);
@@ -498,6 +540,11 @@ private:
   // create an Op from a Node
   std::unique_ptr<Op> addOp(const Node &, const Scope &);
 
+  // Declared before graphs, so that it outlives their Tensors
+  mutable TensorIdInterner tensorIdInterner;
+
+  mutable CompileProfiler compileProfiler;
+
   std::map<GraphId, std::unique_ptr<Graph>> graphs;
 
   // total number of ops ever created
@@ -516,8 +563,11 @@ private:
 
   ExecutionMode executionMode = ExecutionMode::Training;
 
-  bool pingPongPhasesReady = false;
-  bool isPrepared          = false;
+  bool pingPongPhasesReady    = false;
+  bool isPrepared             = false;
+  bool preparedFromSerialized = false;
+
+  std::size_t irBundleHash{0};
 
   // enable/disable a transform stage
   void enableTransform(std::size_t transformId, bool enable);
@@ -567,6 +617,15 @@ template <> struct hash<popart::Ir> {
            std::hash<popart::SessionOptions>{}(ir.getSessionOptions());
   }
 };
+
+// Hash based on the inputs to Ir::prepare, so that it can be computed before
+// the Ir is prepared. Equal Irs are prepared from IrBundles with equal hashes
+// (with the same version of PopART). It is the key of the engine cache, which
+// restores the prepared Ir of an entry rather than preparing it again, see
+// Ir::prepareFromSerialized
+template <> struct hash<popart::IrBundle> {
+  std::size_t operator()(const popart::IrBundle &bundle) const;
+};
 }; // namespace std
 
 #endif
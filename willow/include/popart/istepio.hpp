@@ -15,6 +15,15 @@ public:
   virtual ConstVoidData in(TensorId id, int64_t numElements, bool prefetch) = 0;
   virtual void inComplete(TensorId id, int64_t numElements)                 = 0;
 
+  // Optional zero-copy input data. Return a buffer holding the data for every
+  // call to `in` for tensor `id` during one step, laid out contiguously in the
+  // order `in` would return it. If the buffer has the expected type and
+  // alignment the host->device stream is connected directly to it, and
+  // neither `in` nor `inComplete` are called for `id`. The buffer must stay
+  // valid and unmodified until the step has completed. Returning no data
+  // (the default) selects the copying callbacks.
+  virtual ConstVoidData inZeroCopy(TensorId, int64_t) { return {}; }
+
   // non-const anchor data,
   // which will be modified inplace.
   virtual MutableVoidData out(TensorId id, int64_t numElements) = 0;
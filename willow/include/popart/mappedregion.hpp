@@ -0,0 +1,48 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_MAPPEDREGION_HPP
+#define GUARD_NEURALNET_MAPPEDREGION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace popart {
+
+// A private, copy-on-write memory mapping of a region of a file. The pages
+// are read from the file when first touched, and are only copied into
+// process memory when written to, so the file is never modified through the
+// mapping and writes are not seen by other mappings of the file.
+//
+// The file must not be truncated while it is mapped. A file which is
+// replaced (written to a new file, then renamed) may be, as the mapping
+// keeps the original file alive.
+class MappedRegion {
+public:
+  // Map `length' bytes of the file at `path', starting at byte `offset'
+  MappedRegion(const std::string &path, int64_t offset, int64_t length);
+  ~MappedRegion();
+
+  MappedRegion(const MappedRegion &) = delete;
+  MappedRegion &operator=(const MappedRegion &) = delete;
+
+  char *data() { return data_; }
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+  // True unless disabled by setting the environment variable
+  // POPART_MMAP_EXTERNAL_DATA to 0, in which case externally stored tensor
+  // data is copied into memory when it is loaded.
+  static bool enabled();
+
+private:
+  // The mapping, which starts at the page containing data_
+  void *base{nullptr};
+  std::size_t baseSize{0};
+
+  char *data_{nullptr};
+  std::size_t size_{0};
+};
+
+} // namespace popart
+
+#endif
@@ -4,6 +4,7 @@
 
 // TODO T7106 : determine what the cost of including these
 // in every compilation unit is, consider moving to another header
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <vector>
@@ -41,6 +42,10 @@ using OpType       = std::string;
 using OpVersion    = unsigned;
 using OpId         = int;
 using ReturnPeriod = int;
+// A TensorId interned in the TensorIdInterner of an Ir
+using TensorHandle = uint32_t;
+// Never given to a TensorId
+static constexpr const TensorHandle unusedTensorHandle = UINT32_MAX;
 // The position at which a Tensor is consumed by an Op
 using InIndex = int;
 // The position at which a Tensor is output by an Op
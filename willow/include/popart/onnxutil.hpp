@@ -12,8 +12,8 @@ namespace onnxutil {
 class ExternalTensorProtoInfo {
 public:
   std::string location = "";
-  int offset           = 0;
-  int length           = 0;
+  int64_t offset       = 0;
+  int64_t length       = 0;
 
   ExternalTensorProtoInfo(const ONNX_NAMESPACE::TensorProto &tp);
 };
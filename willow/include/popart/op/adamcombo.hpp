@@ -0,0 +1,74 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_ADAMCOMBOOP_HPP
+#define GUARD_NEURALNET_ADAMCOMBOOP_HPP
+
+#include <popart/op/varupdate.hpp>
+#include <popart/optimizer.hpp>
+#include <popart/optimizervalue.hpp>
+
+namespace popart {
+
+// The Op generated for each Variable Tensor updated by an Adam Optimizer (of
+// any AdamMode). The "Combo" in the name signfies that this Op will be
+// decomposed into smaller Ops, by the AdamDecompose pattern : (1) an optional
+// ReplicatedAllReduceOp of the gradient, (2) an AccumulateOp and
+// ReplicatedAllReduceInplaceOp if there is gradient accumulation and (3) an
+// AdamVarUpdateOp. See optimizer.hpp for the equations.
+
+class AdamComboOp : public VarUpdateWithUpdaterOp {
+public:
+  AdamComboOp(const TensorId &varToUpdate,
+              AdamMode mode_,
+              OptimizerValue initialLr,
+              OptimizerValue initialWd,
+              OptimizerValue initialB1,
+              OptimizerValue initialB2,
+              OptimizerValue initialEps,
+              OptimizerValue initialGs,
+              OptimizerReductionType reductionType_,
+              const Op::Settings &);
+
+  std::unique_ptr<Op> clone() const final;
+  std::unique_ptr<Op> cloneWithNewName(const TensorId &newName) const final;
+
+  // map of size 0-6, containing all non-const optimizer Tensors for this Op
+  std::map<InIndex, TensorId> optimizerInputs() const final;
+
+  void appendOutlineAttributes(OpSerialiserBase &) const final;
+
+  const AdamMode mode;
+
+  // learning rate
+  const OptimizerValue initLr;
+
+  // weight decay
+  const OptimizerValue initWd;
+
+  // decay rates of the first and second moments
+  const OptimizerValue initB1;
+  const OptimizerValue initB2;
+
+  // numerical stability term
+  const OptimizerValue initEps;
+
+  // gradient scale, 1 / (loss scaling * replication factor)
+  const OptimizerValue initGs;
+
+  const OptimizerReductionType reductionType;
+
+  static InIndex getLrInIndex() { return 2; }
+  static InIndex getWdInIndex() { return 3; }
+  static InIndex getBeta1InIndex() { return 4; }
+  static InIndex getBeta2InIndex() { return 5; }
+  static InIndex getEpsInIndex() { return 6; }
+  static InIndex getGsInIndex() { return 7; }
+
+  std::set<InIndex> optionalInputs() const final;
+
+  // this Op should not be present when outlining is performed
+  float getSubgraphValue() const final { return -1.0f; }
+};
+
+} // namespace popart
+
+#endif
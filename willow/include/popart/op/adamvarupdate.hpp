@@ -0,0 +1,69 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_ADAMVARUPDATE_HPP
+#define GUARD_NEURALNET_ADAMVARUPDATE_HPP
+
+#include <popart/op/varupdate.hpp>
+#include <popart/optimizer.hpp>
+
+namespace popart {
+
+// Updates the first and second moments, the step count and the Variable
+// Tensor of an Adam Optimizer, all in place. The updater is the (reduced,
+// accumulated) gradient. If resetUpdater is true, the updater is an
+// accumulation Tensor, which is set to zero after it has been used.
+
+class AdamVarUpdateOp : public VarUpdateWithUpdaterOp {
+
+public:
+  AdamVarUpdateOp(const TensorId &varToUpdate,
+                  AdamMode mode_,
+                  OptimizerValue initLr,
+                  OptimizerValue initWd,
+                  OptimizerValue initB1,
+                  OptimizerValue initB2,
+                  OptimizerValue initEps,
+                  OptimizerValue initGs,
+                  bool resetUpdater_,
+                  const Op::Settings &);
+
+  std::unique_ptr<Op> clone() const final;
+  std::unique_ptr<Op> cloneWithNewName(const TensorId &newName) const final;
+  std::map<InIndex, TensorId> optimizerInputs() const final;
+  void appendOutlineAttributes(OpSerialiserBase &) const final;
+
+  // The moments and step count (and the updater if resetUpdater) are modified
+  view::Regions modifies(InIndex) const final;
+
+  const AdamMode mode;
+  const OptimizerValue initLr;
+  const OptimizerValue initWd;
+  const OptimizerValue initB1;
+  const OptimizerValue initB2;
+  const OptimizerValue initEps;
+  const OptimizerValue initGs;
+  const bool resetUpdater;
+
+  static InIndex getAccl1InIndex() { return 2; }
+  static InIndex getAccl2InIndex() { return 3; }
+  static InIndex getStepInIndex() { return 4; }
+  static InIndex getLrInIndex() { return 5; }
+  static InIndex getWdInIndex() { return 6; }
+  static InIndex getBeta1InIndex() { return 7; }
+  static InIndex getBeta2InIndex() { return 8; }
+  static InIndex getEpsInIndex() { return 9; }
+  static InIndex getGsInIndex() { return 10; }
+
+  std::set<InIndex> optionalInputs() const final;
+
+  bool isOutlineable() const final {
+    return settings.executionContext ==
+                   ExecutionContext::AccumulateOuterFragment
+               ? false
+               : true;
+  }
+  float getSubgraphValue() const final { return getLowSubgraphValue(); }
+};
+
+} // namespace popart
+
+#endif
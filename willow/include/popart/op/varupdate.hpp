@@ -22,7 +22,7 @@ public:
 
   // This Op aliases and modifies the input at index getVarIndex()
   view::Regions aliases(InIndex in, OutIndex) const final;
-  view::Regions modifies(InIndex) const final;
+  view::Regions modifies(InIndex) const override;
 
   const TensorId &getVarId() const { return varId; }
 
@@ -351,6 +351,8 @@ const static AiGraphcoreOpIdV1 SGD1VarUpdate("SGD1VarUpdate");
 const static AiGraphcoreOpIdV1 SGD1AcclUpdate("SGD1AcclUpdate");
 const static AiGraphcoreOpIdV1 SGD1AcclReduce("SGD1AcclReduce");
 const static AiGraphcoreOpIdV1 SGD1Accumulate("SGD1Accumulate");
+const static AiGraphcoreOpIdV1 AdamCombo("AdamCombo");
+const static AiGraphcoreOpIdV1 AdamVarUpdate("AdamVarUpdate");
 
 const static AiGraphcoreOpIdV1 GradCopyToHost("GradCopyToHost");
 const static AiGraphcoreOpIdV1 GradCopyFromHost("GradCopyFromHost");
@@ -30,6 +30,17 @@ enum class OptimizerReductionType {
   AccumReduce
 };
 
+// The variants of the Adam optimizer
+enum class AdamMode {
+  // Adam, with the weight decay added to the gradient (L2 regularization)
+  Adam = 0,
+  // Adam with decoupled weight decay
+  AdamW,
+  // AdamW, with the update scaled by a layer-wise trust ratio
+  Lamb,
+  N
+};
+
 std::map<std::string, OptimizerValue>
 getOptMap(const std::map<std::string, std::pair<float, bool>> &m);
 
@@ -46,6 +57,10 @@ public:
   // have a variable scaled learning rate
   virtual bool validReplacement(const Optimizer &other) const = 0;
 
+  // A hash of the type, of which values are constants of the compute Graph,
+  // and of the values of those constants
+  virtual std::size_t hash() const;
+
   virtual OptimizerType type() const               = 0;
   virtual std::string type_s() const               = 0;
   virtual std::unique_ptr<Optimizer> clone() const = 0;
@@ -320,6 +335,7 @@ public:
   getOptimizerInputs(const Tensor &weight) const final;
 
   bool validReplacement(const Optimizer &other) const final;
+  std::size_t hash() const final;
 
   void resetTensorData(Tensor &) const final;
   void setTensorData(Tensor &) const final;
@@ -411,6 +427,212 @@ public:
             {lossScaling, true}) {}
 };
 
+// Equations based on the PyTorch implementations of Adam and AdamW,
+// https://pytorch.org/docs/stable/_modules/torch/optim/adam.html and
+// https://pytorch.org/docs/stable/_modules/torch/optim/adamw.html, and on
+// LAMB (You et al., "Large Batch Optimization for Deep Learning", 2019):
+//
+// g = gradient computed in backwards pass / (ls * rf)
+// g = g + wd * w                                    (AdamMode::Adam only)
+// m = b1 * m + (1 - b1) * g
+// v = b2 * v + (1 - b2) * g^2
+// t = t + 1
+// u = (m / (1 - b1^t)) / (sqrt(v / (1 - b2^t)) + eps)
+// u = u + wd * w                         (AdamMode::AdamW and AdamMode::Lamb)
+// r = ||w|| / ||u||, or 1 if either norm is 0        (AdamMode::Lamb only)
+// w = w - lr * r * u                             (r = 1 unless AdamMode::Lamb)
+//
+// where the scalars are,
+//   lr  : learning rate
+//   wd  : weight decay
+//   b1  : beta1, the decay rate of the first moment
+//   b2  : beta2, the decay rate of the second moment
+//   eps : a small term, for numerical stability
+//   ls  : loss scaling
+//   rf  : data replication factor (the gradients are summed across replicas).
+//
+// The first and second moments (m and v) and the step count (t) are persistent
+// FLOAT Variable Tensors, one of each per Variable Tensor being updated. The
+// moments are computed in FLOAT, for any type of weight.
+//
+// If there is gradient accumulation, the gradients of the micro batches are
+// summed into an accumulation Tensor in the loop, and the update above is done
+// once, outside the loop, with the sum as the gradient. The update also resets
+// the accumulation Tensor to zero. With data replication, the sum is reduced
+// across replicas before the update (OptimizerReductionType::AccumReduce).
+// Without gradient accumulation, the gradient itself is reduced
+// (OptimizerReductionType::GradReduce).
+//
+// As for SGD, AdamComboOp is created for each Variable Tensor, and is
+// decomposed by the AdamDecompose pattern into
+//
+//   [g]--(GradReduce)--|
+//                      |--(Accumulation)--(AccumReduce)--|
+//                      |                                 |
+//   [w] [m] [v] [t]    |---------------------------------|
+//    |   |   |   |     |                   (optional)
+//    (AdamVarUpdate)---|--[lr] [wd] [b1] [b2] [eps] [gs]
+//          |
+//         [w']
+//
+// where AdamVarUpdateOp computes the moments and the update of w (and for
+// AdamMode::Lamb, the trust ratio) in a single Opx. All of the scalars can be
+// Tensor specific, except loss scaling. The scalar gs is 1 / (ls * rf).
+//
+// Constructing an Adam Optimizer is done in the same 2 steps as SGD. Any
+// OptimizerValue which is not isConst can be changed with
+// updateOptimizerFromHost.
+
+class Adam : public Optimizer {
+
+public:
+  static OptimizerValue getUnsetLearningRate() {
+    return {0.001f, true}; // a learning rate of 0.001 forever
+  }
+
+  static OptimizerValue getUnsetWeightDecay() {
+    return {0.0f, true}; // no weight decay, ever
+  }
+
+  static OptimizerValue getUnsetBeta1() {
+    return {0.9f, true}; // a first moment decay rate of 0.9 forever
+  }
+
+  static OptimizerValue getUnsetBeta2() {
+    return {0.999f, true}; // a second moment decay rate of 0.999 forever
+  }
+
+  static OptimizerValue getUnsetEps() {
+    return {1e-8f, true}; // an eps of 1e-8 forever
+  }
+
+  static OptimizerValue getUnsetLossScaling() {
+    return {1.0f, true}; // no loss scaling, ever
+  }
+
+public:
+  // Does "w" have specific OptimizerValues, or will it use default?
+  bool hasSpecific(const Tensor &w) const;
+
+  // Adam constructor with all 6 parameters, and the mode
+  // ----------------
+  Adam(OptimizerValue default_lr,
+       OptimizerValue default_wd,
+       OptimizerValue default_b1,
+       OptimizerValue default_b2,
+       OptimizerValue default_eps,
+       OptimizerValue ls,
+       AdamMode mode);
+
+  // Example:
+  //
+  // Adam({{"defaultLearningRate", {0.001, False}},
+  //       {"defaultWeightDecay", {0.01, True}}}, AdamMode.AdamW);
+  //
+  // will create an AdamW Optimizer which has a constant weight decay of 0.01
+  // and a changeable learning rate initially of 0.001. All OptimizerValues
+  // not present in the map will take values from the getUnset* functions.
+  //
+  // Construct from pair instead of OptimizerValue for pybind11 support
+  //
+  Adam(const std::map<std::string, std::pair<float, bool>> &,
+       AdamMode mode = AdamMode::Adam);
+  static Adam fromDefaultMap(const std::map<std::string, OptimizerValue> &,
+                             AdamMode mode = AdamMode::Adam);
+
+  Adam(const Adam &) = default;
+  ~Adam()            = default;
+
+  OptimizerType type() const final { return OptimizerType::Adam; }
+  std::string type_s() const final;
+
+  AdamMode getMode() const { return mode; }
+
+  std::unique_ptr<Optimizer> clone() const final;
+
+  std::unique_ptr<Op> createOp(const Tensor &weight, Graph &) const final;
+
+  // The names of the inputs for the VarUpdateOp for the Variable Tensor
+  // "weight". In the returned vector,  a "" is used as a placeholder for
+  // constant inputs
+  std::vector<TensorId> getInputIds(const Tensor &weight) const final;
+
+  // The names and infos of the optimizer Tensors
+  std::vector<std::tuple<TensorId, TensorInfo>>
+  getOptimizerInputs(const Tensor &weight) const final;
+
+  bool validReplacement(const Optimizer &other) const final;
+  std::size_t hash() const final;
+
+  void resetTensorData(Tensor &) const final;
+  void setTensorData(Tensor &) const final;
+
+  // Tensor "opt" has an id, based on which it matches a scalar which this
+  // object can compute from the atomic scalars
+  float getStoredValue(const TensorId &optId) const;
+
+  void insertSpecific(const TensorId &,
+                      OptimizerValue lr,
+                      OptimizerValue wd,
+                      OptimizerValue b1,
+                      OptimizerValue b2,
+                      OptimizerValue eps);
+
+  // insert OptimizerValues specific to one Tensor. The keys of the map should
+  // be the names of atomic optimizer scalars, such as "beta1",
+  // "learningRate". The map does not need to be complete. If it is not
+  // complete, the default values already set for the Adam will be used.
+  void insertSpecific(const TensorId &,
+                      const std::map<std::string, std::pair<float, bool>> &);
+
+  const OptimizerValueMap &learningRates() const { return lrs; }
+  const OptimizerValueMap &weightDecays() const { return wds; }
+  const OptimizerValueMap &beta1s() const { return b1s; }
+  const OptimizerValueMap &beta2s() const { return b2s; }
+  const OptimizerValueMap &epss() const { return epsvs; }
+
+private:
+  void runValueChecks(OptimizerValue lr,
+                      OptimizerValue wd,
+                      OptimizerValue b1,
+                      OptimizerValue b2,
+                      OptimizerValue eps) const;
+
+  AdamMode mode;
+
+  // The atomic scalars
+  // ------------------
+  // learning rates
+  OptimizerValueMap lrs;
+
+  // weight decays
+  OptimizerValueMap wds;
+
+  // first moment decay rates
+  OptimizerValueMap b1s;
+
+  // second moment decay rates
+  OptimizerValueMap b2s;
+
+  // numerical stability terms
+  OptimizerValueMap epsvs;
+
+  // The scalars sent to the device
+  // ------------------------------
+  AdamLearningRateHelper lrhelper;
+  AdamWeightDecayHelper wdhelper;
+  AdamBeta1Helper b1helper;
+  AdamBeta2Helper b2helper;
+  AdamEpsHelper epshelper;
+  AdamGradientScaleHelper gshelper;
+
+  // int argument only to disambiguate from the other Adam constructor
+  Adam(const std::map<std::string, OptimizerValue> &, AdamMode, int);
+
+  static std::map<std::string, OptimizerValue>
+  getComplete(const std::map<std::string, OptimizerValue> &);
+};
+
 } // namespace popart
 
 #endif
@@ -2,6 +2,7 @@
 #ifndef GUARD_NEURALNET_OPTIMIZERVALUE_HPP
 #define GUARD_NEURALNET_OPTIMIZERVALUE_HPP
 
+#include <cstddef>
 #include <tuple>
 
 namespace popart {
@@ -26,6 +27,9 @@ public:
 
   bool validReplacement(const OptimizerValue &rhs) const;
 
+  // A hash of whether the value is constant, and if so of the value
+  std::size_t hash() const;
+
 private:
   float val_;
   bool isConst_;
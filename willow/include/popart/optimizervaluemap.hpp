@@ -32,6 +32,10 @@ public:
   // Graph?
   bool validReplacement(const OptimizerValueMap &rhs) const;
 
+  // A hash of the default and specific OptimizerValues, see
+  // OptimizerValue::hash
+  std::size_t hash() const;
+
 private:
   std::map<TensorId, OptimizerValue> specifics;
 
@@ -19,6 +19,7 @@ class ContiguateIpuCopyIndicesPattern : public PreAliasPattern {
 public:
   // All IpuCopyOps with a single source IPU, for which delta is not +-1
   bool matches(Op *) const final;
+  bool matchesOpType(const Op *) const final;
 
   // return {}
   std::vector<const Tensor *> touches(Op *) const final;
@@ -14,6 +14,7 @@ public:
   // Does op at the root of the
   // pattern make a match?
   bool matches(Op *) const override;
+  bool matchesOpType(const Op *) const override;
   // If this Pattern were to be applied at op, which
   // Tensors in the subgraph centered (rooted) on op
   // would be touched?
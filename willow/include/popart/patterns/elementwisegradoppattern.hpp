@@ -14,7 +14,10 @@ namespace popart {
 template <class GRADOP, class DOP>
 class ElementWiseGradOpPattern : public PreAliasPattern {
 public:
-  bool matches(Op *op) const override { return op->isConvertibleTo<GRADOP>(); }
+  bool matches(Op *op) const override { return matchesOpType(op); }
+  bool matchesOpType(const Op *op) const override {
+    return op->isConvertibleTo<GRADOP>();
+  }
   std::vector<const Tensor *> touches(Op *) const override { return {}; }
   bool apply(Op *op) const override {
     auto grad_in  = op->inTensor(GRADOP::getGradInIndex());
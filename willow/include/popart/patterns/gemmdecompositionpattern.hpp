@@ -12,6 +12,7 @@ namespace popart {
 class GemmDecompositionPattern : public PreAliasPattern {
 public:
   bool matches(Op *) const override;
+  bool matchesOpType(const Op *) const override;
   std::vector<const Tensor *> touches(Op *) const override;
   bool apply(Op *) const override;
 
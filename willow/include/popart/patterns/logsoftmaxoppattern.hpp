@@ -12,6 +12,7 @@ namespace popart {
 class LogSoftmaxOpPattern : public SequenceExpander {
 public:
   bool matches(Op *) const override;
+  bool matchesOpType(const Op *) const override;
 
 private:
   // Replace the given op with the returned sequence of ops
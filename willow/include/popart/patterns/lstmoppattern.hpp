@@ -6,6 +6,7 @@ namespace popart {
 class LSTMPattern : public PreAliasPattern {
 public:
   bool matches(Op *op) const override;
+  bool matchesOpType(const Op *) const override;
 
   std::vector<const Tensor *> touches(Op *) const override { return {}; }
 
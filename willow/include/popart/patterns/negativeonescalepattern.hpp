@@ -10,6 +10,7 @@ namespace popart {
 class NegativeOneScalePattern : public SequenceExpander {
 public:
   bool matches(Op *) const override;
+  bool matchesOpType(const Op *) const override;
 
 private:
   std::vector<std::unique_ptr<Op>> sequence(Op *op) const final;
@@ -16,6 +16,7 @@ namespace popart {
 class NlllWithSoftmaxGradDirect : public PreAliasPattern {
 public:
   bool matches(Op *) const override;
+  bool matchesOpType(const Op *) const override;
   std::vector<const Tensor *> touches(Op *) const override;
   bool apply(Op *) const override;
 };
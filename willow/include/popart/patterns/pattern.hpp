@@ -106,6 +106,14 @@ public:
   // sub-graph centered (rooted) on op?
   virtual bool matches(Op *op) const = 0;
 
+  // Could this Pattern match an Op of the same (C++) type as op? The result
+  // must depend only on the type of op, as it is cached for each type by
+  // PreAliasPatternRewriter, which then only calls matches() on Ops of the
+  // types which could match. By default, all Ops could match. A Pattern which
+  // overrides it checks the type of op only here, and its matches() calls it
+  // first.
+  virtual bool matchesOpType(const Op *op) const;
+
   // Apply this Pattern, modifying the sub-graph
   // centered (rooted) on op
   virtual bool apply(Op *op) const = 0;
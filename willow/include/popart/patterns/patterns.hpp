@@ -272,6 +272,9 @@ public:
   bool operator==(const Patterns &p) const;
   friend std::ostream &operator<<(std::ostream &os, const Patterns &patterns);
 
+  // Hash based on which patterns are enabled
+  std::size_t hash() const;
+
 private:
   // Map of which settings are enabled, indexed by value of std::type_index
   std::map<std::type_index, bool> settings;
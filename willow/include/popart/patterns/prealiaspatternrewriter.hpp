@@ -0,0 +1,67 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_PREALIASPATTERNREWRITER_HPP
+#define GUARD_NEURALNET_PREALIASPATTERNREWRITER_HPP
+
+#include <chrono>
+#include <memory>
+#include <set>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include <popart/names.hpp>
+#include <popart/patterns/pattern.hpp>
+
+namespace popart {
+
+// Applies a list of PreAliasPatterns to a Graph until none of them match.
+//
+// Instead of sweeping over all Ops with every Pattern until nothing changes,
+// a worklist of Ops is kept, ordered by OpId so that the result is
+// deterministic. When a Pattern is applied to an Op, the Ops it creates and
+// the Ops around the Tensors it touches are added to the worklist, as these
+// are the only Ops which can start (or stop) matching. The Patterns are
+// indexed by the types of Op they can match, see
+// PreAliasPattern::matchesOpType, so that matches() is only called for Ops
+// of those types.
+class PreAliasPatternRewriter {
+public:
+  PreAliasPatternRewriter(Ir &,
+                          std::vector<std::unique_ptr<PreAliasPattern>>);
+
+  // Apply the Patterns to all Ops of the Graph, and to the Ops they create
+  // or change, until none of them match. Returns true if a Pattern was
+  // applied. If compile profiling is enabled, each call to Pattern::apply is
+  // recorded under the name of the Pattern. The time spent in matches() is
+  // recorded once per call of this function, under "<name>::matches".
+  bool apply(Graph &);
+
+  // Log, for each Pattern, the number of calls to matches(), the number of
+  // times it was applied and the time spent in matches() and apply()
+  void logStatistics() const;
+
+private:
+  struct Statistics {
+    int64_t matchCalls{0};
+    int64_t applications{0};
+    std::chrono::nanoseconds time{0};
+  };
+
+  // The indices of the Patterns which could match an Op of the type of op,
+  // in the order of the Patterns
+  const std::vector<int> &getCandidates(const Op *op);
+
+  // Add the producers and consumers of the inputs and outputs of op
+  void addNeighbours(Op *op, std::set<OpId> &) const;
+
+  // Add the producer and consumers of t
+  void addNeighbours(const Tensor *t, std::set<OpId> &) const;
+
+  Ir &ir;
+  std::vector<std::unique_ptr<PreAliasPattern>> patterns;
+  std::vector<Statistics> statistics;
+  std::unordered_map<std::type_index, std::vector<int>> candidates;
+};
+
+} // namespace popart
+
+#endif
@@ -9,6 +9,7 @@ namespace popart {
 class SGD0Decompose : public PreAliasPattern {
 public:
   bool matches(Op *) const final;
+  bool matchesOpType(const Op *) const final;
   std::vector<const Tensor *> touches(Op *) const final;
   bool apply(Op *) const final;
 };
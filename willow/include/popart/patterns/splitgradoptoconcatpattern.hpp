@@ -13,6 +13,7 @@ public:
   // Does op at the root of the
   // pattern make a match?
   bool matches(Op *) const override;
+  bool matchesOpType(const Op *) const override;
 
 private:
   // Replace the given op with the returned sequence of ops
@@ -15,6 +15,7 @@
 
 #include <popart/aliaszerocopy.hpp>
 #include <popart/devicemanager.hpp>
+#include <popart/hostreduceengine.hpp>
 #include <popart/popx/creatorx.hpp>
 #include <popart/popx/enigma.hpp>
 #include <popart/popx/linearmapper.hpp>
@@ -24,13 +25,18 @@
 #include <popart/popx/pritask.hpp>
 #include <popart/popx/virtualgraph.hpp>
 
+#include <array>
+#include <future>
+#include <regex>
 #include <set>
+#include <popart/cyclecountreport.hpp>
 #include <popart/names.hpp>
 // MutableVoidData is defined in here:
 #include <popart/stepio.hpp>
 #include <popart/tensordata.hpp>
 
 namespace popart {
+class IrBundle;
 namespace liveness {
 class LivenessAnalyzer;
 }
@@ -76,6 +82,31 @@ poplar::Type popType(DataType);
 
 enum class ToHostStreamType { NonAnchor, NonSumAnchor, SumAnchor };
 
+// A poplar::Executable which is being loaded from the engine cache while the
+// Ir is prepared, see Devicex::loadCachedExecutableAsync. It is only used if
+// the hash of the prepared Ir is irHash, or if the Ir is restored from
+// preparedIr
+class PendingExecutable {
+public:
+  ~PendingExecutable() {
+    if (done.valid()) {
+      done.wait();
+    }
+  }
+
+  // Wait for the executable to be loaded. Returns false, with the reason in
+  // loadError, if it could not be
+  bool wait();
+
+  std::size_t irHash{0};
+  // The prepared Ir stored with the executable, see Ir::serializePrepared.
+  // Empty if the Ir could not be stored
+  std::string preparedIr;
+  nonstd::optional<poplar::Executable> executable;
+  std::string loadError;
+  std::future<void> done;
+};
+
 class Devicex {
 
 private:
@@ -112,6 +143,16 @@ public:
                                           int64_t tileId = 0,
                                           std::string id = "");
   std::map<std::string, uint64_t> cycleCountTensorToHost();
+
+  // Add the hardware cycles of the sequence, counted on the first tile of the
+  // IPU of the Op or pipeline stage, to its total in the CycleCountReport
+  void instrumentOpWithHardwareCycleCounter(poplar::program::Sequence &,
+                                            const Op *);
+  void
+  instrumentPipelineStageWithHardwareCycleCounter(poplar::program::Sequence &,
+                                                  PipelineStage);
+  CycleCountReport cycleCountReportToHost();
+
   void run(IStepIO &);
 
 private:
@@ -127,6 +168,10 @@ public:
   // device ->host stream -> specified host addresses
   void weightsToHost(const std::map<TensorId, MutableVoidData> &);
 
+  // The host end of the stream of weight `id', as written by the last call to
+  // weightsToHost()
+  ConstVoidData getD2hWeightData(const TensorId &id) const;
+
   // TODO T8229 : change these names to disambiguate
   // the source and destination
 
@@ -273,6 +318,15 @@ public:
   const std::map<TensorId, poplar::RemoteBuffer> &
   getHostReduceRemoteBuffers() const;
 
+  // Sum the gradient streams of TensorId with the HostReduceEngine, which is
+  // created by the first call. See SessionOptions::hostAllReduceEngine
+  void addHostReduceEngineGradient(TensorId,
+                                   TensorInfo,
+                                   unsigned nContributions);
+  const HostReduceEngine *getHostReduceEngine() const {
+    return hostReduceEngine.get();
+  }
+
   void connectStreamToCallback(const std::string &streamHandle,
                                std::function<void(void *)> callback,
                                unsigned index);
@@ -432,6 +486,18 @@ public:
 
   bool prepareHasBeenCalled() const { return prepareHasBeenCalled_; }
 
+  // If engine caching is enabled and the IrBundle hash saved in the engine
+  // cache matches the hash of bundle, start loading the cached
+  // poplar::Executable on another thread, and read the prepared Ir stored
+  // with it, if there is one. The executable is loaded while the Ir is
+  // prepared or restored from bundle. Returns nullptr otherwise
+  static std::unique_ptr<PendingExecutable>
+  loadCachedExecutableAsync(const IrBundle &bundle);
+
+  // Use the executable being loaded by loadCachedExecutableAsync in
+  // tryLoadExecutable, rather than loading it from the engine cache again
+  void setPendingExecutable(std::unique_ptr<PendingExecutable>);
+
 private:
   std::map<TaskId, std::vector<Op *>> mainGraphOpRegistry;
   std::map<TaskId, std::vector<Op *>> requiredRecomputes;
@@ -477,6 +543,13 @@ private:
     // Called to indicate the data has been comsumed
     // by poplar
     void readComplete();
+
+  private:
+    // Copy data provided by the IStepIO to the stream buffer at dstAddr,
+    // converting it to the tensor's type if necessary
+    void copyToStream(const ConstVoidData &data, void *dstAddr);
+
+    bool conversionWarningLogged{false};
   };
 
   class PrefetchCallback : public poplar::StreamCallback {
@@ -530,14 +603,37 @@ private:
 
   std::vector<TensorId> hostReduceStreamIds;
 
+  // Sums the gradients of hostAllReduce sessions, if hostAllReduceEngine
+  std::unique_ptr<HostReduceEngine> hostReduceEngine;
+  void connectHostReduceEngineStreams();
+
   // Q: Consider replacing the d2h weight buffer with a data stream as
   // done for inputs
   std::map<TensorId, std::vector<char>> d2hWeightBuffers;
   std::map<TensorId, std::vector<char>> chBuffers;
 
+  // Scratch buffers for the host-side collective rearrangement of sharded
+  // weights in remote buffers, reused by each weight upload and download
+  std::vector<std::vector<char>> collectiveScratch;
+
   // Buffers for storing the hardware cycle count
   std::map<std::string, uint64_t> cycleCount;
 
+  // Buffers for the hardware cycle totals of instrumented Ops and pipeline
+  // stages: the low and high words of the total, and the number of
+  // executions. See Instrumentation::Op and Instrumentation::Stage
+  std::map<std::string, std::array<uint32_t, 3>> cycleTotals;
+  std::map<std::string, const Op *> cycleTotalOps;
+  std::map<std::string, PipelineStage> cycleTotalPipelineStages;
+
+  // Only Ops whose type or name matches it are instrumented, if set
+  nonstd::optional<std::regex> opInstrumentationFilter;
+
+  bool isInstrumentedOp(const Op *) const;
+  void addHardwareCycleTotal(poplar::program::Sequence &,
+                             int64_t tileId,
+                             const std::string &id);
+
   // Wrapper for calls to poplar Engine API calls: loading
   // engine onto the poplar device and connecting streams.
   // Must be called before running a poplar program with a
@@ -547,7 +643,14 @@ private:
   // We may have prefetched data ready to be fed into the model, but we have
   // provided a new buffer which we want to be fetched. We invalidate the
   // prefetch by reconnecting the datastreams before each program run.
-  void reconnectInputStreams();
+  // Streams for which `stepio' provides a usable zero-copy buffer are
+  // connected directly to that buffer instead of to a callback.
+  void reconnectInputStreams(IStepIO &stepio);
+
+  // Return true if `data' can be connected directly to the host->device
+  // stream of `tensor', without a copy in the stream callback.
+  bool canConnectZeroCopy(const Tensor *tensor,
+                          const ConstVoidData &data) const;
 
   // Is this Devicex's engine the last to have been loaded onto
   // deviceInfo's device?
@@ -579,18 +682,22 @@ private:
   // be set to `nonstd::nullopt'.
   poplar::Executable getExecutable();
 
-  // Try to save the argument executable to a file at
-  // `ir().getSessionOptions().cachePath'.
+  // Try to save the argument executable to the engine cache in the directory
+  // `ir().getSessionOptions().cachePath', evicting the least recently used
+  // executables if the cache is larger than `engineCacheMaxBytes'. The
+  // prepared Ir is stored with it, if it can be, see Ir::serializePrepared.
   void trySaveExecutable(poplar::Executable &);
 
-  // Try to load a poplar::Executable from a file at
+  // Try to load a poplar::Executable from the engine cache in the directory
   // `ir().getSessionOptions().cachePath'. If successful,
   // `this->cachedExecutable' will be set else, `this->cachedExecutable' will
   // remain set to `nonstd::nullopt'.
   void tryLoadExecutable();
 
-  std::string getPoplarCachePath();
-  std::string getPopartCachePath();
+  // The name of the entry of the engine cache for the Ir, see EngineCache
+  std::string getEngineCacheKey() const;
+  std::string getPoplarCachePath() const;
+  std::string getPopartCachePath() const;
 
   void setFloatingPointBehaviour(poplar::Graph &graph);
   void setStochasticRoundingBehaviour(poplar::Graph &graph);
@@ -607,6 +714,8 @@ private:
   nonstd::optional<poplar::Executable> cachedExecutable;
   bool usingCachedExecutable = false;
 
+  std::unique_ptr<PendingExecutable> pendingExecutable;
+
   // Option to trace the opx execution using printTensor. This can be useful in
   // determining where an exception has occurred. It is enabled by setting
   // POPART_OPX_TRACE environment variable to "1"
@@ -0,0 +1,34 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_ADAMVARUPDATEX_HPP
+#define GUARD_NEURALNET_ADAMVARUPDATEX_HPP
+
+#include <popops/Expr.hpp>
+#include <popart/names.hpp>
+#include <popart/optimizervalue.hpp>
+#include <popart/popx/op/varupdatex.hpp>
+
+namespace popart {
+namespace popx {
+
+class AdamVarUpdateOpx : public VarUpdateOpx {
+public:
+  AdamVarUpdateOpx(Op *, Devicex *);
+  void grow(poplar::program::Sequence &) const final;
+
+private:
+  // A scalar of an expression, either a constant or the input at inIndex,
+  // which is appended to operands
+  std::unique_ptr<popops::expr::Expr>
+  getScalar(const OptimizerValue &value,
+            InIndex inIndex,
+            std::vector<poplar::Tensor> &operands) const;
+
+  // Is the Variable Tensor sharded across replicas (in which case, the norms
+  // of LAMB are reduced across replicas)
+  bool isReplicaSharded() const;
+};
+
+} // namespace popx
+} // namespace popart
+
+#endif
@@ -50,6 +50,11 @@ public:
   // Reorder tensor back into the expected IR tensor shape and order (host-side)
   void undoRearrangeForCollective(const char *in, char *out) const;
 
+  // The host-side rearrangements query the tile mapping of the graph the
+  // first time either is called. Once this has been called, on the thread
+  // which builds the graph, they can be run on any thread, concurrently.
+  void prepareHostRearrangement() const;
+
   // Get a clone of the tensor that was used to create the CBR object
   poplar::Tensor getReferenceTensorClone(std::string name) const;
 
@@ -68,6 +73,13 @@ private:
   // Host tensor rearrangement routine
   void rearrange(const char *in, char *out, bool forCollective) const;
 
+  // A contiguous run of elements moved by the host tensor rearrangement
+  struct HostCopy {
+    int64_t offset;
+    int64_t rearrangedOffset;
+    int64_t size;
+  };
+
   // Graph or subgraph on which the tensor and reordered tensor are allocated
   poplar::Graph &graph;
 
@@ -85,6 +97,11 @@ private:
 
   // Proxy to reverse simplfy tensors to rearrange for collectives
   poplar::Tensor simplifyReverseProxy;
+
+  // The copies made by the host tensor rearrangement, set by
+  // prepareHostRearrangement
+  mutable std::vector<HostCopy> hostCopies;
+  mutable bool hostCopiesPrepared{false};
 };
 
 // If the input/output to a collective op is padded,
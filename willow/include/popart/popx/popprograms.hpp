@@ -48,6 +48,7 @@ public:
     WeightstoHost,
     ToHostFinalCopy,
     CycleCountTensortoHost,
+    CycleCountReset,
     N // The number of program fragments
   };
 
@@ -61,6 +62,10 @@ public:
   poplar::program::Sequence &setRandomSeedFromHostFragment();
   const poplar::program::Sequence &cycleCountTensorToHostFragment() const;
   poplar::program::Sequence &cycleCountTensorToHostFragment();
+  // Zeroes the totals of the Op and pipeline stage cycle counters at the start
+  // of the main program
+  const poplar::program::Sequence &cycleCountResetFragment() const;
+  poplar::program::Sequence &cycleCountResetFragment();
   const poplar::program::Sequence &toHostFinalCopyFragment() const;
   poplar::program::Sequence &toHostFinalCopyFragment();
   const poplar::program::Sequence &initFragment() const;
@@ -2,7 +2,10 @@
 #ifndef GUARD_NEURALNET_POPTENSORS_HPP
 #define GUARD_NEURALNET_POPTENSORS_HPP
 
+#include <map>
+#include <memory>
 #include <set>
+#include <unordered_map>
 
 #include <popart/names.hpp>
 #include <popart/popx/viewchangers.hpp>
@@ -22,6 +25,7 @@ public:
   // The same as insert but without any checks against the IR
   void insertUnsafe(TensorId id, const poplar::Tensor &pt);
   const poplar::Tensor &get(TensorId) const;
+  const poplar::Tensor &get(TensorHandle) const;
   const poplar::Tensor &getView(TensorId) const;
 
   bool hasViewChangers(TensorId) const;
@@ -29,16 +33,23 @@ public:
   void setViewChangers(TensorId, const ViewChangers &viewChangers);
 
   bool contains(TensorId) const;
-  const std::map<TensorId, std::shared_ptr<poplar::Tensor>> &getTensors() const;
+  bool contains(TensorHandle) const;
+  std::map<TensorId, std::shared_ptr<poplar::Tensor>> getTensors() const;
 
   bool canAlias(TensorId) const;
 
 private:
   void verify(TensorId, const poplar::Tensor &);
-
-  std::map<TensorId, std::shared_ptr<poplar::Tensor>> tensors_;
-  std::map<TensorId, std::shared_ptr<poplar::Tensor>> views_;
-  std::map<TensorId, std::shared_ptr<ViewChangers>> viewChangers_;
+  // The handle of a TensorId, interned in the Ir's TensorIdInterner
+  TensorHandle intern(const TensorId &) const;
+  // The handle of a TensorId, or unusedTensorHandle if it was never interned
+  TensorHandle find(const TensorId &) const;
+
+  // Keyed on the handles of the TensorIds
+  std::unordered_map<TensorHandle, std::shared_ptr<poplar::Tensor>> tensors_;
+  std::unordered_map<TensorHandle, std::shared_ptr<poplar::Tensor>> views_;
+  std::unordered_map<TensorHandle, std::shared_ptr<ViewChangers>>
+      viewChangers_;
   const Ir &ir;
 };
 
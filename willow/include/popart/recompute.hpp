@@ -2,6 +2,9 @@
 #ifndef GUARD_NEURALNET_RECOMPUTE_HPP
 #define GUARD_NEURALNET_RECOMPUTE_HPP
 
+#include <cstdint>
+#include <vector>
+
 namespace popart {
 
 enum class RecomputationType;
@@ -10,6 +13,31 @@ class Graph;
 namespace recompute {
 void autoAnnotate(Graph &graph, RecomputationType rctype);
 
+struct CheckpointSolution {
+  // Whether each Op is checkpointed, rather than recomputed
+  std::vector<bool> checkpoint;
+  // The predicted peak liveness of the activations, in bytes
+  int64_t peakLiveness;
+  // The summed cost of the Ops which are recomputed
+  double recomputeCost;
+};
+
+// Choose which of a schedule of forward Ops to checkpoint, given the memory
+// of each Op's outputs and the cost of recomputing it.
+//
+// The checkpoints split the schedule into segments of recomputed Ops. The
+// outputs of the checkpoints are live until the backward pass, which
+// recomputes one segment at a time, so the predicted peak liveness is the
+// memory of all the checkpoints plus that of the largest segment.
+//
+// Returns the checkpoints with the least recompute cost whose predicted peak
+// liveness is at most memoryBudget. If memoryBudget is not positive, or no
+// checkpoints fit in it, returns the checkpoints with the least predicted
+// peak liveness.
+CheckpointSolution solveCheckpoints(const std::vector<int64_t> &memory,
+                                    const std::vector<double> &cost,
+                                    int64_t memoryBudget);
+
 } // namespace recompute
 } // namespace popart
 
@@ -2,7 +2,10 @@
 #ifndef GUARD_NEURALNET_REGIONIOMAP_HPP
 #define GUARD_NEURALNET_REGIONIOMAP_HPP
 
+#include <array>
+#include <initializer_list>
 #include <memory>
+#include <ostream>
 #include <set>
 #include <vector>
 #include <popart/names.hpp>
@@ -17,21 +20,77 @@ enum class AccessType { None = 0, Read = 1, Write = 2, ReadWrite = 3 };
 
 AccessType combine(std::set<AccessType> accessTypes);
 
+// Merge Regions into a set of disjoint Regions covering the same elements,
+// sorted by their bounds. If the elements form a box, it is a single Region
 Regions mergeRegions(Regions regions);
 
+// true if a Region of lhs intersects a Region of rhs
+bool overlaps(const Regions &lhs, const Regions &rhs);
+
+// The lower or upper bounds of a Region. Bounds of up to inlineRank
+// dimensions are stored inline, so that creating and copying the Regions of
+// most tensors does not allocate.
+class Bounds {
+public:
+  using value_type     = int64_t;
+  using iterator       = int64_t *;
+  using const_iterator = const int64_t *;
+
+  static constexpr size_t inlineRank = 6;
+
+  Bounds() = default;
+  Bounds(size_t n, int64_t value);
+  Bounds(std::initializer_list<int64_t>);
+  Bounds(const std::vector<int64_t> &);
+  Bounds(const Bounds &) = default;
+  Bounds(Bounds &&) noexcept;
+  Bounds &operator=(const Bounds &) = default;
+  Bounds &operator=(Bounds &&) noexcept;
+
+  operator std::vector<int64_t>() const { return {begin(), end()}; }
+
+  size_t size() const { return n; }
+  bool empty() const { return n == 0; }
+  int64_t *data() { return n > inlineRank ? heap.data() : local.data(); }
+  const int64_t *data() const {
+    return n > inlineRank ? heap.data() : local.data();
+  }
+  int64_t &operator[](size_t i) { return data()[i]; }
+  int64_t operator[](size_t i) const { return data()[i]; }
+  int64_t at(size_t i) const;
+  iterator begin() { return data(); }
+  iterator end() { return data() + n; }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + n; }
+
+  bool operator==(const Bounds &) const;
+  bool operator!=(const Bounds &rhs) const { return !(*this == rhs); }
+  // lexicographic, as for std::vector
+  bool operator<(const Bounds &) const;
+
+private:
+  size_t n{0};
+  std::array<int64_t, inlineRank> local{};
+  // only used for more than inlineRank dimensions
+  std::vector<int64_t> heap;
+};
+
+std::ostream &operator<<(std::ostream &, const Bounds &);
+
 // a rectangular sub-region of a Shape
 class Region {
 
 public:
-  Region(const std::vector<int64_t> &lower_,
-         const std::vector<int64_t> &upper_);
-  Region(const std::vector<int64_t> &lower_,
-         const std::vector<int64_t> &upper_,
+  Region(const Bounds &lower_, const Bounds &upper_);
+  Region(const Bounds &lower_,
+         const Bounds &upper_,
          const AccessType accessType);
   int64_t rank() const;
   int64_t nelms() const;
   bool isEmpty() const;
   Region intersect(const Region &rhs) const;
+  // !intersect(rhs).isEmpty(), without creating the intersection
+  bool overlaps(const Region &rhs) const;
   Region transpose(const Shape shape) const;
   Regions sub(const Regions &rhs, bool include_empty = false) const;
   Regions sub(const Region &rhs, bool include_empty = false) const;
@@ -40,25 +99,25 @@ public:
               bool include_empty = false) const;
   Regions reshape(Region fullInRegion, Region fullOutRegion) const;
   std::pair<int64_t, Region> merge(const Region &rhs) const;
-  bool contains(const std::vector<int64_t> &index) const;
+  bool contains(const Bounds &index) const;
   bool contains(const Region &rhs) const;
-  int64_t flatIndex(const std::vector<int64_t> &index) const;
-  std::vector<int64_t> dimIndex(int64_t index) const;
+  int64_t flatIndex(const Bounds &index) const;
+  Bounds dimIndex(int64_t index) const;
   void checks() const;
   static Region getEmpty(int64_t r);
   static Region getFull(const Shape &s,
                         AccessType accessType = AccessType::ReadWrite);
   bool operator==(const Region &) const;
   bool operator!=(const Region &) const;
-  const std::vector<int64_t> &getLower() const { return lower; }
-  const std::vector<int64_t> &getUpper() const { return upper; }
+  const Bounds &getLower() const { return lower; }
+  const Bounds &getUpper() const { return upper; }
   void append(std::ostream &ss) const;
   AccessType getAccessType() const { return accessType; }
   void setAccessType(AccessType at) { accessType = at; }
 
 private:
-  std::vector<int64_t> lower;
-  std::vector<int64_t> upper;
+  Bounds lower;
+  Bounds upper;
   // rank-0 tensors have no lower and upper bounds,
   // so it is not possible to determine if they are empty
   // by looking for equal lower and upper bounds
@@ -66,8 +125,8 @@ private:
 
   AccessType accessType{AccessType::None};
 
-  Region(const std::vector<int64_t> &lower_,
-         const std::vector<int64_t> &upper_,
+  Region(const Bounds &lower_,
+         const Bounds &upper_,
          const AccessType accessType,
          bool isEmpty_r0_);
 };
@@ -2,6 +2,7 @@
 #ifndef GUARD_NEURALNET_SCHEDULER_HPP
 #define GUARD_NEURALNET_SCHEDULER_HPP
 
+#include <cstdint>
 #include <vector>
 #include <popart/names.hpp>
 
@@ -9,6 +10,14 @@ namespace popart {
 
 class ScheduleCacher;
 
+struct ScheduleCacheCounters {
+  int64_t hits{0};
+  int64_t misses{0};
+  // Entries which were found but not used, because they were corrupt or not
+  // valid for the Graph. These are included in misses.
+  int64_t rejections{0};
+};
+
 class Scheduler {
 
 public:
@@ -51,6 +60,12 @@ public:
                      const Graph &,
                      bool respectPingPongPhase) const;
 
+  // Counters of the persistent schedule cache (see
+  // SessionOptions::enableScheduleCaching), summed over all Schedulers in the
+  // process.
+  static ScheduleCacheCounters getPersistentCacheCounters();
+  static void resetPersistentCacheCounters();
+
 private:
   std::unique_ptr<ScheduleCacher> cacher;
 };
@@ -6,6 +6,8 @@
 #include <vector>
 
 #include <poplar/DataStream.hpp>
+#include <popart/asyncrun.hpp>
+#include <popart/cyclecountreport.hpp>
 #include <popart/ir.hpp>
 #include <popart/names.hpp>
 #include <popart/stepio.hpp>
@@ -18,6 +20,7 @@ class DeviceInfo;
 
 namespace popx {
 class Devicex;
+class PendingExecutable;
 }
 
 /**
@@ -73,6 +76,13 @@ public:
    */
   uint64_t getCycleCount(std::string id = "");
 
+  /**
+   * Copy the cycle counts of the Ops and pipeline stages instrumented with
+   * Instrumentation::Op and Instrumentation::Stage to host from the device.
+   * The counts are totals over the last run
+   */
+  CycleCountReport getCycleCountReport();
+
   /**
    * Perform one step.
    *
@@ -81,6 +91,27 @@ public:
    */
   void run(IStepIO &stepIO);
 
+  /**
+   * Start one step, and return without waiting for it to complete.
+   *
+   * input data  : from address in inputs.in, which must remain valid until
+   *               the step has completed
+   * output data : to a set of anchor buffers owned by the session, which are
+   *               available from the returned handle once the step has
+   *               completed, and are reused once the handle is released
+   *
+   * Steps are run in the order they are started, so the host can consume
+   * the anchors of one step while the next runs. The session has
+   * SessionOptions::asyncAnchorBufferSets sets of anchor buffers, and this
+   * throws if all of them are held by handles which have not been released.
+   */
+  std::unique_ptr<AsyncRunHandle> runAsync(IStepIO &inputs);
+
+  /**
+   * Block until every step started by runAsync has completed
+   */
+  void waitForAsyncRuns();
+
   /**
    * Export numElements from stepIO.in
    */
@@ -152,7 +183,8 @@ public:
   /**
    * Retrieve the tensor tile mapping from the poplar::Graph
    *
-   * This may only be called after the `prepareDevice()` call has been made.
+   * This may only be called after the `prepareDevice()` call has been made,
+   * and not if the Ir was restored from the engine cache.
    *
    *  \return a TensorTileMap object for all tensors in the graph
    */
@@ -189,7 +221,8 @@ public:
   void writeWeights(const IWeightsIO &weightsIo);
 
   /**
-   * Serizalise the ir graph to a string
+   * Serizalise the ir graph to a string. Not available if the Ir was
+   * restored from the engine cache
    *
    * format : the format to serialize
    */
@@ -206,6 +239,14 @@ protected:
    */
   void setDevice(std::shared_ptr<DeviceInfo> deviceInfo);
 
+  /**
+   * Prepare the Ir from the bundle, or restore it if the engine cache has an
+   * entry for the bundle with a prepared Ir, see Ir::prepareFromSerialized.
+   *
+   * /param bundle the inputs of Ir::prepare
+   */
+  void prepareIr(const IrBundle &bundle);
+
   /**
    * abstraction of the computation, the Ir is where
    * all the compute graph optimisations, backwards pass construction,
@@ -219,6 +260,18 @@ protected:
    */
   std::unique_ptr<popx::Devicex> device_;
 
+  /**
+   * The executable being loaded from the engine cache while the Ir is
+   * prepared, if any. It is passed on to device_ in setDevice.
+   */
+  std::unique_ptr<popx::PendingExecutable> pendingExecutable_;
+
+  /**
+   * Runs the steps started by runAsync, created by the first call to it.
+   * Declared after device_, so that it is destroyed first.
+   */
+  std::unique_ptr<AsyncRunner> asyncRunner_;
+
   /**
    * Flag to indicate if weightsFromHost has been called
    */
@@ -314,7 +367,8 @@ public:
   /**
    * Access the stream IDs for variables that are involved in host side
    * reductions on the host. Only populated if hostAllReduce is enabled in the
-   * SessionOptions
+   * SessionOptions. If hostAllReduceEngine is enabled, the gradient streams
+   * are connected to the HostReduceEngine and should not be connected again
    */
   const std::vector<std::string> &getHostReduceStreamIds() const;
 
@@ -29,7 +29,10 @@ enum class RecomputationType {
   Standard, // Algorithm to pick checkpoint to try an minimize max liveness
   NormOnly, // Only Norm ops (+ non-linearities, if following) are recomputed
   Pipeline, // Recompute all forward pipeline stages
-  N         // the number of RecomputationTypes, must appear as the final enum
+  // Choose the checkpoints with the least recompute cost whose predicted peak
+  // liveness is within SessionOptions::autoRecomputationMemoryBudget
+  CheckpointSolver,
+  N // the number of RecomputationTypes, must appear as the final enum
 };
 
 enum class MergeVarUpdateType {
@@ -52,6 +55,17 @@ enum class VirtualGraphMode {
   N         // The number of VirtualGraphModes, must appear as the final enum
 };
 
+// If using VirtualGraphMode::Auto, how should the graph be split between IPUs?
+enum class AutoVirtualGraphType {
+  Subgraph = 0, // Balance weights and activations, splitting where the
+                // subgraphs from the inputs collapse into a single Op
+  // Split the schedule into contiguous stages balancing the compute and copy
+  // time estimated by the AutoVirtualGraph cost model, with the memory of each
+  // stage within SessionOptions::autoVirtualGraphMemoryCap
+  ComputeBalanced,
+  N // The number of AutoVirtualGraphTypes, must appear as the final enum
+};
+
 enum class IrSerializationFormat {
   JSON // JSON format
 };
@@ -66,6 +80,8 @@ enum class SyntheticDataMode {
 enum class Instrumentation {
   Outer = 0, // Outer loop instrumentation, graph over all IPUs
   Inner,     // Inner loop instrumentation, graph per IPU
+  Op,        // Per Op instrumentation, see CycleCountReport
+  Stage,     // Per pipeline stage instrumentation, see CycleCountReport
   N          // The number of Instrumentations, the final enum
 };
 
@@ -75,6 +91,9 @@ std::ostream &operator<<(std::ostream &, VirtualGraphMode);
 std::string toString(RecomputationType);
 std::ostream &operator<<(std::ostream &, RecomputationType);
 
+std::string toString(AutoVirtualGraphType);
+std::ostream &operator<<(std::ostream &, AutoVirtualGraphType);
+
 /**
  * A structure containing user configuration options for the Session class
  */
@@ -103,6 +122,11 @@ struct SessionOptions {
   /// Export Poplar vertex graph
   bool exportPoplarVertexGraph = false;
 
+  /// Record the time of each Transform, Pattern pass, schedule and Opx grow
+  /// of the compilation, and write them to logDir as a Chrome trace
+  /// (compile_trace.json) and a summary table (compile_summary.txt)
+  bool enableCompileProfiling = false;
+
   bool separateCallOpPdfs = true;
 
   /// Controls caching of identical sections of the graph.
@@ -112,6 +136,13 @@ struct SessionOptions {
   /// in the outlining cost model.
   bool enableOutliningCopyCostPruning = true;
 
+  /// Find the sub-graphs to outline hierarchically: first find a coarse
+  /// repeated block of the schedule, such as a layer, then find the sub-graphs
+  /// within one instance of it and between its instances in parallel. This is
+  /// much faster for long schedules of repeated layers, but sub-graphs which
+  /// cross the boundaries of the block are not outlined.
+  bool enableHierarchicalOutlining = false;
+
   /// The incremental value that a sub-graph requires, relative to its nested
   /// sub-graphs (if any), to be eligible for outlining. A high threshold
   /// results in fewer sub-graphs being outlined, a negative value results in
@@ -127,6 +158,11 @@ struct SessionOptions {
   /// reduce model size at the cost of computation cycles
   RecomputationType autoRecomputation = RecomputationType::None;
 
+  /// The budget, in bytes, for the predicted peak liveness of the activations
+  /// with RecomputationType::CheckpointSolver. If not positive, the
+  /// checkpoints with the least predicted peak liveness are chosen
+  int64_t autoRecomputationMemoryBudget = 0;
+
   /// Enable merging of VarUpdates into groups of VarUpdates, by flattening
   /// and concatenating Variable Tensors and Updating Tensors
   MergeVarUpdateType mergeVarUpdate = MergeVarUpdateType::None;
@@ -188,6 +224,13 @@ struct SessionOptions {
   /// parallelism - either manually using model annotations, or automatically
   VirtualGraphMode virtualGraphMode = VirtualGraphMode::Off;
 
+  /// How VirtualGraphMode::Auto splits the graph between IPUs
+  AutoVirtualGraphType autoVirtualGraphType = AutoVirtualGraphType::Subgraph;
+
+  /// The cap, in bytes, on the estimated memory of each IPU with
+  /// AutoVirtualGraphType::ComputeBalanced. If not positive, there is no cap
+  int64_t autoVirtualGraphMemoryCap = 0;
+
   /// Enable pipelining of virtual graphs
   bool enablePipelining = false;
 
@@ -201,6 +244,13 @@ struct SessionOptions {
   bool instrumentWithHardwareCycleCounter            = false;
   std::set<Instrumentation> hardwareInstrumentations = {Instrumentation::Outer};
 
+  /// With Instrumentation::Op, only instrument the Ops whose type or name
+  /// matches this (ECMAScript) regular expression. All Ops are instrumented
+  /// if it is empty. Each instrumented Op is synchronised with the other tiles
+  /// of its IPU, so instrumenting many small Ops changes the schedule, and
+  /// the cycle counts, of the program.
+  std::string hardwareInstrumentationOpFilter;
+
   /// If true, the weight gradient tensors are not saved off the device
   /// when devicex.weightsFromHost() is called. Note: this option is
   /// overridden if syntheticDataMode is not Off.
@@ -218,12 +268,30 @@ struct SessionOptions {
   // prepared. This option has no effect on a training session
   bool constantWeights = true;
 
-  /// Enable poplar executable caching
+  /// Enable poplar executable caching. The executables of IPU devices are
+  /// cached, with the prepared Ir, so a session with a cached executable
+  /// neither prepares the Ir nor grows the poplar graph. The restored Ir only
+  /// has the Tensors which are streamed to and from the host. Executables of
+  /// other devices, such as IpuModels, cannot be serialized, see
+  /// enableScheduleCaching for those.
   bool enableEngineCaching = false;
 
-  /// Path to save the poplar::Executable to.
+  /// Directory to save the poplar::Executables to. Each executable is saved
+  /// in an entry named by the hash of the model and the options it was
+  /// compiled with, so sessions with different models or options can share
+  /// the directory, see EngineCache.
   std::string cachePath = "session_cache";
 
+  /// The maximum total size, in bytes, of the executables in the `cachePath'
+  /// directory. When a new executable is saved, the least recently used ones
+  /// are removed until the total size is below it. 0 for no limit.
+  int64_t engineCacheMaxBytes = 0;
+
+  /// Enable caching of Graph schedules on disk, in the directory
+  /// `cachePath'.schedules. Annealing is skipped for Graphs whose schedule is
+  /// found in the cache.
+  bool enableScheduleCaching = false;
+
   // Enable exceptions when floating point errors occur.
   bool enableFloatingPointChecks = false;
 
@@ -287,6 +355,18 @@ struct SessionOptions {
   /// Enable the use of poplar::RemoteBuffers for hostAllReduce operations
   bool hostAllReduceRemoteBuffer = false;
 
+  /// Sum the gradients streamed to the host with the built in
+  /// HostReduceEngine, rather than with callbacks connected by the user with
+  /// connectStreamToCallback. The gradients of all replicas are summed on a
+  /// pool of host threads, and the sums are streamed back to the device.
+  /// Requires hostAllReduce, and is not supported with hostWeightUpdate or
+  /// hostAllReduceRemoteBuffer
+  bool hostAllReduceEngine = false;
+
+  /// The size in bytes of the buckets which the HostReduceEngine splits
+  /// gradients into. The buckets are summed concurrently
+  int64_t hostAllReduceBucketSize = 1 << 20;
+
   /// Poplar engine options
   std::map<std::string, std::string> engineOptions;
 
@@ -349,6 +429,10 @@ struct SessionOptions {
   /// to host at the end, this trades off sum-liveness efficiency for cycle
   /// efficiency.
   bool groupHostSync = false;
+
+  /// The number of sets of anchor buffers used by Session::runAsync, which
+  /// bounds the number of steps whose anchors can be held at once.
+  unsigned asyncAnchorBufferSets = 2;
 };
 
 } // namespace popart
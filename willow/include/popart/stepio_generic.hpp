@@ -112,6 +112,25 @@ public:
     return get<ConstVoidData>(id, inputsInfo, numElements, false, "inputs");
   }
 
+  ConstVoidData inZeroCopy(TensorId id, int64_t) final {
+    if (!zeroCopyInputs) {
+      return {};
+    }
+    auto found = inputsInfo.find(id);
+    if (found == inputsInfo.end()) {
+      throw error("No tensor {} provided in PyStepIO's inputs", id);
+    }
+    ArrayInfo &arrayInfo = found->second;
+    return ConstVoidData(ACCESSOR_TYPE::getDataPointer(arrayInfo.array),
+                         getTensorInfo(arrayInfo.array));
+  }
+
+  // Connect the input streams directly to the input arrays where possible,
+  // rather than copying from them on every stream callback. The arrays must
+  // not be modified while a step is running.
+  void enableZeroCopyInputs(bool b) { zeroCopyInputs = b; }
+  bool zeroCopyInputsEnabled() const { return zeroCopyInputs; }
+
   void inComplete(TensorId id, int64_t numElements) final {
     return advance<ConstVoidData>(id, inputsInfo, numElements, "inputs");
   }
@@ -124,6 +143,9 @@ protected:
   StepIOGeneric() {}
   std::map<TensorId, ArrayInfo> outputsInfo;
   std::map<TensorId, ArrayInfo> inputsInfo;
+
+private:
+  bool zeroCopyInputs{false};
 };
 
 } // namespace popart
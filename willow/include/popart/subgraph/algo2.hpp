@@ -0,0 +1,168 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_RINSEMATCHER_ALGO2_HPP
+#define GUARD_NEURALNET_RINSEMATCHER_ALGO2_HPP
+
+#include "algo1.hpp"
+#include "isomorphic.hpp"
+#include "match.hpp"
+#include "subgraphutil.hpp"
+
+#include <map>
+#include <vector>
+#include <popart/logging.hpp>
+#include <popart/threadpool.hpp>
+
+namespace fwtools {
+namespace subgraph {
+namespace algo2 {
+
+// Schedules shorter than this are matched with ALGO1 directly
+constexpr int minHierarchicalLength = 256;
+
+// The number of times a block is searched for repeated blocks within it
+constexpr int maxHierarchicalDepth = 3;
+
+// The mean number of nodes in a chunk of the compressed schedule
+constexpr int chunkLength = 8;
+
+// The number of candidate blocks checked for isomorphic instances
+constexpr int maxBlockCandidates = 8;
+
+// Split an integer schedule into chunks, with content defined boundaries:
+// whether a chunk starts at a position depends only on the few integers
+// before it, so that repeated sequences are split into the same chunks
+// (except for the chunks at their ends). Returns the start of each chunk,
+// followed by the length of the schedule.
+std::vector<Start> getChunkStarts(const std::vector<int> &intSched,
+                                  int meanLength);
+
+// Candidates for coarse repeated blocks, found with the suffix tree of the
+// schedule compressed to one integer per chunk. The starts of each candidate
+// do not overlap, and the candidates are sorted so that those which cover the
+// most nodes of the schedule (not counting the first instance) are first.
+// The isomorphism of the instances is not checked.
+std::vector<Match> getRepeatedBlocks(const std::vector<int> &intSched,
+                                     int meanChunkLength);
+
+template <typename T>
+std::vector<Match> getAlgo1Matches(const std::vector<T *> &schedule,
+                                   float threshold) {
+  algo1::Algo1<T> algo(schedule);
+  algo.init();
+  return applyIncrementalThreshold(algo.getPreThresholded(),
+                                   static_cast<int>(schedule.size()),
+                                   threshold);
+}
+
+// Hierarchical matching. Find a coarse repeated block (such as a layer of a
+// network) with getRepeatedBlocks, keeping the instances which are
+// isomorphic to the first. Then match within the first instance, and within
+// each of the gaps between instances, independently and in parallel, either
+// recursively or with ALGO1. The matches within the first instance are
+// repeated in every instance, and the block itself is a match.
+template <typename T>
+std::vector<Match> getHierarchicalMatches(const std::vector<T *> &schedule,
+                                          float threshold,
+                                          int depth = 0) {
+  const int n = static_cast<int>(schedule.size());
+  if (n < minHierarchicalLength || depth >= maxHierarchicalDepth) {
+    return getAlgo1Matches(schedule, threshold);
+  }
+
+  std::map<T *, int> schedule_index;
+  for (int i = 0; i < n; ++i) {
+    schedule_index[schedule[i]] = i;
+  }
+
+  // The first candidate block with at least 2 isomorphic instances
+  std::vector<Start> instances;
+  int length      = 0;
+  auto candidates = getRepeatedBlocks(getIntSchedule(schedule), chunkLength);
+  if (candidates.size() > maxBlockCandidates) {
+    candidates.erase(candidates.begin() + maxBlockCandidates,
+                     candidates.end());
+  }
+  for (auto &candidate : candidates) {
+    instances = {candidate.starts[0]};
+    for (int i = 1; i < candidate.starts.size(); ++i) {
+      if (isomorphicUntil(candidate.length,
+                          candidate.starts[0],
+                          candidate.starts[i],
+                          schedule,
+                          schedule_index) == candidate.length) {
+        instances.push_back(candidate.starts[i]);
+      }
+    }
+    if (instances.size() > 1) {
+      length = candidate.length;
+      break;
+    }
+  }
+  if (length == 0) {
+    return getAlgo1Matches(schedule, threshold);
+  }
+
+  popart::logging::trace("[getRinseMatches] depth {}, block of length {} "
+                         "with {} instances in a schedule of length {}",
+                         depth,
+                         length,
+                         instances.size(),
+                         n);
+
+  // The first instance, followed by the gaps between instances
+  std::vector<std::pair<Start, int>> slices{{instances[0], length}};
+  Start end = 0;
+  for (int i = 0; i <= instances.size(); ++i) {
+    Start next = i < instances.size() ? instances[i] : n;
+    if (next > end) {
+      slices.push_back({end, next - end});
+    }
+    if (i < instances.size()) {
+      end = instances[i] + length;
+    }
+  }
+
+  std::vector<std::vector<Match>> sliceMatches(slices.size());
+  popart::ThreadPool::global().parallelFor(
+      static_cast<int64_t>(slices.size()),
+      1,
+      [&](int64_t firstSlice, int64_t endSlice) {
+        for (int64_t i = firstSlice; i < endSlice; ++i) {
+          std::vector<T *> slice(schedule.begin() + slices[i].first,
+                                 schedule.begin() + slices[i].first +
+                                     slices[i].second);
+          sliceMatches[i] = getHierarchicalMatches(slice, threshold, depth + 1);
+        }
+      });
+
+  std::vector<Match> matches{Match(instances, length)};
+  for (auto &match : sliceMatches[0]) {
+    std::vector<Start> starts;
+    for (auto instance : instances) {
+      for (auto start : match.starts) {
+        starts.push_back(instance + start);
+      }
+    }
+    matches.emplace_back(starts, match.length);
+  }
+  for (int i = 1; i < slices.size(); ++i) {
+    for (auto &match : sliceMatches[i]) {
+      std::vector<Start> starts;
+      for (auto start : match.starts) {
+        starts.push_back(slices[i].first + start);
+      }
+      matches.emplace_back(starts, match.length);
+    }
+  }
+
+  // The smallest, least valuable matches first, as in ALGO1
+  setValues(matches, schedule);
+  std::sort(matches.begin(), matches.end());
+  return applyIncrementalThreshold(matches, n, threshold);
+}
+
+} // namespace algo2
+} // namespace subgraph
+} // namespace fwtools
+
+#endif
@@ -98,8 +98,15 @@ int isomorphicUntil(int seq_length,
       auto prod1 = std::get<0>(in1);
       auto out1  = std::get<1>(in1);
 
-      bool extern0 = (prod0 == nullptr || relativeToStart(prod0, s0) < 0);
-      bool extern1 = (prod1 == nullptr || relativeToStart(prod1, s1) < 0);
+      // producers which are not in the schedule are external, as when the
+      // schedule is a slice of a larger schedule
+      auto isExtern = [&schedule_index, &relativeToStart](T *prod, Start s) {
+        return prod == nullptr ||
+               schedule_index.find(prod) == schedule_index.end() ||
+               relativeToStart(prod, s) < 0;
+      };
+      bool extern0 = isExtern(prod0, s0);
+      bool extern1 = isExtern(prod1, s1);
 
       if (extern0 && extern1) {
         // both are external
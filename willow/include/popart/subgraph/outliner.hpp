@@ -4,6 +4,7 @@
 
 #include "algo0.hpp"
 #include "algo1.hpp"
+#include "algo2.hpp"
 #include <popart/logging.hpp>
 
 namespace fwtools {
@@ -29,7 +30,16 @@ enum class OutlinerAlgorithm {
   // it. Otherwise accept it. Best case : O(N) if a big match is found which
   // empties the queue. Worst case when all isomorphic: quadratic. Worst case
   // when few isomorphisms cubic (see T7779)
-  ALGO1
+  ALGO1,
+
+  // Hierarchical
+  // Find a coarse repeated block with the suffix tree of the schedule
+  // compressed into content defined chunks, then run ALGO1 (or ALGO2
+  // recursively) within one instance of the block and within each gap between
+  // instances, in parallel. Matches within the block are repeated in every
+  // instance. Much faster than ALGO1 on long schedules of repeated layers, but
+  // does not find matches which cross the boundaries of the block
+  ALGO2
 };
 
 // ALGO1
@@ -83,6 +93,15 @@ std::vector<Match> getRinseMatches(const std::vector<T *> &schedule,
 
     return acc;
   }
+
+  case OutlinerAlgorithm::ALGO2: {
+    auto acc = algo2::getHierarchicalMatches(schedule, threshold);
+
+    popart::logging::trace("[getRinseMatches] #matches post threshold: {}",
+                           acc.size());
+
+    return acc;
+  }
   }
   return std::vector<Match>{};
 }
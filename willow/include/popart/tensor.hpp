@@ -123,6 +123,8 @@ public:
   // must be set after construction
   Tensor(TensorId, TensorType, Graph &);
   TensorId id;
+  // id, interned in the TensorIdInterner of the Ir
+  const TensorHandle handle;
   std::string str() const final { return id; }
 
   // a copy of this, but with no consumers or producer
@@ -3,10 +3,12 @@
 #define GUARD_NEURALNET_TENSORDATA_HPP
 
 #include <functional>
+#include <memory>
 #include <numeric>
 #include <ostream>
 #include <popart/error.hpp>
 #include <popart/iarray.hpp>
+#include <popart/mappedregion.hpp>
 #include <popart/names.hpp>
 #include <popart/tensorinfo.hpp>
 
@@ -20,12 +22,20 @@ public:
   // the size of the copy determined by TensorInfo
   TensorData(const TensorInfo &, const void *src);
 
-  // create by copying to data_ from ONNX_NAMESPACE::TensorProto
+  // create by copying to data_ from ONNX_NAMESPACE::TensorProto. Data stored
+  // externally is not copied, but referenced in a copy-on-write mapping of
+  // its file (see MappedRegion), if the data is suitably aligned.
   TensorData(const ONNX_NAMESPACE::TensorProto &);
 
   void *data();
   const void *data() const;
 
+  // The size of the data, in bytes
+  std::size_t size() const;
+
+  // Is the data in a mapping of an external data file?
+  bool isMapped() const { return mapped != nullptr; }
+
   // reset the data in the TensorData by copying from src.
   // Input data must be the same size as the existing data_
   void resetData(const TensorInfo &, const void *src);
@@ -37,11 +47,11 @@ public:
 
   template <typename RESULT_TYPE>
   std::vector<RESULT_TYPE> copyDataAs(int expectedResultSize) const {
-    if (data_.size() != expectedResultSize * sizeof(RESULT_TYPE)) {
+    if (size() != expectedResultSize * sizeof(RESULT_TYPE)) {
       throw error("Size of data does not match expected result size. Expected "
                   "data of {} bytes, but data is {} bytes in size.",
                   expectedResultSize * sizeof(RESULT_TYPE),
-                  data_.size());
+                  size());
     }
 
     std::vector<RESULT_TYPE> result;
@@ -54,6 +64,10 @@ public:
 
 private:
   std::vector<char> data_;
+
+  // If set, the data is in this region of an external data file, and data_
+  // is empty
+  std::unique_ptr<MappedRegion> mapped;
 };
 
 } // namespace popart
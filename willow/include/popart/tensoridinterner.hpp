@@ -0,0 +1,45 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_TENSORIDINTERNER_HPP
+#define GUARD_NEURALNET_TENSORIDINTERNER_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <popart/names.hpp>
+
+namespace popart {
+
+// A table giving each TensorId interned in it a dense TensorHandle, counted
+// from 0 in the order the ids were first interned. Handles are never reused,
+// so a handle stays valid (and keeps standing for the same TensorId) for the
+// lifetime of the table, even after the Tensor it was interned for is gone.
+//
+// An Ir has one table, shared by all of its Graphs, so that containers of
+// Tensors keyed on a handle hash the TensorId once, when it is interned,
+// rather than on every lookup.
+//
+// Interning is not thread safe, but any number of threads may look up ids
+// and handles while nothing is being interned.
+class TensorIdInterner {
+public:
+  // The handle of `id', which is interned if it is not already
+  TensorHandle intern(const TensorId &id);
+
+  // The handle of `id', or unusedTensorHandle if it has not been interned
+  TensorHandle find(const TensorId &id) const;
+
+  // The TensorId of a handle given by this table
+  const TensorId &getId(TensorHandle handle) const;
+
+  std::size_t size() const { return ids.size(); }
+
+private:
+  std::unordered_map<TensorId, TensorHandle> handles;
+  // The keys of handles (which are not moved by rehashing), by handle
+  std::vector<const TensorId *> ids;
+};
+
+} // namespace popart
+
+#endif
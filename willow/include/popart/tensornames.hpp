@@ -38,6 +38,10 @@ constexpr const char *reservedAcclToUpdatePrefix() {
 constexpr const char *reservedAcclFinalOutPrefix() {
   return "AcclOutOfAcclUpdate___";
 }
+// The first and second moments, and the step count, of the Adam optimizers
+constexpr const char *reservedAccl1Prefix() { return "Accl1___"; }
+constexpr const char *reservedAccl2Prefix() { return "Accl2___"; }
+constexpr const char *reservedStepPrefix() { return "Step___"; }
 constexpr const char *reservedStashedPrefix() { return "Stashed___"; }
 constexpr const char *reservedRestoredPrefix() { return "Restored___"; }
 
@@ -98,6 +102,48 @@ constexpr const char *reservedSpecificScaledMomentum1Prefix() {
   return "scaledMomentum1___specific___";
 }
 
+constexpr const char *reservedDefaultAdamLearningRatePrefix() {
+  return "adamLearningRate___default___";
+}
+constexpr const char *reservedSpecificAdamLearningRatePrefix() {
+  return "adamLearningRate___specific___";
+}
+
+constexpr const char *reservedDefaultAdamWeightDecayPrefix() {
+  return "adamWeightDecay___default___";
+}
+constexpr const char *reservedSpecificAdamWeightDecayPrefix() {
+  return "adamWeightDecay___specific___";
+}
+
+constexpr const char *reservedDefaultAdamBeta1Prefix() {
+  return "adamBeta1___default___";
+}
+constexpr const char *reservedSpecificAdamBeta1Prefix() {
+  return "adamBeta1___specific___";
+}
+
+constexpr const char *reservedDefaultAdamBeta2Prefix() {
+  return "adamBeta2___default___";
+}
+constexpr const char *reservedSpecificAdamBeta2Prefix() {
+  return "adamBeta2___specific___";
+}
+
+constexpr const char *reservedDefaultAdamEpsPrefix() {
+  return "adamEps___default___";
+}
+constexpr const char *reservedSpecificAdamEpsPrefix() {
+  return "adamEps___specific___";
+}
+
+constexpr const char *reservedDefaultAdamGradientScalePrefix() {
+  return "adamGradientScale___default___";
+}
+constexpr const char *reservedSpecificAdamGradientScalePrefix() {
+  return "adamGradientScale___specific___";
+}
+
 constexpr const char *hostReduceGradCopyPrefix() {
   return "hostReduceGradCopy___";
 }
@@ -2,6 +2,7 @@
 #ifndef GUARD_NEURALNET_WILLOWTENSORS_HPP
 #define GUARD_NEURALNET_WILLOWTENSORS_HPP
 
+#include <map>
 #include <unordered_map>
 #include <vector>
 #include <popart/aliases.hpp>
@@ -17,8 +18,10 @@ public:
   ~Tensors() = default;
 
   Tensor *get(TensorId) const;
+  Tensor *get(TensorHandle) const;
   void remove(TensorId);
   bool contains(TensorId) const;
+  bool contains(TensorHandle) const;
 
   // Search for a tensor with a scope
   // Return the scoped tensorId
@@ -45,6 +48,7 @@ public:
   std::vector<TensorId> getIds(TensorType) const;
   std::vector<Tensor *> getOfType(TensorType) const;
   std::vector<TensorId> getAllTensorIds() const;
+  std::size_t size() const { return M.size(); }
   std::vector<TensorId> getNoProducerIds() const;
   void append(std::stringstream &) const;
 
@@ -55,7 +59,12 @@ public:
 
   const Aliases &getAliases() const { return aliases; }
   void clearAliases();
+  // Let the Chains flow through op, which has been added to the Graph
   void updateAliases(Op *op);
+  // Bring the aliases up to date with the Ops of the Graph. Only the alias
+  // components touched by Ops which were added, removed or changed since the
+  // last call are recomputed, the Chains of all other Tensors are kept
+  void updateAliases();
   view::Regions getAliasRegions(Tensor *from, Tensor *to) const;
 
   // all non-empty alias Chains to "to"
@@ -79,9 +88,13 @@ private:
   // Store the Tensors of type Const
   VectorAndSet constIds;
 
-  std::unordered_map<TensorId, std::unique_ptr<Tensor>> M;
+  // Keyed on the handles of the Tensors' ids
+  std::unordered_map<TensorHandle, std::unique_ptr<Tensor>> M;
   // adds to M, but first confirms that TensorId not already in
   void insert(TensorId, std::unique_ptr<Tensor>);
+  // The handle of a TensorId, or unusedTensorHandle if it was never interned
+  // (in which case there is no Tensor with that id)
+  TensorHandle findHandle(const TensorId &) const;
 
   void
   addInit(const TensorId &, const ONNX_NAMESPACE::TensorProto *, TensorType);
@@ -89,6 +102,26 @@ private:
   Graph &graph;
 
   Aliases aliases;
+
+  // An input to output alias of an Op, as it was when added to aliases
+  struct AliasEdge {
+    InIndex inIndex;
+    OutIndex outIndex;
+    Tensor *in;
+    Tensor *out;
+    Shape inShape;
+    Shape outShape;
+    view::Regions inRegions;
+
+    bool operator==(const AliasEdge &) const;
+    bool operator!=(const AliasEdge &rhs) const { return !(*this == rhs); }
+  };
+
+  // The AliasEdges of the Ops which are in aliases, for Ops with any
+  std::map<OpId, std::vector<AliasEdge>> aliasEdges;
+
+  std::vector<AliasEdge> getAliasEdges(Op *) const;
+  void addAliasEdges(Op *, const std::vector<AliasEdge> &);
 };
 
 } // namespace popart
@@ -0,0 +1,62 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#ifndef GUARD_NEURALNET_THREADPOOL_HPP
+#define GUARD_NEURALNET_THREADPOOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace popart {
+
+// A fixed size pool of worker threads, for data parallel host side work such
+// as type conversion of stream buffers. Tasks are run in the order they are
+// submitted.
+class ThreadPool {
+public:
+  // Create a pool with nThreads workers. A pool with 0 workers runs every
+  // task on the calling thread.
+  explicit ThreadPool(unsigned nThreads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+  // Queue a task to be run on a worker. Exceptions thrown by the task are
+  // rethrown by the returned future's get().
+  std::future<void> submit(std::function<void()> task);
+
+  // Call f(begin, end) on disjoint chunks covering [0, n), each of at least
+  // `grain' elements (except possibly the last), and block until all chunks
+  // are done. The calling thread processes one of the chunks. If called from
+  // within a worker of this pool, all chunks are run on the calling thread.
+  // The first exception thrown by f is rethrown.
+  void parallelFor(int64_t n,
+                   int64_t grain,
+                   const std::function<void(int64_t, int64_t)> &f);
+
+  // The process wide pool. Its size is the value of the environment variable
+  // POPART_HOST_THREADS if set, otherwise one less than the number of hardware
+  // threads.
+  static ThreadPool &global();
+
+private:
+  void workerLoop();
+  bool isWorkerThread() const;
+
+  std::vector<std::thread> workers;
+  std::queue<std::packaged_task<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool stopping{false};
+};
+
+} // namespace popart
+
+#endif
@@ -70,12 +70,18 @@ public:
     return valsBefore;
   }
 
+  // The number of calls which have modified these constraints. Part of the
+  // mutation epoch of the Graph which owns them.
+  uint64_t getNumMutations() const { return nMutations; }
+
 private:
   // for all val : set, "key -> val"
   std::map<Op *, std::set<TopoOp>, POpCmp> valsAfter;
 
   // the mirror of valsAfterKey, so for all val : set, "val -> key"
   std::map<Op *, std::set<TopoOp>, POpCmp> valsBefore;
+
+  uint64_t nMutations{0};
 };
 
 std::ostream &operator<<(std::ostream &os, const TopoCons &tc);
@@ -2,11 +2,68 @@
 #ifndef GUARD_NEURALNET_AUTO_VIRTUAL_GRAPH_HPP
 #define GUARD_NEURALNET_AUTO_VIRTUAL_GRAPH_HPP
 
+#include <memory>
+#include <vector>
 #include <popart/op.hpp>
 #include <popart/transforms/transform.hpp>
 
 namespace popart {
 
+// Estimates the time of Ops and inter-IPU copies, for balancing pipeline
+// stages with AutoVirtualGraphType::ComputeBalanced. The units are arbitrary,
+// but must be the same for computeCost and copyCost. Subclass to plug in a
+// better model, see AutoVirtualGraph::setCostModel.
+class OpCostModel {
+public:
+  // flopsPerCopiedByte: the compute time of a copied byte, in FLOPs
+  OpCostModel(double flopsPerCopiedByte_ = 100.0)
+      : flopsPerCopiedByte(flopsPerCopiedByte_) {}
+  virtual ~OpCostModel() = default;
+
+  // The default is the FLOPs of MatMulOp and ConvOp, and one FLOP per output
+  // element of other Ops. If training, Ops with gradients cost 3 times as
+  // much, for the forward and the 2 backward passes.
+  virtual double computeCost(Op *op, bool training) const;
+
+  // The default is proportional to the bytes copied.
+  virtual double copyCost(int64_t bytes) const;
+
+private:
+  double flopsPerCopiedByte;
+};
+
+namespace autovirtualgraph {
+
+struct StagePartition {
+  // The position in the schedule of the first Op of each stage, followed by
+  // the length of the schedule
+  std::vector<size_t> stageStarts;
+  // The compute cost of each stage plus the cost of copying its outputs to
+  // the next stage
+  std::vector<double> stageTime;
+  std::vector<int64_t> stageMemory;
+  double maxStageTime;
+  // The summed cost of the copies between stages
+  double totalCopyCost;
+};
+
+// Split a schedule of Ops into numStages contiguous stages, given the compute
+// cost and memory of each Op, and cutCost, the cost of the copies needed if
+// a stage starts at each position in the schedule (of size compute.size() +
+// 1, with the first and last entries unused).
+//
+// Returns the stages with the least maximum stage time whose memory is at
+// most memoryCap, and of those, the stages with the least total copy cost. If
+// memoryCap is not positive, memory is not limited. Throws if the schedule is
+// shorter than numStages, or no stages fit in memoryCap.
+StagePartition partitionStages(const std::vector<double> &compute,
+                               const std::vector<int64_t> &memory,
+                               const std::vector<double> &cutCost,
+                               int64_t numStages,
+                               int64_t memoryCap);
+
+} // namespace autovirtualgraph
+
 class Subgraph {
 public:
   Subgraph(OpId op_id) : cost(0.f), candidates({op_id}), split_nodes({}) {}
@@ -42,6 +99,14 @@ public:
 
   float
   costFn(Op *op, bool training, float w_weights, float w_activations) const;
+
+  // Set the cost model used by AutoVirtualGraphType::ComputeBalanced. If
+  // nullptr, the default OpCostModel is used.
+  static void setCostModel(std::shared_ptr<OpCostModel> model);
+  static const OpCostModel &getCostModel();
+
+private:
+  void applyComputeBalanced(Graph &graph, int64_t num_ipus) const;
 };
 
 } // namespace popart
@@ -23,6 +23,9 @@ public:
   // apply a transformation to the given Ir
   static void applyTransform(std::size_t transformId, Graph &);
 
+  // the name of a registered transform
+  static std::string getTransformName(std::size_t transformId);
+
   // add a transform to the list of transforms
   static bool registerTransform(Transform *transform);
 };
@@ -50,18 +50,91 @@ Aliases::aliasChainsFrom(Tensor *from) const {
 
 // Regions in "from" aliased "to"
 view::Regions Aliases::getAliasRegions(Tensor *from, Tensor *to) const {
-  auto aliasedTensorMap = aliasChainsFrom(from);
-  auto it               = aliasedTensorMap.find(to);
-  if (it == aliasedTensorMap.end()) {
-    return view::Regions({view::Region::getEmpty(to->info.rank())});
-  } else {
-    return it->second.apply(view::Region::getFull(from->info.shape()));
+  if (from == to) {
+    return view::Regions({view::Region::getFull(from->info.shape())});
   }
+  auto found = aliasRegionsFromKey.find(from);
+  if (found != aliasRegionsFromKey.end()) {
+    auto it = found->second.find(to);
+    if (it != found->second.end()) {
+      return it->second;
+    }
+  }
+  return view::Regions({view::Region::getEmpty(to->info.rank())});
+}
+
+std::set<Tensor *>
+Aliases::getAliasComponent(const std::vector<Tensor *> &ts) const {
+  std::set<Tensor *> component(ts.begin(), ts.end());
+  std::vector<Tensor *> toVisit(component.begin(), component.end());
+
+  auto visit = [&component, &toVisit](
+                   const std::unordered_map<Tensor *, view::Chains> &M) {
+    for (auto &t_chains : M) {
+      if (component.insert(t_chains.first).second) {
+        toVisit.push_back(t_chains.first);
+      }
+    }
+  };
+
+  while (!toVisit.empty()) {
+    Tensor *t = toVisit.back();
+    toVisit.pop_back();
+    auto to = aliasChainsToKey.find(t);
+    if (to != aliasChainsToKey.end()) {
+      visit(to->second);
+    }
+    auto from = aliasChainsFromKey.find(t);
+    if (from != aliasChainsFromKey.end()) {
+      visit(from->second);
+    }
+  }
+  return component;
 }
 
 void Aliases::clearAliases() {
   aliasChainsFromKey.clear();
   aliasChainsToKey.clear();
+  aliasRegionsFromKey.clear();
+}
+
+void Aliases::clearAliases(const std::set<Tensor *> &ts) {
+  for (Tensor *t : ts) {
+    // the mirrors of the Chains to and from t, keyed on the other Tensor
+    auto to = aliasChainsToKey.find(t);
+    if (to != aliasChainsToKey.end()) {
+      for (auto &from_chains : to->second) {
+        Tensor *from = from_chains.first;
+        if (from != t) {
+          aliasChainsFromKey[from].erase(t);
+          aliasRegionsFromKey[from].erase(t);
+        }
+      }
+      aliasChainsToKey.erase(to);
+    }
+    auto from = aliasChainsFromKey.find(t);
+    if (from != aliasChainsFromKey.end()) {
+      for (auto &to_chains : from->second) {
+        if (to_chains.first != t) {
+          aliasChainsToKey[to_chains.first].erase(t);
+        }
+      }
+      aliasChainsFromKey.erase(from);
+    }
+    aliasRegionsFromKey.erase(t);
+  }
+}
+
+void Aliases::setChains(Tensor *from, Tensor *to, const view::Chains &chains) {
+  aliasChainsToKey[to][from]   = chains;
+  aliasChainsFromKey[from][to] = chains;
+
+  auto regions = chains.apply(view::Region::getFull(from->info.shape()));
+  if (regions.empty()) {
+    aliasRegionsFromKey[from].erase(to);
+  } else {
+    aliasRegionsFromKey[from][to] = std::move(regions);
+  }
 }
 
 // Let the Chains flow through
@@ -98,7 +171,14 @@ void Aliases::updateAliases(Tensor *t1,
         }
       };
 
-  for (auto inRegion : inRegions) {
+  // all chains t0 -> t1 for all t0. These are not changed until the new
+  // Chains are added below
+  auto allInChains = aliasChainsTo(t1);
+
+  // all chains t2 -> t3 for all t3
+  auto allOutChains = aliasChainsFrom(t2);
+
+  for (auto &inRegion : inRegions) {
     if (inRegion.isEmpty()) {
       continue;
     }
@@ -107,7 +187,7 @@ void Aliases::updateAliases(Tensor *t1,
 
     // if there is an alias between the unique output
     // t2 and the input t1, this opens new Chains
-    for (auto outRegion : outRegions) {
+    for (auto &outRegion : outRegions) {
       if (outRegion.isEmpty()) {
         continue;
       }
@@ -115,17 +195,11 @@ void Aliases::updateAliases(Tensor *t1,
       view::Link fwdLink(inRegion, fwdMap, fwdLinkName);
       view::Link bwdLink(outRegion, bwdMap, bwdLinkName);
 
-      // all chains t0 -> t1 for all t0
-      auto allInChains = aliasChainsTo(t1);
-
-      // all chains t2 -> t3 for all t3
-      auto allOutChains = aliasChainsFrom(t2);
-
       for (auto &inwards : allInChains) {
         Tensor *t0 = inwards.first;
         // the chains t0 -> t1
-        view::Chains inChains      = inwards.second;
-        auto inChainsFwdLinkSeries = inChains.series(fwdLink);
+        const view::Chains &inChains = inwards.second;
+        auto inChainsFwdLinkSeries   = inChains.series(fwdLink);
 
         // the chains t1 -> t0. There are such chains,
         // guaranteed by the existence of chains t0 -> t1
@@ -136,7 +210,7 @@ void Aliases::updateAliases(Tensor *t1,
           Tensor *t3 = outwards.first;
 
           // the chains t2 -> t3
-          view::Chains outChains = outwards.second;
+          const view::Chains &outChains = outwards.second;
 
           // the chains t3 -> t2
           // (which must exist by symmetry of aliasing)
@@ -184,22 +258,18 @@ void Aliases::updateAliases(Tensor *t1,
     }
   }
 
-  for (auto x : newAliases) {
-    auto t0         = x.first;
-    auto t3_chain_s = x.second;
-    if (aliasChainsToKey.find(t0) == aliasChainsToKey.end()) {
-      aliasChainsToKey[t0] = {};
-    }
-    for (auto t3_chain : t3_chain_s) {
+  for (auto &x : newAliases) {
+    auto t0    = x.first;
+    auto &toT0 = aliasChainsToKey[t0];
+    for (auto &t3_chain : x.second) {
       auto t3    = t3_chain.first;
-      auto chain = t3_chain.second;
-      if (aliasChainsToKey.at(t0).find(t3) == aliasChainsToKey.at(t0).end()) {
-        aliasChainsToKey[t0][t3] = {}; // empty Chains
+      auto found = toT0.find(t3);
+      // add the new Chains, and update the mirror image
+      if (found == toT0.end()) {
+        setChains(t3, t0, t3_chain.second);
+      } else {
+        setChains(t3, t0, found->second.parallel(t3_chain.second));
       }
-      // add the new Chains
-      aliasChainsToKey[t0][t3] = aliasChainsToKey[t0][t3].parallel(chain);
-      // insert the mirror image
-      aliasChainsFromKey[t3][t0] = aliasChainsToKey[t0][t3];
     }
   }
 }
@@ -207,14 +277,9 @@ void Aliases::updateAliases(Tensor *t1,
 void Aliases::addAllAliases(const Aliases &other) {
   for (auto &kv0 : other.aliasChainsToKey) {
     for (auto &kv1 : kv0.second) {
-      aliasChainsToKey[kv0.first][kv1.first] =
-          aliasChainsToKey[kv0.first][kv1.first].parallel(kv1.second);
-    }
-  }
-  for (auto &kv0 : other.aliasChainsFromKey) {
-    for (auto &kv1 : kv0.second) {
-      aliasChainsFromKey[kv0.first][kv1.first] =
-          aliasChainsFromKey[kv0.first][kv1.first].parallel(kv1.second);
+      auto to   = kv0.first;
+      auto from = kv1.first;
+      setChains(from, to, aliasChainsToKey[to][from].parallel(kv1.second));
     }
   }
 }
@@ -0,0 +1,257 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <chrono>
+
+#include <popart/asyncrun.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/error.hpp>
+#include <popart/ir.hpp>
+#include <popart/logging.hpp>
+#include <popart/popx/devicex.hpp>
+#include <popart/stepio_size_assertion.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensors.hpp>
+
+namespace popart {
+
+HostBufferStepIO::HostBufferStepIO(std::map<TensorId, ConstVoidData> inputs_) {
+  for (auto &input : inputs_) {
+    inputs.insert({input.first, {input.second, 0}});
+  }
+}
+
+ConstVoidData HostBufferStepIO::in(TensorId id, int64_t numElements, bool) {
+  auto found = inputs.find(id);
+  if (found == inputs.end()) {
+    throw error("No tensor {} provided in HostBufferStepIO's inputs", id);
+  }
+  auto &input      = found->second;
+  const auto &info = input.data.info;
+  ConstVoidData data;
+  data.data = static_cast<const char *>(input.data.data) + input.offset;
+  data.info = TensorInfo(info.dataType(), {numElements});
+  return data;
+}
+
+void HostBufferStepIO::inComplete(TensorId id, int64_t numElements) {
+  auto &input = inputs.at(id);
+  input.offset += input.data.info.getDataTypeInfo()->nbytes() * numElements;
+  // Wrap around if we read all the data
+  if (input.offset >= input.data.info.nbytes()) {
+    input.offset = 0;
+  }
+}
+
+ConstVoidData HostBufferStepIO::inZeroCopy(TensorId id, int64_t) {
+  auto found = inputs.find(id);
+  if (found == inputs.end()) {
+    return {};
+  }
+  return found->second.data;
+}
+
+MutableVoidData HostBufferStepIO::out(TensorId id, int64_t) {
+  throw error("HostBufferStepIO has no anchors, but the anchor {} was "
+              "requested",
+              id);
+}
+
+void HostBufferStepIO::assertNumElements(const Ir &ir) const {
+  iosizecheck::assertInCorrect(
+      ir, inputs, [](const Input &input) { return input.data.info.nelms(); });
+}
+
+// The IStepIO given to Devicex::run for an asynchronous step: inputs are read
+// from the user's IStepIO, anchors are written to a buffer set.
+class AsyncRunner::StepIO : public IStepIO {
+public:
+  StepIO(IStepIO &inputs_, BufferSet &bufferSet_)
+      : inputs(inputs_), bufferSet(bufferSet_) {
+    enableRuntimeAsserts(inputs.runtimeAssertsEnabled());
+  }
+
+  ConstVoidData in(TensorId id, int64_t numElements, bool prefetch) final {
+    return inputs.in(id, numElements, prefetch);
+  }
+
+  void inComplete(TensorId id, int64_t numElements) final {
+    inputs.inComplete(id, numElements);
+  }
+
+  ConstVoidData inZeroCopy(TensorId id, int64_t numElements) final {
+    return inputs.inZeroCopy(id, numElements);
+  }
+
+  MutableVoidData out(TensorId id, int64_t numElements) final {
+    auto found = bufferSet.buffers.find(id);
+    if (found == bufferSet.buffers.end()) {
+      throw internal_error("No anchor buffer for {}", id);
+    }
+    auto &buffer = found->second;
+    MutableVoidData data;
+    data.data = buffer.data.data() + buffer.offset;
+    data.info = TensorInfo(buffer.info.dataType(), {numElements});
+    buffer.offset += data.info.nbytes();
+    // Wrap around if we wrote all the data
+    if (buffer.offset >= static_cast<int64_t>(buffer.data.size())) {
+      buffer.offset = 0;
+    }
+    return data;
+  }
+
+  // The anchor buffers are sized by the AsyncRunner, only the inputs need
+  // checking
+  void assertNumElements(const Ir &ir) const final {
+    inputs.assertNumElements(ir);
+  }
+
+private:
+  IStepIO &inputs;
+  BufferSet &bufferSet;
+};
+
+AsyncRunHandle::AsyncRunHandle(AsyncRunner &runner_,
+                               unsigned bufferSet_,
+                               std::shared_future<void> done_)
+    : runner(runner_), bufferSet(bufferSet_), done(std::move(done_)) {}
+
+AsyncRunHandle::~AsyncRunHandle() { release(); }
+
+void AsyncRunHandle::wait() {
+  if (released) {
+    throw error("Cannot wait on an AsyncRunHandle which has been released");
+  }
+  done.get();
+}
+
+bool AsyncRunHandle::isReady() const {
+  return released ||
+         done.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+const std::map<TensorId, MutableVoidData> &AsyncRunHandle::anchors() {
+  wait();
+  return runner.bufferSets.at(bufferSet).anchors;
+}
+
+void AsyncRunHandle::release() {
+  if (!released) {
+    done.wait();
+    runner.releaseBufferSet(bufferSet);
+    released = true;
+  }
+}
+
+AsyncRunner::AsyncRunner(popx::Devicex &device_, unsigned nBufferSets)
+    : device(device_), bufferSets(nBufferSets) {
+  if (nBufferSets == 0) {
+    throw error("AsyncRunner requires at least one set of anchor buffers");
+  }
+
+  const auto &ir       = device.ir();
+  const auto &dataFlow = ir.getDataFlow();
+  const int64_t bps    = dataFlow.batchesPerStep();
+  const int64_t rFact  = device.getReplicationFactor();
+  const int64_t aFact  = device.getAccumulationFactor();
+
+  for (const auto &id : dataFlow.anchors()) {
+    const auto &tensorInfo = ir.getMainGraphTensors().get(id)->info;
+
+    // The shape of the anchor arrays which the Python Session creates:
+    // [batchesPerStep, accumulationFactor, replicationFactor, *tensorShape],
+    // without the dimensions which are not returned or are of size 1.
+    Shape outer{rFact};
+    auto art = dataFlow.art(id);
+    switch (art.id()) {
+    case AnchorReturnTypeId::All:
+      outer.insert(outer.begin(), {bps, aFact});
+      break;
+    case AnchorReturnTypeId::EveryN:
+      outer.insert(outer.begin(), {bps / art.rp(), aFact});
+      break;
+    case AnchorReturnTypeId::Final:
+    case AnchorReturnTypeId::Sum:
+      break;
+    default:
+      throw error("Unknown anchor return type");
+    }
+    Shape shape;
+    for (auto dim : outer) {
+      if (dim != 1) {
+        shape.push_back(dim);
+      }
+    }
+    shape.insert(
+        shape.end(), tensorInfo.shape().begin(), tensorInfo.shape().end());
+    TensorInfo info(tensorInfo.dataType(), shape);
+
+    for (auto &bufferSet : bufferSets) {
+      auto &buffer = bufferSet.buffers[id];
+      buffer.data.resize(info.nbytes());
+      buffer.info   = info;
+      buffer.offset = 0;
+
+      MutableVoidData anchor;
+      anchor.data = buffer.data.data();
+      anchor.info = info;
+      bufferSet.anchors.insert({id, anchor});
+    }
+  }
+
+  logging::session::debug("Created an AsyncRunner with {} anchor buffer sets",
+                          nBufferSets);
+}
+
+AsyncRunner::~AsyncRunner() { waitForAll(); }
+
+std::unique_ptr<AsyncRunHandle> AsyncRunner::run(IStepIO &inputs) {
+  unsigned index;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    index = 0;
+    while (index < bufferSets.size() && bufferSets[index].inUse) {
+      ++index;
+    }
+    if (index == bufferSets.size()) {
+      throw error("All {} sets of anchor buffers are in use. Release an "
+                  "AsyncRunHandle before starting another step",
+                  bufferSets.size());
+    }
+    bufferSets[index].inUse = true;
+  }
+
+  BufferSet &bufferSet = bufferSets[index];
+  auto step            = [this, &inputs, &bufferSet]() {
+    for (auto &buffer : bufferSet.buffers) {
+      buffer.second.offset = 0;
+    }
+    StepIO stepio(inputs, bufferSet);
+    device.run(stepio);
+  };
+
+  std::shared_future<void> done;
+  try {
+    done = worker.submit(step).share();
+  } catch (...) {
+    releaseBufferSet(index);
+    throw;
+  }
+  lastStep = done;
+  logging::session::trace("Started an asynchronous step, anchor buffer set {}",
+                          index);
+  return std::unique_ptr<AsyncRunHandle>(
+      new AsyncRunHandle(*this, index, done));
+}
+
+void AsyncRunner::waitForAll() {
+  // Steps are run in order, so the last one to complete is the last started
+  if (lastStep.valid()) {
+    lastStep.wait();
+  }
+}
+
+void AsyncRunner::releaseBufferSet(unsigned index) {
+  std::lock_guard<std::mutex> lock(mutex);
+  bufferSets.at(index).inUse = false;
+}
+
+} // namespace popart
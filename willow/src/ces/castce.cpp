@@ -1,5 +1,6 @@
 // Copyright (c) 2018 Graphcore Ltd. All rights reserved.
 #include <popart/ces/castce.hpp>
+#include <popart/hostconversion.hpp>
 #include <popart/onnxutil.hpp>
 #include <popart/op/cast.hpp>
 #include <popart/tensor.hpp>
@@ -11,33 +12,48 @@ ConstExprCast::ConstExprCast(Op *op_) : ConstExprOp(op_) {}
 // If a specialised conversion is required, a specialised template for doCast
 // can be implemented.
 template <typename FROM, typename TO>
-std::vector<char> doCast(Tensor *inputTensor, const TensorInfo &outputInfo) {
-  auto inputData = static_cast<FROM *>(inputTensor->tensorData()->data());
-
+std::vector<char> doCast(const FROM *inputData, const TensorInfo &outputInfo) {
   std::vector<char> output(outputInfo.nbytes());
   auto outputData = reinterpret_cast<TO *>(output.data());
 
-  for (int i = 0; i < outputInfo.nelms(); i++) {
+  for (int64_t i = 0; i < outputInfo.nelms(); i++) {
     outputData[i] = static_cast<TO>(inputData[i]);
   }
 
   return output;
 }
 
+// Casts to FLOAT16 go through float, which is converted to FLOAT16 in bulk.
+// This rounds as casting to float16_t does.
 template <typename FROM>
-std::vector<char> tryCastFrom(Tensor *inputTensor,
+std::vector<char> doCastToHalf(const FROM *inputData,
+                               const TensorInfo &outputInfo) {
+  auto floats = doCast<FROM, float>(
+      inputData, TensorInfo(DataType::FLOAT, outputInfo.shape()));
+  std::vector<char> output(outputInfo.nbytes());
+  hostconversion::convert(DataType::FLOAT,
+                          floats.data(),
+                          DataType::FLOAT16,
+                          output.data(),
+                          outputInfo.nelms());
+  return output;
+}
+
+template <typename FROM>
+std::vector<char> tryCastFrom(const FROM *inputData,
+                              const TensorInfo &inputInfo,
                               const TensorInfo &outputInfo) {
   switch (outputInfo.dataType()) {
   case DataType::INT32:
-    return doCast<FROM, int32_t>(inputTensor, outputInfo);
+    return doCast<FROM, int32_t>(inputData, outputInfo);
   case DataType::INT64:
-    return doCast<FROM, int64_t>(inputTensor, outputInfo);
+    return doCast<FROM, int64_t>(inputData, outputInfo);
   case DataType::FLOAT:
-    return doCast<FROM, float>(inputTensor, outputInfo);
+    return doCast<FROM, float>(inputData, outputInfo);
   case DataType::FLOAT16:
-    return doCast<FROM, float16_t>(inputTensor, outputInfo);
+    return doCastToHalf<FROM>(inputData, outputInfo);
   case DataType::UINT32:
-    return doCast<FROM, uint32_t>(inputTensor, outputInfo);
+    return doCast<FROM, uint32_t>(inputData, outputInfo);
   case DataType::UINT8:
   case DataType::INT8:
   case DataType::UINT16:
@@ -52,25 +68,45 @@ std::vector<char> tryCastFrom(Tensor *inputTensor,
   case DataType::UNDEFINED:
   default:
     throw error("Currently no support for casting from {} to {}",
-                inputTensor->info.data_type(),
+                inputInfo.data_type(),
                 outputInfo.data_type());
   }
 }
 
 namespace {
 
+template <typename FROM>
+std::vector<char> tryCastFromTensor(Tensor *inputTensor,
+                                    const TensorInfo &outputInfo) {
+  auto inputData = static_cast<const FROM *>(inputTensor->tensorData()->data());
+  return tryCastFrom(inputData, inputTensor->info, outputInfo);
+}
+
+// Casts from FLOAT16 convert the input to float in bulk, then cast from float.
+// This rounds as casting from float16_t does.
+std::vector<char> tryCastFromHalf(Tensor *inputTensor,
+                                  const TensorInfo &outputInfo) {
+  std::vector<float> floats(inputTensor->info.nelms());
+  hostconversion::convert(DataType::FLOAT16,
+                          inputTensor->tensorData()->data(),
+                          DataType::FLOAT,
+                          floats.data(),
+                          inputTensor->info.nelms());
+  return tryCastFrom(floats.data(), inputTensor->info, outputInfo);
+}
+
 std::vector<char> tryCast(Tensor *inputTensor, const TensorInfo &outputInfo) {
   switch (inputTensor->info.dataType()) {
   case DataType::INT32:
-    return tryCastFrom<int32_t>(inputTensor, outputInfo);
+    return tryCastFromTensor<int32_t>(inputTensor, outputInfo);
   case DataType::INT64:
-    return tryCastFrom<int64_t>(inputTensor, outputInfo);
+    return tryCastFromTensor<int64_t>(inputTensor, outputInfo);
   case DataType::FLOAT:
-    return tryCastFrom<float>(inputTensor, outputInfo);
+    return tryCastFromTensor<float>(inputTensor, outputInfo);
   case DataType::FLOAT16:
-    return tryCastFrom<float16_t>(inputTensor, outputInfo);
+    return tryCastFromHalf(inputTensor, outputInfo);
   case DataType::UINT32:
-    return tryCastFrom<uint32_t>(inputTensor, outputInfo);
+    return tryCastFromTensor<uint32_t>(inputTensor, outputInfo);
   case DataType::UINT8:
   case DataType::INT8:
   case DataType::UINT16:
@@ -100,6 +136,16 @@ std::vector<char> ConstExprCast::compute() {
     std::vector<char> v_out(out_info.nbytes());
     std::memcpy(v_out.data(), in0->tensorData()->data(), in0->info.nbytes());
     return v_out;
+  } else if (hostconversion::canConvert(in0->info.dataType(),
+                                        out_info.dataType())) {
+    // Vectorized, and split across threads for large tensors
+    std::vector<char> v_out(out_info.nbytes());
+    hostconversion::convert(in0->info.dataType(),
+                            in0->tensorData()->data(),
+                            out_info.dataType(),
+                            v_out.data(),
+                            out_info.nelms());
+    return v_out;
   } else {
     return tryCast(in0, out_info);
   }
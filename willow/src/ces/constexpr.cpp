@@ -1,19 +1,25 @@
 // Copyright (c) 2018 Graphcore Ltd. All rights reserved.
 #include <memory>
+#include <set>
 #include <onnx/onnx_pb.h>
 #include <popart/attributes.hpp>
 #include <popart/ces/castce.hpp>
 #include <popart/ces/concatce.hpp>
 #include <popart/ces/constexpr.hpp>
 #include <popart/ces/elementwisece.hpp>
+#include <popart/ces/expandce.hpp>
 #include <popart/ces/floorce.hpp>
 #include <popart/ces/gatherce.hpp>
 #include <popart/ces/identityce.hpp>
+#include <popart/ces/padce.hpp>
+#include <popart/ces/reducece.hpp>
 #include <popart/ces/reshapece.hpp>
 #include <popart/ces/scalece.hpp>
 #include <popart/ces/slicece.hpp>
 #include <popart/ces/squeezece.hpp>
+#include <popart/ces/tilece.hpp>
 #include <popart/ces/transposece.hpp>
+#include <popart/ces/unaryce.hpp>
 #include <popart/ces/unsqueezece.hpp>
 #include <popart/error.hpp>
 #include <popart/graph.hpp>
@@ -22,6 +28,7 @@
 #include <popart/opmanager.hpp>
 #include <popart/tensor.hpp>
 #include <popart/tensors.hpp>
+#include <popart/threadpool.hpp>
 
 namespace popart {
 
@@ -47,6 +54,12 @@ void ConstExprUtil::processOp(Op *op, Graph &graph) {
   auto constOp = ConstExprOpManager::createConstExprOp(op);
 
   auto data = constOp->compute();
+  replaceWithConstInit(op, data, graph);
+}
+
+void ConstExprUtil::replaceWithConstInit(Op *op,
+                                         const std::vector<char> &data,
+                                         Graph &graph) {
   makeTensorConstInit(op->outTensor(0)->id, data.data(), graph);
   op->disconnectAllInputs();
 
@@ -55,37 +68,61 @@ void ConstExprUtil::processOp(Op *op, Graph &graph) {
   }
 
   graph.eraseOp(op->id);
-  op = nullptr;
 }
 
 const Op *ConstExprOp::getBaseOp() const { return this->op; }
 
 void ConstExprUtil::foldConstants(Graph &graph) {
   // get ops that may be computable
-  std::unordered_set<Op *> computable_ops;
+  std::vector<Op *> frontier;
   for (auto &id_op : graph.getOps()) {
     auto &op = id_op.second;
     if (isComputable(op.get(), graph)) {
-      computable_ops.insert(op.get());
+      frontier.push_back(op.get());
     }
   }
 
-  // try to fold ops, and where successful,
-  // add consumers of ops output to `computable_ops`
-  while (!computable_ops.empty()) {
-    auto op = *computable_ops.begin();
-    computable_ops.erase(op);
-
-    // get the id here as if processOp is successful,
-    // the tensor will be replaced
-    auto out_id = op->outTensor(0)->id;
-    processOp(op, graph);
-    auto out_tensor = graph.getTensors().get(out_id);
-    for (auto consumer : out_tensor->consumers.getOps()) {
-      if (isComputable(consumer, graph)) {
-        computable_ops.insert(consumer);
+  // The ops in a frontier only consume Const tensors, so are independent of
+  // each other: compute them in parallel, then replace them all in the Graph.
+  // The consumers of their outputs which become computable form the next
+  // frontier.
+  while (!frontier.empty()) {
+    logging::ces::debug("Folding {} Ops in ConstExprUtil", frontier.size());
+
+    std::vector<std::vector<char>> results(frontier.size());
+    ThreadPool::global().parallelFor(
+        static_cast<int64_t>(frontier.size()),
+        1,
+        [&frontier, &results](int64_t begin, int64_t end) {
+          for (auto i = begin; i < end; ++i) {
+            auto op = frontier[i];
+            logging::ces::trace("Computing Op `{}` ({}) in ConstExprUtil",
+                                op->id,
+                                op->opid.type);
+            results[i] = ConstExprOpManager::createConstExprOp(op)->compute();
+          }
+        });
+
+    std::vector<TensorId> outIds;
+    outIds.reserve(frontier.size());
+    for (uint64_t i = 0; i < frontier.size(); ++i) {
+      // get the id here as the tensor will be replaced
+      outIds.push_back(frontier[i]->outTensor(0)->id);
+      replaceWithConstInit(frontier[i], results[i], graph);
+      results[i] = {};
+    }
+
+    // Ops are only added once, even if they consume several outputs
+    std::set<Op *, POpCmp> next;
+    for (const auto &outId : outIds) {
+      auto out_tensor = graph.getTensors().get(outId);
+      for (auto consumer : out_tensor->consumers.getOps()) {
+        if (isComputable(consumer, graph)) {
+          next.insert(consumer);
+        }
       }
     }
+    frontier.assign(next.begin(), next.end());
   }
 }
 
@@ -176,6 +213,34 @@ void ConstExprOpManager::registerConstOps() {
   registerConstOp<ConstExprIdentity>("Flatten");
   registerConstOp<ConstExprIdentity>("FlattenInplace");
   registerConstOp<ConstExprFloor>("Floor");
+  registerConstOp<ConstExprPow>("Pow");
+  registerConstOp<ConstExprAbs>("Abs");
+  registerConstOp<ConstExprCeil>("Ceil");
+  registerConstOp<ConstExprCos>("Cos");
+  registerConstOp<ConstExprExp>("Exp");
+  registerConstOp<ConstExprLog>("Log");
+  registerConstOp<ConstExprNeg>("Neg");
+  registerConstOp<ConstExprReciprocal>("Reciprocal");
+  registerConstOp<ConstExprRelu>("Relu");
+  registerConstOp<ConstExprSigmoid>("Sigmoid");
+  registerConstOp<ConstExprSign>("Sign");
+  registerConstOp<ConstExprSin>("Sin");
+  registerConstOp<ConstExprSqrt>("Sqrt");
+  registerConstOp<ConstExprSquare>("Square");
+  registerConstOp<ConstExprTanh>("Tanh");
+  registerConstOp<ConstExprExpand>("Expand");
+  registerConstOp<ConstExprExpand>("ExpandInplace");
+  registerConstOp<ConstExprTile>("Tile");
+  registerConstOp<ConstExprPad>("Pad");
+  registerConstOp<ConstExprPad>("PadInplace");
+  registerConstOp<ConstExprReduce>("ReduceSum");
+  registerConstOp<ConstExprReduce>("ReduceMean");
+  registerConstOp<ConstExprReduce>("ReduceMax");
+  registerConstOp<ConstExprReduce>("ReduceMin");
+  registerConstOp<ConstExprReduce>("ReduceProd");
+  registerConstOp<ConstExprReduce>("ReduceSumSquare");
+  registerConstOp<ConstExprReduce>("ReduceL1");
+  registerConstOp<ConstExprReduce>("ReduceL2");
 }
 
 std::unique_ptr<ConstExprOp> ConstExprOpManager::createConstExprOp(Op *op) {
@@ -2,9 +2,11 @@
 #include <cmath>
 #include <vector>
 #include <popart/ces/elementwisece.hpp>
-#include <popart/ndarraywrapper.hpp>
+#include <popart/ces/stridedloop.hpp>
 #include <popart/op/add.hpp>
+#include <popart/op/pow.hpp>
 #include <popart/tensor.hpp>
+#include <popart/tensordata.hpp>
 
 namespace popart {
 
@@ -15,55 +17,103 @@ public:
   operator()(Tensor &in0, Tensor &in1, const Op *opForDebugMsg) {
     TensorInfo outInfo = opForDebugMsg->prettyNpOut(in0.info, in1.info);
     std::vector<char> v_out(outInfo.nbytes());
-    NDArrayWrapper<T> output(reinterpret_cast<T *>(v_out.data()), outInfo);
-    NDArrayWrapper<T> data0(in0);
-    NDArrayWrapper<T> data1(in1);
-    for (int64_t i = 0; i < output.nelms(); ++i) {
-      // the N-dimensional indices in the output tensor
-      auto indices = output.unflatten(i);
-      // perform the addition, where the broadcasting of the
-      // operands is implicitly taken care of by NDIndices
-      output[i] = OPERATION::invoke(data0[indices], data1[indices]);
-    }
+    T *output      = reinterpret_cast<T *>(v_out.data());
+    const T *data0 = static_cast<const T *>(in0.tensorData()->data());
+    const T *data1 = static_cast<const T *>(in1.tensorData()->data());
+
+    // the broadcasting of the operands is taken care of by their strides
+    StridedLoop<2> loop(outInfo.shape(),
+                        {broadcastStrides(in0.info.shape(), outInfo.shape()),
+                         broadcastStrides(in1.info.shape(), outInfo.shape())});
+    const int64_t n     = loop.rowSize();
+    const auto &strides = loop.rowStrides();
+
+    loop.parallelForRows(
+        [=, &strides](int64_t outOffset, const StridedLoop<2>::Offsets &in) {
+          T *out     = output + outOffset;
+          const T *a = data0 + in[0];
+          const T *b = data1 + in[1];
+          // separate loops for the common cases, which the compiler can
+          // vectorize
+          if (strides[0] == 1 && strides[1] == 1) {
+            for (int64_t i = 0; i < n; ++i) {
+              out[i] = OPERATION::invoke(a[i], b[i]);
+            }
+          } else if (strides[0] == 1 && strides[1] == 0) {
+            const T b0 = *b;
+            for (int64_t i = 0; i < n; ++i) {
+              out[i] = OPERATION::invoke(a[i], b0);
+            }
+          } else if (strides[0] == 0 && strides[1] == 1) {
+            const T a0 = *a;
+            for (int64_t i = 0; i < n; ++i) {
+              out[i] = OPERATION::invoke(a0, b[i]);
+            }
+          } else {
+            for (int64_t i = 0; i < n; ++i) {
+              out[i] = OPERATION::invoke(a[i * strides[0]], b[i * strides[1]]);
+            }
+          }
+        });
     return v_out;
   }
 };
 
 class Div {
 public:
-  template <typename T> static T invoke(T &lhs, T &rhs) { return lhs / rhs; }
+  template <typename T> static T invoke(const T &lhs, const T &rhs) {
+    return lhs / rhs;
+  }
 };
 
 class Add {
 public:
-  template <typename T> static T invoke(T &lhs, T &rhs) { return lhs + rhs; }
+  template <typename T> static T invoke(const T &lhs, const T &rhs) {
+    return lhs + rhs;
+  }
 };
 
 class Mul {
 public:
-  template <typename T> static T invoke(T &lhs, T &rhs) { return lhs * rhs; }
+  template <typename T> static T invoke(const T &lhs, const T &rhs) {
+    return lhs * rhs;
+  }
 };
 
 class Sub {
 public:
-  template <typename T> static T invoke(T &lhs, T &rhs) { return lhs - rhs; }
+  template <typename T> static T invoke(const T &lhs, const T &rhs) {
+    return lhs - rhs;
+  }
 };
 
 class Mod {
 public:
-  template <typename T> static T invoke(T &lhs, T &rhs) { return lhs % rhs; }
+  template <typename T> static T invoke(const T &lhs, const T &rhs) {
+    return lhs % rhs;
+  }
+};
+
+// computed in double precision, for every type
+class Pow {
+public:
+  template <typename T> static T invoke(const T &lhs, const T &rhs) {
+    return static_cast<T>(
+        std::pow(static_cast<double>(lhs), static_cast<double>(rhs)));
+  }
 };
 
 // template specializations for float & double which use the
 // fmod functions
-template <> float Mod::invoke<float>(float &lhs, float &rhs) {
+template <> float Mod::invoke<float>(const float &lhs, const float &rhs) {
   return fmodf(lhs, rhs);
 }
-template <> double Mod::invoke<double>(double &lhs, double &rhs) {
+template <>
+double Mod::invoke<double>(const double &lhs, const double &rhs) {
   return fmod(lhs, rhs);
 }
 
-template <> Half Mod::invoke<Half>(Half &lhs, Half &rhs) {
+template <> Half Mod::invoke<Half>(const Half &lhs, const Half &rhs) {
   return fmodf(lhs, rhs);
 }
 
@@ -112,4 +162,13 @@ std::vector<char> ConstExprMod::compute() {
       in0->info.dataType(), *in0, *in1, getBaseOp());
 }
 
+ConstExprPow::ConstExprPow(Op *op_) : ConstExprOp(op_) {}
+
+std::vector<char> ConstExprPow::compute() {
+  Tensor *in0 = inTensor(PowOp::getArg0InIndex());
+  Tensor *in1 = inTensor(PowOp::getArg1InIndex());
+  return callOpFunctor<BinaryFunctor<Pow>>(
+      in0->info.dataType(), *in0, *in1, getBaseOp());
+}
+
 } // namespace popart
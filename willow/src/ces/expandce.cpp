@@ -0,0 +1,47 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <vector>
+#include <popart/ces/expandce.hpp>
+#include <popart/ces/stridedloop.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensordata.hpp>
+
+namespace popart {
+
+class ExpandFunctor {
+public:
+  template <typename T>
+  std::vector<char> operator()(Tensor &in0, const TensorInfo &outInfo) {
+    std::vector<char> v_out(outInfo.nbytes());
+    auto input  = static_cast<const T *>(in0.tensorData()->data());
+    auto output = reinterpret_cast<T *>(v_out.data());
+
+    StridedLoop<1> loop(outInfo.shape(),
+                        {broadcastStrides(in0.info.shape(), outInfo.shape())});
+    const int64_t n      = loop.rowSize();
+    const int64_t stride = loop.rowStrides()[0];
+    loop.parallelForRows(
+        [=](int64_t outOffset, const StridedLoop<1>::Offsets &in) {
+          T *out     = output + outOffset;
+          const T *a = input + in[0];
+          if (stride == 0) {
+            std::fill(out, out + n, *a);
+          } else {
+            for (int64_t i = 0; i < n; ++i) {
+              out[i] = a[i * stride];
+            }
+          }
+        });
+    return v_out;
+  }
+};
+
+ConstExprExpand::ConstExprExpand(Op *op_) : ConstExprOp(op_) {}
+
+std::vector<char> ConstExprExpand::compute() {
+  // The output shape is found by ExpandOp, from its (constant) shape input
+  Tensor *in0 = inTensor(0);
+  return callOpFunctor<ExpandFunctor>(in0->info.dataType(), *in0, outInfo0());
+}
+
+} // namespace popart
@@ -0,0 +1,144 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <vector>
+#include <popart/ces/padce.hpp>
+#include <popart/op/pad.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensordata.hpp>
+#include <popart/threadpool.hpp>
+
+namespace popart {
+
+namespace {
+
+// Rows of the output are split into chunks of at least this many elements
+// when computed on multiple threads
+constexpr int64_t minElementsPerThread = 1 << 16;
+
+// The index in a dimension of size `size' which is read for index `out' of
+// the padded dimension, or -1 if the pad value is used
+int64_t sourceIndex(int64_t out,
+                    int64_t padBefore,
+                    int64_t size,
+                    const std::string &mode) {
+  int64_t i = out - padBefore;
+  if (i >= 0 && i < size) {
+    return i;
+  }
+  if (size == 0) {
+    return -1;
+  }
+  if (mode == "edge") {
+    return std::min(std::max<int64_t>(i, 0), size - 1);
+  }
+  if (mode == "reflect") {
+    if (size == 1) {
+      return 0;
+    }
+    // reflection without repeating the edge has period 2 * (size - 1)
+    int64_t period = 2 * (size - 1);
+    i              = ((i % period) + period) % period;
+    return i < size ? i : period - i;
+  }
+  return -1;
+}
+
+} // namespace
+
+class PadFunctor {
+public:
+  template <typename T>
+  std::vector<char> operator()(Tensor &in0,
+                               const std::vector<std::vector<int64_t>> &maps,
+                               float padValue,
+                               const TensorInfo &outInfo) {
+    std::vector<char> v_out(outInfo.nbytes());
+    auto input  = static_cast<const T *>(in0.tensorData()->data());
+    auto output = reinterpret_cast<T *>(v_out.data());
+    const T pad = static_cast<T>(padValue);
+
+    const auto &inShape  = in0.info.shape();
+    const auto &outShape = outInfo.shape();
+    const auto rank      = outShape.size();
+    if (rank == 0) {
+      output[0] = input[0];
+      return v_out;
+    }
+
+    const int64_t rowSize = outShape.back();
+    const int64_t nRows   = rowSize == 0 ? 0 : outInfo.nelms() / rowSize;
+    const auto &rowMap    = maps.back();
+    auto grain = std::max<int64_t>(1, minElementsPerThread / (rowSize + 1));
+
+    ThreadPool::global().parallelFor(nRows, grain, [&](int64_t b, int64_t e) {
+      // the index of row b in the outer dimensions of the output
+      std::vector<int64_t> index(rank - 1);
+      int64_t rem = b;
+      for (auto d = rank - 1; d-- > 0;) {
+        index[d] = rem % outShape[d];
+        rem /= outShape[d];
+      }
+
+      for (int64_t row = b; row < e; ++row) {
+        T *out = output + row * rowSize;
+
+        // the offset of the input row, if the whole row is not padding
+        int64_t inOffset = 0;
+        bool isPadding   = false;
+        for (uint64_t d = 0; d + 1 < rank; ++d) {
+          auto i = maps[d][index[d]];
+          if (i < 0) {
+            isPadding = true;
+            break;
+          }
+          inOffset = inOffset * inShape[d] + i;
+        }
+
+        if (isPadding) {
+          std::fill(out, out + rowSize, pad);
+        } else {
+          const T *in = input + inOffset * inShape.back();
+          for (int64_t j = 0; j < rowSize; ++j) {
+            out[j] = rowMap[j] < 0 ? pad : in[rowMap[j]];
+          }
+        }
+
+        for (auto d = rank - 1; d-- > 0;) {
+          if (++index[d] < outShape[d]) {
+            break;
+          }
+          index[d] = 0;
+        }
+      }
+    });
+    return v_out;
+  }
+};
+
+ConstExprPad::ConstExprPad(Op *op_) : ConstExprOp(op_) {}
+
+std::vector<char> ConstExprPad::compute() {
+  Tensor *in0       = inTensor(BasePadOp::getInIndex());
+  const auto &padOp = getOp<BasePadOp>();
+  const auto &mode  = padOp.getMode();
+  if (mode != "constant" && mode != "edge" && mode != "reflect") {
+    throw error("Unsupported pad mode {} in ConstExprPad", mode);
+  }
+
+  // For each dimension, the input index read for each output index
+  const auto &pads     = padOp.getPads();
+  const auto &outShape = outInfo0().shape();
+  const auto rank      = outShape.size();
+  std::vector<std::vector<int64_t>> maps(rank);
+  for (uint64_t d = 0; d < rank; ++d) {
+    maps[d].resize(outShape[d]);
+    for (int64_t o = 0; o < outShape[d]; ++o) {
+      maps[d][o] = sourceIndex(o, pads[d], in0->info.dim(d), mode);
+    }
+  }
+
+  return callOpFunctor<PadFunctor>(
+      in0->info.dataType(), *in0, maps, padOp.getPadValue(), outInfo0());
+}
+
+} // namespace popart
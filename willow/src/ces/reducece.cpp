@@ -0,0 +1,152 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <popart/ces/reducece.hpp>
+#include <popart/ces/stridedloop.hpp>
+#include <popart/op/reduce.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensordata.hpp>
+
+namespace popart {
+
+// Reductions are accumulated in double precision, and the result cast back
+// to the type of the input.
+namespace {
+
+class Sum {
+public:
+  static double init() { return 0.0; }
+  static double accumulate(double acc, double x) { return acc + x; }
+  static double finalize(double acc, int64_t) { return acc; }
+};
+
+class Mean {
+public:
+  static double init() { return 0.0; }
+  static double accumulate(double acc, double x) { return acc + x; }
+  static double finalize(double acc, int64_t n) { return acc / n; }
+};
+
+class Max {
+public:
+  static double init() { return -std::numeric_limits<double>::infinity(); }
+  static double accumulate(double acc, double x) { return std::max(acc, x); }
+  static double finalize(double acc, int64_t) { return acc; }
+};
+
+class Min {
+public:
+  static double init() { return std::numeric_limits<double>::infinity(); }
+  static double accumulate(double acc, double x) { return std::min(acc, x); }
+  static double finalize(double acc, int64_t) { return acc; }
+};
+
+class Prod {
+public:
+  static double init() { return 1.0; }
+  static double accumulate(double acc, double x) { return acc * x; }
+  static double finalize(double acc, int64_t) { return acc; }
+};
+
+class SumSquare {
+public:
+  static double init() { return 0.0; }
+  static double accumulate(double acc, double x) { return acc + x * x; }
+  static double finalize(double acc, int64_t) { return acc; }
+};
+
+class L1 {
+public:
+  static double init() { return 0.0; }
+  static double accumulate(double acc, double x) { return acc + std::abs(x); }
+  static double finalize(double acc, int64_t) { return acc; }
+};
+
+class L2 {
+public:
+  static double init() { return 0.0; }
+  static double accumulate(double acc, double x) { return acc + x * x; }
+  static double finalize(double acc, int64_t) { return std::sqrt(acc); }
+};
+
+template <typename REDUCTION> class ReduceFunctor {
+public:
+  // keptShape is the input shape with 1 in the reduced dimensions
+  template <typename T>
+  std::vector<char> operator()(Tensor &in0,
+                               const Shape &keptShape,
+                               const TensorInfo &outInfo) {
+    const auto &inShape = in0.info.shape();
+    auto input          = static_cast<const T *>(in0.tensorData()->data());
+    const int64_t nOut  = outInfo.nelms();
+    const int64_t nIn   = in0.info.nelms();
+    std::vector<double> acc(nOut, REDUCTION::init());
+
+    // Visit the input in order, reading (and writing) the accumulator of
+    // the output element each input element is reduced into
+    StridedLoop<1> loop(inShape, {broadcastStrides(keptShape, inShape)});
+    const int64_t n      = loop.rowSize();
+    const int64_t stride = loop.rowStrides()[0];
+    loop.forRows(0,
+                 loop.nRows(),
+                 [&](int64_t inOffset, const StridedLoop<1>::Offsets &out) {
+                   const T *in = input + inOffset;
+                   double *a   = acc.data() + out[0];
+                   for (int64_t i = 0; i < n; ++i) {
+                     a[i * stride] = REDUCTION::accumulate(
+                         a[i * stride], static_cast<double>(in[i]));
+                   }
+                 });
+
+    std::vector<char> v_out(outInfo.nbytes());
+    auto output = reinterpret_cast<T *>(v_out.data());
+    const int64_t nReduced = nOut == 0 ? 0 : nIn / nOut;
+    for (int64_t i = 0; i < nOut; ++i) {
+      output[i] = static_cast<T>(REDUCTION::finalize(acc[i], nReduced));
+    }
+    return v_out;
+  }
+};
+
+template <typename REDUCTION>
+std::vector<char>
+reduce(Tensor &in0, const Shape &keptShape, const TensorInfo &outInfo) {
+  return typefunctor::get<ReduceFunctor<REDUCTION>, std::vector<char>>(
+      in0.info.dataType(), in0, keptShape, outInfo);
+}
+
+} // namespace
+
+ConstExprReduce::ConstExprReduce(Op *op_) : ConstExprOp(op_) {}
+
+std::vector<char> ConstExprReduce::compute() {
+  Tensor *in0          = inTensor(ReduceOp::getInIndex());
+  const auto &reduceOp = getOp<ReduceOp>();
+  const auto &type     = reduceOp.opid.type;
+  // The output has the elements of the input reduced to backwardShape, in
+  // the same order, whether or not the reduced dimensions are kept
+  const auto &keptShape = reduceOp.backwardShape();
+
+  if (type == "ReduceSum") {
+    return reduce<Sum>(*in0, keptShape, outInfo0());
+  } else if (type == "ReduceMean") {
+    return reduce<Mean>(*in0, keptShape, outInfo0());
+  } else if (type == "ReduceMax") {
+    return reduce<Max>(*in0, keptShape, outInfo0());
+  } else if (type == "ReduceMin") {
+    return reduce<Min>(*in0, keptShape, outInfo0());
+  } else if (type == "ReduceProd") {
+    return reduce<Prod>(*in0, keptShape, outInfo0());
+  } else if (type == "ReduceSumSquare") {
+    return reduce<SumSquare>(*in0, keptShape, outInfo0());
+  } else if (type == "ReduceL1") {
+    return reduce<L1>(*in0, keptShape, outInfo0());
+  } else if (type == "ReduceL2") {
+    return reduce<L2>(*in0, keptShape, outInfo0());
+  }
+  throw internal_error("No ConstExprReduce implementation of {}", type);
+}
+
+} // namespace popart
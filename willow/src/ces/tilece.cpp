@@ -0,0 +1,65 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <vector>
+#include <popart/ces/stridedloop.hpp>
+#include <popart/ces/tilece.hpp>
+#include <popart/op/tile.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensordata.hpp>
+
+namespace popart {
+
+class TileFunctor {
+public:
+  template <typename T>
+  std::vector<char> operator()(Tensor &in0,
+                               const std::vector<int64_t> &repeats,
+                               const TensorInfo &outInfo) {
+    std::vector<char> v_out(outInfo.nbytes());
+    auto input  = static_cast<const T *>(in0.tensorData()->data());
+    auto output = reinterpret_cast<T *>(v_out.data());
+
+    // Dimension d of the output, of size repeats[d] * inShape[d], is
+    // iterated as two dimensions: the repeat, which does not move in the
+    // input, and the position within the input.
+    const auto &inShape = in0.info.shape();
+    auto inStrides      = broadcastStrides(inShape, inShape);
+    Shape splitShape;
+    std::vector<int64_t> splitStrides;
+    for (uint64_t d = 0; d < inShape.size(); ++d) {
+      splitShape.push_back(repeats.at(d));
+      splitStrides.push_back(0);
+      splitShape.push_back(inShape[d]);
+      splitStrides.push_back(inStrides[d]);
+    }
+
+    StridedLoop<1> loop(splitShape, {splitStrides});
+    const int64_t n      = loop.rowSize();
+    const int64_t stride = loop.rowStrides()[0];
+    loop.parallelForRows(
+        [=](int64_t outOffset, const StridedLoop<1>::Offsets &in) {
+          T *out     = output + outOffset;
+          const T *a = input + in[0];
+          for (int64_t i = 0; i < n; ++i) {
+            out[i] = a[i * stride];
+          }
+        });
+    return v_out;
+  }
+};
+
+ConstExprTile::ConstExprTile(Op *op_) : ConstExprOp(op_) {}
+
+std::vector<char> ConstExprTile::compute() {
+  Tensor *in0  = inTensor(TileOp::getInIndex());
+  auto repeats = getOp<TileOp>().getRepeats();
+  if (repeats.size() != static_cast<uint64_t>(in0->info.rank())) {
+    throw error("Tile repeats of size {} for a tensor of rank {} in "
+                "ConstExprTile",
+                repeats.size(),
+                in0->info.rank());
+  }
+  return callOpFunctor<TileFunctor>(
+      in0->info.dataType(), *in0, repeats, outInfo0());
+}
+
+} // namespace popart
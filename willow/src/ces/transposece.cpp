@@ -1,5 +1,6 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
 #include <vector>
+#include <popart/ces/stridedloop.hpp>
 #include <popart/ces/transposece.hpp>
 #include <popart/ndarraywrapper.hpp>
 #include <popart/op/transpose.hpp>
@@ -77,24 +78,20 @@ public:
       }
     }
 
-    // the non 2-D case (which should use blocking too T6847)
+    // the non 2-D case (which should use blocking too T6847). The input is
+    // read with its strides permuted, so that the output is written in order
     else {
-      for (int64_t i = 0; i < outInfo.nelms(); ++i) {
-
-        // the N-dimensional indices in the output tensor
-        auto indices = data0.unflatten(i);
-
-        // re-arrange the indices according to perm
-        Shape pindices;
-        pindices.reserve(perm.size());
-
-        for (auto d : perm) {
-          pindices.push_back(indices[d]);
-        }
-
-        // Move the value
-        output[pindices] = data0[indices];
-      }
+      auto input = static_cast<const T *>(in0.tensorData()->data());
+      auto out   = reinterpret_cast<T *>(v_out.data());
+      StridedLoop<1> loop(shape, {permutedStrides(in0.info.shape(), perm)});
+      const int64_t n      = loop.rowSize();
+      const int64_t stride = loop.rowStrides()[0];
+      loop.parallelForRows(
+          [=](int64_t outOffset, const StridedLoop<1>::Offsets &in) {
+            for (int64_t i = 0; i < n; ++i) {
+              out[outOffset + i] = input[in[0] + i * stride];
+            }
+          });
     }
 
     return v_out;
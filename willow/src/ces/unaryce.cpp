@@ -0,0 +1,167 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <popart/ces/unaryce.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensordata.hpp>
+#include <popart/threadpool.hpp>
+
+namespace popart {
+
+namespace {
+
+// Outputs are split into chunks of at least this many elements when computed
+// on multiple threads
+constexpr int64_t minElementsPerThread = 1 << 16;
+
+// Casting a double which is NaN, infinite or out of the range of an integer
+// type is undefined, so integer results are clamped to the range of the type,
+// and NaN is 0
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value &&
+                            !std::is_same<T, bool>::value,
+                        T>::type
+fromDouble(double x) {
+  if (std::isnan(x)) {
+    return 0;
+  }
+  if (x <= static_cast<double>(std::numeric_limits<T>::lowest())) {
+    return std::numeric_limits<T>::lowest();
+  }
+  if (x >= static_cast<double>(std::numeric_limits<T>::max())) {
+    return std::numeric_limits<T>::max();
+  }
+  return static_cast<T>(x);
+}
+
+template <typename T>
+typename std::enable_if<!std::is_integral<T>::value ||
+                            std::is_same<T, bool>::value,
+                        T>::type
+fromDouble(double x) {
+  return static_cast<T>(x);
+}
+
+} // namespace
+
+// Every operation is computed in double precision, and the result cast back
+// to the type of the input, see fromDouble.
+namespace unaryce {
+class Abs {
+public:
+  static double invoke(double x) { return std::abs(x); }
+};
+
+class Ceil {
+public:
+  static double invoke(double x) { return std::ceil(x); }
+};
+
+class Cos {
+public:
+  static double invoke(double x) { return std::cos(x); }
+};
+
+class Exp {
+public:
+  static double invoke(double x) { return std::exp(x); }
+};
+
+class Log {
+public:
+  static double invoke(double x) { return std::log(x); }
+};
+
+class Neg {
+public:
+  static double invoke(double x) { return -x; }
+};
+
+class Reciprocal {
+public:
+  static double invoke(double x) { return 1.0 / x; }
+};
+
+class Relu {
+public:
+  static double invoke(double x) { return std::max(x, 0.0); }
+};
+
+class Sigmoid {
+public:
+  static double invoke(double x) { return 1.0 / (1.0 + std::exp(-x)); }
+};
+
+class Sign {
+public:
+  static double invoke(double x) { return (0.0 < x) - (x < 0.0); }
+};
+
+class Sin {
+public:
+  static double invoke(double x) { return std::sin(x); }
+};
+
+class Sqrt {
+public:
+  static double invoke(double x) { return std::sqrt(x); }
+};
+
+class Square {
+public:
+  static double invoke(double x) { return x * x; }
+};
+
+class Tanh {
+public:
+  static double invoke(double x) { return std::tanh(x); }
+};
+} // namespace unaryce
+
+template <typename OPERATION> class UnaryFunctor {
+public:
+  template <typename T> std::vector<char> operator()(Tensor &in0) {
+    std::vector<char> v_out(in0.info.nbytes());
+    auto input  = static_cast<const T *>(in0.tensorData()->data());
+    auto output = reinterpret_cast<T *>(v_out.data());
+    ThreadPool::global().parallelFor(
+        in0.info.nelms(),
+        minElementsPerThread,
+        [input, output](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            output[i] = fromDouble<T>(
+                OPERATION::invoke(static_cast<double>(input[i])));
+          }
+        });
+    return v_out;
+  }
+};
+
+template <typename OPERATION>
+ConstExprUnary<OPERATION>::ConstExprUnary(Op *op_) : ConstExprOp(op_) {}
+
+template <typename OPERATION>
+std::vector<char> ConstExprUnary<OPERATION>::compute() {
+  Tensor *in0 = inTensor(0);
+  return callOpFunctor<UnaryFunctor<OPERATION>>(in0->info.dataType(), *in0);
+}
+
+template class ConstExprUnary<unaryce::Abs>;
+template class ConstExprUnary<unaryce::Ceil>;
+template class ConstExprUnary<unaryce::Cos>;
+template class ConstExprUnary<unaryce::Exp>;
+template class ConstExprUnary<unaryce::Log>;
+template class ConstExprUnary<unaryce::Neg>;
+template class ConstExprUnary<unaryce::Reciprocal>;
+template class ConstExprUnary<unaryce::Relu>;
+template class ConstExprUnary<unaryce::Sigmoid>;
+template class ConstExprUnary<unaryce::Sign>;
+template class ConstExprUnary<unaryce::Sin>;
+template class ConstExprUnary<unaryce::Sqrt>;
+template class ConstExprUnary<unaryce::Square>;
+template class ConstExprUnary<unaryce::Tanh>;
+
+} // namespace popart
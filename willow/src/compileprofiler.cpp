@@ -0,0 +1,245 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+#include <popart/compileprofiler.hpp>
+#include <popart/filereader.hpp>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/logging.hpp>
+#include <popart/tensors.hpp>
+
+namespace popart {
+
+namespace {
+
+std::string quoted(const std::string &s) {
+  std::ostringstream oss;
+  oss << '"';
+  for (unsigned char c : s) {
+    if (c == '"' || c == '\\') {
+      oss << '\\' << c;
+    } else if (c < 0x20) {
+      oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+          << static_cast<int>(c) << std::dec;
+    } else {
+      oss << c;
+    }
+  }
+  oss << '"';
+  return oss.str();
+}
+
+void countOpsAndTensors(const Ir &ir, int64_t &ops, int64_t &tensors) {
+  ops     = 0;
+  tensors = 0;
+  for (auto graph : ir.getAllGraphs()) {
+    ops += graph->getOps().size();
+    tensors += graph->getTensors().size();
+  }
+}
+
+const char *const traceFilename   = "compile_trace.json";
+const char *const summaryFilename = "compile_summary.txt";
+
+} // namespace
+
+CompileProfiler::Scope::Scope(CompileProfiler &profiler_,
+                              const std::string &category,
+                              const std::string &name,
+                              const Ir *ir_)
+    : profiler(profiler_), ir(ir_), enabled(profiler_.isEnabled()) {
+  if (!enabled) {
+    return;
+  }
+  event.category = category;
+  event.name     = name;
+  if (ir) {
+    countOpsAndTensors(*ir, event.opsBefore, event.tensorsBefore);
+  }
+  start = Clock::now();
+}
+
+CompileProfiler::Scope::~Scope() {
+  if (!enabled) {
+    return;
+  }
+  auto end = Clock::now();
+  auto us  = [this](Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               t - profiler.epoch)
+        .count();
+  };
+  event.start    = us(start);
+  event.duration = us(end) - event.start;
+  if (ir) {
+    countOpsAndTensors(*ir, event.opsAfter, event.tensorsAfter);
+  }
+  profiler.addEvent(std::move(event));
+}
+
+void CompileProfiler::Scope::addArg(const std::string &key,
+                                    const std::string &value) {
+  if (enabled) {
+    event.args[key] = value;
+  }
+}
+
+void CompileProfiler::enable() {
+  std::lock_guard<std::mutex> lock(mutex);
+  enabled = true;
+  epoch   = Clock::now();
+  events.clear();
+}
+
+void CompileProfiler::addEvent(Event event) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto found = threads.find(std::this_thread::get_id());
+  if (found == threads.end()) {
+    found = threads
+                .insert({std::this_thread::get_id(),
+                         static_cast<int64_t>(threads.size())})
+                .first;
+  }
+  event.thread = found->second;
+  events.push_back(std::move(event));
+}
+
+void CompileProfiler::addEvent(const std::string &category,
+                               const std::string &name,
+                               Clock::duration duration,
+                               const std::map<std::string, std::string> &args) {
+  if (!enabled) {
+    return;
+  }
+  auto end = std::chrono::duration_cast<std::chrono::microseconds>(
+                 Clock::now() - epoch)
+                 .count();
+  Event event;
+  event.category = category;
+  event.name     = name;
+  event.duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  event.start = end - event.duration;
+  event.args  = args;
+  addEvent(std::move(event));
+}
+
+std::vector<CompileProfiler::Event> CompileProfiler::getEvents() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return events;
+}
+
+std::string CompileProfiler::toChromeTrace() const {
+  auto sorted = getEvents();
+  // The events are added when they end, so a stage follows the stages nested
+  // within it. Order them by start, the enclosing stage first
+  std::stable_sort(
+      sorted.begin(), sorted.end(), [](const Event &a, const Event &b) {
+        return std::make_tuple(a.start, -a.duration) <
+               std::make_tuple(b.start, -b.duration);
+      });
+
+  std::ostringstream oss;
+  oss << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    auto &event = sorted[i];
+    oss << (i == 0 ? "" : ",\n") << "{\"name\":" << quoted(event.name)
+        << ",\"cat\":" << quoted(event.category)
+        << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+        << ",\"ts\":" << event.start << ",\"dur\":" << event.duration
+        << ",\"args\":{";
+    bool first = true;
+    for (auto &key_value : event.args) {
+      oss << (first ? "" : ",") << quoted(key_value.first) << ':'
+          << quoted(key_value.second);
+      first = false;
+    }
+    if (event.opsBefore >= 0) {
+      oss << (first ? "" : ",") << "\"opsBefore\":" << event.opsBefore
+          << ",\"opsAfter\":" << event.opsAfter
+          << ",\"tensorsBefore\":" << event.tensorsBefore
+          << ",\"tensorsAfter\":" << event.tensorsAfter;
+    }
+    oss << "}}";
+  }
+  oss << "]}\n";
+  return oss.str();
+}
+
+std::string CompileProfiler::getSummary() const {
+  struct Row {
+    std::string category;
+    std::string name;
+    int64_t count{0};
+    int64_t total{0};
+    int64_t max{0};
+    bool counted{false};
+    int64_t opsChange{0};
+    int64_t tensorsChange{0};
+  };
+
+  std::map<std::pair<std::string, std::string>, Row> rows;
+  for (auto &event : getEvents()) {
+    auto &row    = rows[{event.category, event.name}];
+    row.category = event.category;
+    row.name     = event.name;
+    ++row.count;
+    row.total += event.duration;
+    row.max = std::max(row.max, event.duration);
+    if (event.opsBefore >= 0) {
+      row.counted = true;
+      row.opsChange += event.opsAfter - event.opsBefore;
+      row.tensorsChange += event.tensorsAfter - event.tensorsBefore;
+    }
+  }
+
+  std::vector<Row> sorted;
+  for (auto &key_row : rows) {
+    sorted.push_back(key_row.second);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), [](auto &a, auto &b) {
+    return a.total > b.total;
+  });
+
+  std::ostringstream oss;
+  oss << std::left << std::setw(12) << "Category" << std::setw(40) << "Name"
+      << std::right << std::setw(8) << "Count" << std::setw(14) << "Total (ms)"
+      << std::setw(12) << "Max (ms)" << std::setw(10) << "Ops +/-"
+      << std::setw(12) << "Tensors +/-" << '\n';
+  for (auto &row : sorted) {
+    oss << std::left << std::setw(12) << row.category << std::setw(40)
+        << row.name << std::right << std::setw(8) << row.count << std::fixed
+        << std::setprecision(3) << std::setw(14) << row.total / 1e3
+        << std::setw(12) << row.max / 1e3;
+    if (row.counted) {
+      oss << std::setw(10) << row.opsChange << std::setw(12)
+          << row.tensorsChange;
+    } else {
+      oss << std::setw(10) << '-' << std::setw(12) << '-';
+    }
+    oss << '\n';
+  }
+  return oss.str();
+}
+
+void CompileProfiler::write(const std::string &directory) const {
+  auto writeFile = [](const std::string &fname, const std::string &contents) {
+    std::ofstream ofs(fname);
+    if (!ofs.is_open()) {
+      logging::warn("Failed to open file {}", fname);
+      return;
+    }
+    ofs << contents;
+  };
+
+  auto tracePath   = io::appendDirFn(directory, traceFilename);
+  auto summaryPath = io::appendDirFn(directory, summaryFilename);
+  writeFile(tracePath, toChromeTrace());
+  writeFile(summaryPath, getSummary());
+  logging::info("Compile profile written to {} and {}", tracePath, summaryPath);
+}
+
+} // namespace popart
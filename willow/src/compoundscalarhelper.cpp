@@ -6,46 +6,53 @@
 
 namespace popart {
 
-bool CompoundScalarHelper::idMatch(const TensorId &optId) const {
+template <class T>
+bool CompoundScalarHelper<T>::idMatch(const TensorId &optId) const {
   return (optId.find(specificPrefix()) != std::string::npos) ||
          (optId.find(defaultPrefix()) != std::string::npos);
 }
 
-OptimizerValue CompoundScalarHelper::getFromWeightId(const TensorId &weightId,
-                                                     const SGD &sgd) const {
-  return {val(weightId, sgd), isConst(weightId, sgd)};
+template <class T>
+OptimizerValue
+CompoundScalarHelper<T>::getFromWeightId(const TensorId &weightId,
+                                         const T &opt) const {
+  return {val(weightId, opt), isConst(weightId, opt)};
 }
 
-OptimizerValue CompoundScalarHelper::getFromScalarId(const TensorId &optId,
-                                                     const SGD &sgd) const {
+template <class T>
+OptimizerValue CompoundScalarHelper<T>::getFromScalarId(const TensorId &optId,
+                                                        const T &opt) const {
 
   // the Optimizer Tensor is specific to a weight
   if (optId.find(specificPrefix()) != std::string::npos) {
-    return getFromWeightId(getWeightId(optId), sgd);
+    return getFromWeightId(getWeightId(optId), opt);
   }
 
   else if (optId.find(defaultPrefix()) != std::string::npos) {
-    return getFromWeightId("fudgeCakeSpaghettiBonanza", sgd);
+    return getFromWeightId("fudgeCakeSpaghettiBonanza", opt);
   }
 
   throw internal_error("failed to determine optimizer type from id {}", optId);
 }
 
-TensorId CompoundScalarHelper::getScalarId(const Tensor &w,
-                                           const SGD &sgd) const {
-  if (sgd.hasSpecific(w)) {
+template <class T>
+TensorId CompoundScalarHelper<T>::getScalarId(const Tensor &w,
+                                              const T &opt) const {
+  if (opt.hasSpecific(w)) {
     return specificPrefix() + w.id;
   }
   return defaultPrefix() + w.info.data_type();
 }
 
-TensorId CompoundScalarHelper::getScalarIdIfNonConst(const Tensor &w,
-                                                     const SGD &sgd) const {
-  return isConst(w.id, sgd) ? "" : getScalarId(w, sgd);
+template <class T>
+TensorId CompoundScalarHelper<T>::getScalarIdIfNonConst(const Tensor &w,
+                                                        const T &opt) const {
+  return isConst(w.id, opt) ? "" : getScalarId(w, opt);
 }
 
 // remove specific prefix to obtain the TensorId of the weight
-TensorId CompoundScalarHelper::getWeightId(const TensorId &scalarId) const {
+template <class T>
+TensorId CompoundScalarHelper<T>::getWeightId(const TensorId &scalarId) const {
   if (scalarId.find(specificPrefix()) != std::string::npos) {
     return std::string(scalarId.begin() + specificPrefix().size(),
                        scalarId.end());
@@ -57,6 +64,9 @@ TensorId CompoundScalarHelper::getWeightId(const TensorId &scalarId) const {
                        scalarId);
 }
 
+template class CompoundScalarHelper<SGD>;
+template class CompoundScalarHelper<Adam>;
+
 float WeightDecayScaleFactor0Helper::val(const TensorId &weightId,
                                          const SGD &sgd) const {
   auto wd = sgd.weightDecays().get(weightId).val();
@@ -156,4 +166,61 @@ bool ScaledWeightDecay1Helper::isConst(const TensorId &weightId,
   return dm.isConst() && wd.isConst() && vs.isConst();
 }
 
+float AdamLearningRateHelper::val(const TensorId &weightId,
+                                  const Adam &adam) const {
+  return adam.learningRates().get(weightId).val();
+}
+
+bool AdamLearningRateHelper::isConst(const TensorId &weightId,
+                                     const Adam &adam) const {
+  return adam.learningRates().get(weightId).isConst();
+}
+
+float AdamWeightDecayHelper::val(const TensorId &weightId,
+                                 const Adam &adam) const {
+  return adam.weightDecays().get(weightId).val();
+}
+
+bool AdamWeightDecayHelper::isConst(const TensorId &weightId,
+                                    const Adam &adam) const {
+  return adam.weightDecays().get(weightId).isConst();
+}
+
+float AdamBeta1Helper::val(const TensorId &weightId, const Adam &adam) const {
+  return adam.beta1s().get(weightId).val();
+}
+
+bool AdamBeta1Helper::isConst(const TensorId &weightId,
+                              const Adam &adam) const {
+  return adam.beta1s().get(weightId).isConst();
+}
+
+float AdamBeta2Helper::val(const TensorId &weightId, const Adam &adam) const {
+  return adam.beta2s().get(weightId).val();
+}
+
+bool AdamBeta2Helper::isConst(const TensorId &weightId,
+                              const Adam &adam) const {
+  return adam.beta2s().get(weightId).isConst();
+}
+
+float AdamEpsHelper::val(const TensorId &weightId, const Adam &adam) const {
+  return adam.epss().get(weightId).val();
+}
+
+bool AdamEpsHelper::isConst(const TensorId &weightId, const Adam &adam) const {
+  return adam.epss().get(weightId).isConst();
+}
+
+float AdamGradientScaleHelper::val(const TensorId &,
+                                   const Adam &adam) const {
+  // The gradients are summed across replicas, by both types of reduction
+  return val(adam.lossScaling().val(), adam.getReplicatedGraphCount());
+}
+
+bool AdamGradientScaleHelper::isConst(const TensorId &,
+                                      const Adam &adam) const {
+  return adam.lossScaling().isConst();
+}
+
 } // namespace popart
@@ -0,0 +1,105 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <popart/cyclecountreport.hpp>
+
+namespace popart {
+
+namespace {
+
+std::string quoted(const std::string &s) {
+  std::ostringstream oss;
+  oss << '"';
+  for (unsigned char c : s) {
+    if (c == '"' || c == '\\') {
+      oss << '\\' << c;
+    } else if (c < 0x20) {
+      oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+          << static_cast<int>(c) << std::dec;
+    } else {
+      oss << c;
+    }
+  }
+  oss << '"';
+  return oss.str();
+}
+
+} // namespace
+
+std::vector<std::pair<std::string, uint64_t>>
+CycleCountReport::cyclesPerOpType() const {
+  std::map<std::string, uint64_t> perType;
+  for (auto &entry : ops) {
+    perType[entry.opType] += entry.cycles;
+  }
+  std::vector<std::pair<std::string, uint64_t>> result(perType.begin(),
+                                                       perType.end());
+  std::stable_sort(result.begin(), result.end(), [](auto &a, auto &b) {
+    return a.second > b.second;
+  });
+  return result;
+}
+
+std::string CycleCountReport::toJson() const {
+  std::ostringstream oss;
+  oss << "{\"ops\":[";
+  for (size_t i = 0; i < ops.size(); ++i) {
+    auto &entry = ops[i];
+    oss << (i == 0 ? "" : ",") << "{\"opId\":" << entry.opId
+        << ",\"graphId\":" << quoted(entry.graphId)
+        << ",\"opType\":" << quoted(entry.opType)
+        << ",\"debugName\":" << quoted(entry.debugName)
+        << ",\"cycles\":" << entry.cycles
+        << ",\"executions\":" << entry.executions << "}";
+  }
+  oss << "],\"pipelineStages\":[";
+  for (size_t i = 0; i < pipelineStages.size(); ++i) {
+    auto &entry = pipelineStages[i];
+    oss << (i == 0 ? "" : ",") << "{\"pipelineStage\":" << entry.pipelineStage
+        << ",\"cycles\":" << entry.cycles
+        << ",\"executions\":" << entry.executions << "}";
+  }
+  oss << "]}";
+  return oss.str();
+}
+
+std::ostream &operator<<(std::ostream &os, const CycleCountReport &report) {
+  uint64_t total = 0;
+  for (auto &entry : report.ops) {
+    total += entry.cycles;
+  }
+
+  auto percent = [total](uint64_t cycles) {
+    return total == 0 ? 0.0 : 100.0 * cycles / total;
+  };
+
+  os << std::left << std::setw(8) << "OpId" << std::setw(16) << "Graph"
+     << std::setw(24) << "Type" << std::right << std::setw(16) << "Cycles"
+     << std::setw(12) << "Executions" << std::setw(8) << "%"
+     << "  Name\n";
+  for (auto &entry : report.ops) {
+    os << std::left << std::setw(8) << entry.opId << std::setw(16)
+       << (entry.graphId.empty() ? "main" : entry.graphId) << std::setw(24)
+       << entry.opType << std::right << std::setw(16) << entry.cycles
+       << std::setw(12) << entry.executions << std::setw(8) << std::fixed
+       << std::setprecision(2) << percent(entry.cycles) << "  "
+       << entry.debugName << '\n';
+  }
+
+  if (!report.pipelineStages.empty()) {
+    os << '\n'
+       << std::left << std::setw(16) << "PipelineStage" << std::right
+       << std::setw(16) << "Cycles" << std::setw(12) << "Executions" << '\n';
+    for (auto &entry : report.pipelineStages) {
+      os << std::left << std::setw(16) << entry.pipelineStage << std::right
+         << std::setw(16) << entry.cycles << std::setw(12) << entry.executions
+         << '\n';
+    }
+  }
+  return os;
+}
+
+} // namespace popart
@@ -1,6 +1,7 @@
 // Copyright (c) 2018 Graphcore Ltd. All rights reserved.
 #include <algorithm>
 #include <vector>
+#include <boost/functional/hash.hpp>
 #include <poprithms/util/stringutil.hpp>
 #include <popart/dataflow.hpp>
 #include <popart/error.hpp>
@@ -75,7 +76,10 @@ std::ostream &operator<<(std::ostream &oss, AnchorReturnTypeId art) {
 }
 
 std::size_t AnchorReturnType::hash() const {
-  return std::hash<std::string>()(artStr_) ^ std::hash<int>()(returnPeriod_);
+  std::size_t hsh = 0;
+  boost::hash_combine(hsh, artStr_);
+  boost::hash_combine(hsh, returnPeriod_);
+  return hsh;
 }
 
 DataFlow::DataFlow() : batchesPerStep_(0) {}
@@ -152,12 +156,15 @@ void DataFlow::isValidAnchorReturnPeriod(TensorId anchorId,
 }
 
 std::size_t DataFlow::hash() const {
-  auto hash = std::hash<int>()(batchesPerStep());
-  for (auto tid_art : m_anchors) {
-    hash = hash ^ std::hash<TensorId>()(tid_art.first) ^
-           std::hash<AnchorReturnType>()(tid_art.second);
+  // Each anchor is combined with its return type, so that swapping the return
+  // types of two anchors changes the hash
+  std::size_t hsh = 0;
+  boost::hash_combine(hsh, batchesPerStep());
+  for (auto &tid_art : m_anchors) {
+    boost::hash_combine(hsh, tid_art.first);
+    boost::hash_combine(hsh, tid_art.second.hash());
   }
-  return hash;
+  return hsh;
 }
 
 } // namespace popart
@@ -0,0 +1,488 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <popart/dataloaderstepio.hpp>
+#include <popart/error.hpp>
+#include <popart/ir.hpp>
+#include <popart/logging.hpp>
+#include <popart/mappedregion.hpp>
+#include <popart/stepio_size_assertion.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensors.hpp>
+
+namespace popart {
+
+namespace {
+
+bool endsWith(const std::string &s, const std::string &suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// The DataType of an NPY type descriptor, such as "<f4"
+DataType npyDataType(const std::string &descr, const std::string &path) {
+  static const std::map<std::string, DataType> types{
+      {"b1", DataType::BOOL},
+      {"i1", DataType::INT8},
+      {"u1", DataType::UINT8},
+      {"i2", DataType::INT16},
+      {"u2", DataType::UINT16},
+      {"f2", DataType::FLOAT16},
+      {"i4", DataType::INT32},
+      {"u4", DataType::UINT32},
+      {"f4", DataType::FLOAT},
+      {"i8", DataType::INT64},
+      {"u8", DataType::UINT64},
+      {"f8", DataType::DOUBLE}};
+
+  auto found = descr.size() == 3 ? types.find(descr.substr(1)) : types.end();
+  // Only little endian data, or data of single bytes, can be read as is
+  bool littleEndian = descr[0] == '<' || descr[0] == '|' || descr[0] == '=';
+  if (found == types.end() || !littleEndian) {
+    throw error("Unsupported NPY data type '{}' in file '{}'", descr, path);
+  }
+  return found->second;
+}
+
+// The value of `key' in the Python dict literal of an NPY header, as written
+// by numpy: "{'descr': '<f4', 'fortran_order': False, 'shape': (8, 2), }"
+std::string npyHeaderValue(const std::string &header,
+                           const std::string &key,
+                           const std::string &path) {
+  auto keyPos = header.find("'" + key + "'");
+  auto colon  = keyPos == std::string::npos ? keyPos : header.find(':', keyPos);
+  if (colon == std::string::npos) {
+    throw error("No '{}' in the header of NPY file '{}'", key, path);
+  }
+  auto begin = header.find_first_not_of(" ", colon + 1);
+  if (begin == std::string::npos) {
+    throw error("No value of '{}' in the header of NPY file '{}'", key, path);
+  }
+  std::string::size_type end;
+  if (header[begin] == '\'' || header[begin] == '"') {
+    end = header.find(header[begin], begin + 1);
+    ++begin;
+  } else if (header[begin] == '(') {
+    end = header.find(')', begin);
+    ++begin;
+  } else {
+    end = header.find_first_of(",}", begin);
+  }
+  if (end == std::string::npos) {
+    throw error(
+        "Malformed value of '{}' in the header of NPY file '{}'", key, path);
+  }
+  return header.substr(begin, end - begin);
+}
+
+Shape npyShape(const std::string &value, const std::string &path) {
+  Shape shape;
+  std::string::size_type pos = 0;
+  while (pos < value.size()) {
+    auto end = std::min(value.find(',', pos), value.size());
+    auto dim = value.substr(pos, end - pos);
+    dim.erase(std::remove_if(dim.begin(),
+                             dim.end(),
+                             [](char c) { return std::isspace(c); }),
+              dim.end());
+    if (!dim.empty()) {
+      if (!std::all_of(dim.begin(), dim.end(), [](char c) {
+            return std::isdigit(c);
+          })) {
+        throw error("Malformed shape ({}) in NPY file '{}'", value, path);
+      }
+      shape.push_back(std::stoll(dim));
+    }
+    pos = end + 1;
+  }
+  return shape;
+}
+
+// Read the header of an NPY file, returning the info of the whole array and
+// the offset of its data
+std::pair<TensorInfo, int64_t> readNpyHeader(std::ifstream &ifs,
+                                             const std::string &path) {
+  char preamble[10];
+  if (!ifs.read(preamble, sizeof(preamble)) ||
+      std::memcmp(preamble, "\x93NUMPY", 6) != 0) {
+    throw error("File '{}' is not an NPY file", path);
+  }
+
+  // Version 1 has a 2 byte header length, later versions a 4 byte one
+  int major = static_cast<unsigned char>(preamble[6]);
+  uint32_t headerLength;
+  int64_t dataOffset;
+  auto byte = [&preamble](int i) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(preamble[i]));
+  };
+  if (major == 1) {
+    headerLength = byte(8) | byte(9) << 8;
+    dataOffset   = 10 + headerLength;
+  } else {
+    char more[2];
+    if (!ifs.read(more, sizeof(more))) {
+      throw error("Truncated header in NPY file '{}'", path);
+    }
+    headerLength = byte(8) | byte(9) << 8 |
+                   static_cast<uint32_t>(static_cast<unsigned char>(more[0]))
+                       << 16 |
+                   static_cast<uint32_t>(static_cast<unsigned char>(more[1]))
+                       << 24;
+    dataOffset = 12 + static_cast<int64_t>(headerLength);
+  }
+
+  std::string header(headerLength, '\0');
+  if (!ifs.read(&header[0], headerLength)) {
+    throw error("Truncated header in NPY file '{}'", path);
+  }
+
+  if (npyHeaderValue(header, "fortran_order", path) != "False") {
+    throw error("NPY file '{}' is in Fortran order, only C order is supported",
+                path);
+  }
+  auto type  = npyDataType(npyHeaderValue(header, "descr", path), path);
+  auto shape = npyShape(npyHeaderValue(header, "shape", path), path);
+  return {TensorInfo(type, shape), dataOffset};
+}
+
+} // namespace
+
+RecordFiles::RecordFiles(const std::map<TensorId, std::string> &files_,
+                         const std::map<TensorId, TensorInfo> &rawInfos) {
+  if (files_.empty()) {
+    throw error("No files given to RecordFiles");
+  }
+
+  for (const auto &idAndPath : files_) {
+    const auto &id   = idAndPath.first;
+    const auto &path = idAndPath.second;
+
+    std::ifstream ifs(path, std::ifstream::binary);
+    if (!ifs) {
+      throw error("Failed to open record file '{}' for input {}", path, id);
+    }
+    ifs.seekg(0, std::ifstream::end);
+    const int64_t fileSize = ifs.tellg();
+    ifs.seekg(0);
+
+    File file;
+    int64_t records;
+    if (endsWith(path, ".npy")) {
+      auto infoAndOffset = readNpyHeader(ifs, path);
+      auto shape         = infoAndOffset.first.shape();
+      if (shape.empty()) {
+        throw error("NPY file '{}' for input {} holds a scalar, not records",
+                    path,
+                    id);
+      }
+      records         = shape.front();
+      file.info       = TensorInfo(infoAndOffset.first.dataType(),
+                             Shape(shape.begin() + 1, shape.end()));
+      file.dataOffset = infoAndOffset.second;
+      if (file.dataOffset + infoAndOffset.first.nbytes() > fileSize) {
+        throw error("NPY file '{}' is truncated", path);
+      }
+    } else {
+      auto found = rawInfos.find(id);
+      if (found == rawInfos.end()) {
+        throw error("No sample info given for input {}, whose record file "
+                    "'{}' is not an NPY file",
+                    id,
+                    path);
+      }
+      file.info       = found->second;
+      file.dataOffset = 0;
+      if (file.info.nbytes() == 0 || fileSize % file.info.nbytes() != 0) {
+        throw error("The size of record file '{}' ({} bytes) is not a "
+                    "multiple of the size of a sample of input {} ({})",
+                    path,
+                    fileSize,
+                    id,
+                    file.info);
+      }
+      records = fileSize / file.info.nbytes();
+    }
+
+    if (records == 0) {
+      throw error("Record file '{}' for input {} holds no records", path, id);
+    }
+    if (nRecords != 0 && records != nRecords) {
+      throw error("Record file '{}' for input {} holds {} records, but the "
+                  "other record files hold {}",
+                  path,
+                  id,
+                  records,
+                  nRecords);
+    }
+    nRecords = records;
+
+    file.region.reset(new MappedRegion(path, 0, fileSize));
+    files.insert({id, std::move(file)});
+  }
+}
+
+RecordFiles::~RecordFiles() = default;
+
+std::map<TensorId, TensorInfo> RecordFiles::sampleInfos() const {
+  std::map<TensorId, TensorInfo> infos;
+  for (const auto &file : files) {
+    infos.insert({file.first, file.second.info});
+  }
+  return infos;
+}
+
+void RecordFiles::read(
+    int64_t index,
+    const std::map<TensorId, MutableVoidData> &buffers) const {
+  const int64_t record = index % nRecords;
+  for (const auto &buffer : buffers) {
+    auto found = files.find(buffer.first);
+    if (found == files.end()) {
+      throw error("No record file for input {}", buffer.first);
+    }
+    const auto &file   = found->second;
+    const auto nbytes  = file.info.nbytes();
+    const char *source = file.region->data() + file.dataOffset;
+    std::memcpy(buffer.second.data, source + record * nbytes, nbytes);
+  }
+}
+
+DataLoaderStepIO::DataLoaderStepIO(std::map<TensorId, TensorInfo> inputs_,
+                                   Producer producer_,
+                                   int64_t numSamples_,
+                                   std::map<TensorId, MutableVoidData> outputs_,
+                                   unsigned numWorkers,
+                                   unsigned queueDepth)
+    : producer(std::move(producer_)), numSamples(numSamples_),
+      slots(queueDepth), workers(numWorkers) {
+  if (inputs_.empty()) {
+    throw error("A DataLoaderStepIO needs at least one input");
+  }
+  if (numWorkers == 0) {
+    throw error("A DataLoaderStepIO needs at least one worker");
+  }
+  if (queueDepth < 2) {
+    throw error("The queue depth of a DataLoaderStepIO must be at least 2, "
+                "not {}",
+                queueDepth);
+  }
+
+  for (auto &input : inputs_) {
+    Input in;
+    in.info = input.second;
+    in.ring.resize(queueDepth * input.second.nbytes());
+    inputs.insert({input.first, std::move(in)});
+  }
+  for (auto &output : outputs_) {
+    outputs.insert({output.first, {output.second, 0}});
+  }
+
+  logging::debug("Starting DataLoaderStepIO with {} workers and a queue depth "
+                 "of {} for {} inputs",
+                 numWorkers,
+                 queueDepth,
+                 inputs.size());
+  for (unsigned i = 0; i < numWorkers; ++i) {
+    workers.submit([this]() { workerLoop(); });
+  }
+}
+
+DataLoaderStepIO::DataLoaderStepIO(
+    std::shared_ptr<const RecordFiles> files,
+    int64_t numSamples_,
+    std::map<TensorId, MutableVoidData> outputs_,
+    unsigned numWorkers,
+    unsigned queueDepth)
+    : DataLoaderStepIO(
+          files->sampleInfos(),
+          [files](int64_t index,
+                  const std::map<TensorId, MutableVoidData> &buffers) {
+            files->read(index, buffers);
+          },
+          numSamples_,
+          std::move(outputs_),
+          numWorkers,
+          queueDepth) {}
+
+DataLoaderStepIO::~DataLoaderStepIO() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+}
+
+int64_t DataLoaderStepIO::minCursor() const {
+  int64_t result = std::numeric_limits<int64_t>::max();
+  for (const auto &input : inputs) {
+    result = std::min(result, input.second.cursor);
+  }
+  return result;
+}
+
+void DataLoaderStepIO::workerLoop() {
+  const int64_t depth = static_cast<int64_t>(slots.size());
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    // Wait until there is a sample to produce, and its slot is free
+    condition.wait(lock, [this, depth]() {
+      return stopping || ((numSamples < 0 || nextSample < numSamples) &&
+                          nextSample - minCursor() < depth);
+    });
+    if (stopping) {
+      return;
+    }
+
+    const int64_t index = nextSample++;
+    auto &slot          = slots[index % depth];
+    slot.index          = index;
+    slot.ready          = false;
+    slot.error          = nullptr;
+
+    // The ring buffers are only resized on construction, so the pointers
+    // into them may be taken without the lock held
+    std::map<TensorId, MutableVoidData> buffers;
+    for (auto &input : inputs) {
+      MutableVoidData data;
+      data.data = input.second.ring.data() +
+                  (index % depth) * input.second.info.nbytes();
+      data.info = input.second.info;
+      buffers.insert({input.first, data});
+    }
+
+    lock.unlock();
+    std::exception_ptr producerError;
+    try {
+      producer(index, buffers);
+    } catch (...) {
+      producerError = std::current_exception();
+    }
+    lock.lock();
+
+    slot.ready = true;
+    slot.error = producerError;
+    condition.notify_all();
+  }
+}
+
+ConstVoidData
+DataLoaderStepIO::in(TensorId id, int64_t numElements, bool prefetch) {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto found = inputs.find(id);
+  if (found == inputs.end()) {
+    throw error("No tensor {} provided in DataLoaderStepIO's inputs", id);
+  }
+  auto &input = found->second;
+  if (numElements != input.info.nelms()) {
+    throw error("DataLoaderStepIO produces samples of {} elements for input "
+                "{}, but {} were requested",
+                input.info.nelms(),
+                id,
+                numElements);
+  }
+
+  const int64_t index = input.cursor;
+  if (numSamples >= 0 && index >= numSamples) {
+    if (prefetch) {
+      return {};
+    }
+    throw error("All {} samples of DataLoaderStepIO's input {} have been read",
+                numSamples,
+                id);
+  }
+
+  const int64_t depth = static_cast<int64_t>(slots.size());
+  auto &slot          = slots[index % depth];
+  auto isReady = [&slot, index]() { return slot.index == index && slot.ready; };
+  if (prefetch) {
+    // Leave errors to be rethrown by the fetch which follows
+    if (!isReady() || slot.error) {
+      return {};
+    }
+  } else {
+    condition.wait(lock, isReady);
+    if (slot.error) {
+      std::rethrow_exception(slot.error);
+    }
+  }
+
+  const char *data = input.ring.data() + (index % depth) * input.info.nbytes();
+  return ConstVoidData(data, input.info);
+}
+
+void DataLoaderStepIO::inComplete(TensorId id, int64_t) {
+  bool slotFreed;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &input  = inputs.at(id);
+    slotFreed    = input.cursor == minCursor();
+    input.cursor = input.cursor + 1;
+  }
+  if (slotFreed) {
+    condition.notify_all();
+  }
+}
+
+MutableVoidData DataLoaderStepIO::out(TensorId id, int64_t numElements) {
+  auto found = outputs.find(id);
+  if (found == outputs.end()) {
+    throw error("No tensor {} provided in DataLoaderStepIO's outputs", id);
+  }
+  auto &output = found->second;
+  MutableVoidData data;
+  data.data = static_cast<char *>(output.data.data) + output.offset;
+  data.info = TensorInfo(output.data.info.dataType(), {numElements});
+  output.offset += data.info.nbytes();
+  // Wrap around if we wrote all the data
+  if (output.offset >= output.data.info.nbytes()) {
+    output.offset = 0;
+  }
+  return data;
+}
+
+void DataLoaderStepIO::assertNumElements(const Ir &ir) const {
+  const auto &tensors = ir.getMainGraphTensors();
+  for (const auto &input : inputs) {
+    // The cursor of an input without a stream would never advance, and
+    // production would stop once the queue is full
+    if (!tensors.contains(input.first)) {
+      throw error("DataLoaderStepIO produces input {}, which is not an input "
+                  "of the Ir. Remove it from the inputs of the "
+                  "DataLoaderStepIO",
+                  input.first);
+    }
+    // Nor does that of a Tensor which is not read from a data stream, such as
+    // a Variable
+    auto tensor = tensors.get(input.first);
+    if (tensor->tensorType() != TensorType::Stream ||
+        tensor->isOptimizerTensor() || tensor->isRandomSeedTensor()) {
+      throw error("DataLoaderStepIO produces input {}, which is a {} Tensor, "
+                  "not a data stream of the Ir. Remove it from the inputs of "
+                  "the DataLoaderStepIO",
+                  input.first,
+                  tensor->tensor_type());
+    }
+    auto expected = tensor->info.nelms();
+    if (input.second.info.nelms() != expected) {
+      throw error("DataLoaderStepIO produces samples of {} elements for "
+                  "input {}, but its stream reads {} elements at a time",
+                  input.second.info.nelms(),
+                  input.first,
+                  expected);
+    }
+  }
+  iosizecheck::assertOutCorrect(ir, outputs, [](const Output &output) {
+    return output.data.info.nelms();
+  });
+}
+
+int64_t DataLoaderStepIO::numSamplesCompleted() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return minCursor();
+}
+
+} // namespace popart
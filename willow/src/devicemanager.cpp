@@ -1,5 +1,6 @@
 // Copyright (c) 2018 Graphcore Ltd. All rights reserved.
 #include <sstream>
+#include <boost/functional/hash.hpp>
 #include <poplar/DeviceManager.hpp>
 #include <poplar/OptionFlags.hpp>
 #include <popart/devicemanager.hpp>
@@ -230,3 +231,21 @@ std::ostream &operator<<(std::ostream &os, const DeviceInfo &di) {
 }
 
 } // namespace popart
+
+namespace std {
+std::size_t hash<popart::DeviceInfo>::operator()(
+    const popart::DeviceInfo &di) const {
+  std::stringstream ss;
+  ss << di.getType() << di.getConnectionType();
+
+  // Combined rather than XORed, so that for example 2 IPUs of 4 tiles and 4
+  // IPUs of 2 tiles have different hashes
+  std::size_t hsh = 0;
+  boost::hash_combine(hsh, ss.str());
+  boost::hash_combine(hsh, di.getVersion());
+  boost::hash_combine(hsh, di.getNumIpus());
+  boost::hash_combine(hsh, di.getTilesPerIpu());
+  boost::hash_combine(hsh, di.getNumWorkerContexts());
+  return hsh;
+}
+} // namespace std
@@ -0,0 +1,183 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+
+#include <popart/dynamictoposort.hpp>
+#include <popart/error.hpp>
+
+namespace popart {
+
+DynamicTopoSort::Node DynamicTopoSort::insertNode() {
+  Node node = static_cast<Node>(ord.size());
+  // New nodes have no edges, so can go after every existing node
+  ord.push_back(nextOrd++);
+  outs.emplace_back();
+  ins.emplace_back();
+  marked.push_back(false);
+  return node;
+}
+
+bool DynamicTopoSort::tryInsertEdge(Node from, Node to) {
+  return tryInsertEdges({{from, to}});
+}
+
+bool DynamicTopoSort::tryInsertEdges(const std::vector<Edge> &edges) {
+  undoLog.clear();
+  for (const auto &edge : edges) {
+    if (edge.first >= ord.size() || edge.second >= ord.size()) {
+      throw internal_error("Invalid edge {} -> {} in DynamicTopoSort with {} "
+                           "nodes",
+                           edge.first,
+                           edge.second,
+                           ord.size());
+    }
+    if (!insertEdge(edge.first, edge.second)) {
+      undo();
+      return false;
+    }
+  }
+  undoLog.clear();
+  return true;
+}
+
+bool DynamicTopoSort::insertEdge(Node from, Node to) {
+  if (from == to) {
+    return false;
+  }
+
+  const int64_t lower = ord[to];
+  const int64_t upper = ord[from];
+
+  // The edge agrees with the current order only if `from' is earlier. If
+  // not, the nodes reachable from `to' which are not after `from' need to
+  // move after the nodes which reach `from' and are not before `to'.
+  if (lower < upper) {
+    forwardSet.clear();
+    backwardSet.clear();
+    bool acyclic = searchForward(to, upper, from);
+    if (acyclic) {
+      searchBackward(from, lower);
+    }
+    for (auto n : forwardSet) {
+      marked[n] = false;
+    }
+    for (auto n : backwardSet) {
+      marked[n] = false;
+    }
+    if (!acyclic) {
+      return false;
+    }
+    reorder();
+  }
+
+  outs[from].push_back(to);
+  ins[to].push_back(from);
+  undoLog.push_back({true, from, to, 0});
+  return true;
+}
+
+bool DynamicTopoSort::searchForward(Node start, int64_t upper, Node stop) {
+  stack.clear();
+  stack.push_back(start);
+  marked[start] = true;
+  forwardSet.push_back(start);
+  while (!stack.empty()) {
+    Node n = stack.back();
+    stack.pop_back();
+    for (Node w : outs[n]) {
+      if (w == stop) {
+        return false;
+      }
+      if (!marked[w] && ord[w] < upper) {
+        marked[w] = true;
+        forwardSet.push_back(w);
+        stack.push_back(w);
+      }
+    }
+  }
+  return true;
+}
+
+void DynamicTopoSort::searchBackward(Node start, int64_t lower) {
+  stack.clear();
+  stack.push_back(start);
+  marked[start] = true;
+  backwardSet.push_back(start);
+  while (!stack.empty()) {
+    Node n = stack.back();
+    stack.pop_back();
+    for (Node w : ins[n]) {
+      if (!marked[w] && ord[w] > lower) {
+        marked[w] = true;
+        backwardSet.push_back(w);
+        stack.push_back(w);
+      }
+    }
+  }
+}
+
+void DynamicTopoSort::reorder() {
+  auto byOrd = [this](Node a, Node b) { return ord[a] < ord[b]; };
+  std::sort(forwardSet.begin(), forwardSet.end(), byOrd);
+  std::sort(backwardSet.begin(), backwardSet.end(), byOrd);
+
+  // The positions to reuse, in increasing order
+  std::vector<int64_t> positions;
+  positions.reserve(forwardSet.size() + backwardSet.size());
+  for (auto n : backwardSet) {
+    positions.push_back(ord[n]);
+  }
+  for (auto n : forwardSet) {
+    positions.push_back(ord[n]);
+  }
+  std::sort(positions.begin(), positions.end());
+
+  uint64_t i = 0;
+  for (auto nodes : {&backwardSet, &forwardSet}) {
+    for (auto n : *nodes) {
+      undoLog.push_back({false, n, 0, ord[n]});
+      ord[n] = positions[i++];
+    }
+  }
+}
+
+void DynamicTopoSort::undo() {
+  while (!undoLog.empty()) {
+    const auto &entry = undoLog.back();
+    if (entry.isEdge) {
+      outs[entry.node].pop_back();
+      ins[entry.to].pop_back();
+    } else {
+      ord[entry.node] = entry.oldOrd;
+    }
+    undoLog.pop_back();
+  }
+}
+
+bool DynamicTopoSort::reaches(Node from, Node to) const {
+  if (from == to) {
+    return true;
+  }
+  // Every path goes forwards in the order
+  if (ord.at(from) > ord.at(to)) {
+    return false;
+  }
+  std::vector<bool> seen(ord.size(), false);
+  std::vector<Node> toVisit{from};
+  seen[from] = true;
+  while (!toVisit.empty()) {
+    Node n = toVisit.back();
+    toVisit.pop_back();
+    for (Node w : outs[n]) {
+      if (w == to) {
+        return true;
+      }
+      if (!seen[w] && ord[w] < ord[to]) {
+        seen[w] = true;
+        toVisit.push_back(w);
+      }
+    }
+  }
+  return false;
+}
+
+} // namespace popart
@@ -0,0 +1,223 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+#include <boost/filesystem.hpp>
+#include <popart/enginecache.hpp>
+#include <popart/filereader.hpp>
+#include <popart/logging.hpp>
+
+namespace popart {
+
+namespace {
+
+namespace bf = boost::filesystem;
+
+const char *const popartSuffix = ".popart";
+const char *const poplarSuffix = ".poplar";
+const char *const tmpMarker    = ".tmp-";
+
+// Temporary files older than this were left by writes which did not complete
+const std::time_t staleTmpSeconds = 3600;
+
+bool endsWith(const std::string &s, const std::string &suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Write a file by writing a temporary file in the same directory, and
+// renaming it
+bool writeAtomically(const std::string &fname,
+                     const std::function<void(std::ostream &)> &write) {
+  boost::system::error_code ec;
+  auto tmpName = fname + tmpMarker + bf::unique_path("%%%%-%%%%").string();
+  {
+    std::ofstream ofs(tmpName, std::ofstream::binary);
+    if (!ofs.is_open()) {
+      logging::devicex::warn("Failed to open file {}", tmpName);
+      return false;
+    }
+    write(ofs);
+    if (!ofs) {
+      logging::devicex::warn("Failed to write file {}", tmpName);
+      ofs.close();
+      bf::remove(tmpName, ec);
+      return false;
+    }
+  }
+  bf::rename(tmpName, fname, ec);
+  if (ec) {
+    logging::devicex::warn(
+        "Failed to write engine cache file {}: {}", fname, ec.message());
+    bf::remove(tmpName, ec);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+EngineCache::EngineCache(const std::string &directory_)
+    : directory(directory_) {}
+
+std::string EngineCache::getKey(std::size_t irBundleHash) {
+  std::ostringstream oss;
+  oss << std::hex << std::setfill('0') << std::setw(2 * sizeof(std::size_t))
+      << irBundleHash;
+  return oss.str();
+}
+
+std::string EngineCache::getPopartPath(const std::string &key) const {
+  return io::appendDirFn(directory, key + popartSuffix);
+}
+
+std::string EngineCache::getPoplarPath(const std::string &key) const {
+  return io::appendDirFn(directory, key + poplarSuffix);
+}
+
+std::vector<EngineCache::Entry> EngineCache::list() const {
+  std::vector<Entry> entries;
+  boost::system::error_code ec;
+  if (!bf::is_directory(directory, ec)) {
+    return entries;
+  }
+
+  for (bf::directory_iterator it(directory, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    auto fname = it->path().filename().string();
+    if (!endsWith(fname, popartSuffix) ||
+        fname.find(tmpMarker) != std::string::npos) {
+      continue;
+    }
+    auto key    = fname.substr(0, fname.size() - std::strlen(popartSuffix));
+    auto popart = getPopartPath(key);
+    auto poplar = getPoplarPath(key);
+
+    // Either file may be removed by another process while listing
+    boost::system::error_code fec;
+    Entry entry{key, 0, 0};
+    entry.lastUsed = bf::last_write_time(popart, fec);
+    entry.bytes    = bf::file_size(popart, fec);
+    if (!fec) {
+      entry.bytes += bf::file_size(poplar, fec);
+    }
+    if (!fec) {
+      entries.push_back(entry);
+    }
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+    return std::make_tuple(b.lastUsed, a.key) <
+           std::make_tuple(a.lastUsed, b.key);
+  });
+  return entries;
+}
+
+std::uintmax_t EngineCache::size() const {
+  std::uintmax_t total = 0;
+  for (auto &entry : list()) {
+    total += entry.bytes;
+  }
+  return total;
+}
+
+bool EngineCache::store(
+    const std::string &key,
+    const std::function<void(std::ostream &)> &writePoplar,
+    const std::function<void(std::ostream &)> &writePopart) const {
+  boost::system::error_code ec;
+  bf::create_directories(directory, ec);
+  if (ec) {
+    logging::devicex::warn("Failed to create engine cache directory {}: {}",
+                           directory,
+                           ec.message());
+    return false;
+  }
+
+  // The .popart file is written last, as an entry is only listed, and only
+  // loaded, once it exists
+  return writeAtomically(getPoplarPath(key), writePoplar) &&
+         writeAtomically(getPopartPath(key), writePopart);
+}
+
+void EngineCache::touch(const std::string &key) const {
+  boost::system::error_code ec;
+  bf::last_write_time(getPopartPath(key), std::time(nullptr), ec);
+  if (ec) {
+    logging::devicex::debug("Failed to update the time of engine cache entry "
+                            "{}: {}",
+                            key,
+                            ec.message());
+  }
+}
+
+bool EngineCache::remove(const std::string &key) const {
+  // Remove the .popart file first, so that the entry is not loaded without
+  // its .poplar file
+  boost::system::error_code ec;
+  bool existed = bf::remove(getPopartPath(key), ec);
+  bf::remove(getPoplarPath(key), ec);
+  return existed;
+}
+
+int64_t EngineCache::prune(std::uintmax_t maxBytes) const {
+  boost::system::error_code ec;
+  if (!bf::is_directory(directory, ec)) {
+    return 0;
+  }
+
+  // The file of an entry whose other file is missing, for example a .poplar
+  // file whose .popart file was never written. It is not listed, so it would
+  // otherwise never be evicted
+  auto isIncomplete = [this](const std::string &fname) {
+    boost::system::error_code fec;
+    if (endsWith(fname, poplarSuffix)) {
+      auto key = fname.substr(0, fname.size() - std::strlen(poplarSuffix));
+      return !bf::exists(getPopartPath(key), fec) && !fec;
+    }
+    if (endsWith(fname, popartSuffix)) {
+      auto key = fname.substr(0, fname.size() - std::strlen(popartSuffix));
+      return !bf::exists(getPoplarPath(key), fec) && !fec;
+    }
+    return false;
+  };
+
+  // Only files older than staleTmpSeconds are removed, as a more recent one
+  // may belong to an entry which is still being written
+  auto now = std::time(nullptr);
+  for (bf::directory_iterator it(directory, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    boost::system::error_code fec;
+    auto fname = it->path().filename().string();
+    if ((fname.find(tmpMarker) != std::string::npos || isIncomplete(fname)) &&
+        now - bf::last_write_time(it->path(), fec) > staleTmpSeconds && !fec) {
+      logging::devicex::debug("Removing stale engine cache file {}",
+                              it->path().string());
+      bf::remove(it->path(), fec);
+    }
+  }
+
+  auto entries         = list();
+  std::uintmax_t total = 0;
+  for (auto &entry : entries) {
+    total += entry.bytes;
+  }
+
+  int64_t evicted = 0;
+  while (total > maxBytes && !entries.empty()) {
+    auto &entry = entries.back();
+    logging::devicex::debug("Evicting engine cache entry {} ({} bytes)",
+                            entry.key,
+                            entry.bytes);
+    remove(entry.key);
+    total -= entry.bytes;
+    entries.pop_back();
+    ++evicted;
+  }
+  return evicted;
+}
+
+} // namespace popart
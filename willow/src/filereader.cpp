@@ -9,7 +9,9 @@
 
 #include <cstdio>
 #include <fstream>
+#include <algorithm>
 #include <limits>
+#include <set>
 #include <sstream>
 #include <unistd.h>
 #include <vector>
@@ -19,7 +21,10 @@
 
 #include <popart/error.hpp>
 #include <popart/filereader.hpp>
+#include <popart/hostconversion.hpp>
+#include <popart/logging.hpp>
 #include <popart/names.hpp>
+#include <popart/onnxutil.hpp>
 
 namespace popart {
 namespace io {
@@ -248,6 +253,278 @@ void writeModel(const ONNX_NAMESPACE::ModelProto &model,
   }
 }
 
+namespace {
+
+// Wire format tags (field number << 3 | 2, for length delimited fields) of the
+// fields written by writeModel
+constexpr uint32_t modelGraphTag       = (7 << 3) | 2;
+constexpr uint32_t graphInitializerTag = (5 << 3) | 2;
+constexpr uint32_t tensorRawDataTag    = (9 << 3) | 2;
+
+constexpr int64_t maxDataChunkBytes = 16 << 20;
+
+int64_t varintSize(uint64_t value) {
+  return google::protobuf::io::CodedOutputStream::VarintSize64(value);
+}
+
+// The size of a length delimited field of nbytes, with a one byte tag
+int64_t fieldSize(int64_t nbytes) { return 1 + varintSize(nbytes) + nbytes; }
+
+// A copy of the model without its graph
+ONNX_NAMESPACE::ModelProto
+copyModelWithoutGraph(const ONNX_NAMESPACE::ModelProto &model) {
+  ONNX_NAMESPACE::ModelProto result;
+  if (model.has_ir_version()) {
+    result.set_ir_version(model.ir_version());
+  }
+  *result.mutable_opset_import() = model.opset_import();
+  if (model.has_producer_name()) {
+    result.set_producer_name(model.producer_name());
+  }
+  if (model.has_producer_version()) {
+    result.set_producer_version(model.producer_version());
+  }
+  if (model.has_domain()) {
+    result.set_domain(model.domain());
+  }
+  if (model.has_model_version()) {
+    result.set_model_version(model.model_version());
+  }
+  if (model.has_doc_string()) {
+    result.set_doc_string(model.doc_string());
+  }
+  *result.mutable_metadata_props() = model.metadata_props();
+  return result;
+}
+
+// A copy of the graph without its initializers
+ONNX_NAMESPACE::GraphProto
+copyGraphWithoutInitializers(const ONNX_NAMESPACE::GraphProto &graph) {
+  ONNX_NAMESPACE::GraphProto result;
+  *result.mutable_node() = graph.node();
+  if (graph.has_name()) {
+    result.set_name(graph.name());
+  }
+  *result.mutable_sparse_initializer() = graph.sparse_initializer();
+  if (graph.has_doc_string()) {
+    result.set_doc_string(graph.doc_string());
+  }
+  *result.mutable_input()                   = graph.input();
+  *result.mutable_output()                  = graph.output();
+  *result.mutable_value_info()              = graph.value_info();
+  *result.mutable_quantization_annotation() = graph.quantization_annotation();
+  return result;
+}
+
+// A copy of the initializer without its data
+ONNX_NAMESPACE::TensorProto
+copyTensorWithoutData(const ONNX_NAMESPACE::TensorProto &tp) {
+  ONNX_NAMESPACE::TensorProto result;
+  *result.mutable_dims() = tp.dims();
+  if (tp.has_data_type()) {
+    result.set_data_type(tp.data_type());
+  }
+  if (tp.has_segment()) {
+    *result.mutable_segment() = tp.segment();
+  }
+  if (tp.has_name()) {
+    result.set_name(tp.name());
+  }
+  if (tp.has_doc_string()) {
+    result.set_doc_string(tp.doc_string());
+  }
+  return result;
+}
+
+// An initializer to write, either copied from the model, or written as the
+// initializer without its data, followed by data taken from a buffer
+struct InitializerToWrite {
+  const ONNX_NAMESPACE::TensorProto *copied{nullptr};
+
+  ONNX_NAMESPACE::TensorProto header;
+  ConstVoidData data;
+  DataType dataType;
+  int64_t dataBytes{0};
+
+  // The serialized size, which ByteSizeLong also caches for
+  // SerializeWithCachedSizes
+  int64_t size() const {
+    if (copied) {
+      return copied->ByteSizeLong();
+    }
+    return header.ByteSizeLong() + fieldSize(dataBytes);
+  }
+
+  void write(google::protobuf::io::CodedOutputStream &coded) const {
+    coded.WriteVarint32(graphInitializerTag);
+    coded.WriteVarint64(size());
+    if (copied) {
+      copied->SerializeWithCachedSizes(&coded);
+      return;
+    }
+    header.SerializeWithCachedSizes(&coded);
+    coded.WriteVarint32(tensorRawDataTag);
+    coded.WriteVarint64(dataBytes);
+    forEachDataChunk(data, dataType, [&coded](const char *chunk, int64_t n) {
+      coded.WriteRaw(chunk, static_cast<int>(n));
+    });
+  }
+};
+
+InitializerToWrite copiedInitializer(const ONNX_NAMESPACE::TensorProto &tp) {
+  InitializerToWrite result;
+  result.copied = &tp;
+  return result;
+}
+
+InitializerToWrite streamedInitializer(ONNX_NAMESPACE::TensorProto header,
+                                       const ConstVoidData &data) {
+  InitializerToWrite result;
+  result.header   = std::move(header);
+  result.data     = data;
+  result.dataType = onnxutil::getDataType(result.header.data_type());
+  TensorInfo info(result.dataType,
+                  std::vector<int64_t>(result.header.dims().begin(),
+                                       result.header.dims().end()));
+  if (info.nelms() != data.info.nelms()) {
+    throw error("Cannot write {} elements of data for initializer {} of {} "
+                "elements",
+                data.info.nelms(),
+                result.header.name(),
+                info.nelms());
+  }
+  result.dataBytes = info.nbytes();
+  return result;
+}
+
+} // namespace
+
+void forEachDataChunk(
+    const ConstVoidData &src,
+    DataType dstType,
+    const std::function<void(const char *, int64_t)> &write) {
+  auto srcType  = src.info.dataType();
+  auto srcBytes = static_cast<const char *>(src.data);
+  if (srcType == dstType) {
+    for (int64_t offset = 0; offset < src.info.nbytes();
+         offset += maxDataChunkBytes) {
+      write(srcBytes + offset,
+            std::min(maxDataChunkBytes, src.info.nbytes() - offset));
+    }
+    return;
+  }
+
+  if (!hostconversion::canConvert(srcType, dstType)) {
+    throw error("Cannot write data of type {} as type {}",
+                src.info.data_type(),
+                TensorInfo(dstType, {}).data_type());
+  }
+  int64_t srcElemBytes = src.info.getDataTypeInfo()->nbytes();
+  int64_t dstElemBytes = TensorInfo(dstType, {}).getDataTypeInfo()->nbytes();
+  int64_t nelms        = src.info.nelms();
+  int64_t chunkElms    = std::max<int64_t>(
+      1, maxDataChunkBytes / std::max(srcElemBytes, dstElemBytes));
+  std::vector<char> chunk(std::min(nelms, chunkElms) * dstElemBytes);
+  for (int64_t begin = 0; begin < nelms; begin += chunkElms) {
+    int64_t n = std::min(chunkElms, nelms - begin);
+    hostconversion::convert(
+        srcType, srcBytes + begin * srcElemBytes, dstType, chunk.data(), n);
+    write(chunk.data(), n * dstElemBytes);
+  }
+}
+
+void writeModel(const ONNX_NAMESPACE::ModelProto &model,
+                const std::map<TensorId, ConstVoidData> &weights,
+                const std::string &filename) {
+  const auto &graph = model.graph();
+
+  // The serialized model is the model without its graph, followed by the
+  // graph: the graph without its initializers, followed by the initializers
+  auto modelHeader = copyModelWithoutGraph(model);
+  auto graphHeader = copyGraphWithoutInitializers(graph);
+
+  std::vector<InitializerToWrite> initializers;
+  std::set<TensorId> inModel;
+  // The sizes of the initializers in the model, and as they are written
+  int64_t modelInitializersSize = 0;
+  int64_t initializersSize      = 0;
+  for (const auto &tp : graph.initializer()) {
+    inModel.insert(tp.name());
+    modelInitializersSize += fieldSize(tp.ByteSizeLong());
+    auto found = weights.find(tp.name());
+    if (found == weights.end()) {
+      initializers.push_back(copiedInitializer(tp));
+    } else {
+      if (tp.has_data_location() &&
+          tp.data_location() == ONNX_NAMESPACE::TensorProto::EXTERNAL) {
+        throw error("Cannot write data of initializer {} to the model, it is "
+                    "stored externally",
+                    tp.name());
+      }
+      initializers.push_back(
+          streamedInitializer(copyTensorWithoutData(tp), found->second));
+    }
+    initializersSize += fieldSize(initializers.back().size());
+  }
+
+  for (const auto &weight : weights) {
+    if (inModel.count(weight.first) == 0) {
+      ONNX_NAMESPACE::TensorProto header;
+      header.set_name(weight.first);
+      header.set_data_type(
+          onnxutil::getTPDataType(weight.second.info.dataType()));
+      for (auto d : weight.second.info.shape()) {
+        header.add_dims(d);
+      }
+      initializers.push_back(streamedInitializer(header, weight.second));
+      initializersSize += fieldSize(initializers.back().size());
+    }
+  }
+
+  // The headers must hold all of the model but its initializers. If the
+  // model has fields which copyModelWithoutGraph and
+  // copyGraphWithoutInitializers do not know of, copy the whole model.
+  if (modelHeader.ByteSizeLong() + fieldSize(graph.ByteSizeLong()) !=
+          model.ByteSizeLong() ||
+      graphHeader.ByteSizeLong() + modelInitializersSize !=
+          graph.ByteSizeLong()) {
+    logging::debug("ModelProto has fields unknown to writeModel, copying it");
+    modelHeader = model;
+    modelHeader.clear_graph();
+    graphHeader = graph;
+    graphHeader.clear_initializer();
+  }
+
+  std::ofstream ofs(filename, std::ofstream::out | std::ofstream::binary);
+  if (!ofs.is_open()) {
+    throw error("Failed to open file {}", filename);
+  }
+
+  {
+    google::protobuf::io::OstreamOutputStream outputStream(&ofs);
+    google::protobuf::io::CodedOutputStream coded(&outputStream);
+
+    modelHeader.ByteSizeLong();
+    modelHeader.SerializeWithCachedSizes(&coded);
+
+    coded.WriteVarint32(modelGraphTag);
+    coded.WriteVarint64(graphHeader.ByteSizeLong() + initializersSize);
+    graphHeader.SerializeWithCachedSizes(&coded);
+
+    for (const auto &initializer : initializers) {
+      initializer.write(coded);
+    }
+
+    if (coded.HadError()) {
+      throw error("Failed to serialize ModelProto to {}", filename);
+    }
+  }
+
+  if (!ofs) {
+    throw error("Failed to serialize ModelProto to {}", filename);
+  }
+}
+
 ONNX_NAMESPACE::TensorProto getTensor(const std::string &filename) {
 
   confirmRegularFile(filename);
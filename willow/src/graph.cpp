@@ -1,4 +1,7 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <deque>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/range/algorithm.hpp>
 #include <onnx/onnx_pb.h>
@@ -67,12 +70,134 @@ private:
   TensorGradMapRegister gradRegister;
 };
 
+// The schedules and live sets of a Graph, memoized against its mutation
+// epoch. The scheduling settings of Ops are modified directly rather than
+// through the Graph, so the schedules are also memoized against a snapshot of
+// them.
+class Graph::ScheduleMemo {
+public:
+  struct OpSettings {
+    Op *op;
+    double schedulePriority;
+    OptionalPingPongPhase pingPongPhase;
+    OptionalPipelineStage pipelineStage;
+    OptionalBatchSerializedPhase batchSerializedPhase;
+    // The sizes of the outputs, used to weight liveness, can be changed
+    // without changing the Graph too
+    int64_t outputBytes;
+
+    bool operator==(const OpSettings &rhs) const {
+      return op == rhs.op && schedulePriority == rhs.schedulePriority &&
+             pingPongPhase == rhs.pingPongPhase &&
+             pipelineStage == rhs.pipelineStage &&
+             batchSerializedPhase == rhs.batchSerializedPhase &&
+             outputBytes == rhs.outputBytes;
+    }
+  };
+
+  struct Schedule {
+    OpsBeforeKey gCons;
+    bool respectPingPongPhases;
+    std::vector<Op *> ops;
+    double seconds;
+  };
+
+  struct LiveSets {
+    std::vector<Op *> topoOps;
+    std::vector<std::set<Op *>> sets;
+    double seconds;
+  };
+
+  // The most results of each kind which are kept for one epoch
+  static constexpr std::size_t maxEntries = 8;
+
+  // Forget the results of an earlier epoch
+  void setEpoch(uint64_t epoch) {
+    if (epoch != currentEpoch) {
+      schedules.clear();
+      liveSets.clear();
+      currentEpoch = epoch;
+    }
+  }
+
+  // Forget the schedules of earlier settings
+  void setOpSettings(std::vector<OpSettings> settings) {
+    if (settings != currentSettings) {
+      schedules.clear();
+      currentSettings = std::move(settings);
+    }
+  }
+
+  const Schedule *findSchedule(const OpsBeforeKey &gCons,
+                               bool respectPingPongPhases) {
+    for (const auto &schedule : schedules) {
+      if (schedule.respectPingPongPhases == respectPingPongPhases &&
+          schedule.gCons == gCons) {
+        ++counters.scheduleHits;
+        counters.secondsSaved += schedule.seconds;
+        return &schedule;
+      }
+    }
+    ++counters.scheduleMisses;
+    return nullptr;
+  }
+
+  void insertSchedule(Schedule schedule) {
+    if (schedules.size() == maxEntries) {
+      schedules.pop_front();
+    }
+    schedules.push_back(std::move(schedule));
+  }
+
+  const LiveSets *findLiveSets(const std::vector<Op *> &topoOps) {
+    for (const auto &entry : liveSets) {
+      if (entry.topoOps == topoOps) {
+        ++counters.liveSetsHits;
+        counters.secondsSaved += entry.seconds;
+        return &entry;
+      }
+    }
+    ++counters.liveSetsMisses;
+    return nullptr;
+  }
+
+  void insertLiveSets(LiveSets entry) {
+    if (liveSets.size() == maxEntries) {
+      liveSets.pop_front();
+    }
+    liveSets.push_back(std::move(entry));
+  }
+
+  ScheduleMemoCounters counters;
+
+private:
+  uint64_t currentEpoch{0};
+  std::vector<OpSettings> currentSettings;
+  std::deque<Schedule> schedules;
+  std::deque<LiveSets> liveSets;
+};
+
+constexpr std::size_t Graph::ScheduleMemo::maxEntries;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
 Graph::Graph(Ir &ir_, const GraphId &id_) : id(id_), ir(ir_) {
   up_tensors.reset(new Tensors(*this));
   topoCons.reset(new TopoCons());
   scheduler.reset(new Scheduler());
+  scheduleMemo.reset(new ScheduleMemo());
 }
 
+Graph::~Graph() = default;
+
 const std::map<OpId, std::unique_ptr<Op>> &Graph::getOps() const { return ops; }
 std::map<OpId, std::unique_ptr<Op>> &Graph::getOps() { return ops; }
 
@@ -254,6 +379,7 @@ OpId Graph::moveIntoGraph(std::unique_ptr<Op> op) {
 
   OpId opid = op->id;
   ops[opid] = std::move(op);
+  incrementMutationEpoch();
   return opid;
 }
 
@@ -306,6 +432,7 @@ void Graph::eraseOp(OpId opid) {
   // to clean this up properly, resulting in horrible accidents.
   topoCons->remove(found->second.get());
   ops.erase(opid);
+  incrementMutationEpoch();
 }
 
 // T12001
@@ -458,13 +585,52 @@ void Graph::setConvFlipWeightConstraints() {
   }
 }
 
+uint64_t Graph::getMutationEpoch() const {
+  return mutationEpoch + topoCons->getNumMutations();
+}
+
+const ScheduleMemoCounters &Graph::getScheduleMemoCounters() const {
+  return scheduleMemo->counters;
+}
+
 std::vector<Op *> Graph::getOpSchedule(const OpsBeforeKey &gCons) const {
-  return scheduler->getSchedule(gCons,
-                                *this,
-                                ir.getPingPongPhasesReady(),
-                                getIr().getSessionOptions().timeLimitScheduler,
-                                getIr().getSessionOptions().swapLimitScheduler,
-                                getIr().getSessionOptions().kahnTieBreaker);
+  std::vector<ScheduleMemo::OpSettings> settings;
+  settings.reserve(ops.size());
+  for (const auto &id_op : ops) {
+    const Op *op = id_op.second.get();
+    settings.push_back({id_op.second.get(),
+                        op->settings.schedulePriority,
+                        op->getOptionalPingPongPhase(),
+                        op->getOptionalPipelineStage(),
+                        op->getOptionalBatchSerializedPhase(),
+                        op->memOfOutputs()});
+  }
+  scheduleMemo->setEpoch(getMutationEpoch());
+  scheduleMemo->setOpSettings(std::move(settings));
+
+  const bool respectPingPongPhases = ir.getPingPongPhasesReady();
+  if (auto found = scheduleMemo->findSchedule(gCons, respectPingPongPhases)) {
+    logging::ir::trace("Memoized schedule of graph '{}' used, saving {} s",
+                       id.str(),
+                       found->seconds);
+    return found->ops;
+  }
+
+  CompileProfiler::Scope profile(
+      getIr().getCompileProfiler(), "schedule", "getOpSchedule");
+  profile.addArg("graph", id.str());
+
+  auto start    = Clock::now();
+  auto schedule = scheduler->getSchedule(
+      gCons,
+      *this,
+      respectPingPongPhases,
+      getIr().getSessionOptions().timeLimitScheduler,
+      getIr().getSessionOptions().swapLimitScheduler,
+      getIr().getSessionOptions().kahnTieBreaker);
+  scheduleMemo->insertSchedule(
+      {gCons, respectPingPongPhases, schedule, secondsSince(start)});
+  return schedule;
 }
 
 // Are the Ops with all the dependencies a DAG?
@@ -483,9 +649,9 @@ bool Graph::hasUserRecomputeOps() const {
   return false;
 }
 
-std::vector<std::set<Op *>>
-Graph::getLiveSets(const std::vector<Op *> &topoOps) const {
+namespace {
 
+std::vector<std::set<Op *>> computeLiveSets(const std::vector<Op *> &topoOps) {
   // the key op waits for the ops in val
   // so the key op is later in the sort.
   std::map<Op *, std::vector<Op *>, POpCmp> waiting;
@@ -535,6 +701,24 @@ Graph::getLiveSets(const std::vector<Op *> &topoOps) const {
   return liveSets;
 }
 
+} // namespace
+
+std::vector<std::set<Op *>>
+Graph::getLiveSets(const std::vector<Op *> &topoOps) const {
+  scheduleMemo->setEpoch(getMutationEpoch());
+  if (auto found = scheduleMemo->findLiveSets(topoOps)) {
+    logging::ir::trace("Memoized live sets of graph '{}' used, saving {} s",
+                       id.str(),
+                       found->seconds);
+    return found->sets;
+  }
+
+  auto start    = Clock::now();
+  auto liveSets = computeLiveSets(topoOps);
+  scheduleMemo->insertLiveSets({topoOps, liveSets, secondsSince(start)});
+  return liveSets;
+}
+
 int64_t Graph::getVirtualGraphId(const Op &op) {
   if (op.hasVirtualGraphId()) {
     return op.getVirtualGraphId();
@@ -1,11 +1,9 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
 #include <popart/graphtransformer_impl.hpp>
+#include <popart/hostconversion.hpp>
 #include <popart/onnxutil.hpp>
 #include <popart/opidentifier.hpp>
 
-// used for float to half conversion
-#include <poplar/Target.hpp>
-
 #include <onnx/checker.h>
 
 namespace popart {
@@ -576,15 +574,14 @@ void GraphTransformerImpl::convertFloatTensorToHalf(
     throw error("cannot set tensor type {} to type HALF", data_type_name);
   }
   auto mutableData = onnxutil::getMutableData(tp);
-  auto floatData   = reinterpret_cast<const float *>(mutableData.data);
 
   auto n_elms = mutableData.info.nelms();
   std::vector<char> hValData(2 * n_elms);
-  // poplar::copyFloatToDeviceHalf takes a Target as an argument, but doesn't
-  // use it, so a dummy target can be used here.
-  auto dummyTarget = poplar::Target();
-  poplar::copyFloatToDeviceHalf(
-      dummyTarget, floatData, hValData.data(), n_elms);
+  hostconversion::convert(DataType::FLOAT,
+                          mutableData.data,
+                          DataType::FLOAT16,
+                          hValData.data(),
+                          n_elms);
 
   tp.clear_float_data();
   tp.clear_raw_data();
@@ -600,15 +597,14 @@ void GraphTransformerImpl::convertDoubleTensorToHalf(
     throw error("cannot set tensor type {} to type HALF", data_type_name);
   }
   auto mutableData = onnxutil::getMutableData(tp);
-  auto doubleData  = reinterpret_cast<const double *>(mutableData.data);
 
   auto n_elms = mutableData.info.nelms();
   std::vector<char> hValData(2 * n_elms);
-  // poplar::copyDoubleToDeviceHalf takes a Target as an argument, but doesn't
-  // use it, so a dummy target can be used here.
-  auto dummyTarget = poplar::Target();
-  poplar::copyDoubleToDeviceHalf(
-      dummyTarget, doubleData, hValData.data(), n_elms);
+  hostconversion::convert(DataType::DOUBLE,
+                          mutableData.data,
+                          DataType::FLOAT16,
+                          hValData.data(),
+                          n_elms);
 
   tp.clear_double_data();
   tp.clear_raw_data();
@@ -1,42 +1,16 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
 #include <popart/error.hpp>
 #include <popart/half.hpp>
-
-#include <poplar/Target.hpp>
+#include <popart/hostconversion.hpp>
 
 namespace popart {
 
-static float halfToFloat(uint16_t f16) {
-  // poplar::Target is not used in this function
-  static auto dummyTarget = poplar::Target();
-  float f;
-  poplar::copyDeviceHalfToFloat(dummyTarget, &f16, &f, 1);
-  return f;
-}
-
-static uint16_t floatToHalf(float f) {
-  // poplar::Target is not used in this function
-  static auto dummyTarget = poplar::Target();
-  uint16_t f16;
-  poplar::copyFloatToDeviceHalf(dummyTarget, &f, &f16, 1);
-  return f16;
-}
-
 Half::Half() : data(0) {}
 
-Half::~Half() {}
-
-Half::Half(const Half &rhs) : data(rhs.data) {}
-
-Half::Half(float f) : data(floatToHalf(f)) {}
-
-Half &Half::operator=(const Half &rhs) {
-  data = rhs.data;
-  return *this;
-}
+Half::Half(float f) : data(hostconversion::floatToHalf(f)) {}
 
 Half &Half::operator=(const float rhs) {
-  data = floatToHalf(rhs);
+  data = hostconversion::floatToHalf(rhs);
   return *this;
 }
 
@@ -50,11 +24,31 @@ Half Half::operator/(const Half &rhs) {
   return (static_cast<float>(*this) / static_cast<float>(rhs));
 }
 
-Half::operator float() const { return halfToFloat(this->data); }
+Half::operator float() const { return hostconversion::halfToFloat(this->data); }
 
 std::ostream &operator<<(std::ostream &ss, const Half &v) {
   ss << static_cast<float>(v);
   return ss;
 }
 
+void halfToFloat(const Half *src, float *dst, int64_t nelms) {
+  hostconversion::convert(DataType::FLOAT16, src, DataType::FLOAT, dst, nelms);
+}
+
+void floatToHalf(const float *src, Half *dst, int64_t nelms) {
+  hostconversion::convert(DataType::FLOAT, src, DataType::FLOAT16, dst, nelms);
+}
+
+std::vector<float> halfToFloat(const std::vector<Half> &src) {
+  std::vector<float> dst(src.size());
+  halfToFloat(src.data(), dst.data(), static_cast<int64_t>(src.size()));
+  return dst;
+}
+
+std::vector<Half> floatToHalf(const std::vector<float> &src) {
+  std::vector<Half> dst(src.size());
+  floatToHalf(src.data(), dst.data(), static_cast<int64_t>(src.size()));
+  return dst;
+}
+
 } // namespace popart
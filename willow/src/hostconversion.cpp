@@ -0,0 +1,342 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <popart/error.hpp>
+#include <popart/hostconversion.hpp>
+#include <popart/threadpool.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define POPART_HOSTCONVERSION_X86 1
+#include <immintrin.h>
+#endif
+
+namespace popart {
+namespace hostconversion {
+
+namespace {
+
+// Buffers are split into chunks of at least this many (source) bytes when
+// converting on multiple threads. Smaller chunks cost more in synchronisation
+// than they gain.
+constexpr int64_t minBytesPerThread = 1 << 20;
+
+using Kernel = void (*)(const void *src, void *dst, int64_t nelms);
+
+uint32_t floatBits(float f) {
+  uint32_t u;
+  std::memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+float bitsFloat(uint32_t u) {
+  float f;
+  std::memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+uint16_t floatToHalfScalar(float f) {
+  const uint32_t x    = floatBits(f);
+  const uint32_t sign = (x >> 16) & 0x8000u;
+  uint32_t absx       = x & 0x7fffffffu;
+
+  // Inf and NaN. NaNs are quietened, keeping the top mantissa bits.
+  if (absx >= 0x7f800000u) {
+    uint32_t nan = absx > 0x7f800000u ? (0x200u | ((absx >> 13) & 0x3ffu)) : 0;
+    return static_cast<uint16_t>(sign | 0x7c00u | nan);
+  }
+
+  // Values which round to a magnitude of at least 65520 overflow to Inf.
+  if (absx >= 0x477ff000u) {
+    return static_cast<uint16_t>(sign | 0x7c00u);
+  }
+
+  // Subnormal half values are multiples of 2^-24, which is the ulp of 0.5f,
+  // so adding 0.5f makes the FPU round the value to a subnormal half mantissa
+  // (round to nearest, ties to even).
+  if (absx < 0x38800000u) {
+    float rounded = bitsFloat(absx) + 0.5f;
+    return static_cast<uint16_t>(sign | (floatBits(rounded) - 0x3f000000u));
+  }
+
+  // Normal values: rebias the exponent and round the 13 dropped mantissa bits
+  // to nearest, ties to even.
+  const uint32_t mantissaOdd = (absx >> 13) & 1u;
+  absx += 0xc8000fffu + mantissaOdd;
+  return static_cast<uint16_t>(sign | (absx >> 13));
+}
+
+float halfToFloatScalar(uint16_t h) {
+  const uint32_t sign     = static_cast<uint32_t>(h & 0x8000u) << 16;
+  const uint32_t exponent = (h >> 10) & 0x1fu;
+  const uint32_t mantissa = h & 0x3ffu;
+
+  // Inf and NaN. NaNs are quietened, as by the F16C instructions.
+  if (exponent == 0x1f) {
+    uint32_t nan = mantissa != 0 ? (0x400000u | (mantissa << 13)) : 0;
+    return bitsFloat(sign | 0x7f800000u | nan);
+  }
+  if (exponent == 0) {
+    // Zero or subnormal: the value is mantissa * 2^-24, exact in float.
+    float magnitude = static_cast<float>(mantissa) * bitsFloat(0x33800000u);
+    return bitsFloat(sign | floatBits(magnitude));
+  }
+  return bitsFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+void floatToHalfBaseline(const float *src, uint16_t *dst, int64_t nelms) {
+  for (int64_t i = 0; i < nelms; ++i) {
+    dst[i] = floatToHalfScalar(src[i]);
+  }
+}
+
+void halfToFloatBaseline(const uint16_t *src, float *dst, int64_t nelms) {
+  for (int64_t i = 0; i < nelms; ++i) {
+    dst[i] = halfToFloatScalar(src[i]);
+  }
+}
+
+template <typename From, typename To>
+void staticCastBaseline(const From *src, To *dst, int64_t nelms) {
+  for (int64_t i = 0; i < nelms; ++i) {
+    dst[i] = static_cast<To>(src[i]);
+  }
+}
+
+#ifdef POPART_HOSTCONVERSION_X86
+
+__attribute__((target("avx,f16c"))) void
+floatToHalfF16C(const float *src, uint16_t *dst, int64_t nelms) {
+  int64_t i = 0;
+  for (; i + 8 <= nelms; i += 8) {
+    __m256 f  = _mm256_loadu_ps(src + i);
+    __m128i h = _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), h);
+  }
+  floatToHalfBaseline(src + i, dst + i, nelms - i);
+}
+
+__attribute__((target("avx,f16c"))) void
+halfToFloatF16C(const uint16_t *src, float *dst, int64_t nelms) {
+  int64_t i = 0;
+  for (; i + 8 <= nelms; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+  }
+  halfToFloatBaseline(src + i, dst + i, nelms - i);
+}
+
+// Keep the low 32 bits of each 64 bit integer. The same kernel serves signed
+// and unsigned types.
+__attribute__((target("avx2"))) void
+truncate64To32AVX2(const uint64_t *src, uint32_t *dst, int64_t nelms) {
+  const __m256i lowHalves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  int64_t i               = 0;
+  for (; i + 8 <= nelms; i += 8) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+    __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 4));
+    a = _mm256_permutevar8x32_epi32(a, lowHalves);
+    b = _mm256_permutevar8x32_epi32(b, lowHalves);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm256_permute2x128_si256(a, b, 0x20));
+  }
+  staticCastBaseline(src + i, dst + i, nelms - i);
+}
+
+__attribute__((target("avx"))) void
+doubleToFloatAVX(const double *src, float *dst, int64_t nelms) {
+  int64_t i = 0;
+  for (; i + 4 <= nelms; i += 4) {
+    _mm_storeu_ps(dst + i, _mm256_cvtpd_ps(_mm256_loadu_pd(src + i)));
+  }
+  staticCastBaseline(src + i, dst + i, nelms - i);
+}
+
+struct CpuFeatures {
+  bool avx;
+  bool avx2;
+  bool f16c;
+};
+
+const CpuFeatures &cpuFeatures() {
+  static const CpuFeatures features = []() {
+    __builtin_cpu_init();
+    CpuFeatures f;
+    f.avx  = __builtin_cpu_supports("avx");
+    f.avx2 = __builtin_cpu_supports("avx2");
+    f.f16c = f.avx && __builtin_cpu_supports("f16c");
+    return f;
+  }();
+  return features;
+}
+
+#endif
+
+void floatToHalfKernel(const void *src, void *dst, int64_t nelms) {
+  auto s = static_cast<const float *>(src);
+  auto d = static_cast<uint16_t *>(dst);
+#ifdef POPART_HOSTCONVERSION_X86
+  if (cpuFeatures().f16c) {
+    return floatToHalfF16C(s, d, nelms);
+  }
+#endif
+  floatToHalfBaseline(s, d, nelms);
+}
+
+void halfToFloatKernel(const void *src, void *dst, int64_t nelms) {
+  auto s = static_cast<const uint16_t *>(src);
+  auto d = static_cast<float *>(dst);
+#ifdef POPART_HOSTCONVERSION_X86
+  if (cpuFeatures().f16c) {
+    return halfToFloatF16C(s, d, nelms);
+  }
+#endif
+  halfToFloatBaseline(s, d, nelms);
+}
+
+void truncate64To32Kernel(const void *src, void *dst, int64_t nelms) {
+  auto s = static_cast<const uint64_t *>(src);
+  auto d = static_cast<uint32_t *>(dst);
+#ifdef POPART_HOSTCONVERSION_X86
+  if (cpuFeatures().avx2) {
+    return truncate64To32AVX2(s, d, nelms);
+  }
+#endif
+  staticCastBaseline(s, d, nelms);
+}
+
+void doubleToFloatKernel(const void *src, void *dst, int64_t nelms) {
+  auto s = static_cast<const double *>(src);
+  auto d = static_cast<float *>(dst);
+#ifdef POPART_HOSTCONVERSION_X86
+  if (cpuFeatures().avx) {
+    return doubleToFloatAVX(s, d, nelms);
+  }
+#endif
+  staticCastBaseline(s, d, nelms);
+}
+
+// Round a double to float, rounding inexact values to the neighbouring float
+// with an odd mantissa ("round to odd"). Rounding the result to half then
+// gives the same value as rounding the double to half directly, which
+// rounding to nearest twice does not (for example, 1 + 2^-11 + 2^-40 would
+// round to 1 + 2^-11, then to 1).
+float doubleToFloatRoundToOdd(double x) {
+  float f = static_cast<float>(x);
+  if (static_cast<double>(f) != x && !std::isnan(x)) {
+    uint32_t u = floatBits(f);
+    if (std::fabs(static_cast<double>(f)) > std::fabs(x)) {
+      // Rounded up in magnitude, so take the float below it in magnitude
+      --u;
+    }
+    f = bitsFloat(u | 1u);
+  }
+  return f;
+}
+
+void doubleToHalfKernel(const void *src, void *dst, int64_t nelms) {
+  auto s = static_cast<const double *>(src);
+  auto d = static_cast<uint16_t *>(dst);
+
+  // Round blocks to float, which are then converted by the float kernel
+  constexpr int64_t blockSize = 1024;
+  float block[blockSize];
+  for (int64_t begin = 0; begin < nelms; begin += blockSize) {
+    int64_t n = std::min(blockSize, nelms - begin);
+    for (int64_t i = 0; i < n; ++i) {
+      block[i] = doubleToFloatRoundToOdd(s[begin + i]);
+    }
+    floatToHalfKernel(block, d + begin, n);
+  }
+}
+
+// Widening conversions are vectorized well by the compiler.
+template <typename From, typename To>
+void staticCastKernel(const void *src, void *dst, int64_t nelms) {
+  staticCastBaseline(
+      static_cast<const From *>(src), static_cast<To *>(dst), nelms);
+}
+
+Kernel getKernel(DataType src, DataType dst) {
+  if (src == DataType::FLOAT && dst == DataType::FLOAT16) {
+    return floatToHalfKernel;
+  }
+  if (src == DataType::FLOAT16 && dst == DataType::FLOAT) {
+    return halfToFloatKernel;
+  }
+  if (src == DataType::DOUBLE && dst == DataType::FLOAT16) {
+    return doubleToHalfKernel;
+  }
+  if ((src == DataType::INT64 && dst == DataType::INT32) ||
+      (src == DataType::UINT64 && dst == DataType::UINT32)) {
+    return truncate64To32Kernel;
+  }
+  if (src == DataType::INT32 && dst == DataType::INT64) {
+    return staticCastKernel<int32_t, int64_t>;
+  }
+  if (src == DataType::DOUBLE && dst == DataType::FLOAT) {
+    return doubleToFloatKernel;
+  }
+  return nullptr;
+}
+
+int64_t elementSize(DataType type) {
+  return static_cast<int64_t>(getDataTypeInfoMap().at(type).nbytes());
+}
+
+} // namespace
+
+bool canConvert(DataType src, DataType dst) {
+  return src == dst || getKernel(src, dst) != nullptr;
+}
+
+void convert(DataType srcType,
+             const void *src,
+             DataType dstType,
+             void *dst,
+             int64_t nelms) {
+  auto srcBytes = static_cast<const char *>(src);
+  auto dstBytes = static_cast<char *>(dst);
+  auto srcSize  = elementSize(srcType);
+  auto dstSize  = elementSize(dstType);
+
+  auto &pool = ThreadPool::global();
+  auto grain = std::max<int64_t>(1, minBytesPerThread / srcSize);
+
+  if (srcType == dstType) {
+    pool.parallelFor(nelms, grain, [=](int64_t begin, int64_t end) {
+      std::memcpy(dstBytes + begin * dstSize,
+                  srcBytes + begin * srcSize,
+                  (end - begin) * srcSize);
+    });
+    return;
+  }
+
+  Kernel kernel = getKernel(srcType, dstType);
+  if (!kernel) {
+    throw error("Unsupported host conversion from {} to {}",
+                getDataTypeInfoMap().at(srcType).name(),
+                getDataTypeInfoMap().at(dstType).name());
+  }
+
+  pool.parallelFor(nelms, grain, [=](int64_t begin, int64_t end) {
+    kernel(srcBytes + begin * srcSize, dstBytes + begin * dstSize, end - begin);
+  });
+}
+
+uint16_t floatToHalf(float f) { return floatToHalfScalar(f); }
+
+float halfToFloat(uint16_t h) { return halfToFloatScalar(h); }
+
+void floatToHalf(const float *src, uint16_t *dst, int64_t nelms) {
+  floatToHalfKernel(src, dst, nelms);
+}
+
+void halfToFloat(const uint16_t *src, float *dst, int64_t nelms) {
+  halfToFloatKernel(src, dst, nelms);
+}
+
+} // namespace hostconversion
+} // namespace popart
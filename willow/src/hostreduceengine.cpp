@@ -0,0 +1,326 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstring>
+
+#include <popart/error.hpp>
+#include <popart/hostconversion.hpp>
+#include <popart/hostreduceengine.hpp>
+#include <popart/logging.hpp>
+#include <popart/threadpool.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define POPART_HOSTREDUCE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace popart {
+
+namespace hostreduce {
+
+namespace {
+
+// FLOAT16 data is converted to FLOAT in blocks of this many elements, which
+// fit in the L1 cache along with the blocks of the sources
+constexpr int64_t halfBlockElms = 1024;
+
+void sumFloatBaseline(const float *const *srcs,
+                      unsigned nSrcs,
+                      float *dst,
+                      int64_t begin,
+                      int64_t end) {
+  for (int64_t i = begin; i < end; ++i) {
+    float acc = srcs[0][i];
+    for (unsigned r = 1; r < nSrcs; ++r) {
+      acc += srcs[r][i];
+    }
+    dst[i] = acc;
+  }
+}
+
+#ifdef POPART_HOSTREDUCE_X86
+
+// The replicas are added in the same order as by sumFloatBaseline, so the
+// results do not depend on the kernel used.
+__attribute__((target("avx"))) void sumFloatAVX(const float *const *srcs,
+                                                unsigned nSrcs,
+                                                float *dst,
+                                                int64_t nelms) {
+  int64_t i = 0;
+  for (; i + 16 <= nelms; i += 16) {
+    __m256 acc0 = _mm256_loadu_ps(srcs[0] + i);
+    __m256 acc1 = _mm256_loadu_ps(srcs[0] + i + 8);
+    for (unsigned r = 1; r < nSrcs; ++r) {
+      acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(srcs[r] + i));
+      acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(srcs[r] + i + 8));
+    }
+    _mm256_storeu_ps(dst + i, acc0);
+    _mm256_storeu_ps(dst + i + 8, acc1);
+  }
+  sumFloatBaseline(srcs, nSrcs, dst, i, nelms);
+}
+
+bool hasAVX() {
+  static const bool avx = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") != 0;
+  }();
+  return avx;
+}
+
+#endif
+
+} // namespace
+
+void sumFloat(const float *const *srcs,
+              unsigned nSrcs,
+              float *dst,
+              int64_t nelms) {
+  if (nSrcs == 0) {
+    throw error("Cannot sum 0 buffers in hostreduce::sumFloat");
+  }
+#ifdef POPART_HOSTREDUCE_X86
+  if (hasAVX()) {
+    return sumFloatAVX(srcs, nSrcs, dst, nelms);
+  }
+#endif
+  sumFloatBaseline(srcs, nSrcs, dst, 0, nelms);
+}
+
+void sumHalf(const uint16_t *const *srcs,
+             unsigned nSrcs,
+             uint16_t *dst,
+             int64_t nelms) {
+  if (nSrcs == 0) {
+    throw error("Cannot sum 0 buffers in hostreduce::sumHalf");
+  }
+
+  float acc[halfBlockElms];
+  float src[halfBlockElms];
+  const float *accAndSrc[2] = {acc, src};
+
+  for (int64_t begin = 0; begin < nelms; begin += halfBlockElms) {
+    auto n = std::min(halfBlockElms, nelms - begin);
+    hostconversion::halfToFloat(srcs[0] + begin, acc, n);
+    for (unsigned r = 1; r < nSrcs; ++r) {
+      hostconversion::halfToFloat(srcs[r] + begin, src, n);
+      sumFloat(accAndSrc, 2, acc, n);
+    }
+    hostconversion::floatToHalf(acc, dst + begin, n);
+  }
+}
+
+} // namespace hostreduce
+
+struct HostReduceEngine::Gradient {
+  TensorId id;
+  TensorInfo info;
+  unsigned nContributions;
+
+  // One buffer per contribution. The sum is written to buffers[0].
+  std::vector<std::vector<char>> buffers;
+
+  // Guards the members below
+  std::mutex mutex;
+  std::vector<bool> received;
+  unsigned nReceived{0};
+  // The reductions of the buckets, if started
+  std::vector<std::future<void>> buckets;
+};
+
+HostReduceEngine::HostReduceEngine(unsigned nReplicas_,
+                                   int64_t bucketBytes_,
+                                   ThreadPool &pool_)
+    : nReplicas(nReplicas_), bucketBytes(bucketBytes_), pool(pool_) {
+  if (nReplicas == 0) {
+    throw error("HostReduceEngine requires at least 1 replica");
+  }
+  if (bucketBytes <= 0) {
+    throw error("Invalid HostReduceEngine bucket size {}, it must be positive",
+                bucketBytes);
+  }
+}
+
+HostReduceEngine::~HostReduceEngine() {
+  // The bucket reductions reference the buffers
+  for (auto &id_gradient : gradients) {
+    for (auto &bucket : id_gradient.second->buckets) {
+      if (bucket.valid()) {
+        bucket.wait();
+      }
+    }
+  }
+}
+
+void HostReduceEngine::addGradient(const TensorId &id,
+                                   const TensorInfo &info,
+                                   unsigned nContributions) {
+  if (gradients.find(id) != gradients.end()) {
+    throw error("Gradient {} has already been added to the HostReduceEngine",
+                id);
+  }
+  if (info.dataType() != DataType::FLOAT &&
+      info.dataType() != DataType::FLOAT16) {
+    throw error("HostReduceEngine does not support gradient {} of type {}, "
+                "only FLOAT and FLOAT16 are supported",
+                id,
+                info.data_type());
+  }
+  if (nContributions == 0 || nContributions > nReplicas) {
+    throw error("Invalid number of contributions {} to gradient {}, it must be "
+                "in [1, {}]",
+                nContributions,
+                id,
+                nReplicas);
+  }
+
+  auto gradient            = std::make_unique<Gradient>();
+  gradient->id             = id;
+  gradient->info           = info;
+  gradient->nContributions = nContributions;
+  gradient->buffers.resize(nContributions);
+  for (auto &buffer : gradient->buffers) {
+    buffer.resize(info.nbytes());
+  }
+  gradient->received.resize(nContributions, false);
+
+  logging::devicex::debug("HostReduceEngine: added gradient {} ({} bytes, {} "
+                          "contributions)",
+                          id,
+                          info.nbytes(),
+                          nContributions);
+  gradients.emplace(id, std::move(gradient));
+}
+
+bool HostReduceEngine::hasGradient(const TensorId &id) const {
+  return gradients.find(id) != gradients.end();
+}
+
+int64_t HostReduceEngine::getBytesReceived() const { return bytesReceived; }
+
+HostReduceEngine::Gradient &HostReduceEngine::getGradient(const TensorId &id) {
+  auto found = gradients.find(id);
+  if (found == gradients.end()) {
+    throw error("Gradient {} has not been added to the HostReduceEngine", id);
+  }
+  return *found->second;
+}
+
+void HostReduceEngine::receive(const TensorId &id,
+                               unsigned replica,
+                               const void *src) {
+  if (replica >= nReplicas) {
+    throw error("Invalid replica {} of gradient {}, there are {} replicas",
+                replica,
+                id,
+                nReplicas);
+  }
+
+  auto &g = getGradient(id);
+  if (replica >= g.nContributions) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(g.mutex);
+    if (g.received[replica]) {
+      throw error("Replica {} of gradient {} was received twice before its "
+                  "sum was sent",
+                  replica,
+                  id);
+    }
+    g.received[replica] = true;
+  }
+
+  // Replicas copy to different buffers, so may do so concurrently
+  auto nbytes = g.info.nbytes();
+  std::memcpy(g.buffers[replica].data(), src, nbytes);
+  bytesReceived += nbytes;
+
+  std::lock_guard<std::mutex> lock(g.mutex);
+  ++g.nReceived;
+  if (g.nReceived == g.nContributions) {
+    startReduction(g);
+  }
+}
+
+void HostReduceEngine::startReduction(Gradient &g) {
+  if (g.nContributions == 1) {
+    return;
+  }
+
+  const auto elementBytes = g.info.getDataTypeInfo()->nbytes();
+  const auto bucketElms   = std::max<int64_t>(1, bucketBytes / elementBytes);
+  const auto nelms        = g.info.nelms();
+
+  for (int64_t begin = 0; begin < nelms; begin += bucketElms) {
+    auto end = std::min(nelms, begin + bucketElms);
+    g.buckets.push_back(pool.submit([&g, begin, end]() {
+      auto n = end - begin;
+      if (g.info.dataType() == DataType::FLOAT) {
+        std::vector<const float *> srcs;
+        srcs.reserve(g.nContributions);
+        for (auto &buffer : g.buffers) {
+          srcs.push_back(reinterpret_cast<const float *>(buffer.data()) +
+                         begin);
+        }
+        auto dst = reinterpret_cast<float *>(g.buffers[0].data()) + begin;
+        hostreduce::sumFloat(srcs.data(), g.nContributions, dst, n);
+      } else {
+        std::vector<const uint16_t *> srcs;
+        srcs.reserve(g.nContributions);
+        for (auto &buffer : g.buffers) {
+          srcs.push_back(reinterpret_cast<const uint16_t *>(buffer.data()) +
+                         begin);
+        }
+        auto dst = reinterpret_cast<uint16_t *>(g.buffers[0].data()) + begin;
+        hostreduce::sumHalf(srcs.data(), g.nContributions, dst, n);
+      }
+    }));
+  }
+}
+
+void HostReduceEngine::send(const TensorId &id, void *dst) {
+  auto &g = getGradient(id);
+
+  std::vector<std::future<void>> buckets;
+  {
+    std::lock_guard<std::mutex> lock(g.mutex);
+    if (g.nReceived != g.nContributions) {
+      throw error("Cannot send the sum of gradient {}, only {} of its {} "
+                  "contributions have been received",
+                  id,
+                  g.nReceived,
+                  g.nContributions);
+    }
+    buckets = std::move(g.buckets);
+    g.buckets.clear();
+  }
+
+  std::exception_ptr firstError;
+  for (auto &bucket : buckets) {
+    try {
+      bucket.get();
+    } catch (...) {
+      if (!firstError) {
+        firstError = std::current_exception();
+      }
+    }
+  }
+
+  if (!firstError) {
+    std::memcpy(dst, g.buffers[0].data(), g.info.nbytes());
+  }
+
+  // Ready for the next step
+  {
+    std::lock_guard<std::mutex> lock(g.mutex);
+    std::fill(g.received.begin(), g.received.end(), false);
+    g.nReceived = 0;
+  }
+
+  if (firstError) {
+    std::rethrow_exception(firstError);
+  }
+}
+
+} // namespace popart
@@ -9,6 +9,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include <boost/functional/hash.hpp>
 #include <boost/random/normal_distribution.hpp>
 
 #include <popart/builder.hpp>
@@ -16,9 +17,11 @@
 #include <popart/ces/onnxconstexpr.hpp>
 #include <popart/chains.hpp>
 #include <popart/devicemanager.hpp>
+#include <popart/dynamictoposort.hpp>
 #include <popart/error.hpp>
 #include <popart/filereader.hpp>
 #include <popart/graph.hpp>
+#include <popart/half.hpp>
 #include <popart/intervals.hpp>
 #include <popart/ir.hpp>
 #include <popart/logging.hpp>
@@ -38,6 +41,7 @@
 #include <popart/tensors.hpp>
 #include <popart/topocons.hpp>
 #include <popart/util.hpp>
+#include <popart/version.hpp>
 
 // The transformations
 #include <popart/recompute.hpp>
@@ -69,16 +73,15 @@
 #include <popart/op/sgd0varupdate.hpp>
 #include <popart/op/sum.hpp>
 
+#include <popart/patterns/adamdecompose.hpp>
 #include <popart/patterns/inplace.hpp>
+#include <popart/patterns/prealiaspatternrewriter.hpp>
 #include <popart/patterns/sgd0decompose.hpp>
 #include <popart/patterns/sgd1decompose.hpp>
 #include <popart/patterns/updateinplaceprioritiesforipu.hpp>
 
 #include <popart/dotvisualizer.hpp>
 
-// used for float to half conversion
-#include <poplar/Target.hpp>
-
 namespace popart {
 
 Ir::~Ir() = default;
@@ -758,13 +761,23 @@ void Ir::prepare(const IrBundle &gb) {
     }
   };
 
+  if (gb.userOptions.enableCompileProfiling) {
+    compileProfiler.enable();
+  }
+
   try {
+    CompileProfiler::Scope profile(compileProfiler, "ir", "Ir::prepare", this);
     prepareImpl(gb);
   } catch (...) {
     tryDumpIr(logging::Level::Err);
     throw;
   }
   tryDumpIr(logging::Level::Debug);
+
+  // Written again with the stages of the Poplar graph by Devicex::prepare
+  if (compileProfiler.isEnabled()) {
+    compileProfiler.write(gb.userOptions.logDir);
+  }
 }
 
 void Ir::prepareImpl(const IrBundle &gb) {
@@ -786,6 +799,11 @@ void Ir::prepareImpl(const IrBundle &gb) {
   setPatterns(gb.patterns);
   setOnnxModel(gb.modelProto);
 
+  if (gb.userOptions.enableEngineCaching) {
+    irBundleHash = std::hash<IrBundle>{}(gb);
+    logging::ir::debug("IrBundle hash is {}", irBundleHash);
+  }
+
   if (graphs.size() == 1) {
     if (isPrepared) {
       throw error("There is more than one graph at the loss insertion stage, "
@@ -996,6 +1014,8 @@ void Ir::prepareImpl(const IrBundle &gb) {
   applyPreAliasPattern(&sgd0Decomposer, getMainGraph());
   SGD1Decompose sgd1Decomposer;
   applyPreAliasPattern(&sgd1Decomposer, getMainGraph());
+  AdamDecompose adamDecomposer;
+  applyPreAliasPattern(&adamDecomposer, getMainGraph());
 
   if (getSessionOptions().hostWeightUpdate &&
       !getSessionOptions().hostAllReduce) {
@@ -1003,6 +1023,12 @@ void Ir::prepareImpl(const IrBundle &gb) {
         "Host weight update can't be enabled without enabling hostAllReduce.");
   }
 
+  if (getSessionOptions().hostAllReduceEngine &&
+      !getSessionOptions().hostAllReduce) {
+    throw error("hostAllReduceEngine can't be enabled without enabling "
+                "hostAllReduce.");
+  }
+
   if (getSessionOptions().hostAllReduce) {
     if (canTrain()) {
       if (getSessionOptions().hostWeightUpdate &&
@@ -1156,6 +1182,18 @@ void Ir::prepareImpl(const IrBundle &gb) {
   verifyRecomputeAttributes();
   // end of checks
 
+  for (auto graph : getAllGraphs()) {
+    const auto &counters = graph->getScheduleMemoCounters();
+    logging::ir::info("Graph '{}' used {} memoized schedules and {} memoized "
+                      "live sets ({} and {} computed), saving {} s",
+                      graph->id.str(),
+                      counters.scheduleHits,
+                      counters.liveSetsHits,
+                      counters.scheduleMisses,
+                      counters.liveSetsMisses,
+                      counters.secondsSaved);
+  }
+
   isPrepared = true;
 }
 
@@ -1316,6 +1354,295 @@ void Ir::resetWeights(
 
 namespace {
 
+// The first line of a prepared Ir written by Ir::serializePrepared, followed
+// by its Tensors, in the binary format of this host. The engine cache key
+// includes the version of PopART, so entries are not read by other versions
+const char *const preparedIrHeader = "popart-prepared-ir";
+const int preparedIrFormat         = 1;
+
+void writeUInt64(std::ostream &os, uint64_t x) {
+  os.write(reinterpret_cast<const char *>(&x), sizeof(x));
+}
+
+bool readUInt64(std::istream &is, uint64_t &x) {
+  return static_cast<bool>(is.read(reinterpret_cast<char *>(&x), sizeof(x)));
+}
+
+void writeString(std::ostream &os, const std::string &s) {
+  writeUInt64(os, s.size());
+  os.write(s.data(), s.size());
+}
+
+bool readString(std::istream &is, std::string &s) {
+  uint64_t size;
+  if (!readUInt64(is, size)) {
+    return false;
+  }
+  s.resize(size);
+  return static_cast<bool>(is.read(&s[0], size));
+}
+
+void writeTensorInfo(std::ostream &os, const TensorInfo &info) {
+  writeUInt64(os, static_cast<uint64_t>(info.dataType()));
+  writeUInt64(os, info.shape().size());
+  for (auto dim : info.shape()) {
+    writeUInt64(os, static_cast<uint64_t>(dim));
+  }
+}
+
+bool readTensorInfo(std::istream &is, TensorInfo &info) {
+  uint64_t dataType, rank;
+  if (!readUInt64(is, dataType) || !readUInt64(is, rank) ||
+      dataType >= static_cast<uint64_t>(DataType::UNDEFINED)) {
+    return false;
+  }
+  Shape shape;
+  for (uint64_t i = 0; i < rank; ++i) {
+    uint64_t dim;
+    if (!readUInt64(is, dim)) {
+      return false;
+    }
+    shape.push_back(static_cast<int64_t>(dim));
+  }
+  info = TensorInfo(static_cast<DataType>(dataType), shape);
+  return true;
+}
+
+// The initializers of the model, by name
+std::map<TensorId, const ONNX_NAMESPACE::TensorProto *>
+getInitializers(const ONNX_NAMESPACE::ModelProto &model) {
+  std::map<TensorId, const ONNX_NAMESPACE::TensorProto *> initializers;
+  for (const auto &initializer : model.graph().initializer()) {
+    initializers[initializer.name()] = &initializer;
+  }
+  return initializers;
+}
+
+struct SerializedTensor {
+  TensorId id;
+  TensorInfo info;
+  // A Variable read from the initializer of the same name of the model
+  bool fromModel{false};
+  // The data of a Variable which is not read from the model
+  std::vector<char> data;
+};
+
+} // namespace
+
+bool Ir::canSerializePrepared() const {
+  const auto &opts = getSessionOptions();
+  if (opts.hostAllReduce || opts.instrumentWithHardwareCycleCounter ||
+      !remoteBufferInfoMap.empty()) {
+    return false;
+  }
+  for (auto &id : getTensors().getAllTensorIds()) {
+    if (getTensors().get(id)->cacheInfo.isCached()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Ir::serializePrepared(std::ostream &os) const {
+  os << preparedIrHeader << ' ' << preparedIrFormat << '\n';
+
+  writeUInt64(os, additionalModelProtoTensors.size());
+  for (auto &id : additionalModelProtoTensors) {
+    writeString(os, id);
+  }
+
+  // The initializers are read from the model, which is a part of the key
+  auto initializers = getInitializers(getModel());
+  auto variableIds  = getTensorIds(TensorType::Variable);
+  writeUInt64(os, variableIds.size());
+  for (auto &id : variableIds) {
+    auto tensor    = getTensor(id);
+    auto found     = initializers.find(id);
+    bool fromModel = found != initializers.end() &&
+                     TensorInfo(*found->second) == tensor->info;
+    writeString(os, id);
+    writeTensorInfo(os, tensor->info);
+    writeUInt64(os, fromModel);
+    if (!fromModel) {
+      os.write(static_cast<const char *>(tensor->tensorData()->data()),
+               tensor->info.nbytes());
+    }
+  }
+
+  auto streams = getTensors().getOfType(TensorType::Stream);
+  writeUInt64(os, streams.size());
+  for (auto tensor : streams) {
+    writeString(os, tensor->id);
+    writeTensorInfo(os, tensor->info);
+  }
+
+  // The anchors which are not Variables or Streams
+  std::vector<Tensor *> anchors;
+  for (auto &id : dataFlow.anchors()) {
+    auto tensor = getTensor(id);
+    if (tensor->tensorType() != TensorType::Variable &&
+        tensor->tensorType() != TensorType::Stream) {
+      anchors.push_back(tensor);
+    }
+  }
+  writeUInt64(os, anchors.size());
+  for (auto tensor : anchors) {
+    writeString(os, tensor->id);
+    writeTensorInfo(os, tensor->info);
+  }
+}
+
+bool Ir::prepareFromSerialized(const IrBundle &gb, std::istream &is) {
+  if (isPrepared) {
+    throw error("Ir::prepare called more than once");
+  }
+
+  // The whole record is read before the Ir is changed
+  auto initializers = getInitializers(gb.modelProto);
+  std::vector<TensorId> additionalTensors;
+  std::vector<SerializedTensor> variables, streams, anchors;
+
+  auto readRecord = [&]() {
+    std::string header;
+    int format;
+    is >> header >> format;
+    if (!is || header != preparedIrHeader || format != preparedIrFormat) {
+      return false;
+    }
+    is.get();
+
+    uint64_t n;
+    if (!readUInt64(is, n)) {
+      return false;
+    }
+    additionalTensors.resize(n);
+    for (auto &id : additionalTensors) {
+      if (!readString(is, id)) {
+        return false;
+      }
+    }
+
+    auto readTensors = [&is](std::vector<SerializedTensor> &tensors, auto f) {
+      uint64_t size;
+      if (!readUInt64(is, size)) {
+        return false;
+      }
+      tensors.resize(size);
+      for (auto &tensor : tensors) {
+        if (!readString(is, tensor.id) || !readTensorInfo(is, tensor.info) ||
+            !f(tensor)) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    auto readVariable = [&](SerializedTensor &tensor) {
+      uint64_t fromModel;
+      if (!readUInt64(is, fromModel)) {
+        return false;
+      }
+      tensor.fromModel = fromModel != 0;
+      if (tensor.fromModel) {
+        return initializers.count(tensor.id) != 0;
+      }
+      tensor.data.resize(tensor.info.nbytes());
+      return static_cast<bool>(is.read(tensor.data.data(), tensor.data.size()));
+    };
+    auto readNothing = [](SerializedTensor &) { return true; };
+
+    return readTensors(variables, readVariable) &&
+           readTensors(streams, readNothing) &&
+           readTensors(anchors, readNothing);
+  };
+
+  if (!readRecord()) {
+    logging::ir::warn("Unable to read the prepared Ir from the engine cache, "
+                      "preparing it");
+    return false;
+  }
+
+  if (gb.userOptions.enableCompileProfiling) {
+    compileProfiler.enable();
+  }
+
+  {
+    CompileProfiler::Scope profile(
+        compileProfiler, "ir", "Ir::prepareFromSerialized", this);
+
+    setDeviceInfo(gb.deviceInfo);
+    if (gb.optimizer) {
+      setExecutionMode(ExecutionMode::Training);
+    } else {
+      setExecutionMode(ExecutionMode::Inference);
+    }
+    setDataFlow(gb.dataFlow);
+    setInputShapeInfo(gb.inputShapeInfo);
+    setUserOptions(gb.userOptions);
+    setPatterns(gb.patterns);
+    setOnnxModel(gb.modelProto);
+    irBundleHash           = std::hash<IrBundle>{}(gb);
+    preparedFromSerialized = true;
+
+    if (gb.optimizer) {
+      // As in setOptimizer, without creating the loss scaling Tensors, which
+      // are among the Streams if they were used
+      optimizer = gb.optimizer->clone();
+      optimizer->setFactorsFromOptions(getSessionOptions());
+    }
+
+    additionalModelProtoTensors.insert(additionalTensors.begin(),
+                                       additionalTensors.end());
+
+    for (auto &variable : variables) {
+      if (variable.fromModel) {
+        getTensors().addVarInit(variable.id, initializers.at(variable.id));
+      } else {
+        getTensors().addVarInit(
+            variable.id, variable.info, variable.data.data());
+      }
+    }
+
+    for (auto &stream : streams) {
+      getTensors().addStream(stream.id, stream.info);
+      auto tensor = getTensor(stream.id);
+      if (tensor->isOptimizerTensor()) {
+        optimizer->setTensorData(*tensor);
+        tensor->setReplicatedStreamMode(
+            Tensor::ReplicatedStreamMode::Broadcast);
+      } else if (tensor->isRandomSeedTensor()) {
+        tensor->setReplicatedStreamMode(
+            Tensor::ReplicatedStreamMode::Replicate);
+      }
+    }
+    if (requiresRandomSeed()) {
+      // As in initRandomSeed
+      uint64_t init =
+          std::chrono::system_clock::now().time_since_epoch().count();
+      setRandomSeedValue(init);
+    }
+
+    for (auto &anchor : anchors) {
+      getTensors().addActGrad(anchor.id);
+      getTensor(anchor.id)->info = anchor.info;
+    }
+
+    logging::ir::info("Restored the prepared Ir from the engine cache, with "
+                      "{} Variables, {} Streams and {} other anchors",
+                      variables.size(),
+                      streams.size(),
+                      anchors.size());
+    isPrepared = true;
+  }
+
+  if (compileProfiler.isEnabled()) {
+    compileProfiler.write(gb.userOptions.logDir);
+  }
+  return true;
+}
+
+namespace {
+
 void checkForDimParams(const TensorId &id, const ONNX_NAMESPACE::TypeProto &t) {
   auto dimString = [&]() {
     std::stringstream ss;
@@ -1547,35 +1874,34 @@ void Ir::validateAnchors() const {
   }
 }
 
-bool Ir::applyPreAliasPattern(const PreAliasPattern *pattern, Graph &graph) {
-  bool result = false;
+bool Ir::canApplyPreAliasPattern(const PreAliasPattern *pattern,
+                                 Op *op) const {
+  if (op->isExcludedFromPattern(pattern) || !pattern->matches(op) ||
+      pattern->touchesAnchored(op)) {
+    return false;
+  }
 
-  auto touchesInputToLoss = [&graph, pattern](Op *op) {
-    for (auto &tensor : pattern->touches(op)) {
-      if (graph.getTensors().contains(graph.getLoss())) {
+  // If the ir will construct a loss, but hasn't yet, check that the pattern
+  // doesn't touch the inputs to the loss.
+  if (canTrain() && !constructedFinalLoss) {
+    auto &graph = op->getGraph();
+    if (graph.getTensors().contains(graph.getLoss())) {
+      for (auto &tensor : pattern->touches(op)) {
         if (graph.getLoss() == tensor->id) {
-          return true;
+          return false;
         }
       }
     }
-    return false;
-  };
-
-  auto canApplyPattern = [this, &touchesInputToLoss, pattern](Op *op) {
-    if (op->isExcludedFromPattern(pattern) || !pattern->matches(op) ||
-        pattern->touchesAnchored(op)) {
-      return false;
-    }
+  }
 
-    // If the ir will construct a loss, but hasn't yet, check that the pattern
-    // doesn't touch the inputs to the loss.
-    if (this->canTrain() && !this->constructedFinalLoss &&
-        touchesInputToLoss(op)) {
-      return false;
-    }
+  return true;
+}
 
-    return true;
-  };
+bool Ir::applyPreAliasPattern(const PreAliasPattern *pattern, Graph &graph) {
+  CompileProfiler::Scope profile(
+      compileProfiler, "patterns", pattern->getPatternName(), this);
+  profile.addArg("graph", graph.id.str());
+  bool result = false;
 
   // the pattern chooses what order to go through the ops in
 
@@ -1592,7 +1918,7 @@ bool Ir::applyPreAliasPattern(const PreAliasPattern *pattern, Graph &graph) {
     // If the op still exists
     if (itr != graph.getOps().end()) {
       Op *op = itr->second.get();
-      if (canApplyPattern(op)) {
+      if (canApplyPreAliasPattern(pattern, op)) {
         logging::pattern::debug("Applying pattern {} to {}",
                                 pattern->getPatternName(),
                                 op->debugName());
@@ -1605,25 +1931,34 @@ bool Ir::applyPreAliasPattern(const PreAliasPattern *pattern, Graph &graph) {
 }
 
 void Ir::applyPreAliasPatterns(Graph &graph) {
+  CompileProfiler::Scope profile(
+      compileProfiler, "patterns", "PreAliasPatterns", this);
+  profile.addArg("graph", graph.id.str());
 
-  bool keepRunning = true;
-  std::vector<std::unique_ptr<PreAliasPattern>> pList =
-      patterns.getPreAliasList();
+  PreAliasPatternRewriter rewriter(*this, patterns.getPreAliasList());
 
+  // Constant folding can make patterns match, and patterns can create ops
+  // which can be folded. The rewriter only revisits the ops which a pattern
+  // changed, so each pass after the first is usually a single sweep which
+  // confirms that nothing more matches
+  bool keepRunning = true;
   while (keepRunning) {
     foldConstants(graph);
-
-    keepRunning = false;
-    for (auto &pattern : pList) {
-      keepRunning |= applyPreAliasPattern(pattern.get(), graph);
-    }
+    keepRunning = rewriter.apply(graph);
   }
+
+  rewriter.logStatistics();
 }
 
 void Ir::applyTransform(std::size_t transformId, Graph &graph) {
   // Unless explictly set, a transform is enabled
   if (transformEnableMap.count(transformId) == 0 ||
       transformEnableMap.at(transformId)) {
+    CompileProfiler::Scope profile(compileProfiler,
+                                   "transform",
+                                   Transform::getTransformName(transformId),
+                                   this);
+    profile.addArg("graph", graph.id.str());
     Transform::applyTransform(transformId, graph);
   }
 }
@@ -1704,6 +2039,8 @@ bool Ir::storingIsDisabledForTensor(const TensorId &tensorId) const {
 }
 
 void Ir::constructForwards() {
+  CompileProfiler::Scope profile(
+      compileProfiler, "ir", "constructForwards", this);
   constructFromOnnxGraph(onnxModel->graph(), {});
   for (auto &id_op : getMainGraph().getOps()) {
     auto op      = id_op.second.get();
@@ -1725,6 +2062,8 @@ Graph &Ir::constructFromOnnxGraph(const ONNX_NAMESPACE::GraphProto &graph,
 }
 
 void Ir::foldConstants(Graph &graph) {
+  CompileProfiler::Scope profile(compileProfiler, "ir", "foldConstants", this);
+  profile.addArg("graph", graph.id.str());
   logging::ces::trace("Folding constants");
   ConstExprUtil::foldConstants(graph);
 }
@@ -2135,6 +2474,7 @@ std::set<Vertex *> forwardPropogate(std::vector<Op *> frontier) {
 } // namespace
 
 void Ir::updateVertices() {
+  CompileProfiler::Scope profile(compileProfiler, "ir", "updateVertices");
 
   // for all vertices (Ops and Tensors), set
   //  1) toLoss (is there a path to the final loss?)
@@ -2250,11 +2590,9 @@ void Ir::updateVertices() {
 }
 
 void Ir::updateAliases() {
+  CompileProfiler::Scope profile(compileProfiler, "ir", "updateAliases");
   for (auto &graph : graphs) {
-    graph.second->getTensors().clearAliases();
-    for (auto &op : graph.second->getOps()) {
-      graph.second->getTensors().updateAliases(op.second.get());
-    }
+    graph.second->getTensors().updateAliases();
   }
 }
 
@@ -2321,6 +2659,8 @@ void Ir::setNEdgesToLoss() {
 }
 
 void Ir::constructBackwards() {
+  CompileProfiler::Scope profile(
+      compileProfiler, "ir", "constructBackwards", this);
 
   logging::ir::info("Constructing backwards pass");
 
@@ -2791,10 +3131,7 @@ std::vector<GradNonGradPair> Ir::growLossGradients() {
       break;
     }
     case DataType::FLOAT16: {
-      std::vector<float> floatData(1, lossScale);
-      std::vector<char> gradStarterData(2);
-      poplar::copyFloatToDeviceHalf(
-          poplar::Target(), floatData.data(), gradStarterData.data(), 1);
+      std::vector<float16_t> gradStarterData(1, lossScale);
       getTensors().addConstInit(
           gradStarterId,
           gradStarterInfo,
@@ -2931,6 +3268,10 @@ bool Ir::hasRandomOps() const {
 }
 
 bool Ir::requiresRandomSeed() const {
+  if (preparedFromSerialized) {
+    // There are no Ops, but there is a seed Tensor if they required it
+    return containsTensor(GetRandomSeedOp::getStreamedSeedTensorId());
+  }
   return (getSessionOptions().enableStochasticRounding || hasRandomOps());
 }
 
@@ -3074,7 +3415,99 @@ void Ir::applyUpdateInplacePrioritiesForIpu() {
   }
 }
 
+namespace {
+
+// Tracks a topological order of the Ops of a Graph, with its topological
+// constraints and the constraints which Graph::isSchedulable adds for
+// pipelining, as the Inplace pattern inserts new constraints. Checking the
+// constraints of one inplacing candidate then only visits the Ops between
+// the constrained Ops, rather than the whole Graph.
+class InplaceCycleChecker {
+public:
+  InplaceCycleChecker(const Graph &graph) {
+    for (auto &id_op : graph.getOps()) {
+      nodes[id_op.first] = topoSort.insertNode();
+    }
+
+    std::vector<DynamicTopoSort::Edge> edges;
+    std::map<PipelineStage, std::vector<DynamicTopoSort::Node>> stages;
+    for (auto &id_op : graph.getOps()) {
+      Op *op     = id_op.second.get();
+      auto after = nodes.at(op->id);
+      for (auto t : op->input->tensors()) {
+        if (t->hasProducer()) {
+          edges.push_back({nodes.at(t->getProducer()->id), after});
+        }
+      }
+      for (auto before : graph.topoCons->getBefores(op)) {
+        edges.push_back({nodes.at(before->id), after});
+      }
+      if (graph.getIr().getSessionOptions().enablePipelining &&
+          op->hasPipelineStage()) {
+        stages[op->getPipelineStage()].push_back(after);
+      }
+    }
+
+    // All Ops of a pipeline stage are before all Ops of later stages. A node
+    // between consecutive stages expresses this with a linear number of edges.
+    for (auto it = stages.begin(); it != stages.end(); ++it) {
+      auto next = std::next(it);
+      if (next == stages.end()) {
+        break;
+      }
+      auto boundary = topoSort.insertNode();
+      for (auto n : it->second) {
+        edges.push_back({n, boundary});
+      }
+      for (auto n : next->second) {
+        edges.push_back({boundary, n});
+      }
+    }
+
+    for (const auto &edge : edges) {
+      if (!topoSort.tryInsertEdge(edge.first, edge.second)) {
+        valid = false;
+        break;
+      }
+    }
+  }
+
+  // False if the Graph was not schedulable to begin with, in which case the
+  // checker can not be used.
+  bool isValid() const { return valid; }
+
+  // Insert the constraints if they do not create a cycle. Returns true if
+  // they were inserted.
+  bool tryInsert(const OpsBeforeKey &newTopoCons) {
+    std::vector<DynamicTopoSort::Edge> edges;
+    for (const auto &after_befores : newTopoCons) {
+      auto after = nodes.at(after_befores.first->id);
+      for (auto before : after_befores.second) {
+        edges.push_back({nodes.at(before->id), after});
+      }
+    }
+    return topoSort.tryInsertEdges(edges);
+  }
+
+  // `replacement' takes the place of the Op `replaced' in the Graph, with the
+  // same inputs, outputs and constraints.
+  void replace(OpId replaced, OpId replacement) {
+    auto found = nodes.find(replaced);
+    nodes[replacement] = found->second;
+    nodes.erase(found);
+  }
+
+private:
+  DynamicTopoSort topoSort;
+  std::map<OpId, DynamicTopoSort::Node> nodes;
+  bool valid{true};
+};
+
+} // namespace
+
 void Ir::applyInplacePattern(Graph &graph) {
+  CompileProfiler::Scope profile(compileProfiler, "patterns", "Inplace", this);
+  profile.addArg("graph", graph.id.str());
 
   logging::ir::debug("Applying Inplace Pattern to Graph \"{}\"", graph.id);
 
@@ -3145,6 +3578,13 @@ void Ir::applyInplacePattern(Graph &graph) {
     // we keep track of which ops have already been inplaced
     std::set<OpId> inplacedAlready;
 
+    InplaceCycleChecker cycleChecker(graph);
+    if (!cycleChecker.isValid()) {
+      logging::pattern::debug("[Inplacing] Graph \"{}\" is not schedulable, "
+                              "checking each candidate with isSchedulable",
+                              graph.id);
+    }
+
     for (auto &ip : priorities) {
       OpId id                       = std::get<0>(ip);
       OperatorIdentifier identifier = std::get<1>(ip);
@@ -3252,8 +3692,11 @@ void Ir::applyInplacePattern(Graph &graph) {
       }
 
       // finally, we check if there are cycles with the new topological
-      // constraints
-      if (!graph.isSchedulable(newTopoCons)) {
+      // constraints. If there are none, they are inserted into cycleChecker.
+      bool schedulable = cycleChecker.isValid()
+                             ? cycleChecker.tryInsert(newTopoCons)
+                             : graph.isSchedulable(newTopoCons);
+      if (!schedulable) {
         std::ostringstream oss;
         oss << "[Inplacing] The new topological constraints prevent Op "
             << op->id << " from being inplaced, as they would created a cycle ";
@@ -3266,7 +3709,10 @@ void Ir::applyInplacePattern(Graph &graph) {
         oss << "[Inplacing] Inplacing Op " << op->str();
         logging::pattern::debug(oss.str());
         inplacedAlready.insert(op->id);
+        OpId replacedId = op->id;
+        Tensor *output  = op->output->tensor(0);
         inplace.apply(op, identifier, newTopoCons);
+        cycleChecker.replace(replacedId, output->getProducer()->id);
       }
     }
   }
@@ -3295,21 +3741,35 @@ std::vector<TensorId> Ir::getTensorIds(TensorType tensor_type) const {
 }
 
 Tensor *Ir::getTensor(const TensorId &tensor_id) const {
+  auto handle = tensorIdInterner.find(tensor_id);
+  if (handle == unusedTensorHandle) {
+    throw error("no Ir::Tensor with TensorId " + tensor_id +
+                ", in Ir::getTensor(..) ");
+  }
+  return getTensor(handle);
+}
+
+Tensor *Ir::getTensor(TensorHandle handle) const {
   for (auto &id_graph : graphs) {
     auto graph = id_graph.second.get();
-    if (graph->getTensors().contains(tensor_id)) {
-      return graph->getTensors().get(tensor_id);
+    if (graph->getTensors().contains(handle)) {
+      return graph->getTensors().get(handle);
     }
   }
 
-  throw error("no Ir::Tensor with TensorId " + tensor_id +
-              ", in Ir::getTensor(..) ");
+  throw error("no Ir::Tensor with TensorId " +
+              tensorIdInterner.getId(handle) + ", in Ir::getTensor(..) ");
 }
 
 bool Ir::containsTensor(const TensorId &tensor_id) const {
+  auto handle = tensorIdInterner.find(tensor_id);
+  return handle != unusedTensorHandle && containsTensor(handle);
+}
+
+bool Ir::containsTensor(TensorHandle handle) const {
   for (auto &id_graph : graphs) {
     auto graph = id_graph.second.get();
-    if (graph->getTensors().contains(tensor_id)) {
+    if (graph->getTensors().contains(handle)) {
       return true;
     }
   }
@@ -3437,3 +3897,36 @@ GraphId Ir::createUniqueSubgraphId(GraphId base_id) {
 }
 
 } // namespace popart
+
+namespace std {
+std::size_t hash<popart::IrBundle>::operator()(
+    const popart::IrBundle &bundle) const {
+  // A different version of PopART may prepare a different Ir
+  auto hsh = std::hash<std::string>{}(popart::core::versionString());
+
+  auto combine = [&hsh](std::size_t h) { boost::hash_combine(hsh, h); };
+
+  combine(std::hash<std::string>{}(bundle.modelProto.SerializeAsString()));
+
+  for (auto &id : bundle.inputShapeInfo.getAllTensorIds()) {
+    std::stringstream ss;
+    ss << id << bundle.inputShapeInfo.get(id);
+    combine(std::hash<std::string>{}(ss.str()));
+  }
+
+  combine(std::hash<popart::DataFlow>{}(bundle.dataFlow));
+  combine(std::hash<popart::TensorId>{}(bundle.loss));
+
+  // The optimizer values which are constants of the Ir, for example the
+  // learning rate of a ConstSGD
+  if (bundle.optimizer) {
+    combine(bundle.optimizer->hash());
+  }
+
+  combine(std::hash<popart::DeviceInfo>{}(bundle.deviceInfo));
+  combine(std::hash<popart::SessionOptions>{}(bundle.userOptions));
+  combine(bundle.patterns.hash());
+
+  return hsh;
+}
+} // namespace std
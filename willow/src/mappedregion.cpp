@@ -0,0 +1,106 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <popart/error.hpp>
+#include <popart/logging.hpp>
+#include <popart/mappedregion.hpp>
+#include <popart/util.hpp>
+
+namespace popart {
+
+namespace {
+
+// Closes a file descriptor when it goes out of scope
+class FileDescriptor {
+public:
+  explicit FileDescriptor(int fd_) : fd(fd_) {}
+  ~FileDescriptor() {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+  FileDescriptor(const FileDescriptor &) = delete;
+  FileDescriptor &operator=(const FileDescriptor &) = delete;
+  int get() const { return fd; }
+
+private:
+  int fd;
+};
+
+} // namespace
+
+MappedRegion::MappedRegion(const std::string &path,
+                           int64_t offset,
+                           int64_t length) {
+  if (offset < 0 || length <= 0) {
+    throw error("Invalid region of {} bytes at offset {} to map from file '{}'",
+                length,
+                offset,
+                path);
+  }
+
+  FileDescriptor fd(::open(path.c_str(), O_RDONLY));
+  if (fd.get() < 0) {
+    throw error("Failed to open file '{}': {}", path, std::strerror(errno));
+  }
+
+  struct stat st;
+  if (::fstat(fd.get(), &st) != 0) {
+    throw error("Failed to stat file '{}': {}", path, std::strerror(errno));
+  }
+  if (offset + length > st.st_size) {
+    throw error("Cannot map bytes [{}, {}) of file '{}', which has {} bytes",
+                offset,
+                offset + length,
+                path,
+                st.st_size);
+  }
+
+  // mmap requires the offset to be a multiple of the page size
+  const int64_t pageSize   = ::sysconf(_SC_PAGESIZE);
+  const int64_t baseOffset = offset - offset % pageSize;
+  const std::size_t mapSize =
+      static_cast<std::size_t>(offset - baseOffset + length);
+  void *addr = ::mmap(nullptr,
+                      mapSize,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE,
+                      fd.get(),
+                      static_cast<off_t>(baseOffset));
+  if (addr == MAP_FAILED) {
+    throw error("Failed to map {} bytes of file '{}': {}",
+                length,
+                path,
+                std::strerror(errno));
+  }
+
+  base     = addr;
+  baseSize = mapSize;
+  data_    = static_cast<char *>(base) + (offset - baseOffset);
+  size_    = static_cast<std::size_t>(length);
+
+  logging::trace(
+      "Mapped bytes [{}, {}) of file {}", offset, offset + length, path);
+}
+
+MappedRegion::~MappedRegion() {
+  if (base) {
+    ::munmap(base, baseSize);
+  }
+}
+
+bool MappedRegion::enabled() {
+  static const bool isEnabled = []() {
+    auto env = getPopartEnvVar("MMAP_EXTERNAL_DATA");
+    return !env || std::string(env) != "0";
+  }();
+  return isEnabled;
+}
+
+} // namespace popart
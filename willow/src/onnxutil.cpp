@@ -154,9 +154,9 @@ ExternalTensorProtoInfo::ExternalTensorProtoInfo(
       if (info.key() == "location") {
         location = info.value();
       } else if (info.key() == "offset") {
-        offset = std::stoi(info.value());
+        offset = std::stoll(info.value());
       } else if (info.key() == "length") {
-        length = std::stoi(info.value());
+        length = std::stoll(info.value());
       }
     }
 
@@ -170,7 +170,7 @@ ExternalTensorProtoInfo::ExternalTensorProtoInfo(
           location,
           name);
     }
-    if (length <= 0) {
+    if (length < 0) {
       throw error(
           "Invalid 'length' information ({}) for externally stored tensor '{}'",
           length,
@@ -210,6 +210,14 @@ ConstVoidData getConstData(const ONNX_NAMESPACE::TensorProto &tp) {
     if (externalInfo.offset > 0) {
       ifs.seekg(externalInfo.offset, std::ios::beg);
     }
+    // A missing length is 0, which is only valid for a tensor of no elements
+    if (static_cast<uint64_t>(externalInfo.length) != cv_data.info.nbytes()) {
+      throw error("Externally stored tensor '{}' has length {}, but {} bytes "
+                  "were expected",
+                  tp.name(),
+                  externalInfo.length,
+                  cv_data.info.nbytes());
+    }
     std::vector<char> externalTensorBuffer(externalInfo.length);
     ifs.read(externalTensorBuffer.data(), externalInfo.length);
     cv_data.store(std::move(externalTensorBuffer), TensorInfo(tp));
@@ -339,9 +347,13 @@ void saveInitializersExternally(ONNX_NAMESPACE::ModelProto &model,
                   "contents will be overwritten",
                   fn);
   }
-  std::ofstream ofs(fn, std::ofstream::binary);
+  // Write to a new file which then replaces fn, as fn may be mapped by the
+  // TensorData of an existing Ir (see MappedRegion), which must not see it
+  // truncated
+  auto tmpFn = fn + ".tmp";
+  std::ofstream ofs(tmpFn, std::ofstream::binary);
   if (!ofs.is_open()) {
-    throw error("Failed to open file {}", fn);
+    throw error("Failed to open file {}", tmpFn);
   }
 
   int64_t totalBytes = 0;
@@ -391,6 +403,7 @@ void saveInitializersExternally(ONNX_NAMESPACE::ModelProto &model,
   }
 
   ofs.close();
+  boost::filesystem::rename(tmpFn, fn);
 }
 
 ONNX_NAMESPACE::TensorProto &getTensorProto(ONNX_NAMESPACE::ModelProto &model,
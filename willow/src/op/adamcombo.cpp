@@ -0,0 +1,102 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <memory>
+#include <popart/ir.hpp>
+#include <popart/op/adamcombo.hpp>
+#include <popart/opserialiser.hpp>
+
+namespace popart {
+
+AdamComboOp::AdamComboOp(const TensorId &varId_,
+                         AdamMode mode_,
+                         OptimizerValue initialLr,
+                         OptimizerValue initialWd,
+                         OptimizerValue initialB1,
+                         OptimizerValue initialB2,
+                         OptimizerValue initialEps,
+                         OptimizerValue initialGs,
+                         OptimizerReductionType reductionType_,
+                         const Op::Settings &settings_)
+    : VarUpdateWithUpdaterOp(Onnx::CustomOperators::AdamCombo,
+                             varId_,
+                             settings_),
+      mode(mode_), initLr(initialLr), initWd(initialWd), initB1(initialB1),
+      initB2(initialB2), initEps(initialEps), initGs(initialGs),
+      reductionType(reductionType_) {}
+
+void AdamComboOp::appendOutlineAttributes(OpSerialiserBase &os) const {
+  os.appendAttribute("mode", static_cast<int>(mode));
+
+  if (initLr.isConst()) {
+    os.appendAttribute("const learning rate", initLr.val());
+  }
+
+  if (initWd.isConst()) {
+    os.appendAttribute("const weight decay", initWd.val());
+  }
+
+  if (initB1.isConst()) {
+    os.appendAttribute("const beta1", initB1.val());
+  }
+
+  if (initB2.isConst()) {
+    os.appendAttribute("const beta2", initB2.val());
+  }
+
+  if (initEps.isConst()) {
+    os.appendAttribute("const eps", initEps.val());
+  }
+
+  if (initGs.isConst()) {
+    os.appendAttribute("const gradient scale", initGs.val());
+  }
+
+  os.appendAttribute("reduction type", static_cast<int>(reductionType));
+}
+
+std::unique_ptr<Op> AdamComboOp::cloneWithNewName(const TensorId &x) const {
+  return std::make_unique<AdamComboOp>(x,
+                                       mode,
+                                       initLr,
+                                       initWd,
+                                       initB1,
+                                       initB2,
+                                       initEps,
+                                       initGs,
+                                       reductionType,
+                                       settings);
+}
+
+std::unique_ptr<Op> AdamComboOp::clone() const {
+  return std::make_unique<AdamComboOp>(*this);
+}
+
+std::map<InIndex, TensorId> AdamComboOp::optimizerInputs() const {
+
+  std::map<InIndex, TensorId> m;
+
+  auto insertIfNonConst = [this, &m](const OptimizerValue &v, InIndex index) {
+    if (!v.isConst()) {
+      m.insert({index, inId(index)});
+    }
+  };
+
+  insertIfNonConst(initLr, getLrInIndex());
+  insertIfNonConst(initWd, getWdInIndex());
+  insertIfNonConst(initB1, getBeta1InIndex());
+  insertIfNonConst(initB2, getBeta2InIndex());
+  insertIfNonConst(initEps, getEpsInIndex());
+  insertIfNonConst(initGs, getGsInIndex());
+
+  return m;
+}
+
+std::set<InIndex> AdamComboOp::optionalInputs() const {
+  return {getLrInIndex(),
+          getWdInIndex(),
+          getBeta1InIndex(),
+          getBeta2InIndex(),
+          getEpsInIndex(),
+          getGsInIndex()};
+}
+
+} // namespace popart
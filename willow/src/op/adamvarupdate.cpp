@@ -0,0 +1,114 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <memory>
+#include <popart/ir.hpp>
+#include <popart/op/adamvarupdate.hpp>
+#include <popart/opserialiser.hpp>
+#include <popart/region.hpp>
+
+namespace popart {
+
+AdamVarUpdateOp::AdamVarUpdateOp(const TensorId &varToUpdate,
+                                 AdamMode mode_,
+                                 OptimizerValue lr,
+                                 OptimizerValue wd,
+                                 OptimizerValue b1,
+                                 OptimizerValue b2,
+                                 OptimizerValue eps,
+                                 OptimizerValue gs,
+                                 bool resetUpdater_,
+                                 const Op::Settings &opSettings)
+    : VarUpdateWithUpdaterOp(Onnx::CustomOperators::AdamVarUpdate,
+                             varToUpdate,
+                             opSettings),
+      mode(mode_), initLr(lr), initWd(wd), initB1(b1), initB2(b2),
+      initEps(eps), initGs(gs), resetUpdater(resetUpdater_) {}
+
+std::unique_ptr<Op> AdamVarUpdateOp::cloneWithNewName(const TensorId &x) const {
+  return std::make_unique<AdamVarUpdateOp>(x,
+                                           mode,
+                                           initLr,
+                                           initWd,
+                                           initB1,
+                                           initB2,
+                                           initEps,
+                                           initGs,
+                                           resetUpdater,
+                                           settings);
+}
+
+std::unique_ptr<Op> AdamVarUpdateOp::clone() const {
+  return std::make_unique<AdamVarUpdateOp>(*this);
+}
+
+std::map<InIndex, TensorId> AdamVarUpdateOp::optimizerInputs() const {
+
+  std::map<InIndex, TensorId> m;
+
+  auto insertIfNonConst = [this, &m](const OptimizerValue &v, InIndex index) {
+    if (!v.isConst()) {
+      m.insert({index, inId(index)});
+    }
+  };
+
+  insertIfNonConst(initLr, getLrInIndex());
+  insertIfNonConst(initWd, getWdInIndex());
+  insertIfNonConst(initB1, getBeta1InIndex());
+  insertIfNonConst(initB2, getBeta2InIndex());
+  insertIfNonConst(initEps, getEpsInIndex());
+  insertIfNonConst(initGs, getGsInIndex());
+
+  return m;
+}
+
+std::set<InIndex> AdamVarUpdateOp::optionalInputs() const {
+  return {getLrInIndex(),
+          getWdInIndex(),
+          getBeta1InIndex(),
+          getBeta2InIndex(),
+          getEpsInIndex(),
+          getGsInIndex()};
+}
+
+view::Regions AdamVarUpdateOp::modifies(InIndex index) const {
+  if (index == getVarToUpdateInIndex() || index == getAccl1InIndex() ||
+      index == getAccl2InIndex() || index == getStepInIndex() ||
+      (resetUpdater && index == getUpdaterInIndex())) {
+    return {view::Region::getFull(inShape(index))};
+  } else {
+    return {view::Region::getEmpty(inRank(index))};
+  }
+}
+
+void AdamVarUpdateOp::appendOutlineAttributes(OpSerialiserBase &os) const {
+
+  Op::appendOutlineAttributes(os);
+
+  os.appendAttribute("mode", static_cast<int>(mode));
+  os.appendAttribute("reset updater", resetUpdater);
+
+  if (initLr.isConst()) {
+    os.appendAttribute("const learning rate", initLr.val());
+  }
+
+  if (initWd.isConst()) {
+    os.appendAttribute("const weight decay", initWd.val());
+  }
+
+  if (initB1.isConst()) {
+    os.appendAttribute("const beta1", initB1.val());
+  }
+
+  if (initB2.isConst()) {
+    os.appendAttribute("const beta2", initB2.val());
+  }
+
+  if (initEps.isConst()) {
+    os.appendAttribute("const eps", initEps.val());
+  }
+
+  if (initGs.isConst()) {
+    os.appendAttribute("const gradient scale", initGs.val());
+  }
+}
+
+} // namespace popart
@@ -14,8 +14,8 @@ view::RegMap binaryFwdRegMapImpl(const ElementWiseBinaryBaseOp &op,
   return [out_shape, in_shape](const view::Region &r) {
     auto out_size  = out_shape.size();
     auto arg_shape = padShape(in_shape, out_size, int64_t{1});
-    auto lower     = padShape(r.getLower(), out_size, int64_t{0});
-    auto upper     = padShape(r.getUpper(), out_size, int64_t{1});
+    auto lower     = padShape<int64_t>(r.getLower(), out_size, int64_t{0});
+    auto upper     = padShape<int64_t>(r.getUpper(), out_size, int64_t{1});
 
     // broadcasting
     for (int i = 0; i < out_shape.size(); i++) {
@@ -35,8 +35,8 @@ view::RegMap binaryBwdRegMapImpl(const ElementWiseBinaryBaseOp &op,
   auto out_shape = unpadShape(op.outShape(op.getOutIndex()), arg_size);
 
   return [arg_size, out_shape, arg_shape](const view::Region &r) {
-    auto lower = unpadShape(r.getLower(), arg_size);
-    auto upper = unpadShape(r.getUpper(), arg_size);
+    auto lower = unpadShape<int64_t>(r.getLower(), arg_size);
+    auto upper = unpadShape<int64_t>(r.getUpper(), arg_size);
 
     // unbroadcasting
     for (int i = 0; i < out_shape.size(); i++) {
@@ -35,8 +35,8 @@ view::RegMap ExpandOp::fwdRegMap(InIndex inIndex, OutIndex) const {
   return [out_shape, in_shape](const view::Region &r) {
     auto out_size  = static_cast<int>(out_shape.size());
     auto arg_shape = padShape(in_shape, out_size, int64_t{1});
-    auto lower     = padShape(r.getLower(), out_size, int64_t{0});
-    auto upper     = padShape(r.getUpper(), out_size, int64_t{1});
+    auto lower     = padShape<int64_t>(r.getLower(), out_size, int64_t{0});
+    auto upper     = padShape<int64_t>(r.getUpper(), out_size, int64_t{1});
 
     if (r.isEmpty()) {
       return view::Regions(1, view::Region::getEmpty(out_shape.size()));
@@ -62,7 +62,7 @@ view::RegMap ExpandOp::bwdRegMap(InIndex inIndex, OutIndex) const {
   return
       [out_shape, in_shape, in_size, upper](const view::Region &r_out) mutable {
         auto size_diff = r_out.getLower().size() - in_size;
-        auto lower     = unpadShape(r_out.getLower(), in_size);
+        auto lower     = unpadShape<int64_t>(r_out.getLower(), in_size);
         if (r_out.isEmpty()) {
           return view::Regions(1, view::Region::getEmpty(out_shape.size()));
         }
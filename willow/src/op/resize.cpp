@@ -1,6 +1,7 @@
 #include <cmath>
 
 #include <popart/error.hpp>
+#include <popart/half.hpp>
 #include <popart/op/resize.hpp>
 #include <popart/opmanager.hpp>
 #include <popart/tensor.hpp>
@@ -152,10 +153,8 @@ static OpCreator<ResizeOp> resize10_OpCreator(
       if (scalesTensor->info.dataType() == DataType::FLOAT) {
         scales = scalesTensor->tensorData()->copyDataAs<float>(nelms);
       } else if (scalesTensor->info.dataType() == DataType::FLOAT16) {
-        auto temp = scalesTensor->tensorData()->copyDataAs<float16_t>(nelms);
-        for (auto i : temp) {
-          scales.push_back(i);
-        }
+        scales = halfToFloat(
+            scalesTensor->tensorData()->copyDataAs<float16_t>(nelms));
       } else {
         throw error("Can not import scales from tensor of type {}",
                     scalesTensor->info.dataType());
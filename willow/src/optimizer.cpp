@@ -1,7 +1,9 @@
 // Copyright (c) 2018 Graphcore Ltd. All rights reserved.
+#include <boost/functional/hash.hpp>
 #include <popart/error.hpp>
 #include <popart/graph.hpp>
 #include <popart/ir.hpp>
+#include <popart/op/adamcombo.hpp>
 #include <popart/op/sgd0varupdate.hpp>
 #include <popart/op/sgd1combo.hpp>
 #include <popart/optimizer.hpp>
@@ -136,6 +138,13 @@ Optimizer::Optimizer(OptimizerValue ls_) : ls(ls_) {
   }
 }
 
+std::size_t Optimizer::hash() const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, static_cast<int>(type()));
+  boost::hash_combine(seed, ls.hash());
+  return seed;
+}
+
 bool SGD::hasSpecific(const Tensor &w) const {
 
   // confirm that all the atomic scalars have a specigic value for "w"
@@ -502,8 +511,415 @@ bool SGD::validReplacement(const Optimizer &other) const {
   return true;
 }
 
+std::size_t SGD::hash() const {
+  auto seed = Optimizer::hash();
+  for (auto map : {&lrs, &wds, &mms, &dps, &vss}) {
+    boost::hash_combine(seed, map->hash());
+  }
+  return seed;
+}
+
 std::unique_ptr<Optimizer> SGD::clone() const {
   return std::make_unique<SGD>(*this);
 }
 
+namespace {
+const std::vector<std::string> &getAdamSpecificNames() {
+  const static std::vector<std::string> names{
+      "learningRate", "weightDecay", "beta1", "beta2", "eps"};
+  return names;
+}
+} // namespace
+
+Adam Adam::fromDefaultMap(const std::map<std::string, OptimizerValue> &m,
+                          AdamMode mode_) {
+  return Adam(getComplete(m), mode_, 1011);
+}
+
+Adam::Adam(const std::map<std::string, std::pair<float, bool>> &m,
+           AdamMode mode_)
+    : Adam(getComplete(getOptMap(m)), mode_, 31415) {}
+
+Adam::Adam(const std::map<std::string, OptimizerValue> &cmap,
+           AdamMode mode_,
+           int)
+    : Adam(cmap.at("defaultLearningRate"),
+           cmap.at("defaultWeightDecay"),
+           cmap.at("defaultBeta1"),
+           cmap.at("defaultBeta2"),
+           cmap.at("defaultEps"),
+           cmap.at("lossScaling"),
+           mode_) {}
+
+Adam::Adam(OptimizerValue lr,
+           OptimizerValue wd,
+           OptimizerValue b1,
+           OptimizerValue b2,
+           OptimizerValue eps,
+           OptimizerValue lossScaling,
+           AdamMode mode_)
+    : Optimizer(lossScaling), mode(mode_), lrs(lr), wds(wd), b1s(b1), b2s(b2),
+      epsvs(eps) {
+  if (mode == AdamMode::N) {
+    throw error("Invalid AdamMode in Adam");
+  }
+  runValueChecks(lr, wd, b1, b2, eps);
+}
+
+std::string Adam::type_s() const {
+  switch (mode) {
+  case AdamMode::Adam:
+    return "Adam";
+  case AdamMode::AdamW:
+    return "AdamW";
+  case AdamMode::Lamb:
+    return "Lamb";
+  case AdamMode::N:
+  default:
+    throw error("Unrecognised AdamMode");
+  }
+}
+
+std::map<std::string, OptimizerValue>
+Adam::getComplete(const std::map<std::string, OptimizerValue> &m) {
+
+  std::vector<std::string> sixParamArgs{"defaultLearningRate",
+                                        "defaultWeightDecay",
+                                        "defaultBeta1",
+                                        "defaultBeta2",
+                                        "defaultEps",
+                                        "lossScaling"};
+
+  std::map<std::string, OptimizerValue> complete{};
+
+  complete.insert({"defaultLearningRate", getUnsetLearningRate()});
+  complete.insert({"defaultWeightDecay", getUnsetWeightDecay()});
+  complete.insert({"defaultBeta1", getUnsetBeta1()});
+  complete.insert({"defaultBeta2", getUnsetBeta2()});
+  complete.insert({"defaultEps", getUnsetEps()});
+  complete.insert({"lossScaling", getUnsetLossScaling()});
+
+  for (auto key_val : m) {
+    auto key = key_val.first;
+    auto val = key_val.second;
+    if (std::find(sixParamArgs.cbegin(), sixParamArgs.cend(), key) ==
+        sixParamArgs.cend()) {
+      std::ostringstream oss;
+      oss << "Invalid Adam key, " << key << ", the allowed keys are ( ";
+      for (auto x : sixParamArgs) {
+        oss << x << ' ';
+      }
+      oss << ')';
+      throw error(oss.str());
+    }
+    complete[key] = val;
+  }
+
+  return complete;
+}
+
+void Adam::insertSpecific(
+    const TensorId &id,
+    const std::map<std::string, std::pair<float, bool>> &m0) {
+
+  const auto &names = getAdamSpecificNames();
+
+  // As for SGD, the values not in m0 are the defaults already set
+  std::map<std::string, OptimizerValue> complete;
+  complete.insert({"learningRate", lrs.getDefault()});
+  complete.insert({"weightDecay", wds.getDefault()});
+  complete.insert({"beta1", b1s.getDefault()});
+  complete.insert({"beta2", b2s.getDefault()});
+  complete.insert({"eps", epsvs.getDefault()});
+  for (auto key_val : m0) {
+    if (std::find(names.cbegin(), names.cend(), key_val.first) ==
+        names.cend()) {
+      std::ostringstream oss;
+      oss << "Invalid key " << key_val.first
+          << " in Adam::insertSpecific. Permitted keys are ( ";
+      for (auto x : names) {
+        oss << x << ' ';
+      }
+      oss << ')';
+      throw error(oss.str());
+    }
+    complete[key_val.first] = key_val.second;
+  }
+
+  insertSpecific(id,
+                 complete.at("learningRate"),
+                 complete.at("weightDecay"),
+                 complete.at("beta1"),
+                 complete.at("beta2"),
+                 complete.at("eps"));
+}
+
+void Adam::insertSpecific(const TensorId &id,
+                          OptimizerValue lr,
+                          OptimizerValue wd,
+                          OptimizerValue b1,
+                          OptimizerValue b2,
+                          OptimizerValue eps) {
+
+  lrs.insertSpecific(id, lr);
+  wds.insertSpecific(id, wd);
+  b1s.insertSpecific(id, b1);
+  b2s.insertSpecific(id, b2);
+  epsvs.insertSpecific(id, eps);
+
+  runValueChecks(lr, wd, b1, b2, eps);
+}
+
+bool Adam::hasSpecific(const Tensor &w) const {
+
+  const auto &id = w.id;
+  int counter    = 0;
+  counter += lrs.hasSpecific(id);
+  counter += wds.hasSpecific(id);
+  counter += b1s.hasSpecific(id);
+  counter += b2s.hasSpecific(id);
+  counter += epsvs.hasSpecific(id);
+
+  if (counter != 0 && counter != getAdamSpecificNames().size()) {
+    throw error("Inconsistency in Adam::hasSpecific : there should either be a "
+                "specific value for ALL (5) or NO (0) atomic scalar values, "
+                "not {} of them. ",
+                counter);
+  }
+
+  return counter > 0;
+}
+
+void Adam::runValueChecks(OptimizerValue lr,
+                          OptimizerValue wd,
+                          OptimizerValue b1,
+                          OptimizerValue b2,
+                          OptimizerValue eps) const {
+  if (lr.val() < 0) {
+    throw error("Negative learning rate ({}) in {}, bailing as this might be "
+                "a user error.",
+                lr.val(),
+                type_s());
+  } else if (lr.val() == 0.0f && lr.isConst()) {
+    throw error("Constant, zero learning rate in {}, bailing as this might be "
+                "a user error.",
+                type_s());
+  }
+
+  if (wd.val() < 0) {
+    throw error("Negative weight decay ({}) in {}, bailing as this might be a "
+                "user error",
+                wd.val(),
+                type_s());
+  }
+
+  if (b1.val() < 0 || b1.val() >= 1) {
+    throw error("Beta1 ({}) in {} is not in [0, 1)", b1.val(), type_s());
+  }
+
+  if (b2.val() < 0 || b2.val() >= 1) {
+    throw error("Beta2 ({}) in {} is not in [0, 1)", b2.val(), type_s());
+  }
+
+  if (eps.val() < 0) {
+    throw error(
+        "Negative eps ({}) in {} is not supported", eps.val(), type_s());
+  }
+}
+
+std::unique_ptr<Op> Adam::createOp(const Tensor &w, Graph &graph) const {
+
+  if (graph.getIr().getSessionOptions().hostAllReduce) {
+    throw error("{} is not supported with hostAllReduce", type_s());
+  }
+
+  OptimizerReductionType reductionType{OptimizerReductionType::None};
+  if (getReplicatedGraphCount() > 1) {
+    if (gradientAccumulationEnabled()) {
+      reductionType = OptimizerReductionType::AccumReduce;
+    } else {
+      reductionType = OptimizerReductionType::GradReduce;
+    }
+  }
+
+  return std::make_unique<AdamComboOp>(w.id,
+                                       mode,
+                                       lrhelper.getFromWeightId(w.id, *this),
+                                       wdhelper.getFromWeightId(w.id, *this),
+                                       b1helper.getFromWeightId(w.id, *this),
+                                       b2helper.getFromWeightId(w.id, *this),
+                                       epshelper.getFromWeightId(w.id, *this),
+                                       gshelper.getFromWeightId(w.id, *this),
+                                       reductionType,
+                                       Op::Settings(graph, ""));
+}
+
+std::vector<TensorId> Adam::getInputIds(const Tensor &w) const {
+
+  const TensorId &varId = w.id;
+  std::vector<TensorId> inputs(8, "");
+
+  // variable
+  inputs[VarUpdateOp::getVarToUpdateInIndex()] = varId;
+
+  // gradient
+  inputs[VarUpdateWithUpdaterOp::getUpdaterInIndex()] = getGradId(varId);
+
+  // the scalars (optional)
+  inputs[AdamComboOp::getLrInIndex()] =
+      lrhelper.getScalarIdIfNonConst(w, *this);
+  inputs[AdamComboOp::getWdInIndex()] =
+      wdhelper.getScalarIdIfNonConst(w, *this);
+  inputs[AdamComboOp::getBeta1InIndex()] =
+      b1helper.getScalarIdIfNonConst(w, *this);
+  inputs[AdamComboOp::getBeta2InIndex()] =
+      b2helper.getScalarIdIfNonConst(w, *this);
+  inputs[AdamComboOp::getEpsInIndex()] =
+      epshelper.getScalarIdIfNonConst(w, *this);
+  inputs[AdamComboOp::getGsInIndex()] =
+      gshelper.getScalarIdIfNonConst(w, *this);
+
+  return inputs;
+}
+
+std::vector<std::tuple<TensorId, TensorInfo>>
+Adam::getOptimizerInputs(const Tensor &weight) const {
+
+  std::vector<TensorId> ids{lrhelper.getScalarIdIfNonConst(weight, *this),
+                            wdhelper.getScalarIdIfNonConst(weight, *this),
+                            b1helper.getScalarIdIfNonConst(weight, *this),
+                            b2helper.getScalarIdIfNonConst(weight, *this),
+                            epshelper.getScalarIdIfNonConst(weight, *this),
+                            gshelper.getScalarIdIfNonConst(weight, *this)};
+
+  // The update is computed in FLOAT, for all types of weight
+  std::vector<std::tuple<TensorId, TensorInfo>> optInputs;
+  for (const auto &id : ids) {
+    // empty denotes const, not an input
+    if (!id.empty()) {
+      optInputs.push_back(std::make_tuple(id, TensorInfo(DataType::FLOAT, {})));
+    }
+  }
+
+  return optInputs;
+}
+
+void Adam::setTensorData(Tensor &optTensor) const {
+  const auto &info   = optTensor.info;
+  float storedValue  = getStoredValue(optTensor.id);
+  auto convertedData = convertFloatToDataType(info.dataType(), storedValue);
+
+  logging::ir::trace(
+      "Setting TensorData for {} to {}", optTensor.str(), storedValue);
+  optTensor.setTensorData(info, convertedData.data());
+}
+
+void Adam::resetTensorData(Tensor &optTensor) const {
+  const auto &info   = optTensor.info;
+  float storedValue  = getStoredValue(optTensor.id);
+  auto convertedData = convertFloatToDataType(info.dataType(), storedValue);
+  logging::ir::trace(
+      "Resetting TensorData for {} to {}", optTensor.str(), storedValue);
+  optTensor.tensorData()->resetData(info, convertedData.data());
+}
+
+float Adam::getStoredValue(const TensorId &optId) const {
+
+  if (optId.find(reservedLossScalingPrefix()) != std::string::npos) {
+    return lossScaling().val();
+  }
+
+  if (lrhelper.idMatch(optId)) {
+    return lrhelper.getFromScalarId(optId, *this).val();
+  }
+
+  if (wdhelper.idMatch(optId)) {
+    return wdhelper.getFromScalarId(optId, *this).val();
+  }
+
+  if (b1helper.idMatch(optId)) {
+    return b1helper.getFromScalarId(optId, *this).val();
+  }
+
+  if (b2helper.idMatch(optId)) {
+    return b2helper.getFromScalarId(optId, *this).val();
+  }
+
+  if (epshelper.idMatch(optId)) {
+    return epshelper.getFromScalarId(optId, *this).val();
+  }
+
+  if (gshelper.idMatch(optId)) {
+    return gshelper.getFromScalarId(optId, *this).val();
+  }
+
+  throw error("In getStoredValue for {}, it doesn't match any existing "
+              "optimizer prefix",
+              optId);
+}
+
+bool Adam::validReplacement(const Optimizer &other) const {
+  if (other.type() != type()) {
+    return false;
+  }
+
+  auto asAdam = dynamic_cast<const Adam *>(&other);
+  if (!asAdam) {
+    throw internal_error(
+        "other has same `type' as this Adam, but cannot be "
+        "dynamically cast to Adam. Has there been a redesign of the "
+        "optimizer classes? if so this needs a rethink");
+  }
+
+  logging::ir::debug("Checking Adam modes for compatibility");
+  if (mode != asAdam->mode) {
+    return false;
+  }
+
+  logging::ir::debug("Checking loss scaling for compatibility");
+  if (!lossScaling().validReplacement(other.lossScaling())) {
+    return false;
+  }
+
+  logging::ir::debug("Checking learning rates for compatibility");
+  if (!lrs.validReplacement(asAdam->lrs)) {
+    return false;
+  }
+
+  logging::ir::debug("Checking weight decays for compatibility");
+  if (!wds.validReplacement(asAdam->wds)) {
+    return false;
+  }
+
+  logging::ir::debug("Checking beta1s for compatibility");
+  if (!b1s.validReplacement(asAdam->b1s)) {
+    return false;
+  }
+
+  logging::ir::debug("Checking beta2s for compatibility");
+  if (!b2s.validReplacement(asAdam->b2s)) {
+    return false;
+  }
+
+  logging::ir::debug("Checking epss for compatibility");
+  if (!epsvs.validReplacement(asAdam->epsvs)) {
+    return false;
+  }
+
+  return true;
+}
+
+std::size_t Adam::hash() const {
+  auto seed = Optimizer::hash();
+  boost::hash_combine(seed, static_cast<int>(mode));
+  for (auto map : {&lrs, &wds, &b1s, &b2s, &epsvs}) {
+    boost::hash_combine(seed, map->hash());
+  }
+  return seed;
+}
+
+std::unique_ptr<Optimizer> Adam::clone() const {
+  return std::make_unique<Adam>(*this);
+}
+
 } // namespace popart
@@ -1,4 +1,5 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
+#include <boost/functional/hash.hpp>
 #include <popart/optimizervalue.hpp>
 
 namespace popart {
@@ -12,6 +13,15 @@ bool OptimizerValue::validReplacement(const OptimizerValue &rhs) const {
   return true;
 }
 
+std::size_t OptimizerValue::hash() const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, isConst());
+  if (isConst()) {
+    boost::hash_combine(seed, val());
+  }
+  return seed;
+}
+
 OptimizerValue &OptimizerValue::operator=(const OptimizerValue &rhs) {
   val_     = rhs.val_;
   isConst_ = rhs.isConst_;
@@ -1,4 +1,5 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
+#include <boost/functional/hash.hpp>
 #include <popart/optimizervaluemap.hpp>
 
 namespace popart {
@@ -47,4 +48,13 @@ bool OptimizerValueMap::validReplacement(const OptimizerValueMap &ovm) const {
   return true;
 }
 
+std::size_t OptimizerValueMap::hash() const {
+  auto seed = defaultOptVal.hash();
+  for (const auto &id_ov : specifics) {
+    boost::hash_combine(seed, id_ov.first);
+    boost::hash_combine(seed, id_ov.second.hash());
+  }
+  return seed;
+}
+
 } // namespace popart
@@ -0,0 +1,283 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <memory>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/onnxutil.hpp>
+#include <popart/op/accumulate.hpp>
+#include <popart/op/adamcombo.hpp>
+#include <popart/op/adamvarupdate.hpp>
+#include <popart/op/collectives/replicatedallreduce.hpp>
+#include <popart/patterns/adamdecompose.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/topocons.hpp>
+
+namespace popart {
+
+bool AdamDecompose::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool AdamDecompose::matchesOpType(const Op *op) const {
+  return op->isConvertibleTo<AdamComboOp>();
+}
+
+std::vector<const Tensor *> AdamDecompose::touches(Op *) const { return {}; }
+
+namespace {
+// Add a Variable Tensor of optimizer state, initialised either from the onnx
+// model used to create the session (if it is there), or to zero
+void addStateTensor(Graph &graph, const TensorId &id, const TensorInfo &info) {
+  auto &ir = graph.getIr();
+  if (ir.tensorExistsInInitialisers(id)) {
+    auto tp = onnxutil::getTensorProto(ir.getModel(), id);
+    graph.getTensors().addVarInit(id, &tp);
+  } else {
+    std::vector<char> zeros(info.nbytes(), 0);
+    graph.getTensors().addVarInit(id, info, zeros.data());
+
+    // T12001 better encapsulation
+    if (ir.additionalModelProtoTensors.find(id) ==
+            ir.additionalModelProtoTensors.end() &&
+        !ir.storingIsDisabledForTensor(id)) {
+      ir.additionalModelProtoTensors.insert(id);
+    }
+  }
+}
+} // namespace
+
+bool AdamDecompose::apply(Op *op) const {
+
+  auto &ir    = op->getIr();
+  auto &graph = op->getGraph();
+
+  // matches must have verified the correctness before this call
+  auto combo = static_cast<AdamComboOp *>(op);
+
+  Tensor *weightGrad =
+      combo->inTensor(VarUpdateWithUpdaterOp::getUpdaterInIndex());
+  Tensor *weight    = combo->inTensor(VarUpdateOp::getVarToUpdateInIndex());
+  Tensor *newWeight = combo->outTensor(VarUpdateOp::getUpdatedVarOutIndex());
+
+  TensorId weightGradId    = weightGrad->id;
+  TensorId weightId        = weight->id;
+  TensorId updatedWeightId = newWeight->id;
+
+  bool withAccumulation = ir.getSessionOptions().enableGradientAccumulation;
+
+  // The persistent state of the update, one of each per weight
+  //
+  // 1) The first and second moments, in FLOAT
+  auto accl1Id = reservedAccl1Prefix() + weightId;
+  auto accl2Id = reservedAccl2Prefix() + weightId;
+  addStateTensor(graph, accl1Id, {DataType::FLOAT, weight->info.shape()});
+  addStateTensor(graph, accl2Id, {DataType::FLOAT, weight->info.shape()});
+
+  // 2) The number of updates so far, for the bias corrections
+  auto stepId = reservedStepPrefix() + weightId;
+  addStateTensor(graph, stepId, {DataType::FLOAT, {}});
+
+  // The gradient used by the AdamVarUpdateOp, at each point it has a different
+  // name
+  TensorId updaterId = weightGradId;
+
+  // Gradient reduction (mutually exclusive with accumulator reduction)
+  if (combo->reductionType == OptimizerReductionType::GradReduce) {
+    auto reduceOpUp = std::make_unique<ReplicatedAllReduceOp>(
+        Onnx::CustomOperators::ReplicatedAllReduce,
+        Op::Settings(graph, combo->name() + "_reduce"));
+    auto reduceOp = reduceOpUp.get();
+    transferBaseProperties(combo, reduceOp);
+    graph.moveIntoGraph(std::move(reduceOpUp));
+
+    logging::pattern::trace("Connecting input {} to {} at {}",
+                            weightGradId,
+                            reduceOp->str(),
+                            ReplicatedAllReduceOp::getInIndex());
+    reduceOp->connectInTensor(ReplicatedAllReduceOp::getInIndex(),
+                              weightGradId);
+
+    updaterId = weightGradId + "_reduced";
+    reduceOp->createAndConnectOutTensor(ReplicatedAllReduceOp::getOutIndex(),
+                                        updaterId);
+    reduceOp->setup();
+
+    // Will be transferred to the AdamVarUpdateOp, which does not exist yet at
+    // this point. As for SGD0VarUpdateOp, ReplicatedAllReduceOps which are
+    // tied to optimizer Ops become ReplicatedReduceScatterOps when the weight
+    // is sharded across replicas.
+    graph.topoCons->insert(reduceOp, combo, true);
+  }
+
+  if (withAccumulation) {
+    if (weightGrad->info.dataType() != weight->info.dataType()) {
+      throw error("Currently, weight and weight gradient should have the same "
+                  "type in AdamDecompose, this is outstanding work");
+    }
+
+    // The Accumulator Tensor, a Variable Tensor, goes through up to 3 ops which
+    // update it in-place:
+    //
+    // 1) Input to Accumulate
+    auto acclIntoAccumulatorId =
+        reservedAcclToAccumulatorPrefix() + weightGradId;
+    // 2) input to AccumReduce (if reduction across replicas required)
+    auto acclIntoReduceId = reservedAcclToReducePrefix() + weightGradId;
+    // 3) input to AdamVarUpdate, which resets it to zero
+    auto acclIntoUpdateId = reservedAcclToUpdatePrefix() + weightGradId;
+
+    if (weightGrad->info.dataType() != DataType::FLOAT &&
+        weightGrad->info.dataType() != DataType::FLOAT16) {
+      throw error("Unsupported type in gradient accumulation transformation, "
+                  "currently only FLOAT16 and FLOAT are supported");
+    }
+    addStateTensor(graph, acclIntoAccumulatorId, weightGrad->info);
+
+    // Accumulate Op
+    //
+    // Inputs:
+    // (1) acclIn
+    // (2) dW (a.k.a. the Micro-Batch Weight Gradient Tensor)
+    //
+    // Outputs:
+    // (3) an alias of acclIn
+    auto acclOpUp = std::make_unique<AccumulateOp>(
+        acclIntoAccumulatorId,
+        AccumulationType::Add,
+        OptimizerValue(1.0f, true),
+        Op::Settings(graph, combo->name() + "_accumulate"));
+    auto acclOp = acclOpUp.get();
+    transferBaseProperties(combo, acclOp);
+    graph.moveIntoGraph(std::move(acclOpUp));
+
+    // (1)
+    acclOp->connectInTensor(VarUpdateOp::getVarToUpdateInIndex(),
+                            acclIntoAccumulatorId);
+    // (2)
+    acclOp->connectInTensor(VarUpdateWithUpdaterOp::getUpdaterInIndex(),
+                            updaterId);
+    // (3)
+    updaterId = combo->reductionType == OptimizerReductionType::AccumReduce
+                    ? acclIntoReduceId
+                    : acclIntoUpdateId;
+    acclOp->createAndConnectOutTensor(VarUpdateOp::getUpdatedVarOutIndex(),
+                                      updaterId);
+
+    // T12001 confirm that there are no topo cons here rather
+    graph.topoCons->transfer(combo, acclOp);
+    acclOp->setup();
+
+    // Accumulator reduction (mutually exclusive with gradient reduction)
+    if (combo->reductionType == OptimizerReductionType::AccumReduce) {
+      auto reduceOpUp = std::make_unique<ReplicatedAllReduceInplaceOp>(
+          Onnx::CustomOperators::ReplicatedAllReduceInplace,
+          Op::Settings(graph, combo->name() + "_reduce"));
+      auto reduceOp = reduceOpUp.get();
+      transferBaseProperties(combo, reduceOp);
+      graph.moveIntoGraph(std::move(reduceOpUp));
+
+      logging::pattern::trace("Connecting input {} to {} at {}",
+                              acclIntoReduceId,
+                              reduceOp->str(),
+                              ReplicatedAllReduceInplaceOp::getInIndex());
+      reduceOp->connectInTensor(ReplicatedAllReduceInplaceOp::getInIndex(),
+                                acclIntoReduceId);
+
+      updaterId = acclIntoUpdateId;
+      reduceOp->createAndConnectOutTensor(
+          ReplicatedAllReduceInplaceOp::getOutIndex(), updaterId);
+
+      reduceOp->setup();
+      reduceOp->settings.executionContext =
+          ExecutionContext::AccumulateOuterFragment;
+    }
+  }
+
+  // AdamVarUpdate
+  //
+  // Inputs
+  // (1) W
+  // (2) the (reduced, accumulated) gradient
+  // (3) the first moment
+  // (4) the second moment
+  // (5) the step count
+  // (6) the scalars (an input only if not Const)
+  //
+  // Outputs
+  // (7) W_new
+  auto adamVarUpdateOpUp = std::make_unique<AdamVarUpdateOp>(
+      weightId,
+      combo->mode,
+      combo->initLr,
+      combo->initWd,
+      combo->initB1,
+      combo->initB2,
+      combo->initEps,
+      combo->initGs,
+      withAccumulation,
+      Op::Settings(graph, combo->name() + "_var_update"));
+  auto adamVarUpdateOp = adamVarUpdateOpUp.get();
+  transferBaseProperties(combo, adamVarUpdateOp);
+  graph.moveIntoGraph(std::move(adamVarUpdateOpUp));
+
+  // (1)
+  adamVarUpdateOp->connectInTensor(VarUpdateOp::getVarToUpdateInIndex(),
+                                   weightId);
+  // (2)
+  logging::pattern::trace("Connecting input {} to {} at {}",
+                          updaterId,
+                          adamVarUpdateOp->str(),
+                          VarUpdateWithUpdaterOp::getUpdaterInIndex());
+  adamVarUpdateOp->connectInTensor(VarUpdateWithUpdaterOp::getUpdaterInIndex(),
+                                   updaterId);
+  // (3), (4), (5)
+  adamVarUpdateOp->connectInTensor(AdamVarUpdateOp::getAccl1InIndex(),
+                                   accl1Id);
+  adamVarUpdateOp->connectInTensor(AdamVarUpdateOp::getAccl2InIndex(),
+                                   accl2Id);
+  adamVarUpdateOp->connectInTensor(AdamVarUpdateOp::getStepInIndex(), stepId);
+
+  // (6)
+  const std::vector<std::pair<InIndex, InIndex>> scalarIndices{
+      {AdamComboOp::getLrInIndex(), AdamVarUpdateOp::getLrInIndex()},
+      {AdamComboOp::getWdInIndex(), AdamVarUpdateOp::getWdInIndex()},
+      {AdamComboOp::getBeta1InIndex(), AdamVarUpdateOp::getBeta1InIndex()},
+      {AdamComboOp::getBeta2InIndex(), AdamVarUpdateOp::getBeta2InIndex()},
+      {AdamComboOp::getEpsInIndex(), AdamVarUpdateOp::getEpsInIndex()},
+      {AdamComboOp::getGsInIndex(), AdamVarUpdateOp::getGsInIndex()}};
+  for (auto &comboIndex_updateIndex : scalarIndices) {
+    if (combo->input->hasIndex(comboIndex_updateIndex.first)) {
+      adamVarUpdateOp->connectInTensor(
+          comboIndex_updateIndex.second,
+          combo->inId(comboIndex_updateIndex.first));
+    }
+  }
+
+  // T12001 confirm that there are no topo cons here rather
+  graph.topoCons->transfer(combo, adamVarUpdateOp);
+
+  // deleting combo op now, so that its output can be re-connected
+  combo->disconnectAllInputs();
+  combo->disconnectAllOutputs();
+  graph.eraseOp(combo->id);
+
+  // (7)
+  adamVarUpdateOp->connectOutTensor(VarUpdateOp::getUpdatedVarOutIndex(),
+                                    updatedWeightId);
+  adamVarUpdateOp->setup();
+
+  if (withAccumulation) {
+    adamVarUpdateOp->settings.executionContext =
+        ExecutionContext::AccumulateOuterFragment;
+  }
+
+  return true;
+}
+
+namespace {
+// Not registering this pattern, as we want it to run at a special time (after
+// matmul serialization)
+static AddPatternName<AdamDecompose> registerName("AdamDecompose");
+} // namespace
+
+} // namespace popart
@@ -12,30 +12,35 @@
 namespace popart {
 
 bool ContiguateIpuCopyIndicesPattern::matches(Op *op) const {
+  // if not a IpuCopyOp, return false
+  if (!matchesOpType(op)) {
+    return false;
+  }
   auto copyOp = dynamic_cast<IpuCopyOp *>(op);
-  if (copyOp) {
-    // copies of optimizer tensors run outside the main program fragment
-    if (copyOp->copiesOptimizerTensors()) {
-      return false;
-    }
 
-    if (copyOp->getSourceTensors().size() != 1) {
-      return false;
-    }
+  // copies of optimizer tensors run outside the main program fragment
+  if (copyOp->copiesOptimizerTensors()) {
+    return false;
+  }
 
-    auto out0       = copyOp->outTensor(0);
-    auto firstStage = op->getPipelineStage();
-    auto lastStage  = *out0->consumers.findLowestPipelineStage();
-    auto delta      = lastStage - firstStage;
+  if (copyOp->getSourceTensors().size() != 1) {
+    return false;
+  }
 
-    if (delta == +1 || delta == -1) {
-      return false;
-    }
+  auto out0       = copyOp->outTensor(0);
+  auto firstStage = op->getPipelineStage();
+  auto lastStage  = *out0->consumers.findLowestPipelineStage();
+  auto delta      = lastStage - firstStage;
 
-    return true;
+  if (delta == +1 || delta == -1) {
+    return false;
   }
-  // if not a IpuCopyOp, return false
-  return false;
+
+  return true;
+}
+
+bool ContiguateIpuCopyIndicesPattern::matchesOpType(const Op *op) const {
+  return op->isConvertibleTo<IpuCopyOp>();
 }
 
 std::vector<const Tensor *>
@@ -13,6 +13,10 @@
 namespace popart {
 
 bool CosGradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool CosGradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<CosGradOp>();
 }
 
@@ -15,6 +15,10 @@
 namespace popart {
 
 bool CoshOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool CoshOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<CoshOp>();
 }
 
@@ -10,6 +10,10 @@
 namespace popart {
 
 bool DivArg0GradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool DivArg0GradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<DivArg0GradOp>();
 }
 
@@ -14,6 +14,10 @@
 namespace popart {
 
 bool DivArg1GradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool DivArg1GradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<DivArg1GradOp>();
 }
 
@@ -10,6 +10,10 @@
 namespace popart {
 
 bool ExpGradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool ExpGradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<ExpGradOp>();
 }
 
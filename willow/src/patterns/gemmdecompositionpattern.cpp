@@ -14,6 +14,10 @@
 namespace popart {
 
 bool GemmDecompositionPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool GemmDecompositionPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<GemmOp>();
 }
 
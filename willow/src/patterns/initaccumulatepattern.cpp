@@ -15,7 +15,7 @@ namespace popart {
 bool InitAccumulatePattern::matches(Op *op) const {
 
   // Looking for element-wise binary op (two inputs checked).
-  if (!op->isConvertibleTo<ElementWiseBinaryOp>() or op->input->n() != 2) {
+  if (!matchesOpType(op) or op->input->n() != 2) {
     return false;
   }
   // Ignore ops for which inferTensorMappingToFrom has been modified already.
@@ -89,6 +89,10 @@ bool InitAccumulatePattern::matches(Op *op) const {
   return true;
 }
 
+bool InitAccumulatePattern::matchesOpType(const Op *op) const {
+  return op->isConvertibleTo<ElementWiseBinaryOp>();
+}
+
 std::vector<const Tensor *> InitAccumulatePattern::touches(Op *op) const {
   // This pattern affects the layout or relationship of both inputs.
   return {op->input->tensor(0), op->input->tensor(1)};
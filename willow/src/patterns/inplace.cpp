@@ -269,18 +269,8 @@ OpsBeforeKey Inplace::getNewTopoCons(Op *op, OperatorIdentifier inpid) const {
       for (const auto &op_regs1 : after_regions) {
         Op *before = op_regs0.first;
         Op *after  = op_regs1.first;
-        for (const auto &reg0 : op_regs0.second) {
-          for (const auto &reg1 : op_regs1.second) {
-            // TODO : more efficient way of testing whether Regions
-            // (set of Regions) intersect (T7104)
-            if (!reg0.intersect(reg1).isEmpty()) {
-              if (gCons.find(after) == gCons.end()) {
-                gCons[after] = {before};
-              } else {
-                gCons[after].push_back(before);
-              }
-            }
-          }
+        if (view::overlaps(op_regs0.second, op_regs1.second)) {
+          gCons[after].push_back(before);
         }
       }
     }
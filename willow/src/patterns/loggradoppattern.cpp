@@ -10,6 +10,10 @@
 namespace popart {
 
 bool LogGradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool LogGradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<LogGradOp>();
 }
 
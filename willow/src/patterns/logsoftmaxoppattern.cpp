@@ -11,6 +11,10 @@
 namespace popart {
 
 bool LogSoftmaxOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool LogSoftmaxOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<LogSoftmaxOp>();
 }
 
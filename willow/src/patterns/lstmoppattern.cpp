@@ -14,6 +14,10 @@
 namespace popart {
 
 bool LSTMPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool LSTMPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<LSTMOp>();
 }
 
@@ -12,6 +12,10 @@
 namespace popart {
 
 bool MulArgGradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool MulArgGradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<MulArgGradOp>();
 }
 
@@ -10,7 +10,7 @@ using boost::math::epsilon_difference;
 namespace popart {
 
 bool NegativeOneScalePattern::matches(Op *op) const {
-  if (!(op->isConvertibleTo<ScaleOp>())) {
+  if (!matchesOpType(op)) {
     return false;
   }
 
@@ -18,6 +18,10 @@ bool NegativeOneScalePattern::matches(Op *op) const {
   return epsilon_difference(scale_factor, -1.0f) < 1.0f;
 }
 
+bool NegativeOneScalePattern::matchesOpType(const Op *op) const {
+  return op->isConvertibleTo<ScaleOp>();
+}
+
 // output = neg(x)
 std::vector<std::unique_ptr<Op>>
 NegativeOneScalePattern::sequence(Op *op) const {
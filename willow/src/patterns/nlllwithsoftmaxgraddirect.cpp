@@ -16,10 +16,10 @@ bool NlllWithSoftmaxGradDirect::matches(Op *op) const {
   // 3. NllOp and SoftmaxGradDirectOp must be on same IPU
 
   // 1.
-  auto sfmgdOp = dynamic_cast<SoftmaxGradDirectOp *>(op);
-  if (sfmgdOp == nullptr) {
+  if (!matchesOpType(op)) {
     return false;
   }
+  auto sfmgdOp = dynamic_cast<SoftmaxGradDirectOp *>(op);
 
   // 2.
   if (!sfmgdOp->hasNlllFwdOp()) {
@@ -35,6 +35,10 @@ bool NlllWithSoftmaxGradDirect::matches(Op *op) const {
   return true;
 }
 
+bool NlllWithSoftmaxGradDirect::matchesOpType(const Op *op) const {
+  return op->isConvertibleTo<SoftmaxGradDirectOp>();
+}
+
 std::vector<const Tensor *> NlllWithSoftmaxGradDirect::touches(Op *) const {
   return {};
 }
@@ -14,9 +14,12 @@
 namespace popart {
 
 bool OpToReshapePattern::matches(Op *op) const {
-  return (op->isConvertibleTo<SqueezeOp>() ||
-          op->isConvertibleTo<UnsqueezeOp>() ||
-          op->isConvertibleTo<FlattenOp>());
+  return matchesOpType(op);
+}
+
+bool OpToReshapePattern::matchesOpType(const Op *op) const {
+  return op->isConvertibleTo<SqueezeOp>() ||
+         op->isConvertibleTo<UnsqueezeOp>() || op->isConvertibleTo<FlattenOp>();
 }
 
 std::vector<const Tensor *> OpToReshapePattern::touches(Op *) const {
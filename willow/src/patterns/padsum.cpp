@@ -25,7 +25,7 @@ namespace popart {
 
 bool PadSumPattern::matches(Op *op) const {
   // Is the input a sum/add
-  if (!op->isConvertibleTo<AddOp>() && !op->isConvertibleTo<SumOp>()) {
+  if (!matchesOpType(op)) {
     return false;
   }
 
@@ -80,10 +80,8 @@ bool PadSumPattern::matches(Op *op) const {
   // Are all of the non-zero regions non-overlapping
   for (int i = 0; i < regions.size(); ++i) {
     for (int k = i + 1; k < regions.size(); ++k) {
-      auto intersection = regions[i].intersect(regions[k]);
-
       // Found an overlap
-      if (!intersection.isEmpty()) {
+      if (regions[i].overlaps(regions[k])) {
         return false;
       }
     }
@@ -92,6 +90,10 @@ bool PadSumPattern::matches(Op *op) const {
   return true;
 }
 
+bool PadSumPattern::matchesOpType(const Op *op) const {
+  return op->isConvertibleTo<AddOp>() || op->isConvertibleTo<SumOp>();
+}
+
 std::vector<const Tensor *> PadSumPattern::touches(Op *op) const {
   std::vector<const Tensor *> inputs;
   inputs.reserve(op->input->n());
@@ -23,6 +23,8 @@ bool PreAliasPattern::touchesAnchored(Op *op) const {
   return false;
 };
 
+bool PreAliasPattern::matchesOpType(const Op *) const { return true; }
+
 void Pattern::transferBaseProperties(Op *from, Op *to) const {
   if (from->hasVirtualGraphId()) {
     to->setVirtualGraphId(from->getVirtualGraphId());
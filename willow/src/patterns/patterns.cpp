@@ -529,4 +529,19 @@ bool Patterns::operator==(const Patterns &p) const {
   return true;
 }
 
+std::size_t Patterns::hash() const {
+  std::size_t hsh = 0;
+  auto combine    = [&hsh](std::size_t h) {
+    hsh ^= h + 0x9e3779b9 + (hsh << 6) + (hsh >> 2);
+  };
+  combine(std::hash<bool>{}(inplaceEnabled));
+  combine(std::hash<bool>{}(updateInplacePrioritiesForIpuEnabled));
+  for (auto &ti_enabled : settings) {
+    auto name = PreAliasPatternManager::getPatternName(ti_enabled.first);
+    combine(std::hash<std::string>{}(name));
+    combine(std::hash<bool>{}(ti_enabled.second));
+  }
+  return hsh;
+}
+
 } // namespace popart
@@ -14,6 +14,10 @@
 namespace popart {
 
 bool PowArg0GradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool PowArg0GradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<PowArg0GradOp>();
 }
 
@@ -12,6 +12,10 @@
 namespace popart {
 
 bool PowArg1GradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool PowArg1GradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<PowArg1GradOp>();
 }
 
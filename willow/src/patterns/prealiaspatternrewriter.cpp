@@ -0,0 +1,169 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <popart/compileprofiler.hpp>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/logging.hpp>
+#include <popart/op.hpp>
+#include <popart/patterns/prealiaspatternrewriter.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensorindex.hpp>
+
+namespace popart {
+
+PreAliasPatternRewriter::PreAliasPatternRewriter(
+    Ir &ir_,
+    std::vector<std::unique_ptr<PreAliasPattern>> patterns_)
+    : ir(ir_), patterns(std::move(patterns_)), statistics(patterns.size()) {}
+
+const std::vector<int> &PreAliasPatternRewriter::getCandidates(const Op *op) {
+  auto type  = std::type_index(typeid(*op));
+  auto found = candidates.find(type);
+  if (found == candidates.end()) {
+    std::vector<int> indices;
+    for (int i = 0; i < static_cast<int>(patterns.size()); ++i) {
+      if (patterns[i]->matchesOpType(op)) {
+        indices.push_back(i);
+      }
+    }
+    found = candidates.emplace(type, std::move(indices)).first;
+  }
+  return found->second;
+}
+
+void PreAliasPatternRewriter::addNeighbours(const Tensor *t,
+                                            std::set<OpId> &opIds) const {
+  if (t->hasProducer()) {
+    opIds.insert(t->getProducerUnsafe()->id);
+  }
+  for (Op *consumer : t->consumers.getOps()) {
+    opIds.insert(consumer->id);
+  }
+}
+
+void PreAliasPatternRewriter::addNeighbours(Op *op,
+                                            std::set<OpId> &opIds) const {
+  for (auto &index_tensor : op->input->tensorMap()) {
+    addNeighbours(index_tensor.second, opIds);
+  }
+  for (auto &index_tensor : op->output->tensorMap()) {
+    addNeighbours(index_tensor.second, opIds);
+  }
+}
+
+bool PreAliasPatternRewriter::apply(Graph &graph) {
+  using Clock = std::chrono::steady_clock;
+
+  bool result    = false;
+  auto &ops      = graph.getOps();
+  auto &profiler = ir.getCompileProfiler();
+
+  // The calls to matches() in this pass, recorded in the compile profile
+  std::vector<Statistics> passStatistics(patterns.size());
+
+  std::set<OpId> worklist;
+  for (auto &id_op : ops) {
+    worklist.insert(id_op.first);
+  }
+
+  while (!worklist.empty()) {
+    auto found = ops.find(*worklist.begin());
+    worklist.erase(worklist.begin());
+
+    // The op may have been removed by a pattern
+    if (found == ops.end()) {
+      continue;
+    }
+    Op *op = found->second.get();
+
+    for (int i : getCandidates(op)) {
+      auto pattern    = patterns[i].get();
+      auto &stats     = statistics[i];
+      auto &passStats = passStatistics[i];
+      auto t0         = Clock::now();
+
+      bool matches   = ir.canApplyPreAliasPattern(pattern, op);
+      auto matchTime = Clock::now() - t0;
+      ++stats.matchCalls;
+      stats.time += matchTime;
+      ++passStats.matchCalls;
+      passStats.time += matchTime;
+      if (!matches) {
+        continue;
+      }
+
+      logging::pattern::debug("Applying pattern {} to {}",
+                              pattern->getPatternName(),
+                              op->debugName());
+
+      // The ops around op may start or stop matching once it is changed.
+      // They, and op itself, are found before the pattern removes any of them
+      std::set<OpId> dirty{op->id};
+      addNeighbours(op, dirty);
+      for (auto tensor : pattern->touches(op)) {
+        addNeighbours(tensor, dirty);
+      }
+      OpId lastOpId = ops.rbegin()->first;
+
+      auto t1 = Clock::now();
+      bool applied;
+      {
+        CompileProfiler::Scope profile(
+            profiler, "patterns", pattern->getPatternName(), &ir);
+        applied = pattern->apply(op);
+      }
+      stats.time += Clock::now() - t1;
+
+      if (applied) {
+        ++stats.applications;
+        result = true;
+
+        // New ops have larger OpIds than all of the existing ones
+        for (auto it = ops.upper_bound(lastOpId); it != ops.end(); ++it) {
+          dirty.insert(it->first);
+          addNeighbours(it->second.get(), dirty);
+        }
+        worklist.insert(dirty.begin(), dirty.end());
+
+        // op may no longer exist. If it does, it is in the worklist
+        break;
+      }
+    }
+  }
+
+  if (profiler.isEnabled()) {
+    for (int i = 0; i < static_cast<int>(patterns.size()); ++i) {
+      auto &passStats = passStatistics[i];
+      if (passStats.matchCalls > 0) {
+        profiler.addEvent("patterns",
+                          patterns[i]->getPatternName() + "::matches",
+                          passStats.time,
+                          {{"graph", graph.id.str()},
+                           {"calls", std::to_string(passStats.matchCalls)}});
+      }
+    }
+  }
+
+  return result;
+}
+
+void PreAliasPatternRewriter::logStatistics() const {
+  std::ostringstream oss;
+  oss << "Pre-alias pattern statistics:\n"
+      << std::left << std::setw(32) << "Pattern" << std::right
+      << std::setw(12) << "matches()" << std::setw(12) << "applied"
+      << std::setw(12) << "time (ms)";
+  for (int i = 0; i < static_cast<int>(patterns.size()); ++i) {
+    auto &stats = statistics[i];
+    oss << '\n'
+        << std::left << std::setw(32) << patterns[i]->getPatternName()
+        << std::right << std::setw(12) << stats.matchCalls << std::setw(12)
+        << stats.applications << std::setw(12) << std::fixed
+        << std::setprecision(3) << stats.time.count() / 1e6;
+  }
+  logging::pattern::info(oss.str());
+}
+
+} // namespace popart
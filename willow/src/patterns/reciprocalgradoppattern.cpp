@@ -15,6 +15,10 @@
 namespace popart {
 
 bool ReciprocalGradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool ReciprocalGradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<ReciprocalGradOp>();
 }
 
@@ -17,6 +17,10 @@
 namespace popart {
 
 bool SGD0Decompose::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool SGD0Decompose::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<SGD0VarUpdateOp>();
 }
 
@@ -4,6 +4,8 @@
 #include <popart/ces/flattence.hpp>
 #include <popart/ces/slicece.hpp>
 #include <popart/graph.hpp>
+#include <popart/half.hpp>
+#include <popart/hostconversion.hpp>
 #include <popart/ir.hpp>
 #include <popart/onnxutil.hpp>
 #include <popart/op/accumulate.hpp>
@@ -22,13 +24,16 @@
 namespace popart {
 
 bool SGD1Decompose::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool SGD1Decompose::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<SGD1ComboOp>();
 }
 
 std::vector<const Tensor *> SGD1Decompose::touches(Op *) const { return {}; }
 
 namespace {
-template <typename T>
 void addAcclInTensor(SGD1ComboOp &comboOp,
                      const Tensor &weight,
                      const Tensor &weightGrad,
@@ -37,6 +42,7 @@ void addAcclInTensor(SGD1ComboOp &comboOp,
   auto &graph = comboOp.getGraph();
   auto wgInfo = weightGrad.info;
   auto nelms  = wgInfo.nelms();
+  auto dtype  = wgInfo.dataType();
 
   // A note: we could have chosen to always initialize the velocity Tensor to
   // 0, which would correspond to no weight decay in the first iteration. One
@@ -47,24 +53,33 @@ void addAcclInTensor(SGD1ComboOp &comboOp,
   // back-track to find the data.
   // tempData needs to be outside the if statment as it should have the same
   // lifetime as weightVal0.
-  std::vector<T> d(nelms, 0.0f);
   std::vector<char> tempData;
-  const T *weightVal0;
+  const void *weightVal0;
   if (weight.hasTensorData()) {
-    const void *outTemp = weight.tensorData()->data();
-    weightVal0          = static_cast<const T *>(outTemp);
+    weightVal0 = weight.tensorData()->data();
   } else {
     tempData   = weight.getDataViaRecursion();
-    weightVal0 = reinterpret_cast<const T *>(tempData.data());
+    weightVal0 = tempData.data();
   }
+
+  // The weights are scaled in float. FLOAT16 weights are converted to and
+  // from float in bulk.
+  std::vector<float> d(nelms);
+  hostconversion::convert(dtype, weightVal0, DataType::FLOAT, d.data(), nelms);
+
   // We add to the initialized velocity a weight decay term (see the equations)
-  for (auto i = 0; i < nelms; ++i) {
-    // T12001 investigate why += doesn't work
-    // Recall, this scaling factor is (1-dm)*wd*vs
-    d[i] = weightVal0[i] * static_cast<T>(comboOp.initSwd1.val());
+  // Recall, this scaling factor is (1-dm)*wd*vs, in the type of the weight
+  float scale = comboOp.initSwd1.val();
+  if (dtype == DataType::FLOAT16) {
+    scale = static_cast<float>(Half(scale));
+  }
+  for (auto &x : d) {
+    x *= scale;
   }
 
-  graph.getTensors().addVarInit(acclIntoAccumulatorId, wgInfo, d.data());
+  std::vector<char> accl(wgInfo.nbytes());
+  hostconversion::convert(DataType::FLOAT, d.data(), dtype, accl.data(), nelms);
+  graph.getTensors().addVarInit(acclIntoAccumulatorId, wgInfo, accl.data());
 }
 } // namespace
 
@@ -118,12 +133,9 @@ bool SGD1Decompose::apply(Op *op) const {
     graph.getTensors().addVarInit(acclIntoAccumulatorId, &tp);
   } else {
     // ... Or by initializing directly
-    if (weightGrad->info.dataType() == DataType::FLOAT) {
-      addAcclInTensor<float>(
-          *combo, *weight, *weightGrad, acclIntoAccumulatorId);
-    } else if (weightGrad->info.dataType() == DataType::FLOAT16) {
-      addAcclInTensor<float16_t>(
-          *combo, *weight, *weightGrad, acclIntoAccumulatorId);
+    if (weightGrad->info.dataType() == DataType::FLOAT ||
+        weightGrad->info.dataType() == DataType::FLOAT16) {
+      addAcclInTensor(*combo, *weight, *weightGrad, acclIntoAccumulatorId);
     } else {
       throw error("Unsupported type in gradient accumulation transformation, "
                   "currently only FLOAT16 and FLOAT are supported");
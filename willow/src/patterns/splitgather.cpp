@@ -27,13 +27,8 @@ public:
 } // namespace
 
 bool SplitGatherPattern::matches(Op *op) const {
-  // Isn't a gather op
-  if (!op->isConvertibleTo<GatherOp>()) {
-    return false;
-  }
-
-  // Is an already split gather op
-  if (op->isConvertibleTo<SplitGatherOp>()) {
+  // Isn't a gather op, or is an already split gather op
+  if (!matchesOpType(op)) {
     return false;
   }
 
@@ -78,6 +73,11 @@ bool SplitGatherPattern::matches(Op *op) const {
   return true;
 }
 
+bool SplitGatherPattern::matchesOpType(const Op *op) const {
+  return op->isConvertibleTo<GatherOp>() &&
+         !op->isConvertibleTo<SplitGatherOp>();
+}
+
 std::vector<const Tensor *> SplitGatherPattern::touches(Op *) const {
   return {};
 }
@@ -17,6 +17,10 @@
 namespace popart {
 
 bool SplitGradOpToConcatPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool SplitGradOpToConcatPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<SplitGradOp>();
 }
 
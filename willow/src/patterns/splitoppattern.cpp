@@ -38,6 +38,10 @@ bool SplitOpPattern::matches(Op *op) const {
   if (op->getIr().canTrain() && !op->getIr().hasConstructedBackwards()) {
     return false;
   }
+  return matchesOpType(op);
+}
+
+bool SplitOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<SplitOp>();
 }
 
@@ -13,6 +13,10 @@
 namespace popart {
 
 bool SqrtGradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool SqrtGradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<SqrtGradOp>();
 }
 
@@ -11,6 +11,10 @@
 namespace popart {
 
 bool SubtractArg1GradOpPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool SubtractArg1GradOpPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<SubtractArg1GradOp>();
 }
 
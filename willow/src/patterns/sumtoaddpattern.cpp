@@ -11,7 +11,11 @@
 namespace popart {
 
 bool SumToAddPattern::matches(Op *op) const {
-  return op->isConvertibleTo<SumOp>() && op->input->n() == 2;
+  return matchesOpType(op) && op->input->n() == 2;
+}
+
+bool SumToAddPattern::matchesOpType(const Op *op) const {
+  return op->isConvertibleTo<SumOp>();
 }
 
 std::vector<const Tensor *> SumToAddPattern::touches(Op *) const { return {}; }
@@ -12,6 +12,10 @@
 namespace popart {
 
 bool TanToSinOverCosPattern::matches(Op *op) const {
+  return matchesOpType(op);
+}
+
+bool TanToSinOverCosPattern::matchesOpType(const Op *op) const {
   return op->isConvertibleTo<TanOp>();
 }
 
@@ -1,9 +1,11 @@
 // Copyright (c) 2018 Graphcore Ltd. All rights reserved.
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
+#include <iterator>
 #include <memory>
 #include <random>
 #include <set>
@@ -20,6 +22,7 @@
 #include <poplar/CycleCount.hpp>
 #include <poplin/codelets.hpp>
 #include <popnn/codelets.hpp>
+#include <popops/Cast.hpp>
 #include <popops/ElementWise.hpp>
 #include <popops/ScaledAdd.hpp>
 #include <popops/Zero.hpp>
@@ -27,10 +30,13 @@
 #include <poprand/RandomGen.hpp>
 #include <poprand/codelets.hpp>
 #include <poputil/exceptions.hpp>
+#include <popart/compileprofiler.hpp>
 #include <popart/devicemanager.hpp>
+#include <popart/enginecache.hpp>
 #include <popart/error.hpp>
 #include <popart/filereader.hpp>
 #include <popart/graph.hpp>
+#include <popart/hostconversion.hpp>
 #include <popart/ir.hpp>
 #include <popart/liveness.hpp>
 #include <popart/logging.hpp>
@@ -57,9 +63,11 @@
 #include <popart/popx/pritask.hpp>
 #include <popart/recompute.hpp>
 #include <popart/stepio.hpp>
+#include <popart/stepio_size_assertion.hpp>
 #include <popart/tensor.hpp>
 #include <popart/tensordata.hpp>
 #include <popart/tensors.hpp>
+#include <popart/threadpool.hpp>
 #include <popart/tojson.hpp>
 #include <popart/topocons.hpp>
 
@@ -81,15 +89,93 @@ void progressLogger(int progress, int total) {
   }
 }
 
+// The most host-side collective rearrangements of sharded weights in flight
+// at once, while the engine copies other weights to or from remote buffers.
+// Each needs a scratch buffer the size of the (padded) weight.
+constexpr std::size_t maxCollectiveRearrangementsInFlight = 4;
+
+// Runs the host-side collective rearrangements of a sequence of sharded
+// weights on ThreadPool::global(). Weight i uses scratch buffer i % depth(),
+// and the task of weight i must be complete before weight i + depth() can
+// use the buffer.
+class CollectiveRearrangementPipeline {
+public:
+  CollectiveRearrangementPipeline(std::vector<std::vector<char>> &scratch_,
+                                  std::size_t nWeights)
+      : scratch(scratch_) {
+    auto depth = std::min(nWeights,
+                          std::min<std::size_t>(
+                              ThreadPool::global().size() + 1,
+                              maxCollectiveRearrangementsInFlight));
+    pending.resize(std::max<std::size_t>(depth, 1));
+    if (scratch.size() < pending.size()) {
+      scratch.resize(pending.size());
+    }
+  }
+
+  // Tasks reference the scratch buffers, so must not outlive them
+  ~CollectiveRearrangementPipeline() {
+    for (auto &task : pending) {
+      if (task.valid()) {
+        task.wait();
+      }
+    }
+  }
+
+  std::size_t depth() const { return pending.size(); }
+
+  // Wait for the task of weight i (if any), rethrowing its exception
+  void wait(std::size_t i) {
+    auto &task = pending[i % depth()];
+    if (task.valid()) {
+      task.get();
+    }
+  }
+
+  void waitAll() {
+    for (std::size_t i = 0; i < depth(); ++i) {
+      wait(i);
+    }
+  }
+
+  // The scratch buffer of weight i, of at least `nbytes', zeroed. The
+  // collective rearrangement does not write the padding of a weight, which
+  // must not keep the bytes of the weight which used the buffer before
+  char *buffer(std::size_t i, std::size_t nbytes) {
+    wait(i);
+    auto &buf = scratch[i % depth()];
+    if (buf.size() < nbytes) {
+      buf.resize(nbytes);
+    }
+    std::fill(buf.begin(), buf.begin() + nbytes, 0);
+    return buf.data();
+  }
+
+  void submit(std::size_t i, std::function<void()> task) {
+    pending[i % depth()] = ThreadPool::global().submit(std::move(task));
+  }
+
+private:
+  std::vector<std::vector<char>> &scratch;
+  std::vector<std::future<void>> pending;
+};
+
 class SavedInfo {
 public:
-  SavedInfo(const Devicex &devicex) : irHash(std::hash<Ir>{}(devicex.ir())) {}
+  SavedInfo(const Devicex &devicex)
+      : irHash(std::hash<Ir>{}(devicex.ir())),
+        irBundleHash(devicex.ir().getIrBundleHash()) {}
 
-  void serialize(std::ostream &os) { os << irHash; }
+  void serialize(std::ostream &os) { os << irHash << ' ' << irBundleHash; }
 
+  // The irBundleHash was added after the irHash, and is 0 if the saved info
+  // only has an irHash
   static SavedInfo deserialize(std::istream &is) {
     SavedInfo result;
     is >> result.irHash;
+    if (!(is >> result.irBundleHash)) {
+      result.irBundleHash = 0;
+    }
     return result;
   }
 
@@ -103,11 +189,17 @@ public:
   }
 
   std::size_t irHash;
+  std::size_t irBundleHash;
 
 private:
-  SavedInfo() : irHash(0) {}
+  SavedInfo() : irHash(0), irBundleHash(0) {}
 };
 
+bool useEngineCache(const SessionOptions &opts, const DeviceInfo &deviceInfo) {
+  return opts.enableEngineCaching && !opts.cachePath.empty() &&
+         deviceInfo.getType() == DeviceType::Ipu;
+}
+
 // Walk the producers of an ops inputs, applying function f to every producer.
 // The producers are walked in a top down fashion. If f returns false of an op,
 // then further producers below it are not traversed.
@@ -324,44 +416,13 @@ void Devicex::InputDatastream::read(void *ptr) {
 
     ConstVoidData data = io->in(getTensorId(), tensor->info.nelms(), false);
 
-    const void *srcAddr = data.data;
-    void *dstAddr       = ptr;
-
-    auto srcInfo = data.info;
-    auto dstInfo = tensor->info;
-
     // check the shape
 
     // Not sure how best to match the shape as the shape of the input
     // does not match the shape of the data.info. Infact that is a bit
     // wrong now.
 
-    // check the type
-    if (srcInfo.dataType() == dstInfo.dataType()) {
-      memcpy(dstAddr, srcAddr, tensor->info.nbytes());
-    } else if (srcInfo.dataType() == DataType::INT64 &&
-               dstInfo.dataType() == DataType::INT32) {
-
-      static bool loggingWarning = false;
-      if (loggingWarning == false) {
-        logging::devicex::warn(
-            "Copying (host) tensor {} from INT64 to INT32. Will only warn once",
-            getTensorId());
-        loggingWarning = true;
-      }
-      int32_t *dest      = static_cast<int32_t *>(dstAddr);
-      const int64_t *src = static_cast<const int64_t *>(srcAddr);
-      for (int i = 0; i < tensor->info.nelms(); ++i) {
-        dest[i] = static_cast<int32_t>(src[i]);
-      }
-    } else {
-      std::stringstream ss;
-      ss << "Type discrepency for tensor " << getTensorId()
-         << ". User provided : " << srcInfo.data_type()
-         << " and expected : " << dstInfo.data_type()
-         << ". Consider a custom copy here (as memcpy cannot be used)";
-      throw error(ss.str());
-    }
+    copyToStream(data, ptr);
 
   } else {
     logging::devicex::warn(
@@ -379,46 +440,7 @@ bool Devicex::InputDatastream::readPrefetch(void *ptr) {
       logging::devicex::info("readPrefetch returning false");
       return false;
     } else {
-
-      const void *srcAddr = data.data;
-      void *dstAddr       = ptr;
-
-      auto srcInfo = data.info;
-      auto dstInfo = tensor->info;
-
-      // check the shape
-
-      // Not sure how best to match the shape as the shape of the input
-      // does not match the shape of the data.info. Infact that is a bit
-      // wrong now.
-
-      // check the type
-      if (srcInfo.dataType() == dstInfo.dataType()) {
-        memcpy(dstAddr, srcAddr, tensor->info.nbytes());
-      } else if (srcInfo.dataType() == DataType::INT64 &&
-                 dstInfo.dataType() == DataType::INT32) {
-
-        static bool loggingWarning = false;
-        if (loggingWarning == false) {
-          logging::devicex::warn("Copying (host) tensor {} from INT64 to "
-                                 "INT32. Will only warn once",
-                                 getTensorId());
-          loggingWarning = true;
-        }
-        int32_t *dest      = static_cast<int32_t *>(dstAddr);
-        const int64_t *src = static_cast<const int64_t *>(srcAddr);
-        for (int i = 0; i < tensor->info.nelms(); ++i) {
-          dest[i] = static_cast<int32_t>(src[i]);
-        }
-      } else {
-        std::stringstream ss;
-        ss << "Type discrepency for tensor " << getTensorId()
-           << ". User provided : " << srcInfo.data_type()
-           << " and expected : " << dstInfo.data_type()
-           << ". Consider a custom copy here (as memcpy cannot be used)";
-        throw error(ss.str());
-      }
-
+      copyToStream(data, ptr);
       return true;
     }
 
@@ -429,6 +451,35 @@ bool Devicex::InputDatastream::readPrefetch(void *ptr) {
   }
 }
 
+void Devicex::InputDatastream::copyToStream(const ConstVoidData &data,
+                                            void *dstAddr) {
+  auto srcType = data.info.dataType();
+  auto dstType = tensor->info.dataType();
+
+  // check the type
+  if (srcType == dstType) {
+    memcpy(dstAddr, data.data, tensor->info.nbytes());
+  } else if (hostconversion::canConvert(srcType, dstType)) {
+    if (!conversionWarningLogged) {
+      logging::devicex::warn("Converting (host) tensor {} from {} to {}. Will "
+                             "only warn once per tensor",
+                             getTensorId(),
+                             data.info.data_type(),
+                             tensor->info.data_type());
+      conversionWarningLogged = true;
+    }
+    hostconversion::convert(
+        srcType, data.data, dstType, dstAddr, tensor->info.nelms());
+  } else {
+    std::stringstream ss;
+    ss << "Type discrepency for tensor " << getTensorId()
+       << ". User provided : " << data.info.data_type()
+       << " and expected : " << tensor->info.data_type()
+       << ". Consider a custom copy here (as memcpy cannot be used)";
+    throw error(ss.str());
+  }
+}
+
 void Devicex::InputDatastream::readComplete() {
   if (io) {
     io->inComplete(getTensorId(), tensor->info.nelms());
@@ -442,7 +493,16 @@ void Devicex::OutputDatastream::write(void *ptr) {
 
   if (io) {
     MutableVoidData data = io->out(getTensorId(), tensor->info.nelms());
-    memcpy(data.data, ptr, tensor->info.nbytes());
+    auto srcType         = tensor->info.dataType();
+    auto dstType         = data.info.dataType();
+    // Anchors of a different type to the tensor are converted where
+    // supported, anything else is copied as before.
+    if (srcType != dstType && hostconversion::canConvert(srcType, dstType)) {
+      hostconversion::convert(
+          srcType, ptr, dstType, data.data, tensor->info.nelms());
+    } else {
+      memcpy(data.data, ptr, tensor->info.nbytes());
+    }
     io->outComplete(getTensorId());
   } else {
     logging::devicex::warn(
@@ -597,48 +657,66 @@ void Devicex::weightsToHost() {
 }
 
 void Devicex::remoteBufferWeightsToHost() {
+  // Copies to and from remote buffers are made on this thread, one at a time,
+  // as the engine is not thread safe. Undoing the collective rearrangement of
+  // a sharded weight is done by the thread pool, while the weights after it
+  // are copied.
+  std::vector<Tensor *> shardedWeights;
   for (auto initId : ir().getTensorIds(TensorType::Variable)) {
     Tensor *tensor = ir().getTensor(initId);
     if (tensor->cacheInfo.isCached()) {
+      if (tensor->cacheInfo.isSharded()) {
+        shardedWeights.push_back(tensor);
+        continue;
+      }
       logging::devicex::debug("remoteBufferWeightsToHost: {}", initId);
       auto remoteBufferInfo = tensor->cacheInfo.getRemoteBufferInfo();
-      char *data0           = d2hWeightBuffers[initId].data();
-
-      if (tensor->cacheInfo.isSharded()) {
-        // Replicated weight sharding, each replica holds 1/repfactor
-        // parts of the weight
-        auto cbr = getCollectiveBalancedReorder(
-            getCacheArgTensorId(stripAllReservedPrefixes(tensor->id)));
-
-        auto elemSize = cbr->getElementByteSize();
-        auto nelms    = cbr->getNumRearrangedTensorElems();
-
-        // Temporary buffer that can hold the padded weight shards
-        // from all replicas
-        std::vector<char> tmp(nelms * elemSize);
-
-        for (unsigned replica_id = 0; replica_id < getReplicationFactor();
-             ++replica_id) {
-          pEngine->copyFromRemoteBuffer(
-              getRemoteBuffer(remoteBufferInfo.first).first,
-              &tmp[replica_id * nelms / getReplicationFactor() * elemSize],
-              static_cast<int>(remoteBufferInfo.second),
-              replica_id);
-        }
+      // Weight should be the same for each replica if not using sharded,
+      // only return weights from replica_id == 0
+      pEngine->copyFromRemoteBuffer(
+          getRemoteBuffer(remoteBufferInfo.first).first,
+          d2hWeightBuffers[initId].data(),
+          static_cast<int>(remoteBufferInfo.second),
+          0);
+    }
+  }
 
-        // Rearrange collected weights into d2h buffer
-        cbr->undoRearrangeForCollective(&tmp[0], data0);
-      } else {
-        // Weight should be the same for each replica if not using sharded,
-        // only return weights from replica_id == 0
-        pEngine->copyFromRemoteBuffer(
-            getRemoteBuffer(remoteBufferInfo.first).first,
-            data0,
-            static_cast<int>(remoteBufferInfo.second),
-            0);
-      }
+  CollectiveRearrangementPipeline pipeline(collectiveScratch,
+                                           shardedWeights.size());
+  for (std::size_t i = 0; i < shardedWeights.size(); ++i) {
+    Tensor *tensor = shardedWeights[i];
+    logging::devicex::debug("remoteBufferWeightsToHost: {}", tensor->id);
+    auto remoteBufferInfo = tensor->cacheInfo.getRemoteBufferInfo();
+    char *data0           = d2hWeightBuffers[tensor->id].data();
+
+    // Replicated weight sharding, each replica holds 1/repfactor
+    // parts of the weight
+    auto cbr = getCollectiveBalancedReorder(
+        getCacheArgTensorId(stripAllReservedPrefixes(tensor->id)));
+    cbr->prepareHostRearrangement();
+
+    auto elemSize = cbr->getElementByteSize();
+    auto nelms    = cbr->getNumRearrangedTensorElems();
+
+    // Scratch buffer that can hold the padded weight shards
+    // from all replicas
+    char *tmp = pipeline.buffer(i, nelms * elemSize);
+
+    for (unsigned replica_id = 0; replica_id < getReplicationFactor();
+         ++replica_id) {
+      pEngine->copyFromRemoteBuffer(
+          getRemoteBuffer(remoteBufferInfo.first).first,
+          tmp + replica_id * nelms / getReplicationFactor() * elemSize,
+          static_cast<int>(remoteBufferInfo.second),
+          replica_id);
     }
+
+    // Rearrange collected weights into d2h buffer
+    pipeline.submit(i, [cbr, tmp, data0]() {
+      cbr->undoRearrangeForCollective(tmp, data0);
+    });
   }
+  pipeline.waitAll();
 }
 
 void Devicex::readWeights(const IWeightsIO &weights) {
@@ -664,7 +742,21 @@ void Devicex::writeWeights(const IWeightsIO &weights) {
     if (weights.contains(id)) {
       auto tensor             = ir().getTensor(id);
       MutableVoidData stepout = weights.weight(id);
-      tensor->tensorData()->resetData(stepout.info, stepout.data);
+      auto srcType            = stepout.info.dataType();
+      auto dstType            = tensor->info.dataType();
+      if (srcType != dstType && hostconversion::canConvert(srcType, dstType)) {
+        if (stepout.info.nelms() != tensor->info.nelms()) {
+          throw error("cannot reset tensor data with data of non-matching "
+                      "size");
+        }
+        hostconversion::convert(srcType,
+                                stepout.data,
+                                dstType,
+                                tensor->tensorData()->data(),
+                                tensor->info.nelms());
+      } else {
+        tensor->tensorData()->resetData(stepout.info, stepout.data);
+      }
     }
   }
 }
@@ -691,6 +783,7 @@ void Devicex::weightsToHost(
     logging::devicex::debug("Writing weights to ONNX ModelProto");
     // copy from the host stream memory points to the
     // addresses on onnxModelData
+    std::vector<std::pair<TensorId, MutableVoidData>> copies;
     for (auto id : ir().getTensorIds(TensorType::Variable)) {
       if (!ir().storingIsDisabledForTensor(id)) {
         auto found = onnxModelData.find(id);
@@ -704,11 +797,26 @@ void Devicex::weightsToHost(
           oss << ']';
           throw error(oss.str());
         }
-        MutableVoidData mv_data = found->second;
-        hostStreamToHost(mv_data, id);
+        copies.push_back({id, found->second});
       }
     }
+
+    // The weights are independent, so are copied concurrently
+    ThreadPool::global().parallelFor(
+        copies.size(), 1, [this, &copies](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            hostStreamToHost(copies[i].second, copies[i].first);
+          }
+        });
+  }
+}
+
+ConstVoidData Devicex::getD2hWeightData(const TensorId &id) const {
+  auto found = d2hWeightBuffers.find(id);
+  if (found == d2hWeightBuffers.end()) {
+    throw error("No host stream buffer for weight {}", id);
   }
+  return ConstVoidData(found->second.data(), ir().getTensor(id)->info);
 }
 
 const std::string Devicex::cycleCountStreamId(std::string id) const {
@@ -734,6 +842,127 @@ void Devicex::instrumentWithHardwareCycleCounter(poplar::program::Sequence &sq,
   progs.cycleCountTensorToHostFragment().add(cyclesToHostStream);
 }
 
+bool Devicex::isInstrumentedOp(const Op *op) const {
+  const auto &opts = ir().getSessionOptions();
+  if (!opts.instrumentWithHardwareCycleCounter ||
+      opts.hardwareInstrumentations.count(Instrumentation::Op) == 0) {
+    return false;
+  }
+  if (!opInstrumentationFilter) {
+    return true;
+  }
+  return std::regex_search(op->opid.type, *opInstrumentationFilter) ||
+         std::regex_search(op->name(), *opInstrumentationFilter);
+}
+
+void Devicex::addHardwareCycleTotal(poplar::program::Sequence &sq,
+                                    int64_t tileId,
+                                    const std::string &id) {
+  poplar::Tensor count = poplar::cycleCount(
+      graph(), sq, static_cast<unsigned>(tileId), cycleCountPrefix());
+
+  // The low and high words of the total, and the number of executions. They
+  // are zeroed at the start of each run of the main program
+  auto total = graph().addVariable(
+      poplar::UNSIGNED_INT, {3}, std::string(cycleCountPrefix()) + id);
+  graph().setTileMapping(total, tileId);
+  popops::zero(graph(), total, progs.cycleCountResetFragment());
+
+  auto one = graph().addConstant(poplar::UNSIGNED_INT, {}, 1u);
+  graph().setTileMapping(one, tileId);
+
+  // 64 bit addition of the count to the total. The low word has wrapped
+  // around if it is less than the low word of the count after the addition
+  auto low  = total[0];
+  auto high = total[1];
+  popops::addInPlace(graph(), low, count[0], sq);
+  auto carry = popops::cast(graph(),
+                            popops::lt(graph(), low, count[0], sq),
+                            poplar::UNSIGNED_INT,
+                            sq);
+  popops::addInPlace(graph(), high, count[1], sq);
+  popops::addInPlace(graph(), high, carry, sq);
+  popops::addInPlace(graph(), total[2], one, sq);
+
+  auto st = graph().addDeviceToHostFIFO(
+      cycleCountStreamId(id), total.elementType(), total.numElements());
+  cycleTotals[id] = {0, 0, 0};
+  progs.cycleCountTensorToHostFragment().add(
+      poplar::program::Copy(total, st, true));
+}
+
+void Devicex::instrumentOpWithHardwareCycleCounter(
+    poplar::program::Sequence &sq,
+    const Op *op) {
+  int64_t tileId = 0;
+  if (op->hasVirtualGraphId()) {
+    tileId = op->getVirtualGraphId() * deviceInfo->getTilesPerIpu();
+  }
+  auto id = "op_" + std::to_string(op->id);
+  addHardwareCycleTotal(sq, tileId, id);
+  cycleTotalOps[id] = op;
+}
+
+void Devicex::instrumentPipelineStageWithHardwareCycleCounter(
+    poplar::program::Sequence &sq,
+    PipelineStage stage) {
+  // The cycles are counted on the IPU of the Ops of the stage
+  int64_t tileId = 0;
+  for (auto &id_op : ir().getMainGraph().getOps()) {
+    auto op = id_op.second.get();
+    if (op->hasPipelineStage() && op->getPipelineStage() == stage &&
+        op->hasVirtualGraphId()) {
+      tileId = op->getVirtualGraphId() * deviceInfo->getTilesPerIpu();
+      break;
+    }
+  }
+  auto id = "pipelineStage_" + std::to_string(stage);
+  addHardwareCycleTotal(sq, tileId, id);
+  cycleTotalPipelineStages[id] = stage;
+}
+
+CycleCountReport Devicex::cycleCountReportToHost() {
+  // Copies all of the cycle counts and totals to the host
+  cycleCountTensorToHost();
+
+  auto getCycles = [](const std::array<uint32_t, 3> &words) {
+    return (static_cast<uint64_t>(words[1]) << 32) | words[0];
+  };
+
+  CycleCountReport report;
+  for (auto &id_op : cycleTotalOps) {
+    auto &words = cycleTotals.at(id_op.first);
+    auto op     = id_op.second;
+    report.ops.push_back({op->id,
+                          op->getGraph().id.str(),
+                          op->opid.type,
+                          op->debugName(),
+                          getCycles(words),
+                          words[2]});
+  }
+  std::sort(report.ops.begin(),
+            report.ops.end(),
+            [](const CycleCountReport::OpEntry &a,
+               const CycleCountReport::OpEntry &b) {
+              return std::make_tuple(b.cycles, a.opId) <
+                     std::make_tuple(a.cycles, b.opId);
+            });
+
+  for (auto &id_stage : cycleTotalPipelineStages) {
+    auto &words = cycleTotals.at(id_stage.first);
+    report.pipelineStages.push_back(
+        {id_stage.second, getCycles(words), words[2]});
+  }
+  std::sort(report.pipelineStages.begin(),
+            report.pipelineStages.end(),
+            [](const CycleCountReport::PipelineStageEntry &a,
+               const CycleCountReport::PipelineStageEntry &b) {
+              return a.pipelineStage < b.pipelineStage;
+            });
+
+  return report;
+}
+
 std::map<std::string, uint64_t> Devicex::cycleCountTensorToHost() {
   if (ir().getSessionOptions().instrumentWithHardwareCycleCounter) {
     // Calls the copy from device to host
@@ -852,6 +1081,17 @@ Devicex::Devicex(const Ir &ir, std::shared_ptr<DeviceInfo> deviceInfo_)
   auto POPART_OPX_TRACE = getPopartEnvVar("OPX_TRACE");
   opxTrace = POPART_OPX_TRACE ? strncmp(POPART_OPX_TRACE, "1", 1) == 0 : false;
 
+  const auto &opFilter = ir.getSessionOptions().hardwareInstrumentationOpFilter;
+  if (!opFilter.empty()) {
+    try {
+      opInstrumentationFilter.emplace(opFilter);
+    } catch (const std::regex_error &e) {
+      throw error("Invalid hardwareInstrumentationOpFilter '{}': {}",
+                  opFilter,
+                  e.what());
+    }
+  }
+
   // TODO (see T5100) : if inference, forward should be INFERENCE_FWD
   for (auto it : ir.getSessionOptions().convolutionOptions) {
     logging::devicex::info(
@@ -939,51 +1179,91 @@ void Devicex::weightsFromHost() {
 }
 
 void Devicex::remoteBufferWeightsFromHost() {
+  // As in remoteBufferWeightsToHost, the copies are made on this thread, and
+  // the collective rearrangements of the sharded weights by the thread pool,
+  // up to CollectiveRearrangementPipeline::depth() weights ahead of the copies
+  std::vector<Tensor *> shardedWeights;
   for (auto initId : ir().getTensorIds(TensorType::Variable)) {
     Tensor *tensor = ir().getTensor(initId);
-    if (tensor->cacheInfo.isCached()) {
+    if (tensor->cacheInfo.isCached() && tensor->cacheInfo.isSharded()) {
+      shardedWeights.push_back(tensor);
+    }
+  }
+
+  CollectiveRearrangementPipeline pipeline(collectiveScratch,
+                                           shardedWeights.size());
+  std::vector<char *> shardBuffers(shardedWeights.size());
+
+  // Rearrange weights into the scratch buffer of weight i
+  auto rearrange = [&](std::size_t i) {
+    Tensor *tensor = shardedWeights[i];
+    auto cbr       = getCollectiveBalancedReorder(
+        getCacheArgTensorId(stripAllReservedPrefixes(tensor->id)));
+    cbr->prepareHostRearrangement();
+    auto elemSize   = cbr->getElementByteSize();
+    auto nelms      = cbr->getNumRearrangedTensorElems();
+    auto data0      = static_cast<const char *>(tensor->tensorData()->data());
+    auto tmp        = pipeline.buffer(i, nelms * elemSize);
+    shardBuffers[i] = tmp;
+    pipeline.submit(
+        i, [cbr, data0, tmp]() { cbr->rearrangeForCollective(data0, tmp); });
+  };
+
+  for (std::size_t i = 0; i < std::min(pipeline.depth(), shardBuffers.size());
+       ++i) {
+    rearrange(i);
+  }
+
+  // Copy the unsharded weights while the first rearrangements are made
+  for (auto initId : ir().getTensorIds(TensorType::Variable)) {
+    Tensor *tensor = ir().getTensor(initId);
+    if (tensor->cacheInfo.isCached() && !tensor->cacheInfo.isSharded()) {
       logging::devicex::debug("remoteBufferWeightsFromHost: {}", initId);
       auto remoteBufferInfo = tensor->cacheInfo.getRemoteBufferInfo();
-      char *data0           = static_cast<char *>(tensor->tensorData()->data());
-
-      if (tensor->cacheInfo.isSharded()) {
-        // Replicated weight sharding, each replica holds 1/repfactor
-        // parts of the weight
-        auto cbr = getCollectiveBalancedReorder(
-            getCacheArgTensorId(stripAllReservedPrefixes(tensor->id)));
-
-        auto elemSize = cbr->getElementByteSize();
-        auto nelms    = cbr->getNumRearrangedTensorElems();
-
-        // Temporary buffer that can hold the padded weight shards
-        // for all replicas
-        std::vector<char> tmp(nelms * elemSize);
-
-        // Rearrange weights into tmp buffer
-        cbr->rearrangeForCollective(data0, &tmp[0]);
-
-        for (unsigned replica_id = 0; replica_id < getReplicationFactor();
-             ++replica_id) {
-          // 1/repfactor weight shard to each replica
-          pEngine->copyToRemoteBuffer(
-              &tmp[replica_id * nelms / getReplicationFactor() * elemSize],
-              getRemoteBuffer(remoteBufferInfo.first).first,
-              static_cast<int>(remoteBufferInfo.second),
-              replica_id);
-        }
-      } else {
-        for (unsigned replica_id = 0; replica_id < getReplicationFactor();
-             ++replica_id) {
-          // Identical weights to each replica
-          pEngine->copyToRemoteBuffer(
-              data0,
-              getRemoteBuffer(remoteBufferInfo.first).first,
-              static_cast<int>(remoteBufferInfo.second),
-              replica_id);
-        }
+      char *data0 = static_cast<char *>(tensor->tensorData()->data());
+      for (unsigned replica_id = 0; replica_id < getReplicationFactor();
+           ++replica_id) {
+        // Identical weights to each replica
+        pEngine->copyToRemoteBuffer(
+            data0,
+            getRemoteBuffer(remoteBufferInfo.first).first,
+            static_cast<int>(remoteBufferInfo.second),
+            replica_id);
       }
     }
   }
+
+  for (std::size_t i = 0; i < shardedWeights.size(); ++i) {
+    Tensor *tensor = shardedWeights[i];
+    logging::devicex::debug("remoteBufferWeightsFromHost: {}", tensor->id);
+    auto remoteBufferInfo = tensor->cacheInfo.getRemoteBufferInfo();
+
+    // Replicated weight sharding, each replica holds 1/repfactor
+    // parts of the weight
+    auto cbr = getCollectiveBalancedReorder(
+        getCacheArgTensorId(stripAllReservedPrefixes(tensor->id)));
+
+    auto elemSize = cbr->getElementByteSize();
+    auto nelms    = cbr->getNumRearrangedTensorElems();
+
+    // Wait for the weights to be rearranged into the scratch buffer
+    pipeline.wait(i);
+    const char *tmp = shardBuffers[i];
+    for (unsigned replica_id = 0; replica_id < getReplicationFactor();
+         ++replica_id) {
+      // 1/repfactor weight shard to each replica
+      pEngine->copyToRemoteBuffer(
+          tmp + replica_id * nelms / getReplicationFactor() * elemSize,
+          getRemoteBuffer(remoteBufferInfo.first).first,
+          static_cast<int>(remoteBufferInfo.second),
+          replica_id);
+    }
+
+    // The scratch buffer of weight i is free for the next weight to use it
+    if (i + pipeline.depth() < shardedWeights.size()) {
+      rearrange(i + pipeline.depth());
+    }
+  }
 }
 
 void Devicex::optimizerFromHost() {
@@ -1021,6 +1301,23 @@ void Devicex::hostStreamToHost(const MutableVoidData &mv_data, TensorId id) {
   // display which tensors are being copied
   logging::devicex::debug("       {} {}", id, ir().getTensor(id)->info.shape());
 
+  // Weights are converted if the destination has a different type to the
+  // tensor, and the conversion is supported
+  auto srcType = ir().getTensor(id)->info.dataType();
+  auto dstType = mv_data.info.dataType();
+  if (srcType != dstType && hostconversion::canConvert(srcType, dstType)) {
+    int64_t nelms = ir().getTensor(id)->info.nelms();
+    if (nelms != mv_data.info.nelms()) {
+      throw error("number of elements of src ({}) and dst ({}) differ in "
+                  "hostStreamToHost for {}",
+                  nelms,
+                  mv_data.info.nelms(),
+                  id);
+    }
+    hostconversion::convert(srcType, src, dstType, dst, nelms);
+    return;
+  }
+
   // We confirm that the sizes of src and dst are the same
   if (nbytes_src != nbytes_dst) {
     std::stringstream errms;
@@ -1070,7 +1367,7 @@ void Devicex::run(IStepIO &stepio) {
   logging::devicex::debug("Performing one step: ");
 
   // Reconnect input streams.
-  reconnectInputStreams();
+  reconnectInputStreams(stepio);
 
   // Configure the inputstreams
   anchorsHostToHostStreams(stepio);
@@ -2172,14 +2469,32 @@ void Devicex::growOpx(Opx *opx, poplar::program::Sequence &seq) {
                           opx->op_p->str(),
                           opx->op_p->debugName());
 
+  auto &profiler = ir().getCompileProfiler();
+  CompileProfiler::Scope profile(profiler, "opx", opx->op_p->opid.type);
+  if (profiler.isEnabled()) {
+    profile.addArg("op", opx->op_p->debugName());
+    profile.addArg("graph", opx->op_p->getGraph().id.str());
+  }
+
+  // An instrumented Opx is grown into its own sequence, so that the cycle
+  // counter brackets only its programs
+  bool instrument = isInstrumentedOp(opx->op_p);
+  poplar::program::Sequence instrumented;
+  auto &opxSeq = instrument ? instrumented : seq;
+
   if (opxTrace) {
-    seq.add(poplar::program::PrintTensor(opx->op_p->str() + "/enter",
-                                         opxTraceTensor));
-    opx->grow(seq);
-    seq.add(poplar::program::PrintTensor(opx->op_p->str() + "/exit",
-                                         opxTraceTensor));
+    opxSeq.add(poplar::program::PrintTensor(opx->op_p->str() + "/enter",
+                                            opxTraceTensor));
+    opx->grow(opxSeq);
+    opxSeq.add(poplar::program::PrintTensor(opx->op_p->str() + "/exit",
+                                            opxTraceTensor));
   } else {
-    opx->grow(seq);
+    opx->grow(opxSeq);
+  }
+
+  if (instrument) {
+    instrumentOpWithHardwareCycleCounter(instrumented, opx->op_p);
+    seq.add(instrumented);
   }
 };
 
@@ -2566,6 +2881,10 @@ void Devicex::loadEngineAndConnectStreams() {
     }
   }
 
+  if (hostReduceEngine && !ir().useSyntheticData()) {
+    connectHostReduceEngineStreams();
+  }
+
   // Hardware cycle counter - connect stream even if synthetic data mode is
   // not off
   if (ir().getSessionOptions().instrumentWithHardwareCycleCounter) {
@@ -2573,14 +2892,68 @@ void Devicex::loadEngineAndConnectStreams() {
       pEngine->connectStream(cycleCountStreamId(kv.first),
                              static_cast<void *>(&kv.second));
     }
+    for (auto &kv : cycleTotals) {
+      pEngine->connectStream(cycleCountStreamId(kv.first),
+                             static_cast<void *>(kv.second.data()));
+    }
   }
 }
 
-void Devicex::reconnectInputStreams() {
+bool Devicex::canConnectZeroCopy(const Tensor *tensor,
+                                 const ConstVoidData &data) const {
+  if (data.data == nullptr) {
+    return false;
+  }
+
+  auto &dstInfo = tensor->info;
+  if (data.info.dataType() != dstInfo.dataType()) {
+    logging::devicex::debug("Not connecting {} zero-copy: type {} != {}",
+                            tensor->id,
+                            data.info.data_type(),
+                            dstInfo.data_type());
+    return false;
+  }
+
+  // The stream reads the buffer as a ring of whole tensors, so its size must
+  // be a non-zero multiple of the tensor size.
+  if (dstInfo.nbytes() == 0 || data.info.nbytes() == 0 ||
+      data.info.nbytes() % dstInfo.nbytes() != 0) {
+    logging::devicex::debug("Not connecting {} zero-copy: buffer of {} bytes "
+                            "is not a multiple of the tensor size {}",
+                            tensor->id,
+                            data.info.nbytes(),
+                            dstInfo.nbytes());
+    return false;
+  }
+
+  auto elementSize = dstInfo.getDataTypeInfo()->nbytes();
+  if (reinterpret_cast<std::uintptr_t>(data.data) % elementSize != 0) {
+    logging::devicex::debug("Not connecting {} zero-copy: buffer is not "
+                            "aligned to {} bytes",
+                            tensor->id,
+                            elementSize);
+    return false;
+  }
+
+  // With replication the data for each replica is interleaved in the buffer,
+  // which cannot be expressed as one contiguous ring per replica.
+  if (getReplicationFactor() > 1) {
+    logging::devicex::debug(
+        "Not connecting {} zero-copy: replicated graphs are not supported",
+        tensor->id);
+    return false;
+  }
+
+  return true;
+}
+
+void Devicex::reconnectInputStreams(IStepIO &stepio) {
   logging::devicex::debug(
       "Reconnecting input streams, invalidating prefetches.");
+  // The streams are connected by handle, as those of the engine of a cached
+  // executable are not in fromHostStreams
   auto engineToInputStreamWithCallback =
-      [&pEngine = pEngine, this](Tensor *tensor, poplar::DataStream &stream) {
+      [&pEngine = pEngine, this](Tensor *tensor, PopStreamId streamId) {
         auto replicationFactor = getReplicationFactor();
         for (auto replicationIndex = 0; replicationIndex < replicationFactor;
              ++replicationIndex) {
@@ -2588,15 +2961,40 @@ void Devicex::reconnectInputStreams() {
           auto callback = std::make_unique<PrefetchCallback>(
               this->inputStreams[tensor->id]);
           pEngine->connectStreamToCallback(
-              stream, replicationIndex, std::move(callback));
+              streamId, replicationIndex, std::move(callback));
         }
       };
 
+  // Connect the stream to the user's buffer, which poplar reads as a circular
+  // buffer, advancing by one tensor per transfer.
+  auto engineToInputStreamZeroCopy = [&pEngine = pEngine](
+                                         const ConstVoidData &data,
+                                         PopStreamId streamId) {
+    char *begin = static_cast<char *>(const_cast<void *>(data.data));
+    pEngine->connectStream(streamId, begin, begin + data.info.nbytes());
+  };
+
   for (Tensor *tensor : ir().dataStreamTensors()) {
     // The data stream for a tensor won't exist if using synthetic data, so
     // don't try and recreate them.
     if (!ir().useSyntheticData() && !tensor->cacheInfo.isCached()) {
-      engineToInputStreamWithCallback(tensor, fromHostStreams.at(tensor->id));
+      auto stream = h2dId(tensor->id);
+      auto data   = stepio.inZeroCopy(tensor->id, tensor->info.nelms());
+      // The stream reads a whole step from the buffer, which is not checked
+      // by the copying callbacks. As the buffer can differ between runs, the
+      // check is done on every run, not only on the first as in run(.)
+      if (data.data != nullptr && stepio.runtimeAssertsEnabled()) {
+        iosizecheck::assertInCorrect(
+            ir(),
+            std::map<TensorId, ConstVoidData>{{tensor->id, data}},
+            [](const ConstVoidData &d) { return d.info.nelms(); });
+      }
+      if (canConnectZeroCopy(tensor, data)) {
+        logging::devicex::trace("Connecting {} zero-copy", tensor->id);
+        engineToInputStreamZeroCopy(data, stream);
+      } else {
+        engineToInputStreamWithCallback(tensor, stream);
+      }
     }
   }
 }
@@ -2647,12 +3045,27 @@ void Devicex::prepareGraph() {
     return;
   }
 
+  CompileProfiler::Scope profile(
+      ir().getCompileProfiler(), "devicex", "Devicex::prepareGraph");
+
   logging::devicex::info("Poplar version: {}", poplar::versionString());
   logging::devicex::info("Poplar release githash: {}", poplar::packageHash());
 
   tryLoadExecutable();
   logging::devicex::info("Loaded executable");
 
+  if (ir().isPreparedFromSerialized()) {
+    // The restored Ir has no Ops to grow a graph from. The engine is created
+    // from the cached executable, and its streams are connected by handle
+    if (!cachedExecutable) {
+      throw error("The Ir was restored from the engine cache in '{}', but its "
+                  "poplar::Executable could not be loaded",
+                  ir().getSessionOptions().cachePath);
+    }
+    prepareGraphHasBeenCalled_ = true;
+    return;
+  }
+
   initPoplarGraph();
 
   logging::devicex::info("Poplar graph initialised");
@@ -2775,9 +3188,13 @@ void Devicex::prepareGraph() {
   logging::devicex::info("Turning Ops into Opxes");
 
   // create an Opx for every Op
-  for (Op *op : ir().getOpSchedule({})) {
-    logging::devicex::trace("Creating OPX for {}", op->debugName());
-    opxs[op->id] = createOpx(op);
+  {
+    CompileProfiler::Scope profileCreate(
+        ir().getCompileProfiler(), "devicex", "createOpx");
+    for (Op *op : ir().getOpSchedule({})) {
+      logging::devicex::trace("Creating OPX for {}", op->debugName());
+      opxs[op->id] = createOpx(op);
+    }
   }
 
   PriTasks tasks;
@@ -3159,6 +3576,12 @@ void Devicex::compileAndExport(const std::string &executablePath,
   if (executablePath.empty()) {
     return;
   }
+  if (ir().isPreparedFromSerialized()) {
+    throw error("The Ir was restored from the engine cache, so there is no "
+                "Poplar graph to export. Disable engine caching "
+                "(userOptions.enableEngineCaching = false) to export the "
+                "executable");
+  }
   try {
     // Regroup programs in 3 programs: HOST_TO_DEVICE / MAIN_SEQUENCE /
     // DEVICE_TO_HOST
@@ -3183,8 +3606,12 @@ void Devicex::compileAndExport(const std::string &executablePath,
     fusedProgs.push_back(fusedMain);
     fusedProgs.push_back(fusedD2h);
 
-    auto executable = poplar::compileGraph(
-        graph(), fusedProgs, engineOptions, progressLogger);
+    auto executable = [&]() {
+      CompileProfiler::Scope profile(
+          ir().getCompileProfiler(), "poplar", "poplar::compileGraph");
+      return poplar::compileGraph(
+          graph(), fusedProgs, engineOptions, progressLogger);
+    }();
     auto numIPUs = graph().getTarget().getNumIPUs();
     logging::devicex::info("Exporting compiled executable");
     exportExecutable(executable,
@@ -3194,6 +3621,10 @@ void Devicex::compileAndExport(const std::string &executablePath,
                      SavedInfo(*this).toString(),
                      numIPUs,
                      executablePath);
+
+    if (ir().getCompileProfiler().isEnabled()) {
+      ir().getCompileProfiler().write(ir().getSessionOptions().logDir);
+    }
   } catch (const poplar::graph_memory_allocation_error &e) {
     // If the creation of the engine throw an exception due to memory
     // allocation i.e. the program does not fit show graph profile and
@@ -3215,6 +3646,8 @@ void Devicex::prepare() {
   if (ir().getSessionOptions().compileEngine) {
     try {
       auto executable = getExecutable();
+      CompileProfiler::Scope profile(
+          ir().getCompileProfiler(), "poplar", "poplar::Engine");
       pEngine.reset(new poplar::Engine(std::move(executable), engineOptions));
     } catch (const poplar::graph_memory_allocation_error &e) {
       // If the creation of the engine throw an exception due to memory
@@ -3240,7 +3673,12 @@ void Devicex::prepare() {
                 oss.str());
   }
 
-  loadEngineAndConnectStreams();
+  {
+    CompileProfiler::Scope profile(ir().getCompileProfiler(),
+                                   "devicex",
+                                   "loadEngineAndConnectStreams");
+    loadEngineAndConnectStreams();
+  }
   logging::devicex::info("Loaded engine and connect streams");
 
   setRandomSeedFromHost(); // Stream random seed value by default (prog empty if
@@ -3252,6 +3690,10 @@ void Devicex::prepare() {
     optimizerFromHost();
   }
 
+  if (ir().getCompileProfiler().isEnabled()) {
+    ir().getCompileProfiler().write(ir().getSessionOptions().logDir);
+  }
+
   prepareHasBeenCalled_ = true;
 }
 
@@ -3302,8 +3744,12 @@ poplar::Executable Devicex::getExecutable() {
     try {
       logging::devicex::info("Starting Engine compilation");
 
-      auto executable = poplar::compileGraph(
-          graph(), progs.progs(), engineOptions, progressLogger);
+      auto executable = [this]() {
+        CompileProfiler::Scope profile(
+            ir().getCompileProfiler(), "poplar", "poplar::compileGraph");
+        return poplar::compileGraph(
+            graph(), progs.progs(), engineOptions, progressLogger);
+      }();
 
       logging::devicex::info("Graph compiled");
 
@@ -3324,34 +3770,116 @@ poplar::Executable Devicex::getExecutable() {
   }
 }
 
-std::string Devicex::getPoplarCachePath() {
-  return ir().getSessionOptions().cachePath + ".poplar";
+std::string Devicex::getEngineCacheKey() const {
+  return EngineCache::getKey(ir().getIrBundleHash());
 }
 
-std::string Devicex::getPopartCachePath() {
-  return ir().getSessionOptions().cachePath + ".popart";
+std::string Devicex::getPoplarCachePath() const {
+  EngineCache cache(ir().getSessionOptions().cachePath);
+  return cache.getPoplarPath(getEngineCacheKey());
 }
 
-void Devicex::trySaveExecutable(poplar::Executable &executable) {
+std::string Devicex::getPopartCachePath() const {
+  EngineCache cache(ir().getSessionOptions().cachePath);
+  return cache.getPopartPath(getEngineCacheKey());
+}
 
-  auto cachePath    = ir().getSessionOptions().cachePath;
-  auto cacheEnabled = ir().getSessionOptions().enableEngineCaching;
+std::unique_ptr<PendingExecutable>
+Devicex::loadCachedExecutableAsync(const IrBundle &bundle) {
+  if (!useEngineCache(bundle.userOptions, bundle.deviceInfo)) {
+    return nullptr;
+  }
 
-  if (cacheEnabled && !cachePath.empty() &&
-      deviceInfo->getType() == DeviceType::Ipu) {
-    // save the poplar executable
-    auto poplarCachePath = getPoplarCachePath();
-    std::ofstream poplarFs(poplarCachePath, std::ofstream::binary);
-    logging::devicex::debug("Saving poplar Executable to '{}'",
-                            poplarCachePath);
-    executable.serialize(poplarFs);
+  EngineCache cache(bundle.userOptions.cachePath);
+  auto irBundleHash    = std::hash<IrBundle>{}(bundle);
+  auto key             = EngineCache::getKey(irBundleHash);
+  auto popartCachePath = cache.getPopartPath(key);
+  std::ifstream popartFs(popartCachePath, std::ifstream::binary);
+  if (!popartFs.is_open()) {
+    logging::devicex::debug("No engine cache entry {} in '{}'",
+                            key,
+                            cache.getDirectory());
+    return nullptr;
+  }
 
-    // save the popart ir hash
-    auto popartCachePath = getPopartCachePath();
-    std::ofstream popartFs(popartCachePath, std::ofstream::binary);
-    logging::devicex::debug("Saving popart ir hash to '{}'", popartCachePath);
+  auto savedInfo = SavedInfo::deserialize(popartFs);
+  if (savedInfo.irBundleHash != irBundleHash) {
+    logging::devicex::debug("IrBundle hashes differ, not loading the cached "
+                            "poplar Executable before preparing the Ir");
+    return nullptr;
+  }
+
+  auto poplarCachePath = cache.getPoplarPath(key);
+  logging::devicex::debug("Loading poplar Executable from '{}' while the Ir "
+                          "is prepared",
+                          poplarCachePath);
+  auto pending    = std::make_unique<PendingExecutable>();
+  pending->irHash = savedInfo.irHash;
+
+  // The prepared Ir follows the hashes, see trySaveExecutable
+  pending->preparedIr.assign(std::istreambuf_iterator<char>(popartFs),
+                             std::istreambuf_iterator<char>());
+
+  // pending outlives the task, as its destructor waits for done
+  auto pendingPtr = pending.get();
+  auto load       = [pendingPtr, poplarCachePath]() {
+    std::ifstream poplarFs(poplarCachePath, std::ifstream::binary);
+    if (!poplarFs.is_open()) {
+      throw error("could not open file `{}'", poplarCachePath);
+    }
+    pendingPtr->executable.emplace(poplar::Executable::deserialize(poplarFs));
+  };
+  pending->done = ThreadPool::global().submit(load);
+  return pending;
+}
+
+bool PendingExecutable::wait() {
+  if (done.valid()) {
+    try {
+      done.get();
+    } catch (const std::exception &e) {
+      loadError = e.what();
+    }
+  }
+  return static_cast<bool>(executable);
+}
+
+void Devicex::setPendingExecutable(
+    std::unique_ptr<PendingExecutable> pending) {
+  pendingExecutable = std::move(pending);
+}
+
+void Devicex::trySaveExecutable(poplar::Executable &executable) {
+  const auto &opts = ir().getSessionOptions();
+
+  if (useEngineCache(opts, *deviceInfo)) {
+    EngineCache cache(opts.cachePath);
+    auto key = getEngineCacheKey();
+    logging::devicex::debug("Saving poplar Executable to '{}'",
+                            cache.getPoplarPath(key));
     SavedInfo savedInfo(*this);
-    savedInfo.serialize(popartFs);
+    auto writePopart = [this, &savedInfo](std::ostream &os) {
+      savedInfo.serialize(os);
+      if (ir().canSerializePrepared()) {
+        os << '\n';
+        ir().serializePrepared(os);
+      }
+    };
+    cache.store(
+        key,
+        [&executable](std::ostream &os) { executable.serialize(os); },
+        writePopart);
+
+    if (opts.engineCacheMaxBytes > 0) {
+      auto evicted = cache.prune(opts.engineCacheMaxBytes);
+      if (evicted > 0) {
+        logging::devicex::info("Evicted {} executables from the engine cache "
+                               "'{}' to keep it below {} bytes",
+                               evicted,
+                               cache.getDirectory(),
+                               opts.engineCacheMaxBytes);
+      }
+    }
   }
 }
 
@@ -3360,11 +3888,30 @@ void Devicex::tryLoadExecutable() {
     logging::devicex::warn("Unable to load cached poplar::Executable, {}", msg);
   };
 
-  auto cachePath    = ir().getSessionOptions().cachePath;
-  auto cacheEnabled = ir().getSessionOptions().enableEngineCaching;
+  const auto &opts = ir().getSessionOptions();
+  EngineCache cache(opts.cachePath);
+
+  if (pendingExecutable) {
+    // The executable has been loaded (or is being loaded) while the Ir was
+    // prepared, it can be used if the Ir is the one it was compiled from. A
+    // restored Ir has no Ops to hash, it was read from the same entry
+    auto pending = std::move(pendingExecutable);
+    if (!pending->wait()) {
+      warn(pending->loadError);
+    } else if (!ir().isPreparedFromSerialized() &&
+               pending->irHash != SavedInfo(*this).irHash) {
+      warn("ir hashes differ");
+    } else {
+      logging::devicex::debug("Using poplar Executable loaded from '{}'",
+                              getPoplarCachePath());
+      cachedExecutable.emplace(std::move(pending->executable.value()));
+      usingCachedExecutable = true;
+      cache.touch(getEngineCacheKey());
+    }
+    return;
+  }
 
-  if (cacheEnabled && !cachePath.empty() &&
-      deviceInfo->getType() == DeviceType::Ipu) {
+  if (useEngineCache(opts, *deviceInfo)) {
     // load the popart ir hash
     auto popartCachePath = getPopartCachePath();
     std::ifstream popartFs(popartCachePath, std::ifstream::binary);
@@ -3374,9 +3921,10 @@ void Devicex::tryLoadExecutable() {
         std::ifstream poplarFs(poplarCachePath, std::ifstream::binary);
         if (poplarFs.is_open()) {
           logging::devicex::debug("Loading poplar Executable from '{}'",
-                                  cachePath);
+                                  poplarCachePath);
           cachedExecutable.emplace(poplar::Executable::deserialize(poplarFs));
           usingCachedExecutable = true;
+          cache.touch(getEngineCacheKey());
         } else {
           warn(logging::format("could not open file `{}'", poplarCachePath));
         }
@@ -3805,7 +4353,7 @@ void Devicex::doProfileChecks() const {
     throw error("Unable to get reports when using a cached executable.\n"
                 "Either remove the cache file ({}), or \ndisable engine "
                 "caching (userOptions.enableEngineCaching = false)",
-                ir().getSessionOptions().cachePath);
+                getPoplarCachePath());
   }
 }
 
@@ -4060,6 +4608,47 @@ Devicex::getHostReduceRemoteBuffers() const {
   return hostReduceRemoteBuffers;
 }
 
+void Devicex::addHostReduceEngineGradient(TensorId gradId,
+                                          TensorInfo gradInfo,
+                                          unsigned nContributions) {
+  if (!hostReduceEngine) {
+    hostReduceEngine = std::make_unique<HostReduceEngine>(
+        getReplicationFactor(),
+        ir().getSessionOptions().hostAllReduceBucketSize,
+        ThreadPool::global());
+  }
+  hostReduceEngine->addGradient(gradId, gradInfo, nContributions);
+}
+
+void Devicex::connectHostReduceEngineStreams() {
+  logging::devicex::debug("Connecting HostReduceEngine streams");
+
+  auto engine = hostReduceEngine.get();
+  for (auto &id_stream : toHostGradientStreams) {
+    auto gradId = id_stream.first;
+    if (!engine->hasGradient(gradId)) {
+      continue;
+    }
+    logging::devicex::debug("   {}", gradId);
+
+    // Every replica streams its own gradient to the host
+    for (unsigned replica = 0; replica < getReplicationFactor(); ++replica) {
+      pEngine->connectStreamToCallback(
+          gradientStoreStreamId(gradId),
+          replica,
+          [engine, gradId, replica](void *g) {
+            engine->receive(gradId, replica, g);
+          });
+    }
+
+    // The sum is broadcast to all replicas
+    pEngine->connectStreamToCallback(
+        gradientLoadStreamId(gradId), 0, [engine, gradId](void *g) {
+          engine->send(gradId, g);
+        });
+  }
+}
+
 void Devicex::connectStreamToCallback(const std::string &streamHandle,
                                       std::function<void(void *)> callback,
                                       unsigned index) {
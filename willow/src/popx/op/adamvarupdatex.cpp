@@ -0,0 +1,263 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <popops/Collectives.hpp>
+#include <popops/ElementWise.hpp>
+#include <popops/Reduce.hpp>
+#include <popops/Zero.hpp>
+#include <popart/error.hpp>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op/adamvarupdate.hpp>
+#include <popart/popx/devicex.hpp>
+#include <popart/popx/op/adamvarupdatex.hpp>
+#include <popart/popx/opxmanager.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensors.hpp>
+
+namespace pe = popops::expr;
+
+namespace popart {
+namespace popx {
+
+namespace {
+// Append t to the operands of an expression, and return its placeholder
+std::unique_ptr<pe::Expr> addOperand(const poplar::Tensor &t,
+                                     std::vector<poplar::Tensor> &operands) {
+  operands.push_back(t);
+  return std::make_unique<pe::PlaceHolder>(
+      static_cast<unsigned>(operands.size()));
+}
+} // namespace
+
+AdamVarUpdateOpx::AdamVarUpdateOpx(Op *op, Devicex *devicex)
+    : VarUpdateOpx(op, devicex) {
+  verifyOp<AdamVarUpdateOp>(op, Onnx::CustomOperators::AdamVarUpdate);
+}
+
+std::unique_ptr<pe::Expr>
+AdamVarUpdateOpx::getScalar(const OptimizerValue &value,
+                            InIndex inIndex,
+                            std::vector<poplar::Tensor> &operands) const {
+  if (value.isConst()) {
+    return std::make_unique<pe::Const>(value.val());
+  }
+  return addOperand(getInTensor(inIndex), operands);
+}
+
+bool AdamVarUpdateOpx::isReplicaSharded() const {
+  const auto &tensors = op_p->getGraph().getTensors();
+  const auto &varId   = getOp<AdamVarUpdateOp>().getVarId();
+  return tensors.contains(varId) && tensors.get(varId)->cacheInfo.isSharded();
+}
+
+void AdamVarUpdateOpx::grow(poplar::program::Sequence &prog) const {
+
+  // see optimizer.hpp for the equations implemented here. All of the terms
+  // are computed in FLOAT, with each of the expressions below computing one
+  // Tensor in a single pass over the elements.
+
+  auto &adamOp = getOp<AdamVarUpdateOp>();
+
+  poplar::Tensor var = getInTensor(VarUpdateOp::getVarToUpdateInIndex());
+  poplar::Tensor grad =
+      getInTensor(VarUpdateWithUpdaterOp::getUpdaterInIndex());
+  poplar::Tensor accl1 = getInTensor(AdamVarUpdateOp::getAccl1InIndex());
+  poplar::Tensor accl2 = getInTensor(AdamVarUpdateOp::getAccl2InIndex());
+  poplar::Tensor step  = getInTensor(AdamVarUpdateOp::getStepInIndex());
+
+  const bool withWd =
+      !adamOp.initWd.isConst() || adamOp.initWd.val() != 0.0f;
+  const bool decoupledWd = adamOp.mode != AdamMode::Adam;
+  const bool withGs = !adamOp.initGs.isConst() || adamOp.initGs.val() != 1.0f;
+
+  // (1) the step count, and the bias corrections 1 - b^t
+  popops::mapInPlace(graph(),
+                     pe::Add(pe::_1, pe::Const(1.0f)),
+                     {step},
+                     prog,
+                     debugPrefix("step"));
+
+  auto getBiasCorrection = [this, &step, &prog](const OptimizerValue &beta,
+                                                InIndex index,
+                                                const std::string &name) {
+    std::vector<poplar::Tensor> operands{step};
+    auto b = getScalar(beta, index, operands);
+    return popops::map(graph(),
+                       pe::Sub(pe::Const(1.0f), pe::Pow(*b, pe::_1)),
+                       operands,
+                       prog,
+                       debugPrefix(name));
+  };
+  poplar::Tensor bc1 = getBiasCorrection(
+      adamOp.initB1, AdamVarUpdateOp::getBeta1InIndex(), "biasCorrection1");
+  poplar::Tensor bc2 = getBiasCorrection(
+      adamOp.initB2, AdamVarUpdateOp::getBeta2InIndex(), "biasCorrection2");
+
+  // The scaled gradient, with the weight decay term of AdamMode::Adam
+  auto getGradient = [&](std::vector<poplar::Tensor> &operands) {
+    auto g = addOperand(grad, operands);
+    std::unique_ptr<pe::Expr> gradient =
+        std::make_unique<pe::Cast>(*g, poplar::FLOAT);
+    if (withGs) {
+      auto gs =
+          getScalar(adamOp.initGs, AdamVarUpdateOp::getGsInIndex(), operands);
+      gradient = std::make_unique<pe::Mul>(*gradient, *gs);
+    }
+    if (withWd && !decoupledWd) {
+      auto w = addOperand(var, operands);
+      auto wd =
+          getScalar(adamOp.initWd, AdamVarUpdateOp::getWdInIndex(), operands);
+      gradient = std::make_unique<pe::Add>(
+          *gradient, pe::Mul(*wd, pe::Cast(*w, poplar::FLOAT)));
+    }
+    return gradient;
+  };
+
+  // (2) the first moment, m = b1 * m + (1 - b1) * g
+  {
+    std::vector<poplar::Tensor> operands{accl1};
+    auto gradient = getGradient(operands);
+    auto b1 =
+        getScalar(adamOp.initB1, AdamVarUpdateOp::getBeta1InIndex(), operands);
+    popops::mapInPlace(
+        graph(),
+        pe::Add(pe::Mul(*b1, pe::_1),
+                pe::Mul(pe::Sub(pe::Const(1.0f), *b1), *gradient)),
+        operands,
+        prog,
+        debugPrefix("firstMoment"));
+  }
+
+  // (3) the second moment, v = b2 * v + (1 - b2) * g^2
+  {
+    std::vector<poplar::Tensor> operands{accl2};
+    auto gradient = getGradient(operands);
+    auto b2 =
+        getScalar(adamOp.initB2, AdamVarUpdateOp::getBeta2InIndex(), operands);
+    popops::mapInPlace(
+        graph(),
+        pe::Add(pe::Mul(*b2, pe::_1),
+                pe::Mul(pe::Sub(pe::Const(1.0f), *b2), pe::Square(*gradient))),
+        operands,
+        prog,
+        debugPrefix("secondMoment"));
+  }
+
+  // The update u, with the decoupled weight decay term. w is the placeholder of
+  // the Variable Tensor, already in operands
+  auto getUpdate = [&](const pe::Expr &w,
+                       std::vector<poplar::Tensor> &operands) {
+    auto m  = addOperand(accl1, operands);
+    auto v  = addOperand(accl2, operands);
+    auto c1 = addOperand(bc1, operands);
+    auto c2 = addOperand(bc2, operands);
+    auto eps =
+        getScalar(adamOp.initEps, AdamVarUpdateOp::getEpsInIndex(), operands);
+    std::unique_ptr<pe::Expr> update = std::make_unique<pe::Divide>(
+        pe::Divide(*m, *c1), pe::Add(pe::Sqrt(pe::Divide(*v, *c2)), *eps));
+    if (withWd && decoupledWd) {
+      auto wd =
+          getScalar(adamOp.initWd, AdamVarUpdateOp::getWdInIndex(), operands);
+      update = std::make_unique<pe::Add>(
+          *update, pe::Mul(*wd, pe::Cast(w, poplar::FLOAT)));
+    }
+    return update;
+  };
+
+  // (4) the weight update, w = w - lr * r * u
+  if (adamOp.mode != AdamMode::Lamb) {
+    std::vector<poplar::Tensor> operands{var};
+    auto update = getUpdate(pe::_1, operands);
+    auto lr =
+        getScalar(adamOp.initLr, AdamVarUpdateOp::getLrInIndex(), operands);
+    popops::mapInPlace(graph(),
+                       pe::Cast(pe::Sub(pe::Cast(pe::_1, poplar::FLOAT),
+                                        pe::Mul(*lr, *update)),
+                                var.elementType()),
+                       operands,
+                       prog,
+                       debugPrefix("varUpdate"));
+  } else {
+    std::vector<poplar::Tensor> operands;
+    auto w              = addOperand(var, operands);
+    auto update         = getUpdate(*w, operands);
+    poplar::Tensor u    = popops::map(graph(),
+                                   *update,
+                                   operands,
+                                   prog,
+                                   debugPrefix("update"));
+
+    // The squared norms of w and u, reduced across replicas if the Variable
+    // Tensor is sharded
+    poplar::Tensor wNormSq = popops::reduce(graph(),
+                                            var.flatten(),
+                                            poplar::FLOAT,
+                                            {0},
+                                            {popops::Operation::SQUARE_ADD},
+                                            prog,
+                                            debugPrefix("weightNormSquared"));
+    poplar::Tensor uNormSq = popops::reduce(graph(),
+                                            u.flatten(),
+                                            poplar::FLOAT,
+                                            {0},
+                                            {popops::Operation::SQUARE_ADD},
+                                            prog,
+                                            debugPrefix("updateNormSquared"));
+    if (isReplicaSharded()) {
+      poplar::Tensor normsSq =
+          poplar::concat(wNormSq.reshape({1}), uNormSq.reshape({1}));
+      poplar::OptionFlags allReduceOptions = dv_p->gclOptions;
+      allReduceOptions.set("useReplicatedImplementation", "true");
+      normsSq = popops::replicatedAllReduce(graph(),
+                                            normsSq,
+                                            popops::Operation::ADD,
+                                            prog,
+                                            debugPrefix("normsAllReduce"),
+                                            allReduceOptions);
+      wNormSq = normsSq[0];
+      uNormSq = normsSq[1];
+    }
+
+    // The trust ratio, r = ||w|| / ||u||, or 1 if either norm is 0
+    poplar::Tensor ratio = popops::map(
+        graph(),
+        pe::Select(pe::Sqrt(pe::Divide(pe::_1, pe::_2)),
+                   pe::Const(1.0f),
+                   pe::And(pe::Gt(pe::_1, pe::Const(0.0f)),
+                           pe::Gt(pe::_2, pe::Const(0.0f)))),
+        {wNormSq, uNormSq},
+        prog,
+        debugPrefix("trustRatio"));
+
+    std::vector<poplar::Tensor> varOperands{var, u, ratio};
+    auto lr =
+        getScalar(adamOp.initLr, AdamVarUpdateOp::getLrInIndex(), varOperands);
+    popops::mapInPlace(
+        graph(),
+        pe::Cast(pe::Sub(pe::Cast(pe::_1, poplar::FLOAT),
+                         pe::Mul(pe::Mul(*lr, pe::_3), pe::_2)),
+                 var.elementType()),
+        varOperands,
+        prog,
+        debugPrefix("varUpdate"));
+  }
+
+  // (5) the accumulation Tensor is ready for the next micro batches
+  if (adamOp.resetUpdater) {
+    popops::zero(graph(), grad, prog, debugPrefix("resetAccl"));
+  }
+
+  if (hasInViewChangers(VarUpdateOp::getVarToUpdateInIndex())) {
+    setOutViewChangers(VarUpdateOp::getUpdatedVarOutIndex(),
+                       getInViewChangers(VarUpdateOp::getVarToUpdateInIndex()));
+  }
+  // output is a reference to the updated input
+  setOutTensor(VarUpdateOp::getUpdatedVarOutIndex(), var);
+}
+
+namespace {
+OpxCreator<AdamVarUpdateOpx>
+    adamVarUpdateOpxCreator(Onnx::CustomOperators::AdamVarUpdate);
+} // namespace
+
+} // namespace popx
+} // namespace popart
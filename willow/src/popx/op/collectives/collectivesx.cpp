@@ -203,9 +203,11 @@ poplar::Tensor CollectiveBalancedReorder::undoRearrangeForCollective(
   return concatResult;
 }
 
-void CollectiveBalancedReorder::rearrange(const char *in,
-                                          char *out,
-                                          bool forCollective) const {
+void CollectiveBalancedReorder::prepareHostRearrangement() const {
+  if (hostCopiesPrepared) {
+    return;
+  }
+
   auto reorder = reordering;
 
   // Sort by start offset in the original tensor
@@ -222,6 +224,7 @@ void CollectiveBalancedReorder::rearrange(const char *in,
   int64_t intervalIndex  = 0;
   int64_t intervalOffset = 0;
 
+  hostCopies.clear();
   for (auto &r : reorder) {
     if (r.offset > -1) {
       // Translate offset in the simplifed tensor (ostart) to offset in the
@@ -234,19 +237,9 @@ void CollectiveBalancedReorder::rearrange(const char *in,
         int64_t size =
             std::min(intervalSize - intervalOffset, r.size - copiedOffset);
 
-        int64_t inOff;
-        int64_t outOff;
-        if (forCollective) {
-          inOff  = (osstart + intervalOffset) * elemByteSize;
-          outOff = (r.rearranged_offset + copiedOffset) * elemByteSize;
-        } else {
-          outOff = (osstart + intervalOffset) * elemByteSize;
-          inOff  = (r.rearranged_offset + copiedOffset) * elemByteSize;
-        }
-
-        auto byteSize = size * elemByteSize;
-
-        std::memcpy(out + outOff, in + inOff, byteSize);
+        hostCopies.push_back({osstart + intervalOffset,
+                              r.rearranged_offset + copiedOffset,
+                              size});
 
         copiedOffset += size;
         intervalOffset += size;
@@ -258,6 +251,26 @@ void CollectiveBalancedReorder::rearrange(const char *in,
       }
     }
   }
+  hostCopiesPrepared = true;
+}
+
+void CollectiveBalancedReorder::rearrange(const char *in,
+                                          char *out,
+                                          bool forCollective) const {
+  prepareHostRearrangement();
+
+  for (auto &c : hostCopies) {
+    int64_t inOff;
+    int64_t outOff;
+    if (forCollective) {
+      inOff  = c.offset * elemByteSize;
+      outOff = c.rearrangedOffset * elemByteSize;
+    } else {
+      outOff = c.offset * elemByteSize;
+      inOff  = c.rearrangedOffset * elemByteSize;
+    }
+    std::memcpy(out + outOff, in + inOff, c.size * elemByteSize);
+  }
 }
 
 void CollectiveBalancedReorder::rearrangeForCollective(const char *in,
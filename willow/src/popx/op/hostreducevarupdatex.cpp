@@ -31,12 +31,26 @@ void GradCopyToHostOpx::grow(poplar::program::Sequence &prog) const {
 
   dv_p->getHostReduceStreamIds().emplace_back(deviceToHostStream.handle());
 
+  // With the HostReduceEngine the gradients of all replicas are summed on the
+  // host. If accumulation is enabled the replicatedAllReduce is run from
+  // SGD1AcclReduceOp, and the engine takes the gradient of replica 0.
+  const bool hostReduceEngine =
+      op_p->getIr().getSessionOptions().hostAllReduceEngine;
+  if (hostReduceEngine) {
+    dv_p->addHostReduceEngineGradient(grad_id,
+                                      inInfo(updater_index),
+                                      dv_p->getAccumulationFactor() == 1
+                                          ? dv_p->getReplicationFactor()
+                                          : 1);
+  }
+
   // TODO(T12685): Once replicatedReduceScatter is part of the Poplar
   // public API we can replace the replicatedAllReduce with it and
   // then do the AllGather on the host.
   // If accumulation is enabled then the replicatedAllReduce is run from
   // SGD1AcclReduceOp
-  if (dv_p->getReplicationFactor() > 1 && dv_p->getAccumulationFactor() == 1) {
+  if (!hostReduceEngine && dv_p->getReplicationFactor() > 1 &&
+      dv_p->getAccumulationFactor() == 1) {
     poplar::OptionFlags allReduceOptions = dv_p->gclOptions;
     allReduceOptions.set("useReplicatedImplementation", "true");
     weightDeltas = popops::replicatedAllReduce(graph(),
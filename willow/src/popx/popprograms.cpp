@@ -47,6 +47,13 @@ poplar::program::Sequence &PopPrograms::cycleCountTensorToHostFragment() {
   return seqs[static_cast<int>(ProgramFragmentIndex::CycleCountTensortoHost)];
 }
 
+const poplar::program::Sequence &PopPrograms::cycleCountResetFragment() const {
+  return seqs[static_cast<int>(ProgramFragmentIndex::CycleCountReset)];
+}
+poplar::program::Sequence &PopPrograms::cycleCountResetFragment() {
+  return seqs[static_cast<int>(ProgramFragmentIndex::CycleCountReset)];
+}
+
 const poplar::program::Sequence &PopPrograms::initFragment() const {
   return seqs[static_cast<int>(ProgramFragmentIndex::Init)];
 }
@@ -273,9 +280,24 @@ PopPrograms::getMainProgramFromPipelineFragments() const {
 
   std::map<PipelineStage, poplar::Function> fwdFunctions;
 
+  bool instrumentStages =
+      dv_p->ir().getSessionOptions().instrumentWithHardwareCycleCounter &&
+      dv_p->ir().getSessionOptions().hardwareInstrumentations.count(
+          Instrumentation::Stage) > 0;
+
   for (auto &stage_seq : pipelineSeqs.at(PipelineFragmentId::Forward)) {
-    fwdFunctions.insert(
-        {stage_seq.first, dv_p->graph().addFunction(stage_seq.second)});
+    if (instrumentStages) {
+      // The cycles of the stage are added up over all pipeline cycles
+      poplar::program::Sequence instrumented;
+      instrumented.add(stage_seq.second);
+      dv_p->instrumentPipelineStageWithHardwareCycleCounter(instrumented,
+                                                            stage_seq.first);
+      fwdFunctions.insert(
+          {stage_seq.first, dv_p->graph().addFunction(instrumented)});
+    } else {
+      fwdFunctions.insert(
+          {stage_seq.first, dv_p->graph().addFunction(stage_seq.second)});
+    }
   }
 
   poplar::program::Sequence fill;
@@ -381,7 +403,10 @@ poplar::program::Sequence PopPrograms::program() const {
     dv_p->instrumentWithHardwareCycleCounter(outer);
   }
 
-  return outer;
+  // The cycle count totals of Instrumentation::Op and Instrumentation::Stage
+  // are zeroed before each run. The reset fragment is only complete once the
+  // main program has been instrumented
+  return poplar::program::Sequence(cycleCountResetFragment(), outer);
 }
 
 poplar::program::Sequence PopPrograms::weightsToHost() const {
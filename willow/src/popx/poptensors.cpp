@@ -8,21 +8,30 @@ namespace popx {
 
 PopTensors::PopTensors(const Ir &ir_) : ir(ir_) {}
 
+TensorHandle PopTensors::intern(const TensorId &id) const {
+  return ir.getTensorIdInterner().intern(id);
+}
+
+TensorHandle PopTensors::find(const TensorId &id) const {
+  return ir.getTensorIdInterner().find(id);
+}
+
 void PopTensors::verify(TensorId id, const poplar::Tensor &pt) {
-  auto found             = tensors_.find(id);
-  auto foundViewChangers = viewChangers_.find(id);
+  auto handle            = find(id);
+  auto found             = tensors_.find(handle);
+  auto foundViewChangers = viewChangers_.find(handle);
 
   if (found != tensors_.end()) {
     throw internal_error("poplar::Tensor " + id + " already in map");
   }
 
-  if (!ir.containsTensor(id)) {
+  if (handle == unusedTensorHandle || !ir.containsTensor(handle)) {
     throw internal_error(
         "no tensor named {} in ir, is this a valid poplar::Tensor?", id);
   }
 
   // confirm shapes agree (up to squeezing out the extra 1s)
-  auto irTensor = ir.getTensor(id);
+  auto irTensor = ir.getTensor(handle);
 
   auto shape = foundViewChangers == viewChangers_.end()
                    ? pt.shape()
@@ -46,7 +55,7 @@ void PopTensors::verify(TensorId id, const poplar::Tensor &pt) {
   }
 
   // confirm types agree
-  auto expectedType = popType(ir.getTensor(id)->info);
+  auto expectedType = popType(irTensor->info);
   if (pt.elementType() != expectedType) {
     std::stringstream ss;
     ss << "poplar::Tensor " << id << " of unexpected Type. "
@@ -60,11 +69,12 @@ void PopTensors::verify(TensorId id, const poplar::Tensor &pt) {
 void PopTensors::insert(TensorId id, const poplar::Tensor &pt) {
   verify(id, pt);
 
-  tensors_[id] = std::make_shared<poplar::Tensor>(pt);
+  auto handle      = find(id);
+  tensors_[handle] = std::make_shared<poplar::Tensor>(pt);
 
-  auto foundViewChangers = viewChangers_.find(id);
+  auto foundViewChangers = viewChangers_.find(handle);
   if (foundViewChangers != viewChangers_.end()) {
-    views_[id] =
+    views_[handle] =
         std::make_shared<poplar::Tensor>(foundViewChangers->second->apply(pt));
   }
 }
@@ -74,43 +84,59 @@ bool PopTensors::canAlias(TensorId id) const {
 }
 
 void PopTensors::insertAliased(TensorId to, TensorId from) {
-  std::shared_ptr<poplar::Tensor> pt = tensors_.at(from);
-  auto foundView                     = views_.find(from);
+  auto fromHandle = find(from);
+  auto toHandle   = intern(to);
+
+  std::shared_ptr<poplar::Tensor> pt = tensors_.at(fromHandle);
+  auto foundView                     = views_.find(fromHandle);
   if (foundView != views_.end()) {
-    views_[to]        = foundView->second;
-    viewChangers_[to] = viewChangers_[from];
+    views_[toHandle]        = foundView->second;
+    viewChangers_[toHandle] = viewChangers_[fromHandle];
   }
   verify(to, *pt);
-  tensors_[to] = tensors_.at(from);
+  tensors_[toHandle] = pt;
 }
 
 void PopTensors::insertUnsafe(TensorId id, const poplar::Tensor &pt) {
-  auto found = tensors_.find(id);
+  auto handle = intern(id);
+  auto found  = tensors_.find(handle);
   if (found != tensors_.end()) {
     throw internal_error("poplar::Tensor " + id + " already in map");
   }
 
-  tensors_[id] = std::make_shared<poplar::Tensor>(pt);
+  tensors_[handle] = std::make_shared<poplar::Tensor>(pt);
 }
 
-bool PopTensors::contains(TensorId id) const {
-  return tensors_.find(id) != tensors_.end();
+bool PopTensors::contains(TensorId id) const { return contains(find(id)); }
+
+bool PopTensors::contains(TensorHandle handle) const {
+  return tensors_.find(handle) != tensors_.end();
 }
 
 const poplar::Tensor &PopTensors::get(TensorId id) const {
-  auto found = tensors_.find(id);
+  auto found = tensors_.find(find(id));
   if (found == tensors_.end()) {
     throw error("no poplar::Tensor " + id);
   }
   return *found->second;
 }
 
+const poplar::Tensor &PopTensors::get(TensorHandle handle) const {
+  auto found = tensors_.find(handle);
+  if (found == tensors_.end()) {
+    throw error("no poplar::Tensor " +
+                ir.getTensorIdInterner().getId(handle));
+  }
+  return *found->second;
+}
+
 const poplar::Tensor &PopTensors::getView(TensorId id) const {
-  auto found = tensors_.find(id);
+  auto handle = find(id);
+  auto found  = tensors_.find(handle);
   if (found == tensors_.end()) {
     throw error("no poplar::Tensor " + id);
   }
-  auto foundView = views_.find(id);
+  auto foundView = views_.find(handle);
   if (foundView == views_.end()) {
     return *found->second;
   } else {
@@ -119,12 +145,12 @@ const poplar::Tensor &PopTensors::getView(TensorId id) const {
 }
 
 bool PopTensors::hasViewChangers(TensorId id) const {
-  auto foundViewChangers = viewChangers_.find(id);
+  auto foundViewChangers = viewChangers_.find(find(id));
   return foundViewChangers != viewChangers_.end();
 }
 
 const ViewChangers &PopTensors::getViewChangers(TensorId id) {
-  auto foundViewChangers = viewChangers_.find(id);
+  auto foundViewChangers = viewChangers_.find(find(id));
   if (foundViewChangers == viewChangers_.end()) {
     throw error("no ViewChangers " + id);
   } else {
@@ -134,12 +160,17 @@ const ViewChangers &PopTensors::getViewChangers(TensorId id) {
 
 void PopTensors::setViewChangers(TensorId id,
                                  const ViewChangers &viewChangers) {
-  viewChangers_[id] = std::make_shared<ViewChangers>(viewChangers);
+  viewChangers_[intern(id)] = std::make_shared<ViewChangers>(viewChangers);
 }
 
-const std::map<TensorId, std::shared_ptr<poplar::Tensor>> &
+std::map<TensorId, std::shared_ptr<poplar::Tensor>>
 PopTensors::getTensors() const {
-  return tensors_;
+  std::map<TensorId, std::shared_ptr<poplar::Tensor>> tensors;
+  for (const auto &handle_tensor : tensors_) {
+    tensors.emplace(ir.getTensorIdInterner().getId(handle_tensor.first),
+                    handle_tensor.second);
+  }
+  return tensors;
 }
 
 } // namespace popx
@@ -1,4 +1,11 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <set>
+
 #include <popart/graph.hpp>
 #include <popart/intervals.hpp>
 #include <popart/ir.hpp>
@@ -10,6 +17,7 @@
 #include <popart/op/groupnorm.hpp>
 #include <popart/pbwrap.hpp>
 #include <popart/recompute.hpp>
+#include <popart/sessionoptions.hpp>
 #include <popart/tensor.hpp>
 #include <popart/tensornames.hpp>
 #include <popart/tensors.hpp>
@@ -32,6 +40,452 @@ void annotateNormOnly(Graph &graph) {
   }
 }
 
+// CheckpointSolver::minimiseCost splits the memory available to the
+// checkpoints into units, so that its tables have at most this many entries
+constexpr int64_t maxCheckpointTableSize = int64_t{1} << 18;
+constexpr int64_t minCheckpointUnits     = 16;
+// If a schedule has at most this many segments, every one of their sizes is
+// tried as the size of the largest segment
+constexpr int64_t maxExhaustiveSegments = 256;
+// The number of steps of the bisection of the price of memory in
+// CheckpointSolver::leastCostByPrice
+constexpr int priceIterations = 32;
+
+// Solves the problem of solveCheckpoints. The solver works on a schedule of
+// nodes, which are the Ops with an extra node at each end, both of which are
+// always checkpoints.
+//
+// For each size of the largest segment tried, the checkpoints are chosen
+// with dynamic programs over the schedule, in which the previous checkpoint
+// of each node is the best of a sliding window of nodes. The segments of the
+// chosen checkpoints may all be smaller than the size tried, in which case
+// their largest size is tried next.
+class CheckpointSolver {
+public:
+  CheckpointSolver(const std::vector<int64_t> &memory_,
+                   const std::vector<double> &cost_)
+      : nNodes(static_cast<int>(memory_.size()) + 2), memory(nNodes, 0),
+        cost(nNodes, 0.0), prefix(nNodes + 1, 0) {
+    std::copy(memory_.begin(), memory_.end(), memory.begin() + 1);
+    std::copy(cost_.begin(), cost_.end(), cost.begin() + 1);
+    for (int b = 0; b < nNodes; ++b) {
+      prefix[b + 1] = prefix[b] + memory[b];
+    }
+  }
+
+  // The checkpoints with the least predicted peak liveness, and of those the
+  // least recompute cost
+  CheckpointSolution minimisePeak() const {
+    CheckpointSolution best;
+    bool found = false;
+    std::set<int64_t> tried;
+    for (auto maxSegment : segmentCandidates()) {
+      while (tried.insert(maxSegment).second) {
+        int64_t largest;
+        auto solution = leastMemory(maxSegment, largest);
+        if (!found || solution.peakLiveness < best.peakLiveness ||
+            (solution.peakLiveness == best.peakLiveness &&
+             solution.recomputeCost < best.recomputeCost)) {
+          best  = std::move(solution);
+          found = true;
+        }
+        maxSegment = largest;
+      }
+    }
+    return best;
+  }
+
+  // The checkpoints with the least recompute cost whose predicted peak
+  // liveness is at most budget. Returns false if none were found, which may
+  // be because the memory of the checkpoints is rounded up to a unit of the
+  // budget.
+  bool minimiseCost(int64_t budget, CheckpointSolution &best) const {
+    bool found = false;
+    std::set<int64_t> tried;
+    for (auto maxSegment : segmentCandidates()) {
+      while (maxSegment <= budget && tried.insert(maxSegment).second) {
+        CheckpointSolution byUnits;
+        CheckpointSolution byPrice;
+        int64_t largestByUnits = 0;
+        int64_t largestByPrice = 0;
+        bool foundByUnits =
+            leastCostByUnits(maxSegment, budget, byUnits, largestByUnits);
+        bool foundByPrice =
+            leastCostByPrice(maxSegment, budget, byPrice, largestByPrice);
+        if (!foundByUnits && !foundByPrice) {
+          break;
+        }
+        if (!foundByUnits ||
+            (foundByPrice && byPrice.recomputeCost < byUnits.recomputeCost)) {
+          byUnits        = std::move(byPrice);
+          largestByUnits = largestByPrice;
+        }
+        if (!found || byUnits.recomputeCost < best.recomputeCost ||
+            (byUnits.recomputeCost == best.recomputeCost &&
+             byUnits.peakLiveness < best.peakLiveness)) {
+          best  = std::move(byUnits);
+          found = true;
+        }
+        maxSegment = largestByUnits;
+      }
+    }
+    return found;
+  }
+
+private:
+  // The checkpoints with the least memory whose segments hold at most
+  // maxSegment bytes. Sets largest to the size of their largest segment.
+  CheckpointSolution leastMemory(int64_t maxSegment, int64_t &largest) const {
+    auto starts = windowStarts(maxSegment);
+
+    // The least memory of the checkpoints up to and including each node, if
+    // it is a checkpoint. The window holds the nodes which may be the
+    // previous checkpoint, in increasing order of that memory.
+    std::vector<int64_t> least(nNodes, 0);
+    std::vector<int> parent(nNodes, 0);
+    std::deque<int> window;
+    for (int b = 1; b < nNodes; ++b) {
+      while (!window.empty() && least[window.back()] >= least[b - 1]) {
+        window.pop_back();
+      }
+      window.push_back(b - 1);
+      while (window.front() < starts[b]) {
+        window.pop_front();
+      }
+      parent[b] = window.front();
+      least[b]  = least[parent[b]] + memory[b];
+    }
+
+    return fromParents(parent, largest);
+  }
+
+  // The checkpoints with the least recompute cost whose segments hold at
+  // most maxSegment bytes, and whose predicted peak liveness is at most
+  // budget, found with a knapsack over units of the memory left to the
+  // checkpoints. Sets largest to the size of their largest segment. Returns
+  // false if there are none.
+  //
+  // This is exact if the units are bytes, but as the memory of each
+  // checkpoint is rounded up to a whole unit, it does poorly with many Ops
+  // smaller than a unit.
+  bool leastCostByUnits(int64_t maxSegment,
+                        int64_t budget,
+                        CheckpointSolution &solution,
+                        int64_t &largest) const {
+    const double unreachable = std::numeric_limits<double>::lowest();
+    const int64_t maxUnits =
+        std::max(maxCheckpointTableSize / nNodes, minCheckpointUnits);
+
+    const int64_t capacity = budget - maxSegment;
+    const int64_t unit =
+        std::max<int64_t>(1, (capacity + maxUnits - 1) / maxUnits);
+    const int nUnits = static_cast<int>(capacity / unit) + 1;
+
+    // The units of memory of each node, or nUnits if it may not be a
+    // checkpoint
+    std::vector<int> units(nNodes);
+    for (int b = 0; b < nNodes; ++b) {
+      units[b] = static_cast<int>(
+          std::min<int64_t>((memory[b] + unit - 1) / unit, nUnits));
+    }
+    auto starts = windowStarts(maxSegment);
+
+    // The greatest cost of the checkpoints up to and including node b, if it
+    // is a checkpoint, which use w units of memory, at b * nUnits + w. For
+    // each w, windows[w] holds the nodes which may be the previous
+    // checkpoint, in decreasing order of that cost.
+    std::vector<double> saved(nNodes * nUnits, unreachable);
+    std::vector<int> parent(nNodes * nUnits, 0);
+    std::vector<std::deque<int>> windows(nUnits);
+    saved[0] = 0.0;
+    for (int b = 1; b < nNodes; ++b) {
+      const int a = b - 1;
+      for (int w = 0; w < nUnits; ++w) {
+        const double value = saved[a * nUnits + w];
+        if (value == unreachable) {
+          continue;
+        }
+        auto &window = windows[w];
+        while (!window.empty() &&
+               saved[window.back() * nUnits + w] <= value) {
+          window.pop_back();
+        }
+        window.push_back(a);
+      }
+
+      for (int w = units[b]; w < nUnits; ++w) {
+        auto &window = windows[w - units[b]];
+        while (!window.empty() && window.front() < starts[b]) {
+          window.pop_front();
+        }
+        if (!window.empty()) {
+          const int from = window.front();
+          saved[b * nUnits + w] =
+              saved[from * nUnits + w - units[b]] + cost[b];
+          parent[b * nUnits + w] = from;
+        }
+      }
+    }
+
+    const int end = nNodes - 1;
+    int bestUnits = -1;
+    for (int w = 0; w < nUnits; ++w) {
+      if (saved[end * nUnits + w] != unreachable &&
+          (bestUnits < 0 ||
+           saved[end * nUnits + w] > saved[end * nUnits + bestUnits])) {
+        bestUnits = w;
+      }
+    }
+    if (bestUnits < 0) {
+      return false;
+    }
+
+    std::vector<int> nodeParent(nNodes, 0);
+    for (int b = end, w = bestUnits; b > 0;) {
+      const int a   = parent[b * nUnits + w];
+      nodeParent[b] = a;
+      w -= units[b];
+      b = a;
+    }
+    solution = fromParents(nodeParent, largest);
+    return true;
+  }
+
+  // The checkpoints with the least recompute cost whose segments hold at
+  // most maxSegment bytes, and whose predicted peak liveness is at most
+  // budget, found by a Lagrangian relaxation of the budget: the checkpoints
+  // which save the most cost, less a price for each byte of their memory,
+  // are chosen with the least price which keeps them within the budget. Sets
+  // largest to the size of their largest segment. Returns false if there are
+  // none.
+  //
+  // This is not always exact, but is as good with small Ops as large ones.
+  bool leastCostByPrice(int64_t maxSegment,
+                        int64_t budget,
+                        CheckpointSolution &solution,
+                        int64_t &largest) const {
+    const int64_t capacity = budget - maxSegment;
+    auto starts            = windowStarts(maxSegment);
+
+    // The checkpoints which save the most cost, less price for each byte.
+    // Sets checkpointMemory to their memory.
+    std::vector<int> parent(nNodes, 0);
+    auto choose = [&](double price, int64_t &checkpointMemory) {
+      // The most saved up to and including each node, if it is a checkpoint,
+      // and the memory of those checkpoints. The window holds the nodes
+      // which may be the previous checkpoint, in decreasing order of saving.
+      std::vector<double> saved(nNodes, 0.0);
+      std::vector<int64_t> used(nNodes, 0);
+      std::deque<int> window;
+      for (int b = 1; b < nNodes; ++b) {
+        while (!window.empty() && saved[window.back()] <= saved[b - 1]) {
+          window.pop_back();
+        }
+        window.push_back(b - 1);
+        while (window.front() < starts[b]) {
+          window.pop_front();
+        }
+        parent[b] = window.front();
+        saved[b]  = saved[parent[b]] + cost[b] - price * memory[b];
+        used[b]   = used[parent[b]] + memory[b];
+      }
+      checkpointMemory = used[nNodes - 1];
+    };
+
+    int64_t checkpointMemory;
+    bool found = false;
+    auto consider = [&]() {
+      if (checkpointMemory > capacity) {
+        return;
+      }
+      int64_t candidateLargest;
+      auto candidate = fromParents(parent, candidateLargest);
+      if (!found || candidate.recomputeCost < solution.recomputeCost) {
+        solution = std::move(candidate);
+        largest  = candidateLargest;
+        found    = true;
+      }
+    };
+
+    // With no price every Op is a checkpoint, and with a price above the
+    // cost per byte of every Op, the checkpoints have the least memory
+    double low  = 0.0;
+    double high = 1.0;
+    for (int b = 1; b < nNodes - 1; ++b) {
+      if (memory[b] > 0) {
+        high = std::max(high, 2.0 * cost[b] / memory[b]);
+      }
+    }
+    choose(low, checkpointMemory);
+    consider();
+    if (found) {
+      return true;
+    }
+    choose(high, checkpointMemory);
+    consider();
+    if (!found) {
+      return false;
+    }
+    for (int i = 0; i < priceIterations; ++i) {
+      const double price = 0.5 * (low + high);
+      choose(price, checkpointMemory);
+      consider();
+      if (checkpointMemory > capacity) {
+        low = price;
+      } else {
+        high = price;
+      }
+    }
+    return true;
+  }
+
+  // The sizes of the largest segment to try, in increasing order. These are
+  // the sizes of all possible segments, if there are few enough of them, or
+  // else sizes evenly spaced between no memory and the memory of every Op,
+  // and geometrically spaced from the smallest memory of an Op, for
+  // schedules of many small Ops.
+  std::vector<int64_t> segmentCandidates() const {
+    const int64_t total = prefix.back();
+    std::set<int64_t> candidates{0, total};
+
+    const int64_t nOps = nNodes - 2;
+    if (nOps * (nOps + 1) / 2 <= maxExhaustiveSegments) {
+      for (int a = 1; a < nNodes - 1; ++a) {
+        for (int b = a + 1; b < nNodes; ++b) {
+          candidates.insert(prefix[b] - prefix[a]);
+        }
+      }
+      return {candidates.begin(), candidates.end()};
+    }
+
+    for (int64_t k = 1; k < 16; ++k) {
+      candidates.insert(total / 16 * k);
+    }
+    int64_t smallest = total;
+    for (auto m : memory) {
+      if (m > 0) {
+        smallest = std::min(smallest, m);
+      }
+    }
+    for (double s = static_cast<double>(smallest); s < total;
+         s *= std::sqrt(2.0)) {
+      candidates.insert(static_cast<int64_t>(s));
+    }
+    return {candidates.begin(), candidates.end()};
+  }
+
+  // For each node b, the first node which may be the checkpoint before b if
+  // no segment holds more than maxSegment bytes. Nodes a + 1 to b - 1 are
+  // the segment between checkpoints a and b.
+  std::vector<int> windowStarts(int64_t maxSegment) const {
+    std::vector<int> starts(nNodes, 0);
+    int a = 0;
+    for (int b = 1; b < nNodes; ++b) {
+      while (prefix[b] - prefix[a + 1] > maxSegment) {
+        ++a;
+      }
+      starts[b] = a;
+    }
+    return starts;
+  }
+
+  // The solution whose checkpoints are the nodes on the chain of parents from
+  // the final node. Sets largest to the size of its largest segment.
+  CheckpointSolution fromParents(const std::vector<int> &parent,
+                                 int64_t &largest) const {
+    CheckpointSolution solution;
+    solution.checkpoint.assign(nNodes - 2, false);
+    int64_t checkpointMemory = 0;
+    largest                  = 0;
+    for (int b = nNodes - 1; b > 0; b = parent[b]) {
+      const int a = parent[b];
+      largest     = std::max(largest, prefix[b] - prefix[a + 1]);
+      if (a > 0) {
+        solution.checkpoint[a - 1] = true;
+        checkpointMemory += memory[a];
+      }
+    }
+    solution.peakLiveness  = checkpointMemory + largest;
+    solution.recomputeCost = 0.0;
+    for (int b = 1; b < nNodes - 1; ++b) {
+      if (!solution.checkpoint[b - 1]) {
+        solution.recomputeCost += cost[b];
+      }
+    }
+    return solution;
+  }
+
+  const int nNodes;
+  std::vector<int64_t> memory;
+  std::vector<double> cost;
+  // prefix[b] is the memory of the nodes before b
+  std::vector<int64_t> prefix;
+};
+
+// An estimate of the cost of recomputing an Op: the number of elements it
+// reads and writes, weighted by its outlining value, which is high for Ops
+// doing a lot of work per element, such as convolutions, and low for
+// elementwise Ops.
+double estimateComputeCost(const Op *op) {
+  int64_t elements = 0;
+  for (auto &index_tensor : op->input->tensorMap()) {
+    elements += index_tensor.second->info.nelms();
+  }
+  for (auto &index_tensor : op->output->tensorMap()) {
+    elements += index_tensor.second->info.nelms();
+  }
+  float value = std::max(op->getSubgraphValue(), op->getLowSubgraphValue());
+  return static_cast<double>(elements) * value;
+}
+
+void annotateCheckpointSolver(const Graph &graph) {
+  std::vector<Op *> fwdOps;
+  for (auto op : graph.getOpSchedule({})) {
+    if (op->toLoss == PathToLoss::Yes) {
+      fwdOps.push_back(op);
+    }
+  }
+
+  std::vector<int64_t> memory;
+  std::vector<double> cost;
+  memory.reserve(fwdOps.size());
+  cost.reserve(fwdOps.size());
+  for (auto op : fwdOps) {
+    memory.push_back(op->memOfOutputs());
+    cost.push_back(estimateComputeCost(op));
+  }
+
+  auto &opts    = graph.getIr().getSessionOptions();
+  auto budget   = opts.autoRecomputationMemoryBudget;
+  auto solution = solveCheckpoints(memory, cost, budget);
+
+  int64_t nRecomputed = 0;
+  double totalCost    = 0.0;
+  for (size_t i = 0; i < fwdOps.size(); ++i) {
+    totalCost += cost[i];
+    if (!solution.checkpoint[i]) {
+      fwdOps[i]->settings.recomputeType = RecomputeType::Recompute;
+      ++nRecomputed;
+    }
+  }
+
+  // Without recomputation, the outputs of every forward Op are live until the
+  // backward pass
+  int64_t peakWithout =
+      std::accumulate(memory.begin(), memory.end(), int64_t{0});
+  logging::transform::info(
+      "Checkpoint solver: predicted peak activation liveness of {} bytes "
+      "without recomputation and {} bytes with it (budget {}), recomputing "
+      "{} of {} forward Ops at an estimated cost of {} of {}",
+      peakWithout,
+      solution.peakLiveness,
+      budget > 0 ? std::to_string(budget) + " bytes" : "none",
+      nRecomputed,
+      fwdOps.size(),
+      solution.recomputeCost,
+      totalCost);
+}
+
 void annotateStandard(const Graph &graph) {
   std::vector<Op *> fwdOps;
   for (auto op : graph.getOpSchedule({})) {
@@ -122,6 +576,45 @@ void annotateStandard(const Graph &graph) {
 
 } // namespace
 
+CheckpointSolution solveCheckpoints(const std::vector<int64_t> &memory,
+                                    const std::vector<double> &cost,
+                                    int64_t memoryBudget) {
+  if (memory.size() != cost.size()) {
+    throw internal_error("{} Op memories but {} Op costs in solveCheckpoints",
+                         memory.size(),
+                         cost.size());
+  }
+  for (size_t i = 0; i < memory.size(); ++i) {
+    if (memory[i] < 0 || cost[i] < 0.0) {
+      throw internal_error("Negative memory {} or cost {} of Op {} in "
+                           "solveCheckpoints",
+                           memory[i],
+                           cost[i],
+                           i);
+    }
+  }
+
+  CheckpointSolver solver(memory, cost);
+  auto leastPeak = solver.minimisePeak();
+  if (memoryBudget <= 0) {
+    memoryBudget = leastPeak.peakLiveness;
+  } else if (memoryBudget < leastPeak.peakLiveness) {
+    logging::transform::warn(
+        "The recomputation memory budget of {} bytes is less than the least "
+        "predicted peak liveness, {} bytes, which will be used instead",
+        memoryBudget,
+        leastPeak.peakLiveness);
+    return leastPeak;
+  }
+
+  CheckpointSolution leastCost;
+  if (solver.minimiseCost(memoryBudget, leastCost) &&
+      leastCost.recomputeCost < leastPeak.recomputeCost) {
+    return leastCost;
+  }
+  return leastPeak;
+}
+
 void autoAnnotate(Graph &graph, RecomputationType rctype) {
 
   switch (rctype) {
@@ -140,6 +633,11 @@ void autoAnnotate(Graph &graph, RecomputationType rctype) {
     annotateNormOnly(graph);
     break;
   }
+  case RecomputationType::CheckpointSolver: {
+    logging::transform::info("Using 'CheckpointSolver' auto-recompute method");
+    annotateCheckpointSolver(graph);
+    break;
+  }
 
   case RecomputationType::N:
   case RecomputationType::Pipeline:
@@ -1,104 +1,273 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
+#include <algorithm>
 #include <utility>
 
 #include <popart/error.hpp>
 #include <popart/region.hpp>
 #include <popart/util.hpp>
 
-#include <boost/range/algorithm.hpp>
-
 namespace popart {
 namespace view {
 
-AccessType combine(std::set<AccessType> accessTypes) {
-  int accessTypeMask = 0;
-  for (auto accessType : accessTypes) {
-    accessTypeMask |= static_cast<int>(accessType);
+Bounds::Bounds(size_t n_, int64_t value) : n(n_) {
+  if (n > inlineRank) {
+    heap.assign(n, value);
+  } else {
+    std::fill(local.begin(), local.begin() + n, value);
   }
-  return static_cast<AccessType>(accessTypeMask);
 }
 
-// Merge in approx. O(rank * 2 * n log^2 n)
-Regions mergeRegions(Regions regions) {
+Bounds::Bounds(std::initializer_list<int64_t> values) : n(values.size()) {
+  if (n > inlineRank) {
+    heap.assign(values.begin(), values.end());
+  } else {
+    std::copy(values.begin(), values.end(), local.begin());
+  }
+}
 
-  AccessType accessType = AccessType::None;
-  for (Region &r : regions) {
-    accessType = combine({r.getAccessType(), accessType});
+Bounds::Bounds(const std::vector<int64_t> &values) : n(values.size()) {
+  if (n > inlineRank) {
+    heap = values;
+  } else {
+    std::copy(values.begin(), values.end(), local.begin());
   }
+}
 
-  bool unchanged = false;
-  if (regions.size() > 0) {
-    Regions subRegions;
+Bounds::Bounds(Bounds &&rhs) noexcept
+    : n(rhs.n), local(rhs.local), heap(std::move(rhs.heap)) {
+  rhs.n = 0;
+}
 
-    while (!unchanged) {
-      unchanged = true;
+Bounds &Bounds::operator=(Bounds &&rhs) noexcept {
+  n     = rhs.n;
+  local = rhs.local;
+  heap  = std::move(rhs.heap);
+  rhs.n = 0;
+  return *this;
+}
 
-      auto rank = regions.front().rank();
+int64_t Bounds::at(size_t i) const {
+  if (i >= n) {
+    throw error("Index {} out of range for Bounds of size {}", i, n);
+  }
+  return data()[i];
+}
 
-      for (int64_t d = 0; d < rank; ++d) {
-        regions.insert(regions.end(), subRegions.begin(), subRegions.end());
-        subRegions.clear();
-        auto last_size = regions.size();
+bool Bounds::operator==(const Bounds &rhs) const {
+  return n == rhs.n && std::equal(begin(), end(), rhs.begin());
+}
 
-        std::sort(regions.begin(),
-                  regions.end(),
-                  [d](const view::Region &a, const view::Region &b) -> bool {
-                    return a.getLower()[d] < b.getLower()[d];
-                  });
+bool Bounds::operator<(const Bounds &rhs) const {
+  return std::lexicographical_compare(begin(), end(), rhs.begin(), rhs.end());
+}
 
-        std::vector<bool> erase(regions.size(), false);
+std::ostream &operator<<(std::ostream &os, const Bounds &bounds) {
+  appendSequence(os, bounds);
+  return os;
+}
 
-        int64_t jstart = 0;
-        for (int64_t i = 0; i < regions.size(); ++i) {
-          if (regions[i].isEmpty())
-            erase[i] = true;
-          if (erase[i]) {
-            continue;
-          }
-          // Using jstart brings down worst-case complexity to less than N**2
-          for (int64_t j = std::max(i + 1, jstart); j < regions.size(); ++j) {
-            if (erase[j]) {
-              continue;
+namespace {
+
+// Orders Regions by their lower bounds, then by their upper bounds
+bool regionLess(const Region &a, const Region &b) {
+  if (a.getLower() != b.getLower()) {
+    return a.getLower() < b.getLower();
+  }
+  return a.getUpper() < b.getUpper();
+}
+
+// The non-empty Regions of a set, sorted by their lower bound in dimension 0,
+// with the running maximum of their upper bounds in dimension 0. This is an
+// interval tree flattened into arrays: the Regions overlapping a query in
+// dimension 0 are found with a binary search on the lower bounds, followed by
+// a scan back which stops once the maximum upper bound is below the query.
+class RegionIndex {
+public:
+  explicit RegionIndex(const Regions &regions) {
+    for (const auto &r : regions) {
+      if (!r.isEmpty()) {
+        sorted.push_back(&r);
+      }
+    }
+    if (!sorted.empty() && sorted.front()->rank() > 0) {
+      std::sort(sorted.begin(),
+                sorted.end(),
+                [](const Region *a, const Region *b) {
+                  return a->getLower()[0] < b->getLower()[0];
+                });
+      maxUpper.reserve(sorted.size());
+      for (auto r : sorted) {
+        maxUpper.push_back(maxUpper.empty()
+                               ? r->getUpper()[0]
+                               : std::max(maxUpper.back(), r->getUpper()[0]));
+      }
+    }
+  }
+
+  // The first indexed Region which intersects r, or nullptr
+  const Region *findOverlap(const Region &r) const {
+    if (r.isEmpty() || sorted.empty()) {
+      return nullptr;
+    }
+    if (r.rank() != sorted.front()->rank()) {
+      // throws
+      sorted.front()->overlaps(r);
+    }
+    if (maxUpper.empty()) {
+      // rank 0, all non-empty Regions overlap
+      return sorted.front();
+    }
+
+    // The Regions starting before the end of r in dimension 0
+    auto end = std::lower_bound(sorted.begin(),
+                                sorted.end(),
+                                r.getUpper()[0],
+                                [](const Region *a, int64_t upper) {
+                                  return a->getLower()[0] < upper;
+                                });
+    for (auto i = std::distance(sorted.begin(), end); i > 0; --i) {
+      if (maxUpper[i - 1] <= r.getLower()[0]) {
+        // none of the Regions before i end after the start of r
+        break;
+      }
+      if (sorted[i - 1]->overlaps(r)) {
+        return sorted[i - 1];
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  std::vector<const Region *> sorted;
+  std::vector<int64_t> maxUpper;
+};
+
+// Merges disjoint Regions which are adjacent in one dimension and equal in
+// all others, until no more can be merged. Unlike mergeRegions, which also
+// has to resolve overlaps, this is O(rank * n log n) per pass.
+Regions coalesceDisjoint(Regions regions) {
+  if (regions.empty()) {
+    return regions;
+  }
+  const int64_t rank = regions.front().rank();
+  bool changed       = true;
+  while (changed) {
+    changed = false;
+    for (int64_t d = rank - 1; d >= 0; --d) {
+      // Sort on the bounds in all dimensions other than d, then on d
+      auto less = [d, rank](const Region &a, const Region &b) {
+        for (int64_t i = 0; i < rank; ++i) {
+          if (i != d) {
+            if (a.getLower()[i] != b.getLower()[i]) {
+              return a.getLower()[i] < b.getLower()[i];
             }
-            if (regions[i].getLower()[d] == regions[j].getLower()[d] &&
-                regions[i].getUpper()[d] == regions[j].getUpper()[d]) {
-              // if i and j fully overlap, any region in [i, j] does not have
-              // to check for merges with any other region in [i, j], so we can
-              // set the next j to j + 1
-              jstart = j + 1;
-              continue;
-            } else if (regions[i].getUpper()[d] < regions[j].getLower()[d]) {
-              // j and any region after j are not connected to i and therefore
-              // can't be merged in d, advance to next i
-              break;
-            } else {
-              // Try merge
-              auto merged = regions[i].merge(regions[j]);
-              if (merged.first == d) {
-                regions[i] = merged.second;
-                erase[j]   = true;
-              } else {
-                // Try subtraction
-                auto subs = regions[j].sub(regions[i]);
-                if (subs.size() > 0 && subs.front() != regions[j]) {
-                  subRegions.insert(subRegions.end(), subs.begin(), subs.end());
-                  erase[j] = true;
-                }
-              }
+            if (a.getUpper()[i] != b.getUpper()[i]) {
+              return a.getUpper()[i] < b.getUpper()[i];
             }
           }
         }
+        return a.getLower()[d] < b.getLower()[d];
+      };
+      auto adjacent = [d, rank](const Region &a, const Region &b) {
+        for (int64_t i = 0; i < rank; ++i) {
+          if (i != d && (a.getLower()[i] != b.getLower()[i] ||
+                         a.getUpper()[i] != b.getUpper()[i])) {
+            return false;
+          }
+        }
+        return a.getUpper()[d] == b.getLower()[d];
+      };
+      std::sort(regions.begin(), regions.end(), less);
+
+      Regions merged;
+      merged.reserve(regions.size());
+      for (auto &r : regions) {
+        if (!merged.empty() && adjacent(merged.back(), r)) {
+          Bounds upper = merged.back().getUpper();
+          upper[d]     = r.getUpper()[d];
+          merged.back() =
+              Region(merged.back().getLower(), upper, r.getAccessType());
+          changed = true;
+        } else {
+          merged.push_back(std::move(r));
+        }
+      }
+      regions = std::move(merged);
+    }
+  }
+  std::sort(regions.begin(), regions.end(), regionLess);
+  return regions;
+}
 
-        regions.erase(std::remove_if(regions.begin(),
-                                     regions.end(),
-                                     [&erase, &regions](Region const &i) {
-                                       return erase.at(&i - regions.data());
-                                     }),
-                      regions.end());
+} // namespace
 
-        unchanged &= (last_size == regions.size() && subRegions.size() == 0);
+bool overlaps(const Regions &lhs, const Regions &rhs) {
+  // Testing all pairs is faster for a few Regions
+  if (lhs.size() * rhs.size() <= 16) {
+    for (const auto &r0 : lhs) {
+      for (const auto &r1 : rhs) {
+        if (r0.overlaps(r1)) {
+          return true;
+        }
       }
     }
+    return false;
+  }
+
+  const bool indexLhs = lhs.size() < rhs.size();
+  RegionIndex index(indexLhs ? lhs : rhs);
+  for (const auto &r : indexLhs ? rhs : lhs) {
+    if (index.findOverlap(r)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+AccessType combine(std::set<AccessType> accessTypes) {
+  int accessTypeMask = 0;
+  for (auto accessType : accessTypes) {
+    accessTypeMask |= static_cast<int>(accessType);
+  }
+  return static_cast<AccessType>(accessTypeMask);
+}
+
+// Each Region keeps only its parts which are not in the Regions before it,
+// then adjacent parts are merged. If the union is a box, it is returned as a
+// single Region.
+Regions mergeRegions(Regions regions) {
+
+  AccessType accessType = AccessType::None;
+  for (Region &r : regions) {
+    accessType = combine({r.getAccessType(), accessType});
+  }
+
+  Regions disjoint;
+  for (const Region &r : regions) {
+    if (!r.isEmpty()) {
+      auto parts = disjoint.empty() ? Regions{r} : r.sub(disjoint);
+      disjoint.insert(disjoint.end(), parts.begin(), parts.end());
+    }
+  }
+  regions = coalesceDisjoint(disjoint);
+
+  if (regions.size() > 1) {
+    // The parts are disjoint, so they fill their bounding box if the numbers
+    // of elements agree
+    Bounds lower  = regions.front().getLower();
+    Bounds upper  = regions.front().getUpper();
+    int64_t nelms = 0;
+    for (const Region &r : regions) {
+      for (int64_t d = 0; d < r.rank(); ++d) {
+        lower[d] = std::min(lower[d], r.getLower()[d]);
+        upper[d] = std::max(upper[d], r.getUpper()[d]);
+      }
+      nelms += r.nelms();
+    }
+    Region box(lower, upper);
+    if (box.nelms() == nelms) {
+      regions = {box};
+    }
   }
 
   for (Region &r : regions) {
@@ -114,18 +283,13 @@ bool Region::operator==(const Region &r) const {
 
 bool Region::operator!=(const Region &r) const { return !(r == *this); }
 
-Region::Region(const std::vector<int64_t> &l, const std::vector<int64_t> &u)
+Region::Region(const Bounds &l, const Bounds &u)
     : Region(l, u, AccessType::ReadWrite, false) {}
 
-Region::Region(const std::vector<int64_t> &l,
-               const std::vector<int64_t> &u,
-               const AccessType at)
+Region::Region(const Bounds &l, const Bounds &u, const AccessType at)
     : Region(l, u, at, false) {}
 
-Region::Region(const std::vector<int64_t> &l,
-               const std::vector<int64_t> &u,
-               AccessType at,
-               bool er0)
+Region::Region(const Bounds &l, const Bounds &u, AccessType at, bool er0)
     : lower(l), upper(u), isEmptyRank0(er0), accessType(at) {
   checks();
 }
@@ -154,15 +318,12 @@ void Region::checks() const {
 
 Region Region::getEmpty(int64_t r) {
   // One possible empty region
-  return Region(LowBounds(r, 0),
-                UppBounds(r, 0),
-                AccessType::None,
-                r == 0 ? true : false);
+  return Region(Bounds(r, 0), Bounds(r, 0), AccessType::None, r == 0);
 }
 
 Region Region::getFull(const Shape &s, AccessType accessType) {
   // Use the Shape as the UppBounds
-  return Region(LowBounds(s.size(), 0), s, accessType, false);
+  return Region(Bounds(s.size(), 0), s, accessType, false);
 }
 
 int64_t Region::rank() const { return lower.size(); }
@@ -197,70 +358,93 @@ Region Region::intersect(const Region &rhs) const {
     return getEmpty(rhs.rank());
   }
   Region result(lower, upper, combine({getAccessType(), rhs.getAccessType()}));
-
-  // Resolve templates and overload set
-  const auto min = [](int64_t a, int64_t b) { return std::min(a, b); };
-  const auto max = [](int64_t a, int64_t b) { return std::max(a, b); };
-
-  boost::transform(lower, rhs.lower, result.lower.begin(), max);
-  boost::transform(upper, rhs.upper, result.upper.begin(), min);
-  boost::transform(result.lower, result.upper, result.lower.begin(), min);
-  boost::transform(result.lower, result.upper, result.upper.begin(), max);
-
+  for (int64_t d = 0; d < rank(); ++d) {
+    auto l          = std::max(lower[d], rhs.lower[d]);
+    auto u          = std::min(upper[d], rhs.upper[d]);
+    result.lower[d] = std::min(l, u);
+    result.upper[d] = u;
+  }
   return result;
 }
 
-Regions Region::sub(const Region &rhs, bool include_empty) const {
-  Regions result;
+bool Region::overlaps(const Region &rhs) const {
+  if (rank() != rhs.rank()) {
+    std::ostringstream oss;
+    oss << "Regions of different rank in overlaps. ";
+    oss << "\n     First Region " << *this;
+    oss << "\n     Second Region " << rhs;
+    throw internal_error(oss.str());
+  }
+  if (isEmpty() || rhs.isEmpty()) {
+    return false;
+  }
+  for (int64_t d = 0; d < rank(); ++d) {
+    if (std::max(lower[d], rhs.lower[d]) >= std::min(upper[d], rhs.upper[d])) {
+      return false;
+    }
+  }
+  return true;
+}
 
-  if (*this == rhs) {
-    return result;
+// The parts of this Region outside of rhs, as at most 2 * rank disjoint
+// Regions: for each dimension d, from the innermost, the slabs below and
+// above rhs in d, within rhs in the dimensions after d. So the slabs of the
+// inner dimensions span the outer dimensions.
+Regions Region::sub(const Region &rhs, bool /* include_empty */) const {
+  if (*this == rhs || isEmpty()) {
+    return {};
   }
 
   if (rank() != rhs.rank()) {
     throw error(
         "Regions are of different rank ({} vs. {}) in sub", rank(), rhs.rank());
   }
-  if (rhs.isEmpty()) {
+  if (!overlaps(rhs)) {
     return {*this};
   }
 
-  std::vector<std::set<int64_t>> cuts(rank());
-
-  for (int64_t d = 0; d < rank(); ++d) {
-    cuts[d].insert(rhs.getLower()[d]);
-    cuts[d].insert(rhs.getUpper()[d]);
-  }
-
-  result = cut(cuts, include_empty);
-
-  Regions filteredResults;
-  for (auto r : result) {
-    if (rhs.intersect(r) != r) {
-      // r not fully contained in rhs
-      filteredResults.push_back(r);
+  Regions result;
+  Region rest = *this;
+  for (int64_t d = rank() - 1; d >= 0; --d) {
+    if (rest.lower[d] < rhs.lower[d]) {
+      Region below   = rest;
+      below.upper[d] = rhs.lower[d];
+      result.push_back(below);
+      rest.lower[d] = rhs.lower[d];
+    }
+    if (rest.upper[d] > rhs.upper[d]) {
+      Region above   = rest;
+      above.lower[d] = rhs.upper[d];
+      result.push_back(above);
+      rest.upper[d] = rhs.upper[d];
     }
   }
-  filteredResults = mergeRegions(filteredResults);
-
-  return filteredResults;
+  std::sort(result.begin(), result.end(), regionLess);
+  return result;
 }
 
 Regions Region::sub(const Regions &rhs, bool /* include_empty */) const {
-  Regions rqueue;
-  Regions wqueue;
-  rqueue.push_back(*this);
-  for (auto &r0 : rhs) {
-    for (auto &r1 : rqueue) {
-      for (auto &r2 : r1.sub(r0)) {
-        wqueue.push_back(r2);
-      }
+  // Each part of this Region is split by the first Region of rhs it
+  // intersects, until no part intersects rhs
+  RegionIndex index(rhs);
+  Regions result;
+  Regions queue(1, *this);
+  while (!queue.empty()) {
+    Region r = std::move(queue.back());
+    queue.pop_back();
+    if (r.isEmpty()) {
+      continue;
+    }
+    auto overlap = index.findOverlap(r);
+    if (overlap) {
+      auto parts = r.sub(*overlap);
+      queue.insert(queue.end(), parts.begin(), parts.end());
+    } else {
+      result.push_back(std::move(r));
     }
-    rqueue = wqueue;
-    wqueue.clear();
   }
-  rqueue = mergeRegions(rqueue);
-  return rqueue;
+  // The parts are disjoint, so only adjacent parts have to be merged
+  return coalesceDisjoint(result);
 }
 
 Regions Region::cut(const std::vector<std::set<int64_t>> &cuts,
@@ -274,12 +458,12 @@ Regions Region::cut(const std::vector<std::set<int64_t>> &cuts,
         Region r0 = rqueue.back();
         rqueue.pop_back();
         if (cut > r0.getLower()[i] && cut < r0.getUpper()[i]) {
-          std::vector<int64_t> l1 = r0.getLower();
-          std::vector<int64_t> u1 = r0.getUpper();
-          std::vector<int64_t> l2 = r0.getLower();
-          std::vector<int64_t> u2 = r0.getUpper();
-          u1[i]                   = cut;
-          l2[i]                   = cut;
+          Bounds l1 = r0.getLower();
+          Bounds u1 = r0.getUpper();
+          Bounds l2 = r0.getLower();
+          Bounds u2 = r0.getUpper();
+          u1[i]     = cut;
+          l2[i]     = cut;
           Region r1(l1, u1, accessType);
           Region r2(l2, u2, accessType);
           if (r1.nelms() > 0 || include_empty)
@@ -298,25 +482,33 @@ Regions Region::cut(const std::vector<std::set<int64_t>> &cuts,
   return rqueue;
 }
 
-bool Region::contains(const std::vector<int64_t> &index) const {
-  bool contained = true;
-  for (int64_t i = 0; i < index.size(); ++i) {
-    contained &= (lower[i] <= index[i] && index[i] < upper[i]);
+bool Region::contains(const Bounds &index) const {
+  if (static_cast<int64_t>(index.size()) != rank()) {
+    return false;
+  }
+  for (int64_t i = 0; i < rank(); ++i) {
+    if (index[i] < lower[i] || index[i] >= upper[i]) {
+      return false;
+    }
   }
-  return index.size() == rank() && contained;
+  return true;
 }
 
 bool Region::contains(const Region &rhs) const {
-  auto rhsl = rhs.getLower();
-  auto rhsu = rhs.getUpper();
-
-  for (auto &x : rhsu)
-    x--;
-
-  return rank() == rhs.rank() && contains(rhsl) && contains(rhsu);
+  if (rank() != rhs.rank()) {
+    return false;
+  }
+  // contains the first and the last element of rhs
+  for (int64_t i = 0; i < rank(); ++i) {
+    if (rhs.lower[i] < lower[i] || rhs.lower[i] >= upper[i] ||
+        rhs.upper[i] - 1 < lower[i] || rhs.upper[i] - 1 >= upper[i]) {
+      return false;
+    }
+  }
+  return true;
 }
 
-int64_t Region::flatIndex(const std::vector<int64_t> &index) const {
+int64_t Region::flatIndex(const Bounds &index) const {
   int64_t flat = 0;
   for (int64_t d = 0; d < rank(); ++d) {
     flat += index[d];
@@ -326,8 +518,8 @@ int64_t Region::flatIndex(const std::vector<int64_t> &index) const {
   return flat;
 }
 
-std::vector<int64_t> Region::dimIndex(int64_t index) const {
-  std::vector<int64_t> dim(rank());
+Bounds Region::dimIndex(int64_t index) const {
+  Bounds dim(rank(), 0);
   for (int64_t d = rank() - 1; d >= 0; --d) {
     int64_t size = (upper[d] - lower[d]);
     dim[d]       = index % size;
@@ -416,7 +608,7 @@ Regions Region::reshape(Region fullInRegion, Region fullOutRegion) const {
   std::vector<std::set<int64_t>> cuts(fullInRegion.rank());
 
   for (auto cut_point : cut_points) {
-    std::vector<int64_t> dim = fullInRegion.dimIndex(cut_point);
+    auto dim = fullInRegion.dimIndex(cut_point);
     for (int64_t d = 0; d < fullInRegion.rank(); ++d) {
       cuts[d].insert(dim[d]);
     }
@@ -496,8 +688,8 @@ std::pair<int64_t, Region> Region::merge(const Region &rhs) const {
   }
 
   if (can_merge) {
-    std::vector<int64_t> newLower = lower;
-    std::vector<int64_t> newUpper = upper;
+    Bounds newLower     = lower;
+    Bounds newUpper     = upper;
     newLower[merge_dim] = std::min(lower[merge_dim], rhs.lower[merge_dim]);
     newUpper[merge_dim] = std::max(upper[merge_dim], rhs.upper[merge_dim]);
     return {merge_dim,
@@ -517,8 +709,8 @@ void Region::append(std::ostream &ss) const {
 }
 
 Region Region::transpose(const Shape perm) const {
-  std::vector<int64_t> l(perm.size());
-  std::vector<int64_t> u(perm.size());
+  Bounds l(perm.size(), 0);
+  Bounds u(perm.size(), 0);
 
   for (int64_t i = 0; i < perm.size(); ++i) {
     l[i] = lower[perm[i]];
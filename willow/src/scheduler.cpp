@@ -3,6 +3,9 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
 #include <numeric>
 #include <queue>
 #include <unordered_map>
@@ -56,6 +59,22 @@ private:
   std::vector<Op *> addressToOp;
   RithmicGraph g;
 
+  // The constraints and bins inserted into g, to validate schedules which do
+  // not come from g (see PersistentScheduleCache)
+  std::vector<std::array<OpAddress, 2>> constraints;
+  std::vector<std::vector<std::vector<OpAddress>>> bins;
+
+  void insertConstraint(OpAddress before, OpAddress after) {
+    constraints.push_back({before, after});
+    g.insertConstraint(before, after);
+  }
+
+  void insertBinConstraints(const std::vector<std::vector<OpAddress>> &b,
+                            const std::string &prefix) {
+    bins.push_back(b);
+    g.insertBinConstraints(b, prefix);
+  }
+
 public:
   GraphGrower(const Graph &_pg_)
       : pg(_pg_), nOps(pg.getOps().size()),
@@ -91,6 +110,49 @@ public:
 
   Op *toOp(OpAddress a) const { return addressToOp.at(a); }
 
+  // Return true if `schedule' contains every Op exactly once, in an order
+  // which satisfies all of the constraints and bins inserted into the graph.
+  bool isValidSchedule(const std::vector<OpAddress> &schedule) const {
+    if (schedule.size() != nOps) {
+      return false;
+    }
+    std::vector<uint64_t> position(nOps, nOps);
+    for (uint64_t i = 0; i < nOps; ++i) {
+      auto address = schedule[i];
+      if (address >= nOps || position[address] != nOps) {
+        return false;
+      }
+      position[address] = i;
+    }
+    for (const auto &c : constraints) {
+      if (position[c[0]] > position[c[1]]) {
+        return false;
+      }
+    }
+    // All Ops in a bin must be scheduled before all Ops in later bins
+    for (const auto &binSet : bins) {
+      bool started       = false;
+      uint64_t latestEnd = 0;
+      for (const auto &bin : binSet) {
+        if (bin.empty()) {
+          continue;
+        }
+        uint64_t first = nOps;
+        uint64_t last  = 0;
+        for (auto address : bin) {
+          first = std::min(first, position[address]);
+          last  = std::max(last, position[address]);
+        }
+        if (started && first < latestEnd) {
+          return false;
+        }
+        started   = true;
+        latestEnd = last;
+      }
+    }
+    return true;
+  }
+
   void setBasic() {
     addressToOp.reserve(nOps);
     for (const auto &popartTensorId : allPopartTensorIds) {
@@ -112,7 +174,7 @@ public:
       auto opAddress = opAddresses[op];
       for (const auto t : op->input->tensors()) {
         if (auto producer = t->getProducerUnsafe()) {
-          g.insertConstraint(opAddresses[producer], opAddress);
+          insertConstraint(opAddresses[producer], opAddress);
         }
         if (t->tensorType() != TensorType::Variable) {
           g.insertOpAlloc(opAddress, allocAddresses[t]);
@@ -122,7 +184,7 @@ public:
         g.insertOpAlloc(opAddress, allocAddresses[popartTensor]);
       }
       for (const auto before : pg.topoCons->getBefores(op)) {
-        g.insertConstraint(opAddresses[before], opAddress);
+        insertConstraint(opAddresses[before], opAddress);
       }
     }
   }
@@ -145,7 +207,7 @@ public:
         bins[binIndex].push_back(opAddress);
       }
     }
-    g.insertBinConstraints(bins, "pingPongPhaseStart_");
+    insertBinConstraints(bins, "pingPongPhaseStart_");
   }
 
   void annotatePipelineStages() {
@@ -169,7 +231,7 @@ public:
         bins[binIndex].push_back(opAddress);
       }
     }
-    g.insertBinConstraints(bins, "PipelineStageStart_");
+    insertBinConstraints(bins, "PipelineStageStart_");
   }
 
   void annotatePriorities() {
@@ -249,12 +311,137 @@ public:
       auto addressAfter = opAddresses[after];
       for (auto b : befores) {
         auto addressBefore = opAddresses[b];
-        g.insertConstraint(addressBefore, addressAfter);
+        insertConstraint(addressBefore, addressAfter);
       }
     }
   }
 };
 
+std::atomic<int64_t> persistentCacheHits{0};
+std::atomic<int64_t> persistentCacheMisses{0};
+std::atomic<int64_t> persistentCacheRejections{0};
+
+// FNV-1a. Unlike std::hash, this is the same in every build, so can be used
+// for file names which outlive the process.
+uint64_t fnv1a(const std::string &s, uint64_t h = 14695981039346656037ULL) {
+  for (unsigned char c : s) {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+const char *const formatHeader = "popart_schedule_v1";
+
+std::string toHex(uint64_t x) {
+  std::ostringstream oss;
+  oss << std::hex << std::setw(16) << std::setfill('0') << x;
+  return oss.str();
+}
+
+// Schedules found by annealing, stored in a directory so that they can be
+// reused by later compilations of the same graph. An entry is keyed by a hash
+// of everything which determines the result of annealing: the serialized
+// poprithms Graph (ops, allocs, constraints, ping-pong and pipeline bins,
+// attractors), the Kahn tie-breaker and the annealing limits. A second,
+// independent hash is stored in the entry to detect collisions, and a loaded
+// schedule is only used if it is valid for the graph.
+class PersistentScheduleCache {
+public:
+  PersistentScheduleCache(const std::string &dir,
+                          const GraphGrower &grower,
+                          const std::string &kahnTieBreaker,
+                          double timeLimitSeconds,
+                          int64_t swapLimitCount)
+      : directory(dir) {
+    std::ostringstream oss;
+    oss << grower.getSerializationString() << "\nkahnTieBreaker "
+        << kahnTieBreaker << "\ntimeLimitSeconds " << timeLimitSeconds
+        << "\nswapLimitCount " << swapLimitCount;
+    key   = oss.str();
+    fname = io::appendDirFn(directory, toHex(fnv1a(key)) + ".schedule");
+  }
+
+  // Return true, and set `schedule', if there is a valid entry for the graph.
+  bool load(const GraphGrower &grower, std::vector<OpAddress> &schedule) const {
+    std::ifstream ifs(fname);
+    if (!ifs.is_open()) {
+      return false;
+    }
+    std::string header, check;
+    uint64_t nOps;
+    ifs >> header >> check >> nOps;
+    if (!ifs || header != formatHeader || check != checkString()) {
+      logging::ir::warn("[Scheduler] Ignoring invalid schedule cache file {}",
+                        fname);
+      return false;
+    }
+    schedule.resize(nOps);
+    for (auto &address : schedule) {
+      ifs >> address;
+    }
+    if (!ifs || !grower.isValidSchedule(schedule)) {
+      logging::ir::warn(
+          "[Scheduler] Schedule in cache file {} is not valid for the Graph",
+          fname);
+      return false;
+    }
+    return true;
+  }
+
+  // Write an entry. Failures are logged, but are not errors.
+  void store(const std::vector<OpAddress> &schedule) const {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(directory, ec);
+    if (ec) {
+      logging::ir::warn("[Scheduler] Failed to create schedule cache directory "
+                        "{}: {}",
+                        directory,
+                        ec.message());
+      return;
+    }
+
+    // Write to a temporary file and rename it, so that concurrent
+    // compilations never see a partially written entry.
+    auto tmpName =
+        fname + boost::filesystem::unique_path(".%%%%-%%%%-%%%%").string();
+    {
+      std::ofstream ofs(tmpName);
+      if (!ofs.is_open()) {
+        logging::ir::warn("[Scheduler] Failed to open file {}", tmpName);
+        return;
+      }
+      ofs << formatHeader << ' ' << checkString() << ' ' << schedule.size()
+          << '\n';
+      for (auto address : schedule) {
+        ofs << address << '\n';
+      }
+    }
+    boost::filesystem::rename(tmpName, fname, ec);
+    if (ec) {
+      logging::ir::warn(
+          "[Scheduler] Failed to write schedule cache file {}: {}",
+          fname,
+          ec.message());
+      boost::filesystem::remove(tmpName, ec);
+      return;
+    }
+    logging::ir::debug("[Scheduler] Wrote schedule cache file {}", fname);
+  }
+
+  const std::string &filename() const { return fname; }
+
+private:
+  std::string checkString() const {
+    return toHex(fnv1a(key, 0x84222325cbf29ce4ULL)) + "-" +
+           std::to_string(key.size());
+  }
+
+  std::string directory;
+  std::string key;
+  std::string fname;
+};
+
 } // namespace
 
 class ScheduleCacher {
@@ -387,25 +574,62 @@ Scheduler::getSchedule(const OpsBeforeKey &gCons,
     throw error("Unrecognised KahnTieBreaker, {}", kahnTieBreakerString);
   }
 
-  grower->initialize(ktb);
+  const auto nOps = pg.getOps().size();
+  std::vector<OpAddress> addressSchedule;
+
+  const auto &opts = pg.getIr().getSessionOptions();
+  std::unique_ptr<PersistentScheduleCache> persistentCache;
+  if (opts.enableScheduleCaching && !opts.cachePath.empty()) {
+    persistentCache = std::make_unique<PersistentScheduleCache>(
+        opts.cachePath + ".schedules",
+        *grower,
+        ktbLower,
+        timeLimitSeconds,
+        swapLimitCount);
+    if (persistentCache->load(*grower, addressSchedule)) {
+      auto hits = ++persistentCacheHits;
+      logging::ir::debug("[Scheduler] Persistent schedule cache hit # {} ({})",
+                         hits,
+                         persistentCache->filename());
+    } else {
+      addressSchedule.clear();
+      if (boost::filesystem::exists(persistentCache->filename())) {
+        ++persistentCacheRejections;
+      }
+      auto misses = ++persistentCacheMisses;
+      logging::ir::debug("[Scheduler] Persistent schedule cache miss # {}",
+                         misses);
+    }
+  }
+
+  if (addressSchedule.empty()) {
+    grower->initialize(ktb);
 
-  grower->minSumLivenessAnneal(
-      {{"debug", "0"},
-       {"seed", "1011"},
-       {"timeLimitSeconds", std::to_string(timeLimitSeconds)},
-       {"swapLimitCount", std::to_string(swapLimitCount)}});
+    grower->minSumLivenessAnneal(
+        {{"debug", "0"},
+         {"seed", "1011"},
+         {"timeLimitSeconds", std::to_string(timeLimitSeconds)},
+         {"swapLimitCount", std::to_string(swapLimitCount)}});
 
-  const auto nOps = pg.getOps().size();
-  std::vector<std::tuple<ScheduleIndex, OpAddress>> subSchedule;
-  subSchedule.reserve(nOps);
-  for (OpAddress add = 0; add < nOps; ++add) {
-    subSchedule.push_back({grower->opToSchedule(add), add});
+    std::vector<std::tuple<ScheduleIndex, OpAddress>> subSchedule;
+    subSchedule.reserve(nOps);
+    for (OpAddress add = 0; add < nOps; ++add) {
+      subSchedule.push_back({grower->opToSchedule(add), add});
+    }
+    std::sort(subSchedule.begin(), subSchedule.end());
+    addressSchedule.reserve(nOps);
+    for (const auto &x : subSchedule) {
+      addressSchedule.push_back(std::get<1>(x));
+    }
+    if (persistentCache) {
+      persistentCache->store(addressSchedule);
+    }
   }
-  std::sort(subSchedule.begin(), subSchedule.end());
+
   std::vector<Op *> finalSchedule;
   finalSchedule.reserve(nOps);
-  for (auto i = 0; i < nOps; ++i) {
-    finalSchedule.push_back(grower->toOp(std::get<1>(subSchedule[i])));
+  for (auto address : addressSchedule) {
+    finalSchedule.push_back(grower->toOp(address));
   }
   cacher->setSchedule(finalSchedule);
   cacher->setGrower(std::move(grower));
@@ -430,6 +654,20 @@ bool Scheduler::isSchedulable(const OpsBeforeKey &gCons,
   return grower.isSchedulable();
 }
 
+ScheduleCacheCounters Scheduler::getPersistentCacheCounters() {
+  ScheduleCacheCounters counters;
+  counters.hits       = persistentCacheHits;
+  counters.misses     = persistentCacheMisses;
+  counters.rejections = persistentCacheRejections;
+  return counters;
+}
+
+void Scheduler::resetPersistentCacheCounters() {
+  persistentCacheHits       = 0;
+  persistentCacheMisses     = 0;
+  persistentCacheRejections = 0;
+}
+
 Scheduler::Scheduler()  = default;
 Scheduler::~Scheduler() = default;
 
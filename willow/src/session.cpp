@@ -1,7 +1,8 @@
 // Copyright (c) 2018 Graphcore Ltd. All rights reserved.
 #include <fstream>
+#include <set>
+#include <sstream>
 
-#include <popart/builder_impl.hpp>
 #include <popart/error.hpp>
 #include <popart/filereader.hpp>
 #include <popart/graph.hpp>
@@ -15,6 +16,7 @@
 #include <popart/tensor.hpp>
 #include <popart/tensordata.hpp>
 #include <popart/tensors.hpp>
+#include <popart/threadpool.hpp>
 #include <popart/util.hpp>
 #include <popart/version.hpp>
 
@@ -29,10 +31,29 @@ Session::Session() {
 void Session::setDevice(std::shared_ptr<DeviceInfo> deviceInfo) {
   logging::session::trace("Session::setDevice({})", *deviceInfo);
   device_.reset(new popx::Devicex(ir, deviceInfo));
+  if (pendingExecutable_) {
+    device_->setPendingExecutable(std::move(pendingExecutable_));
+  }
+}
+
+void Session::prepareIr(const IrBundle &bundle) {
+  pendingExecutable_ = popx::Devicex::loadCachedExecutableAsync(bundle);
+
+  // The restored Ir can only be run with the cached executable, so it is only
+  // restored once the executable is loaded
+  if (pendingExecutable_ && !pendingExecutable_->preparedIr.empty() &&
+      pendingExecutable_->wait()) {
+    std::istringstream iss(pendingExecutable_->preparedIr);
+    if (ir.prepareFromSerialized(bundle, iss)) {
+      return;
+    }
+  }
+  ir.prepare(bundle);
 }
 
 void Session::setRandomSeed(uint64_t seedValue) {
   logging::session::trace("Session::setRandomSeed({})", seedValue);
+  waitForAsyncRuns();
   if (!ir.requiresRandomSeed()) {
     logging::session::warn("Trying to set the random seed, but this session "
                            "has no random behaviour. Doing nothing.");
@@ -51,12 +72,22 @@ void Session::setRandomSeed(uint64_t seedValue) {
 
 uint64_t Session::getCycleCount(std::string id) {
   logging::session::trace("Session::getCycleCount()");
+  waitForAsyncRuns();
   if (!runCalled) {
     throw error("Must call run before getCycleCount.");
   }
   return device_->cycleCountTensorToHost().at(id);
 }
 
+CycleCountReport Session::getCycleCountReport() {
+  logging::session::trace("Session::getCycleCountReport()");
+  waitForAsyncRuns();
+  if (!runCalled) {
+    throw error("Must call run before getCycleCountReport.");
+  }
+  return device_->cycleCountReportToHost();
+}
+
 // get the TensorInfo on a Tensor
 TensorInfo Session::getInfo(TensorId id) const {
   logging::session::trace("Session::getInfo({})", id);
@@ -94,6 +125,7 @@ void Session::prepareDevice() {
 
 void Session::weightsFromHost() {
   logging::session::trace("Sessions::weightsFromHost");
+  waitForAsyncRuns();
 
   device_->weightsFromHost();
   weightsFromHostCalled = true;
@@ -105,6 +137,7 @@ void Session::weightsToHost() {
   if (!device_) {
     throw error("Must call setDevice before {}", __func__);
   }
+  waitForAsyncRuns();
 
   device_->weightsToHost();
 }
@@ -115,6 +148,7 @@ void Session::readWeights(const IWeightsIO &weightsIo) {
   if (!device_) {
     throw error("Must call setDevice before {}", __func__);
   }
+  waitForAsyncRuns();
 
   device_->readWeights(weightsIo);
 }
@@ -125,6 +159,7 @@ void Session::writeWeights(const IWeightsIO &weightsIo) {
   if (!device_) {
     throw error("Must call setDevice before {}", __func__);
   }
+  waitForAsyncRuns();
 
   device_->writeWeights(weightsIo);
 }
@@ -149,17 +184,113 @@ void Session::run(IStepIO &stepio) {
         "and the session has been created in training mode");
   }
 
+  // Steps started by runAsync run before this one
+  waitForAsyncRuns();
   device_->run(stepio);
 
   runCalled = true;
 }
 
+std::unique_ptr<AsyncRunHandle> Session::runAsync(IStepIO &inputs) {
+  logging::session::trace("Session::runAsync");
+  if (!ir.canInfer()) {
+    throw error("Trying to infer when not in inference mode");
+  }
+
+  if (ir.containsInitialisers() && ir.isTraining() &&
+      weightsFromHostCalled == false) {
+    throw error(
+        "Must call weightsFromHost before runAsync as the model has "
+        "initializers and the session has been created in training mode");
+  }
+
+  if (!device_->prepareHasBeenCalled()) {
+    throw error("Must call prepareDevice before runAsync");
+  }
+
+  if (!asyncRunner_) {
+    asyncRunner_ = std::make_unique<AsyncRunner>(
+        *device_, ir.getSessionOptions().asyncAnchorBufferSets);
+  }
+  auto handle = asyncRunner_->run(inputs);
+
+  runCalled = true;
+  return handle;
+}
+
+void Session::waitForAsyncRuns() {
+  if (asyncRunner_) {
+    asyncRunner_->waitForAll();
+  }
+}
+
+namespace {
+
+// Write the data of an initializer stored externally to its location on disk
+void writeExternalWeight(const ONNX_NAMESPACE::TensorProto &tp,
+                         const ConstVoidData &data) {
+  auto externalInfo = onnxutil::ExternalTensorProtoInfo(tp);
+  auto dstType      = onnxutil::getDataType(tp.data_type());
+  if (TensorInfo(dstType, data.info.shape()).nbytes() != externalInfo.length) {
+    throw error("Trying to update initializer {}, stored in file {}, when "
+                "writing modelToHost. Its length, {} bytes, does not match "
+                "its data",
+                tp.name(),
+                externalInfo.location,
+                externalInfo.length);
+  }
+
+  std::fstream ofs(externalInfo.location,
+                   std::ofstream::binary | std::ios_base::out |
+                       std::ios_base::in);
+  if (!ofs.is_open()) {
+    throw error("Trying to update initializer {}, stored in file {}, when "
+                "writing modelToHost. Failed to open file",
+                tp.name(),
+                externalInfo.location);
+  }
+
+  if (externalInfo.offset > 0) {
+    ofs.seekp(externalInfo.offset, std::ios::beg);
+  }
+  io::forEachDataChunk(data, dstType, [&ofs](const char *chunk, int64_t n) {
+    ofs.write(chunk, n);
+  });
+  if (!ofs) {
+    throw error("Failed to write initializer {} to file {}",
+                tp.name(),
+                externalInfo.location);
+  }
+}
+
+} // namespace
+
 // write current model to ONNX file
 void Session::modelToHost(const std::string &fn) {
   logging::session::trace("Session::modelToHost");
 
-  ONNX_NAMESPACE::ModelProto model      = ir.getModel();
-  ONNX_NAMESPACE::GraphProto *onnxgraph = model.mutable_graph();
+  waitForAsyncRuns();
+
+  // The weights are not copied into a ModelProto. They are written to disk
+  // from the host end of their streams, which weightsToHost() fills, so that
+  // only a chunk of the serialized model is in memory at a time.
+  device_->weightsToHost();
+
+  const auto &model = ir.getModel();
+
+  // Weights which are read from the device
+  auto isStoredWeight = [this](const TensorId &tenId) {
+    return !ir.useSyntheticData() && ir.containsTensor(tenId) &&
+           ir.getTensor(tenId)->tensorType() == TensorType::Variable &&
+           !ir.storingIsDisabledForTensor(tenId);
+  };
+
+  // The data of the initializers to write to the model, in place of their
+  // data in the model, and of those stored externally
+  std::map<TensorId, ConstVoidData> weights;
+  std::vector<std::pair<const ONNX_NAMESPACE::TensorProto *, ConstVoidData>>
+      externalWeights;
+  std::vector<TensorId> storedWeights;
 
   for (auto tId : ir.additionalModelProtoTensors) {
     // For additional tensors we want to save in the onnx modelproto, we copy
@@ -168,79 +299,58 @@ void Session::modelToHost(const std::string &fn) {
       throw error("Tensor id {} already in initializers, duplicate tensor "
                   "Ids not allowed in onnx specification.",
                   tId);
+    } else if (isStoredWeight(tId)) {
+      weights[tId] = device_->getD2hWeightData(tId);
+      storedWeights.push_back(tId);
     } else {
-      ONNX_NAMESPACE::TensorProto *init = onnxgraph->add_initializer();
-      init->set_name(tId);
-      auto tensor = ir.getMainGraph().getTensors().get(tId);
-
-      ConstVoidData cvData;
-      cvData.data = tensor->tensorData()->data();
-      cvData.info = tensor->info;
-      BuilderImpl::populateTensorProtoFromConstVoidData(cvData, tId, init);
+      auto tensor  = ir.getMainGraph().getTensors().get(tId);
+      weights[tId] = ConstVoidData(tensor->tensorData()->data(), tensor->info);
     }
   }
 
-  std::map<TensorId, MutableVoidData> initMap;
-  // For storing tensor data for externally stored tensors.
-  std::map<TensorId, std::vector<char>> externalTensorBuffers;
-
-  for (int init_index = 0; init_index < model.graph().initializer_size();
-       ++init_index) {
-    ONNX_NAMESPACE::TensorProto &tp =
-        *model.mutable_graph()->mutable_initializer(init_index);
+  std::set<TensorId> initializers;
+  for (const auto &tp : model.graph().initializer()) {
     TensorId tenId = tp.name();
-
+    initializers.insert(tenId);
+    if (!isStoredWeight(tenId)) {
+      continue;
+    }
     if (tp.has_data_location() &&
         tp.data_location() == ONNX_NAMESPACE::TensorProto::EXTERNAL) {
-      // Initialise a new MutableVoidData object to write to from host weight
-      // buffers
-      MutableVoidData mvd;
-      mvd.info = getInfo(tenId);
-      std::vector<char> buffer(mvd.info.nbytes());
-      externalTensorBuffers.emplace(tenId, buffer);
-      mvd.data = reinterpret_cast<void *>(externalTensorBuffers[tenId].data());
-      initMap[tenId] = mvd;
+      externalWeights.push_back({&tp, device_->getD2hWeightData(tenId)});
     } else {
-      initMap[tenId] = onnxutil::getMutableData(tp);
+      weights[tenId] = device_->getD2hWeightData(tenId);
     }
+    storedWeights.push_back(tenId);
   }
 
-  device_->weightsToHost(initMap);
-
-  // Write data for externally saved weights to relevant locations on disk
-  for (int init_index = 0; init_index < model.graph().initializer_size();
-       ++init_index) {
-    ONNX_NAMESPACE::TensorProto tp = model.graph().initializer(init_index);
-
-    if (tp.has_data_location() &&
-        tp.data_location() == ONNX_NAMESPACE::TensorProto::EXTERNAL) {
-      TensorId tenId    = tp.name();
-      auto externalInfo = onnxutil::ExternalTensorProtoInfo(tp);
-      std::fstream ofs(externalInfo.location,
-                       std::ofstream::binary | std::ios_base::out |
-                           std::ios_base::in);
-      if (!ofs.is_open()) {
-        throw error("Trying to update initializer {}, stored in file {}, when "
-                    "writing modelToHost. Failed to open file",
-                    tenId,
-                    fn);
-      }
-
-      if (externalInfo.offset > 0) {
-        ofs.seekp(externalInfo.offset, std::ios::beg);
-      }
-      ofs.write(static_cast<const char *>(initMap[tenId].data),
-                externalInfo.length);
-      ofs.close();
+  for (auto tenId : ir.getTensorIds(TensorType::Variable)) {
+    if (isStoredWeight(tenId) && initializers.count(tenId) == 0 &&
+        ir.additionalModelProtoTensors.count(tenId) == 0) {
+      throw error("No initializer in the model for weight {}", tenId);
     }
   }
 
-  io::writeModel(model, fn);
+  // Write data for externally saved weights to relevant locations on disk,
+  // with the weights written concurrently, each by its own stream
+  ThreadPool::global().parallelFor(
+      externalWeights.size(), 1, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          writeExternalWeight(*externalWeights[i].first,
+                              externalWeights[i].second);
+        }
+      });
+
+  io::writeModel(model, weights, fn);
 
   if (!ir.getSessionOptions().constantWeights ||
       ir.getExecutionMode() != Ir::ExecutionMode::Inference) {
     // Weights in ir, device, and disk now all match
-    ir.resetWeights(model);
+    for (auto tenId : storedWeights) {
+      auto tensor = ir.getTensor(tenId);
+      tensor->tensorData()->resetData(tensor->info,
+                                      device_->getD2hWeightData(tenId).data);
+    }
   }
 }
 
@@ -268,6 +378,12 @@ std::string Session::getSerializedGraph() const {
 TensorTileMap Session::getTensorTileMap() const {
   logging::session::trace("Session::getTensorTileMap");
 
+  if (ir.isPreparedFromSerialized()) {
+    throw error("The Ir was restored from the engine cache, so there is no "
+                "Poplar graph to get the tile mapping of. Disable engine "
+                "caching (userOptions.enableEngineCaching = false) to get the "
+                "tensor tile map");
+  }
   return device_->getTensorTileMap();
 }
 
@@ -275,6 +391,7 @@ void Session::resetHostWeights(
     const std::string &modelProtoOrFilename,
     const bool ignoreWeightsInModelWithoutCorrespondingHostWeight) {
   logging::session::trace("Session::resetHostWeights");
+  waitForAsyncRuns();
   if (ir.getSessionOptions().constantWeights &&
       ir.getExecutionMode() == Ir::ExecutionMode::Inference) {
     throw error("Cannot call resetHostWeights when constantWeights is set");
@@ -289,6 +406,12 @@ void Session::resetHostWeights(
 
 std::string Session::serializeIr(IrSerializationFormat format) {
   (void)format;
+  if (ir.isPreparedFromSerialized()) {
+    throw error("The Ir was restored from the engine cache, so it only has "
+                "the Tensors streamed to and from the host. Disable engine "
+                "caching (userOptions.enableEngineCaching = false) to "
+                "serialize the Ir");
+  }
   std::stringstream ss;
   ir.serialise(Ir::SerialiseFormat::JSON, ss);
   return ss.str();
@@ -310,8 +433,9 @@ void InferenceSession::configureFromOnnx(
 
   auto modelProto = onnxutil::getModelProto(modelProtoOrFilename);
 
-  ir.prepare(
-      {modelProto, perk, df, {}, nullptr, *deviceInfo, userOptions, patterns});
+  IrBundle bundle(
+      modelProto, perk, df, {}, nullptr, *deviceInfo, userOptions, patterns);
+  prepareIr(bundle);
 }
 
 std::unique_ptr<InferenceSession>
@@ -355,14 +479,15 @@ void TrainingSession::configureFromOnnx(const std::string &modelProtoOrFilename,
 
   auto modelProto = onnxutil::getModelProto(modelProtoOrFilename);
 
-  ir.prepare({modelProto,
-              perk,
-              df,
-              lossIn,
-              &optimizerIn,
-              *deviceInfo,
-              userOptions,
-              patterns});
+  IrBundle bundle(modelProto,
+                  perk,
+                  df,
+                  lossIn,
+                  &optimizerIn,
+                  *deviceInfo,
+                  userOptions,
+                  patterns);
+  prepareIr(bundle);
 }
 
 std::unique_ptr<TrainingSession>
@@ -399,6 +524,7 @@ TrainingSession::createFromOnnxModel(const std::string &model,
 
 void TrainingSession::updateOptimizerFromHost(const Optimizer *optimizer) {
   logging::session::trace("TrainingSession::updateOptimizerFromHost");
+  waitForAsyncRuns();
   ir.updateOptimizer(*optimizer);
 
   // There has been a change to the TensorData of the optimizer tensors
@@ -424,6 +550,7 @@ void TrainingSession::connectStreamToCallback(
     const std::string &streamHandle,
     std::function<void(void *)> callback,
     unsigned index) {
+  waitForAsyncRuns();
   device_->connectStreamToCallback(streamHandle, callback, index);
 }
 
@@ -431,6 +558,7 @@ void TrainingSession::copyFromRemoteBuffer(const poplar::RemoteBuffer &buffer,
                                            void *w,
                                            int repeat_index,
                                            unsigned replication_index) {
+  waitForAsyncRuns();
   device_->copyFromRemoteBuffer(buffer, w, repeat_index, replication_index);
 }
 
@@ -438,6 +566,7 @@ void TrainingSession::copyToRemoteBuffer(void *w,
                                          const poplar::RemoteBuffer &buffer,
                                          int repeat_index,
                                          unsigned replication_index) {
+  waitForAsyncRuns();
   device_->copyToRemoteBuffer(w, buffer, repeat_index, replication_index);
 }
 
@@ -1,6 +1,7 @@
 // Copyright (c) 2018 Graphcore Ltd. All rights reserved.
 #include <algorithm>
 #include <array>
+#include <boost/functional/hash.hpp>
 #include <popart/error.hpp>
 #include <popart/sessionoptions.hpp>
 
@@ -85,6 +86,8 @@ std::string toString(RecomputationType r) {
     return "RecomputationType::Pipeline";
   case RecomputationType::NormOnly:
     return "RecomputationType::NormOnly";
+  case RecomputationType::CheckpointSolver:
+    return "RecomputationType::CheckpointSolver";
   case RecomputationType::N:
     throw error("Bad RecomputationType {}", static_cast<int>(r));
   default:
@@ -97,6 +100,24 @@ std::ostream &operator<<(std::ostream &os, RecomputationType r) {
   return os;
 }
 
+std::string toString(AutoVirtualGraphType t) {
+  switch (t) {
+  case AutoVirtualGraphType::Subgraph:
+    return "AutoVirtualGraphType::Subgraph";
+  case AutoVirtualGraphType::ComputeBalanced:
+    return "AutoVirtualGraphType::ComputeBalanced";
+  case AutoVirtualGraphType::N:
+    throw error("Bad AutoVirtualGraphType {}", static_cast<int>(t));
+  default:
+    throw error("Unknown AutoVirtualGraphType");
+  }
+}
+
+std::ostream &operator<<(std::ostream &os, AutoVirtualGraphType t) {
+  os << toString(t);
+  return os;
+}
+
 // No implementation required
 
 } // namespace popart
@@ -104,30 +125,79 @@ std::ostream &operator<<(std::ostream &os, RecomputationType r) {
 namespace std {
 std::size_t hash<popart::SessionOptions>::operator()(
     const popart::SessionOptions &so) const {
-  // Hash based on all the SessionOptions attributes that
-  // can affect compiled program
-
-  std::stringstream ss;
-  ss << so.autoRecomputation;
-
-  auto hsh = std::hash<std::string>{}(ss.str());
-  hsh      = (hsh ^ (std::hash<bool>{}(so.rearrangeAnchorsOnHost) << 1)) << 1;
-  hsh      = (hsh ^ (std::hash<bool>{}(so.enableNonStableSoftmax) << 1)) << 1;
-  hsh      = (hsh ^ (std::hash<int64_t>{}(so.replicatedGraphCount) << 1)) << 1;
-  hsh      = (hsh ^ (std::hash<bool>{}(so.enablePipelining) << 1)) << 1;
-  hsh = (hsh ^ (std::hash<bool>{}(so.enableFloatingPointChecks) << 1)) << 1;
-  hsh = (hsh ^ (std::hash<bool>{}(so.enableStochasticRounding) << 1)) << 1;
-  hsh = (hsh ^ (std::hash<bool>{}(so.enableFullyConnectedPass) << 1)) << 1;
-  hsh = (hsh ^ (std::hash<int>{}(static_cast<int>(so.syntheticDataMode)) << 1))
-        << 1;
-  for (auto key_val : so.engineOptions) {
-    hsh = (hsh ^ (std::hash<std::string>()(key_val.first) << 1)) << 1;
-    hsh = (hsh ^ (std::hash<std::string>()(key_val.second) << 1)) << 1;
-  }
-  for (auto key_val : so.convolutionOptions) {
-    hsh = (hsh ^ (std::hash<std::string>()(key_val.first) << 1)) << 1;
-    hsh = (hsh ^ (std::hash<std::string>()(key_val.second) << 1)) << 1;
+  // Hash based on all the SessionOptions attributes that can affect the Ir or
+  // the compiled program. Those which only change what is logged, exported or
+  // cached are not hashed, so that they do not change the engine cache key
+  std::size_t hsh = 0;
+  auto combine    = [&hsh](const auto &value) {
+    boost::hash_combine(hsh, value);
+  };
+  auto combineEnum = [&hsh](auto value) {
+    boost::hash_combine(hsh, static_cast<int>(value));
+  };
+
+  combine(so.enableOutlining);
+  combine(so.enableOutliningCopyCostPruning);
+  combine(so.enableHierarchicalOutlining);
+  combine(so.outlineThreshold);
+  combineEnum(so.autoRecomputation);
+  combine(so.autoRecomputationMemoryBudget);
+  combineEnum(so.mergeVarUpdate);
+  combine(so.mergeVarUpdateMemThreshold);
+  combine(so.looseThresholdAtPeak);
+  combine(so.rearrangeAnchorsOnHost);
+  combine(so.enablePrefetchDatastreams);
+  combine(so.enableNonStableSoftmax);
+  combine(so.enableReplicatedGraphs);
+  combine(so.enableGradientAccumulation);
+  combine(so.replicatedGraphCount);
+  combine(so.accumulationFactor);
+  combineEnum(so.virtualGraphMode);
+  combineEnum(so.autoVirtualGraphType);
+  combine(so.autoVirtualGraphMemoryCap);
+  combine(so.enablePipelining);
+  combineEnum(so.syntheticDataMode);
+  combine(so.instrumentWithHardwareCycleCounter);
+  for (auto instrumentation : so.hardwareInstrumentations) {
+    combineEnum(instrumentation);
   }
+  combine(so.hardwareInstrumentationOpFilter);
+  combine(so.disableGradAccumulationTensorStreams);
+  combine(so.compileEngine);
+  combine(so.constantWeights);
+  combine(so.enableFloatingPointChecks);
+  combine(so.enableStochasticRounding);
+  combine(so.pingPongPhases);
+  combine(so.explicitRecomputation);
+  combine(so.replicatedWeightSharding);
+  combine(so.replicatedWeightShardingMinNumElements);
+  combine(so.numIOTiles);
+  combine(so.aliasZeroCopy);
+  combine(so.batchSerializationFactor);
+  combine(so.delayVarUpdates);
+  combine(so.enableFullyConnectedPass);
+  combine(so.enableGroupedMatmuls);
+  combine(so.enableSerializedMatmuls);
+  combine(so.partialsTypeMatMuls);
+  combine(so.enableStableNorm);
+  combine(so.hostAllReduce);
+  combine(so.hostWeightUpdate);
+  combine(so.hostAllReduceRemoteBuffer);
+  combine(so.hostAllReduceEngine);
+  combine(so.hostAllReduceBucketSize);
+  combine(so.engineOptions);
+  combine(so.convolutionOptions);
+  combine(so.customCodelets);
+  combine(so.customCodeletCompileFlags);
+  combine(so.timeLimitScheduler);
+  combine(so.swapLimitScheduler);
+  combine(so.kahnTieBreaker);
+  combine(so.decomposeGradSum);
+  combine(so.enableDistributedReplicatedGraphs);
+  combine(so.globalReplicationFactor);
+  combine(so.globalReplicaOffset);
+  combine(so.ipuSystemType);
+  combine(so.groupHostSync);
 
   return hsh;
 }
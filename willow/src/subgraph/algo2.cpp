@@ -0,0 +1,119 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <popart/subgraph/algo2.hpp>
+#include <popart/subgraph/suffixtree.hpp>
+
+namespace fwtools {
+namespace subgraph {
+namespace algo2 {
+
+namespace {
+
+// The number of integers which decide whether a chunk starts at a position
+constexpr int chunkWindow = 4;
+
+uint64_t mix(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+} // namespace
+
+std::vector<Start> getChunkStarts(const std::vector<int> &intSched,
+                                  int meanLength) {
+  const int n = static_cast<int>(intSched.size());
+  std::vector<Start> starts{0};
+  for (int i = chunkWindow; i < n; ++i) {
+    uint64_t hash = 0;
+    for (int j = i - chunkWindow; j < i; ++j) {
+      hash = mix(hash ^ static_cast<uint64_t>(intSched[j]));
+    }
+    if (hash % static_cast<uint64_t>(meanLength) == 0) {
+      starts.push_back(i);
+    }
+  }
+  starts.push_back(n);
+  return starts;
+}
+
+std::vector<Match> getRepeatedBlocks(const std::vector<int> &intSched,
+                                     int meanChunkLength) {
+  auto chunkStarts = getChunkStarts(intSched, meanChunkLength);
+  const int nChunks = static_cast<int>(chunkStarts.size()) - 1;
+
+  // The compressed schedule, with an integer for each distinct chunk
+  std::map<std::vector<int>, int> chunkIds;
+  std::vector<int> chunkSched;
+  chunkSched.reserve(nChunks);
+  for (int c = 0; c < nChunks; ++c) {
+    std::vector<int> chunk(intSched.begin() + chunkStarts[c],
+                           intSched.begin() + chunkStarts[c + 1]);
+    auto found = chunkIds.find(chunk);
+    if (found == chunkIds.end()) {
+      found = chunkIds.insert({chunk, static_cast<int>(chunkIds.size())}).first;
+    }
+    chunkSched.push_back(found->second);
+  }
+  if (nChunks < 2 || chunkIds.size() == nChunks) {
+    return {};
+  }
+
+  std::vector<Match> blocks;
+  for (auto &internal : suffixtree::getInternal(chunkSched)) {
+    // Non-overlapping instances, in nodes of the schedule
+    std::vector<Start> starts;
+    int last = -internal.length;
+    for (auto start : internal.starts) {
+      if (start >= last + internal.length) {
+        starts.push_back(chunkStarts[start]);
+        last = start;
+      }
+    }
+    if (starts.size() < 2) {
+      continue;
+    }
+    auto first  = internal.starts[0];
+    auto length = chunkStarts[first + internal.length] - chunkStarts[first];
+
+    // The instances start at chunk boundaries, which may be inside the
+    // repeated sequence (such as a layer). Move them back to where the
+    // repetition begins, and add an instance after the last if the
+    // repetition continues.
+    auto repeatsBefore = [&intSched, &starts]() {
+      for (auto start : starts) {
+        if (start == 0 || intSched[start - 1] != intSched[starts[0] - 1]) {
+          return false;
+        }
+      }
+      return true;
+    };
+    for (int shift = 0; shift < length && repeatsBefore(); ++shift) {
+      for (auto &start : starts) {
+        --start;
+      }
+    }
+    Start next = starts.back() + length;
+    if (next + length <= intSched.size() &&
+        std::equal(intSched.begin() + starts.back(),
+                   intSched.begin() + next,
+                   intSched.begin() + next)) {
+      starts.push_back(next);
+    }
+
+    Match block(starts, length);
+    block.setValue(static_cast<double>(length) *
+                   static_cast<double>(starts.size() - 1));
+    blocks.push_back(block);
+  }
+
+  std::sort(blocks.rbegin(), blocks.rend());
+  return blocks;
+}
+
+} // namespace algo2
+} // namespace subgraph
+} // namespace fwtools
@@ -311,6 +311,7 @@ void Consumers::extend(const std::map<Op *, int, POpCmp> &m) {
       consumers_m[op_count.first] = op_count.second;
     }
   }
+  tensorConsumed->getGraph().incrementMutationEpoch();
 }
 
 void Tensor::setProducer(Op *op) {
@@ -318,6 +319,7 @@ void Tensor::setProducer(Op *op) {
     throw error("Cannot set a producer for Tensor " + id + " as already one");
   }
   producer = op;
+  graph.incrementMutationEpoch();
 }
 
 void Tensor::resetProducer(Op *op) {
@@ -326,6 +328,7 @@ void Tensor::resetProducer(Op *op) {
                 " as it does not already have one");
   }
   producer = op;
+  graph.incrementMutationEpoch();
 }
 
 void Tensor::setImplicitLoopInput(bool implicit_) {
@@ -348,7 +351,8 @@ int Consumers::getTotal() const {
 // using 'this' in a constructor list? Be careful.
 // https://stackoverflow.com/questions/5058349
 Tensor::Tensor(TensorId n, TensorType t, Graph &g)
-    : Vertex(), id(n), consumers(this), graph(g), producer(nullptr),
+    : Vertex(), id(n), handle(g.getIr().getTensorIdInterner().intern(n)),
+      consumers(this), graph(g), producer(nullptr),
       tensorTypeInfo(&getTensorTypeInfoMap().at(t)), implicitLoopInput(false),
       data_(nullptr) {
   // graph is currently unused - this removes the compiler warning
@@ -364,6 +368,7 @@ void Consumers::decrement(Op *op) {
   if (found->second == 0) {
     consumers_m.erase(op);
   }
+  tensorConsumed->getGraph().incrementMutationEpoch();
 }
 
 Op *Tensor::getProducer() const {
@@ -407,10 +412,16 @@ bool Tensor::isRandomSeedTensor() const {
 }
 
 bool Tensor::isAcclTensor() const {
-  auto states = reservedOptimizerStatePrefixes();
-  if (std::any_of(states.begin(), states.end(), [this](const std::string) {
-        return id.find(reservedAcclToAccumulatorPrefix()) != std::string::npos;
-      })) {
+  // The optimizer state Variables (not their aliases, such as the output of
+  // the AccumulateOp)
+  const std::vector<std::string> states{reservedAcclToAccumulatorPrefix(),
+                                        reservedAccl1Prefix(),
+                                        reservedAccl2Prefix(),
+                                        reservedStepPrefix()};
+  if (std::any_of(
+          states.begin(), states.end(), [this](const std::string &state) {
+            return id.find(state) != std::string::npos;
+          })) {
     // sanity check that the accl tensor is of Variable type
     if (tensorType() != TensorType::Variable) {
       throw error("Tensor {} has been identified as an Accl tensor, but it is "
@@ -429,6 +440,7 @@ void Consumers::increment(Op *op) {
   } else {
     ++(found->second);
   }
+  tensorConsumed->getGraph().incrementMutationEpoch();
 }
 
 std::vector<Op *> Consumers::getOps() const {
@@ -458,6 +470,7 @@ const std::string &Tensor::tensor_type() const {
 
 void Tensor::setTensorType(TensorType t) {
   tensorTypeInfo = &getTensorTypeInfoMap().at(t);
+  graph.incrementMutationEpoch();
 }
 
 std::vector<Op *> Tensor::associatedOps() const {
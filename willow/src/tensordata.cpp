@@ -11,6 +11,33 @@
 namespace popart {
 
 TensorData::TensorData(const ONNX_NAMESPACE::TensorProto &tp) {
+  if (MappedRegion::enabled() && tp.has_data_location() &&
+      tp.data_location() == ONNX_NAMESPACE::TensorProto::EXTERNAL) {
+    auto externalInfo = onnxutil::ExternalTensorProtoInfo(tp);
+    TensorInfo info(tp);
+    if (static_cast<uint64_t>(externalInfo.length) != info.nbytes()) {
+      throw error("Externally stored tensor '{}' has length {}, but {} bytes "
+                  "were expected",
+                  tp.name(),
+                  externalInfo.length,
+                  info.nbytes());
+    }
+
+    // A tensor with no elements is valid, but a region of 0 bytes can not be
+    // mapped
+    if (externalInfo.length == 0) {
+      return;
+    }
+
+    // Mappings start on a page boundary, so the elements are aligned if the
+    // offset is. Otherwise the data is copied.
+    if (externalInfo.offset % info.getDataTypeInfo()->nbytes() == 0) {
+      mapped = std::make_unique<MappedRegion>(
+          externalInfo.location, externalInfo.offset, externalInfo.length);
+      return;
+    }
+  }
+
   ConstVoidData cv_data = onnxutil::getConstData(tp);
   data_.resize(cv_data.info.nbytes());
   std::memcpy(data_.data(), cv_data.data, cv_data.info.nbytes());
@@ -21,23 +48,29 @@ TensorData::TensorData(const TensorInfo &info, const void *from) {
   std::memcpy(data_.data(), from, info.nbytes());
 }
 
-void *TensorData::data() { return data_.data(); }
-const void *TensorData::data() const { return data_.data(); }
+// Writes to mapped data only copy the pages written to
+void *TensorData::data() { return mapped ? mapped->data() : data_.data(); }
+const void *TensorData::data() const {
+  return mapped ? mapped->data() : data_.data();
+}
+
+std::size_t TensorData::size() const {
+  return mapped ? mapped->size() : data_.size();
+}
 
 void TensorData::resetData(const ONNX_NAMESPACE::TensorProto &tp) {
   ConstVoidData cv_data = onnxutil::getConstData(tp);
-  if (data_.size() != cv_data.info.nbytes()) {
+  if (size() != cv_data.info.nbytes()) {
     throw error("cannot reset tensor data with data of non-matching size");
   }
-  std::memcpy(data_.data(), cv_data.data, cv_data.info.nbytes());
+  std::memcpy(data(), cv_data.data, cv_data.info.nbytes());
 }
 
 void TensorData::resetData(const TensorInfo &info, const void *from) {
-  if (data_.size() != info.nbytes()) {
+  if (size() != info.nbytes()) {
     throw error("cannot reset tensor data with data of non-matching size");
   }
-  data_.resize(info.nbytes());
-  std::memcpy(data_.data(), from, info.nbytes());
+  std::memcpy(data(), from, info.nbytes());
 }
 
 bool WeightsIO::contains(TensorId id) const {
@@ -0,0 +1,41 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <limits>
+
+#include <popart/error.hpp>
+#include <popart/tensoridinterner.hpp>
+
+namespace popart {
+
+TensorHandle TensorIdInterner::intern(const TensorId &id) {
+  auto found = handles.find(id);
+  if (found != handles.end()) {
+    return found->second;
+  }
+
+  if (ids.size() >= std::numeric_limits<TensorHandle>::max()) {
+    throw error("Cannot intern TensorId {}, as {} TensorIds have been interned",
+                id,
+                ids.size());
+  }
+  auto handle   = static_cast<TensorHandle>(ids.size());
+  auto inserted = handles.emplace(id, handle).first;
+  ids.push_back(&inserted->first);
+  return handle;
+}
+
+TensorHandle TensorIdInterner::find(const TensorId &id) const {
+  auto found = handles.find(id);
+  return found == handles.end() ? unusedTensorHandle : found->second;
+}
+
+const TensorId &TensorIdInterner::getId(TensorHandle handle) const {
+  if (handle >= ids.size()) {
+    throw internal_error("Invalid TensorHandle {}, only {} TensorIds have "
+                         "been interned",
+                         handle,
+                         ids.size());
+  }
+  return *ids[handle];
+}
+
+} // namespace popart
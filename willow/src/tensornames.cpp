@@ -42,6 +42,19 @@ std::vector<std::string> reservedOptimizerPrefixes() {
           reservedDefaultScaledMomentum1Prefix(),
           reservedSpecificScaledMomentum1Prefix(),
 
+          reservedDefaultAdamLearningRatePrefix(),
+          reservedSpecificAdamLearningRatePrefix(),
+          reservedDefaultAdamWeightDecayPrefix(),
+          reservedSpecificAdamWeightDecayPrefix(),
+          reservedDefaultAdamBeta1Prefix(),
+          reservedSpecificAdamBeta1Prefix(),
+          reservedDefaultAdamBeta2Prefix(),
+          reservedSpecificAdamBeta2Prefix(),
+          reservedDefaultAdamEpsPrefix(),
+          reservedSpecificAdamEpsPrefix(),
+          reservedDefaultAdamGradientScalePrefix(),
+          reservedSpecificAdamGradientScalePrefix(),
+
           reservedLossScalingPrefix()};
 }
 
@@ -84,7 +97,10 @@ std::vector<std::string> reservedOptimizerStatePrefixes() {
   std::vector<std::string> prefs = {reservedAcclToAccumulatorPrefix(),
                                     reservedAcclToReducePrefix(),
                                     reservedAcclToUpdatePrefix(),
-                                    reservedAcclFinalOutPrefix()};
+                                    reservedAcclFinalOutPrefix(),
+                                    reservedAccl1Prefix(),
+                                    reservedAccl2Prefix(),
+                                    reservedStepPrefix()};
   return prefs;
 }
 
@@ -1,6 +1,7 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
 #include <popart/chains.hpp>
 #include <popart/graph.hpp>
+#include <popart/ir.hpp>
 #include <popart/names.hpp>
 #include <popart/op.hpp>
 #include <popart/tensor.hpp>
@@ -31,37 +32,31 @@ Tensors::aliasChainsFrom(Tensor *from) const {
 
 // Regions in "from" aliased "to"
 view::Regions Tensors::getAliasRegions(Tensor *from, Tensor *to) const {
-  auto aliasedTensorMap = graph.getTensors().aliasChainsFrom(from);
-  auto it               = aliasedTensorMap.find(to);
-  if (it == aliasedTensorMap.end()) {
-    return view::Regions({view::Region::getEmpty(to->info.rank())});
-  } else {
-    return it->second.apply(view::Region::getFull(from->info.shape()));
-  }
+  return aliases.getAliasRegions(from, to);
 }
 
-void Tensors::clearAliases() { aliases.clearAliases(); }
+void Tensors::clearAliases() {
+  aliases.clearAliases();
+  aliasEdges.clear();
+}
 
-// Let the Chains flow through op (called on new inplace ops)
-void Tensors::updateAliases(Op *op) {
-  logging::trace("[updateAliases] Updating alias for Op {}", op->debugName());
+bool Tensors::AliasEdge::operator==(const AliasEdge &rhs) const {
+  return inIndex == rhs.inIndex && outIndex == rhs.outIndex && in == rhs.in &&
+         out == rhs.out && inShape == rhs.inShape && outShape == rhs.outShape &&
+         inRegions == rhs.inRegions;
+}
+
+std::vector<Tensors::AliasEdge> Tensors::getAliasEdges(Op *op) const {
+  std::vector<AliasEdge> edges;
 
   // for all of the inputs of op, t1 and all output, t2:
-  for (auto i1_t1 : op->input->tensorMap()) {
-    for (auto o1_t2 : op->output->tensorMap()) {
+  for (auto &i1_t1 : op->input->tensorMap()) {
+    for (auto &o1_t2 : op->output->tensorMap()) {
       InIndex i1 = i1_t1.first;
       Tensor *t1 = i1_t1.second;
 
-      InIndex o1 = o1_t2.first;
-      Tensor *t2 = o1_t2.second;
-
-      logging::trace("[updateAliases] In: {}-{} {}, Out: {}-{} {}",
-                     i1,
-                     t1->id,
-                     t1->info.shape(),
-                     o1,
-                     t2->id,
-                     t2->info.shape());
+      OutIndex o1 = o1_t2.first;
+      Tensor *t2  = o1_t2.second;
 
       view::Regions inRegions = op->aliases(i1, o1);
 
@@ -71,39 +66,141 @@ void Tensors::updateAliases(Op *op) {
         continue;
       }
 
-      auto fwdMap = op->fwdRegMap(i1, o1);
-      auto bwdMap = op->bwdRegMap(i1, o1);
-
-      aliases.updateAliases(t1,
-                            t2,
-                            inRegions,
-                            fwdMap,
-                            bwdMap,
-                            "Fwd Link of " + op->debugName() + " " +
-                                std::to_string(i1) + "->" + std::to_string(o1),
-                            "Bwd Link of " + op->debugName() + " " +
-                                std::to_string(i1) + "->" + std::to_string(o1));
+      edges.push_back({i1,
+                       o1,
+                       t1,
+                       t2,
+                       t1->info.shape(),
+                       t2->info.shape(),
+                       std::move(inRegions)});
     }
   }
+  return edges;
+}
+
+void Tensors::addAliasEdges(Op *op, const std::vector<AliasEdge> &edges) {
+  for (auto &edge : edges) {
+    auto i1 = edge.inIndex;
+    auto o1 = edge.outIndex;
+
+    logging::trace("[updateAliases] In: {}-{} {}, Out: {}-{} {}",
+                   i1,
+                   edge.in->id,
+                   edge.inShape,
+                   o1,
+                   edge.out->id,
+                   edge.outShape);
+
+    aliases.updateAliases(edge.in,
+                          edge.out,
+                          edge.inRegions,
+                          op->fwdRegMap(i1, o1),
+                          op->bwdRegMap(i1, o1),
+                          "Fwd Link of " + op->debugName() + " " +
+                              std::to_string(i1) + "->" + std::to_string(o1),
+                          "Bwd Link of " + op->debugName() + " " +
+                              std::to_string(i1) + "->" + std::to_string(o1));
+  }
+}
+
+// Let the Chains flow through op (called on new inplace ops)
+void Tensors::updateAliases(Op *op) {
+  logging::trace("[updateAliases] Updating alias for Op {}", op->debugName());
+
+  auto edges = getAliasEdges(op);
+  addAliasEdges(op, edges);
+  if (edges.empty()) {
+    aliasEdges.erase(op->id);
+  } else {
+    aliasEdges[op->id] = std::move(edges);
+  }
+}
+
+void Tensors::updateAliases() {
+  std::map<OpId, std::vector<AliasEdge>> currentEdges;
+  for (auto &id_op : graph.getOps()) {
+    auto edges = getAliasEdges(id_op.second.get());
+    if (!edges.empty()) {
+      currentEdges.emplace(id_op.first, std::move(edges));
+    }
+  }
+
+  // The Tensors of AliasEdges which no longer exist. The Chains through them
+  // must be removed, which is done by recomputing their alias components. The
+  // Tensors may have been deleted, they are only used as keys.
+  std::vector<Tensor *> staleTensors;
+  for (auto &id_edges : aliasEdges) {
+    auto found = currentEdges.find(id_edges.first);
+    if (found == currentEdges.end() || found->second != id_edges.second) {
+      for (auto &edge : id_edges.second) {
+        staleTensors.push_back(edge.in);
+        staleTensors.push_back(edge.out);
+      }
+    }
+  }
+
+  // Ops which are new, or whose AliasEdges have changed
+  std::set<OpId> toAdd;
+  for (auto &id_edges : currentEdges) {
+    auto found = aliasEdges.find(id_edges.first);
+    if (found == aliasEdges.end() || found->second != id_edges.second) {
+      toAdd.insert(id_edges.first);
+    }
+  }
+
+  if (!staleTensors.empty()) {
+    auto component = aliases.getAliasComponent(staleTensors);
+    aliases.clearAliases(component);
+
+    // All Chains within the cleared components came from the AliasEdges
+    // between their Tensors, which are added again
+    for (auto &id_edges : currentEdges) {
+      for (auto &edge : id_edges.second) {
+        if (component.count(edge.in) || component.count(edge.out)) {
+          toAdd.insert(id_edges.first);
+          break;
+        }
+      }
+    }
+
+    logging::ir::trace("[updateAliases] Cleared {} aliased Tensors of {} stale "
+                       "Tensors",
+                       component.size(),
+                       staleTensors.size());
+  }
+
+  logging::ir::debug("[updateAliases] Adding the aliases of {} of {} Ops",
+                     toAdd.size(),
+                     currentEdges.size());
+
+  // In OpId order, as a full recomputation would
+  for (auto id : toAdd) {
+    addAliasEdges(graph.getOp(id), currentEdges.at(id));
+  }
+
+  aliasEdges = std::move(currentEdges);
 }
 
 std::vector<TensorId> Tensors::getAllTensorIds() const {
   std::vector<TensorId> allIds;
   allIds.reserve(M.size());
-  for (auto &id_tensor : M) {
-    allIds.push_back(id_tensor.first);
+  for (auto &handle_tensor : M) {
+    allIds.push_back(handle_tensor.second->id);
   }
   return allIds;
 }
 
 // remove all Tensors with no producer and no consumers
 void Tensors::removeIsolated(bool retainCached) {
-  for (auto &id : getAllTensorIds()) {
-    Tensor *tensor = M[id].get();
+  for (auto it = M.begin(); it != M.end();) {
+    Tensor *tensor = it->second.get();
     if (tensor->hasProducer() == false && tensor->consumers.getTotal() == 0 &&
         !(retainCached && tensor->cacheInfo.isCached())) {
-      M.erase(id);
-      logging::ir::debug("Removing isolated Tensor {}", id);
+      logging::ir::debug("Removing isolated Tensor {}", tensor->id);
+      it = M.erase(it);
+      graph.incrementMutationEpoch();
+    } else {
+      ++it;
     }
   }
 }
@@ -130,8 +227,12 @@ std::vector<TensorId> Tensors::getIds(TensorType type) const {
 
 Tensors::Tensors(Graph &pg) : graph(pg) {}
 
+TensorHandle Tensors::findHandle(const TensorId &tenId) const {
+  return graph.getIr().getTensorIdInterner().find(tenId);
+}
+
 Tensor *Tensors::get(TensorId tenId) const {
-  auto found = M.find(tenId);
+  auto found = M.find(findHandle(tenId));
   if (found == M.end()) {
     throw error("No Ir::Tensor with TensorId " + tenId +
                 " in Tensors::get(..)");
@@ -139,19 +240,29 @@ Tensor *Tensors::get(TensorId tenId) const {
   return found->second.get();
 }
 
+Tensor *Tensors::get(TensorHandle handle) const {
+  auto found = M.find(handle);
+  if (found == M.end()) {
+    throw error("No Ir::Tensor with TensorId " +
+                graph.getIr().getTensorIdInterner().getId(handle) +
+                " in Tensors::get(..)");
+  }
+  return found->second.get();
+}
+
 bool Tensors::contains(TensorId tenId, const Scope &scope) const {
   Scope s = scope;
 
   while (!s.empty()) {
     auto id = (s / tenId).str();
-    if (M.find(id) != M.end()) {
+    if (M.find(findHandle(id)) != M.end()) {
       return true;
     } else {
       s.pop();
     }
   }
 
-  if (M.find(tenId) != M.end()) {
+  if (M.find(findHandle(tenId)) != M.end()) {
     return true;
   } else {
     return false;
@@ -163,14 +274,14 @@ TensorId Tensors::find(TensorId tenId, const Scope &scope) const {
 
   while (!s.empty()) {
     auto id = (s / tenId).str();
-    if (M.find(id) != M.end()) {
+    if (M.find(findHandle(id)) != M.end()) {
       return id;
     } else {
       s.pop();
     }
   }
 
-  if (M.find(tenId) != M.end()) {
+  if (M.find(findHandle(tenId)) != M.end()) {
     return tenId;
   } else {
     throw error("Could not find tensor with id {} in scope {}", tenId, scope);
@@ -185,7 +296,7 @@ void Tensors::append(std::stringstream &ss) const {
       ss << ' ';
     }
     frst = false;
-    ss << id_ptr.first;
+    ss << id_ptr.second->id;
   }
   ss << ']';
 }
@@ -201,10 +312,12 @@ std::vector<TensorId> Tensors::getNoProducerIds() const {
 }
 
 void Tensors::insert(TensorId name, std::unique_ptr<Tensor> t) {
-  if (M.find(name) != M.end()) {
+  auto handle = t->handle;
+  if (M.find(handle) != M.end()) {
     throw internal_error("tensor {} already in M", name);
   }
-  M[name] = std::move(t);
+  M[handle] = std::move(t);
+  graph.incrementMutationEpoch();
 }
 
 void Tensors::addConstInit(const TensorId &name,
@@ -293,9 +406,18 @@ void Tensors::addActGrad(TensorId tenId) {
       std::unique_ptr<Tensor>(new Tensor(tenId, TensorType::ActGrad, graph)));
 }
 
-void Tensors::remove(TensorId id) { M.erase(id); }
+void Tensors::remove(TensorId id) {
+  M.erase(findHandle(id));
+  graph.incrementMutationEpoch();
+}
+
+bool Tensors::contains(TensorId id) const {
+  return M.find(findHandle(id)) != M.end();
+}
 
-bool Tensors::contains(TensorId id) const { return M.find(id) != M.end(); }
+bool Tensors::contains(TensorHandle handle) const {
+  return M.find(handle) != M.end();
+}
 
 void Tensors::insertConstId(const std::string &id) { constIds.insert(id); }
 
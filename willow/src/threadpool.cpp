@@ -0,0 +1,137 @@
+// Copyright (c) 2020 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include <popart/error.hpp>
+#include <popart/threadpool.hpp>
+#include <popart/util.hpp>
+
+namespace popart {
+
+namespace {
+
+// The pool whose worker is running on this thread, if any
+thread_local const ThreadPool *currentPool = nullptr;
+
+unsigned getGlobalPoolSize() {
+  auto env = getPopartEnvVar("HOST_THREADS");
+  if (env) {
+    try {
+      return static_cast<unsigned>(std::stoul(env));
+    } catch (const std::exception &) {
+      throw error("Invalid value '{}' for POPART_HOST_THREADS", env);
+    }
+  }
+  // The thread calling parallelFor also processes a chunk
+  auto nCores = std::thread::hardware_concurrency();
+  return nCores > 1 ? nCores - 1 : 0;
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned nThreads) {
+  workers.reserve(nThreads);
+  for (unsigned i = 0; i < nThreads; ++i) {
+    workers.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::workerLoop() {
+  currentPool = this;
+  while (true) {
+    std::packaged_task<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+      if (tasks.empty()) {
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop();
+    }
+    task();
+  }
+}
+
+bool ThreadPool::isWorkerThread() const { return currentPool == this; }
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+  std::packaged_task<void()> packaged(std::move(task));
+  auto future = packaged.get_future();
+  if (workers.empty()) {
+    packaged();
+    return future;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push(std::move(packaged));
+  }
+  condition.notify_one();
+  return future;
+}
+
+void ThreadPool::parallelFor(int64_t n,
+                             int64_t grain,
+                             const std::function<void(int64_t, int64_t)> &f) {
+  if (n <= 0) {
+    return;
+  }
+  grain = std::max<int64_t>(grain, 1);
+
+  int64_t maxChunks = static_cast<int64_t>(size()) + 1;
+  int64_t nChunks   = std::min(maxChunks, (n + grain - 1) / grain);
+
+  if (nChunks <= 1 || isWorkerThread()) {
+    f(0, n);
+    return;
+  }
+
+  int64_t chunkSize = (n + nChunks - 1) / nChunks;
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(nChunks - 1);
+  for (int64_t begin = chunkSize; begin < n; begin += chunkSize) {
+    int64_t end = std::min(n, begin + chunkSize);
+    futures.push_back(submit([&f, begin, end]() { f(begin, end); }));
+  }
+
+  // The first chunk is processed by the calling thread. All futures are
+  // waited on before rethrowing, as the tasks reference `f'.
+  std::exception_ptr firstError;
+  try {
+    f(0, std::min(n, chunkSize));
+  } catch (...) {
+    firstError = std::current_exception();
+  }
+  for (auto &future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!firstError) {
+        firstError = std::current_exception();
+      }
+    }
+  }
+  if (firstError) {
+    std::rethrow_exception(firstError);
+  }
+}
+
+ThreadPool &ThreadPool::global() {
+  static ThreadPool pool(getGlobalPoolSize());
+  return pool;
+}
+
+} // namespace popart
@@ -139,6 +139,7 @@ void TopoCons::remove(Op *op) {
   }
   valsBefore.erase(op);
   valsAfter.erase(op);
+  ++nMutations;
 }
 
 void TopoCons::remove(Op *before, Op *after) {
@@ -149,6 +150,7 @@ void TopoCons::remove(Op *before, Op *after) {
 
   valsAfter[before].erase(after);
   valsBefore[after].erase(before);
+  ++nMutations;
 }
 
 // insert the topological constraint before -> after
@@ -191,6 +193,7 @@ void TopoCons::insert(Op *before, Op *after, bool tied) {
   } else {
     valsBefore[after] = {topoBefore};
   }
+  ++nMutations;
 }
 
 bool TopoCons::hasConstraint(Op *op) {
@@ -1,10 +1,14 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <limits>
 #include <popart/error.hpp>
 #include <popart/graph.hpp>
 #include <popart/ir.hpp>
 #include <popart/logging.hpp>
 #include <popart/names.hpp>
 #include <popart/op.hpp>
+#include <popart/op/conv.hpp>
+#include <popart/op/matmul.hpp>
 #include <popart/tensor.hpp>
 #include <popart/tensorindex.hpp>
 #include <popart/transforms/auto_virtual_graph.hpp>
@@ -33,6 +37,237 @@ std::pair<bool, OpId> Subgraph::best_split(float split_cost) {
   return {true, best_node->second};
 }
 
+double OpCostModel::computeCost(Op *op, bool training) const {
+  double flops = 0.0;
+  if (auto matmul = dynamic_cast<MatMulOp *>(op)) {
+    // Each output element is a dot product over the reducing dimension
+    auto lhsShape = matmul->getExpandedLhsShape();
+    flops         = 2.0 * static_cast<double>(matmul->outInfo(0).nelms()) *
+            static_cast<double>(lhsShape.back());
+  } else if (auto conv = dynamic_cast<ConvOp *>(op)) {
+    // Each output element is a dot product over a kernel of one group
+    auto &weights = conv->weightsIn()->info;
+    flops         = 2.0 * static_cast<double>(conv->outInfo(0).nelms()) *
+            static_cast<double>(weights.nelms() / weights.dim(0));
+  } else {
+    for (auto &index_tensor : op->output->tensorMap()) {
+      flops += static_cast<double>(index_tensor.second->info.nelms());
+    }
+  }
+  if (training && !op->getGradOps().empty()) {
+    flops *= 3.0;
+  }
+  return flops;
+}
+
+double OpCostModel::copyCost(int64_t bytes) const {
+  return flopsPerCopiedByte * static_cast<double>(bytes);
+}
+
+namespace autovirtualgraph {
+
+namespace {
+
+// Range minimum queries over an array which does not change
+class SparseTableMin {
+public:
+  SparseTableMin(const std::vector<double> &values) {
+    table.push_back(values);
+    for (size_t width = 1; 2 * width <= values.size(); width *= 2) {
+      auto &prev = table.back();
+      std::vector<double> next(prev.size() - width);
+      for (size_t i = 0; i < next.size(); ++i) {
+        next[i] = std::min(prev[i], prev[i + width]);
+      }
+      table.push_back(std::move(next));
+    }
+  }
+
+  // The least value in [begin, end), begin < end
+  double min(size_t begin, size_t end) const {
+    size_t level = 0;
+    while ((size_t(2) << level) <= end - begin) {
+      ++level;
+    }
+    return std::min(table[level][begin],
+                    table[level][end - (size_t(1) << level)]);
+  }
+
+private:
+  std::vector<std::vector<double>> table;
+};
+
+} // namespace
+
+StagePartition partitionStages(const std::vector<double> &compute,
+                               const std::vector<int64_t> &memory,
+                               const std::vector<double> &cutCost,
+                               int64_t numStages,
+                               int64_t memoryCap) {
+  const size_t n = compute.size();
+  const size_t k = static_cast<size_t>(numStages);
+  if (memory.size() != n || cutCost.size() != n + 1) {
+    throw internal_error("[AutoVirtualGraph] Expected {} memory and {} cut "
+                         "costs, not {} and {}",
+                         n,
+                         n + 1,
+                         memory.size(),
+                         cutCost.size());
+  }
+  if (k < 1 || n < k) {
+    throw error("[AutoVirtualGraph] Cannot split {} Ops into {} stages",
+                n,
+                numStages);
+  }
+
+  std::vector<double> prefixCompute(n + 1, 0.0);
+  std::vector<int64_t> prefixMemory(n + 1, 0);
+  for (size_t i = 0; i < n; ++i) {
+    prefixCompute[i + 1] = prefixCompute[i] + compute[i];
+    prefixMemory[i + 1]  = prefixMemory[i] + memory[i];
+  }
+
+  // The time of the stage [begin, end): its compute, and the copies out of it
+  auto stageTime = [&](size_t begin, size_t end) {
+    return prefixCompute[end] - prefixCompute[begin] +
+           (end < n ? cutCost[end] : 0.0);
+  };
+  auto stageMemory = [&](size_t begin, size_t end) {
+    return prefixMemory[end] - prefixMemory[begin];
+  };
+
+  // Both the time and the memory of a stage ending at `end' decrease as its
+  // beginning increases, so the beginnings of the stages ending at `end'
+  // which fit in maxTime and memoryCap are the range [firstBegin[end], end).
+  // If firstBegin[end] == end there are none.
+  std::vector<size_t> firstBegin(n + 1);
+  auto setFirstBegins = [&](double maxTime) {
+    for (size_t end = 1; end <= n; ++end) {
+      size_t lo = 0;
+      size_t hi = end;
+      while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (stageTime(mid, end) <= maxTime &&
+            (memoryCap <= 0 || stageMemory(mid, end) <= memoryCap)) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
+        }
+      }
+      firstBegin[end] = lo;
+    }
+  };
+
+  // Whether numStages stages can end at the end of the schedule
+  auto feasible = [&](double maxTime) {
+    setFirstBegins(maxTime);
+    // reached[i] : whether the stages so far can end at position i
+    std::vector<bool> reached(n + 1, false);
+    reached[0] = true;
+    std::vector<size_t> reachedBefore(n + 2, 0);
+    for (size_t stage = 0; stage < k; ++stage) {
+      for (size_t i = 0; i <= n; ++i) {
+        reachedBefore[i + 1] = reachedBefore[i] + (reached[i] ? 1 : 0);
+      }
+      for (size_t end = 0; end <= n; ++end) {
+        reached[end] = end > 0 && firstBegin[end] < end &&
+                       reachedBefore[end] > reachedBefore[firstBegin[end]];
+      }
+    }
+    return static_cast<bool>(reached[n]);
+  };
+
+  double hi = prefixCompute[n] +
+              *std::max_element(cutCost.begin(), cutCost.end()) + 1.0;
+  if (!feasible(hi)) {
+    throw error("[AutoVirtualGraph] Cannot split the graph into {} stages "
+                "which each fit in the memory cap of {} bytes",
+                numStages,
+                memoryCap);
+  }
+  double lo = 0.0;
+  for (int iteration = 0; iteration < 64 && hi - lo > 1e-9 * hi; ++iteration) {
+    double mid = lo + (hi - lo) / 2;
+    if (feasible(mid)) {
+      hi = mid;
+    } else {
+      lo = mid;
+    }
+  }
+
+  // Of the stages within the least maximum time, choose those with the least
+  // total copy cost. least[stage][end] is the least copy cost of stage + 1
+  // stages ending at end.
+  setFirstBegins(hi);
+  const double inf = std::numeric_limits<double>::infinity();
+  std::vector<std::vector<double>> least(k, std::vector<double>(n + 1, inf));
+  for (size_t end = 1; end <= n; ++end) {
+    if (firstBegin[end] == 0) {
+      least[0][end] = end < n ? cutCost[end] : 0.0;
+    }
+  }
+  for (size_t stage = 1; stage < k; ++stage) {
+    SparseTableMin previous(least[stage - 1]);
+    for (size_t end = 1; end <= n; ++end) {
+      if (firstBegin[end] < end) {
+        least[stage][end] = previous.min(firstBegin[end], end) +
+                            (end < n ? cutCost[end] : 0.0);
+      }
+    }
+  }
+
+  // Walk back from the end of the schedule, choosing the earliest beginning
+  // of each stage with the least cost, so that ties are broken
+  // deterministically
+  StagePartition partition;
+  partition.stageStarts.assign(k + 1, n);
+  size_t end = n;
+  for (size_t stage = k - 1; stage > 0; --stage) {
+    size_t begin = firstBegin[end];
+    for (size_t i = begin + 1; i < end; ++i) {
+      if (least[stage - 1][i] < least[stage - 1][begin]) {
+        begin = i;
+      }
+    }
+    partition.stageStarts[stage] = begin;
+    end                          = begin;
+  }
+  partition.stageStarts[0] = 0;
+
+  partition.maxStageTime  = 0.0;
+  partition.totalCopyCost = 0.0;
+  for (size_t stage = 0; stage < k; ++stage) {
+    auto begin = partition.stageStarts[stage];
+    auto end   = partition.stageStarts[stage + 1];
+    partition.stageTime.push_back(stageTime(begin, end));
+    partition.stageMemory.push_back(stageMemory(begin, end));
+    partition.maxStageTime =
+        std::max(partition.maxStageTime, partition.stageTime.back());
+    if (end < n) {
+      partition.totalCopyCost += cutCost[end];
+    }
+  }
+  return partition;
+}
+
+} // namespace autovirtualgraph
+
+namespace {
+std::shared_ptr<OpCostModel> &costModel() {
+  static std::shared_ptr<OpCostModel> model = std::make_shared<OpCostModel>();
+  return model;
+}
+} // namespace
+
+void AutoVirtualGraph::setCostModel(std::shared_ptr<OpCostModel> model) {
+  if (!model) {
+    model = std::make_shared<OpCostModel>();
+  }
+  costModel() = model;
+}
+
+const OpCostModel &AutoVirtualGraph::getCostModel() { return *costModel(); }
+
 std::size_t AutoVirtualGraph::id() {
   return typeid(AutoVirtualGraph).hash_code();
 }
@@ -148,6 +383,11 @@ bool AutoVirtualGraph::apply(Graph &graph) const {
     return true;
   }
 
+  if (opts.autoVirtualGraphType == AutoVirtualGraphType::ComputeBalanced) {
+    applyComputeBalanced(graph, num_ipus);
+    return true;
+  }
+
   float w_weights = 1.0f;
   if (opts.enableGradientAccumulation) {
     // Weights are doubled as there is an accumulator to match each.
@@ -380,6 +620,102 @@ bool AutoVirtualGraph::apply(Graph &graph) const {
   return true;
 }
 
+// Splits the schedule into contiguous stages, one per IPU, so that the stages
+// run in pipeline order. The stages balance the compute of their Ops plus the
+// copies of their outputs to later stages, as estimated by the cost model,
+// subject to the memory cap. The memory of an Op is as estimated by costFn.
+void AutoVirtualGraph::applyComputeBalanced(Graph &graph,
+                                            int64_t num_ipus) const {
+  auto &ir         = graph.getIr();
+  auto &opts       = ir.getSessionOptions();
+  auto &model      = getCostModel();
+  const auto train = ir.canTrain();
+  float w_weights  = opts.enableGradientAccumulation ? 2.0f : 1.0f;
+
+  logging::transform::info("[AutoVirtualGraph] Compute balanced stages for {} "
+                           "IPUs, with a memory cap of {} bytes",
+                           num_ipus,
+                           opts.autoVirtualGraphMemoryCap);
+
+  auto schedule = graph.getOpSchedule({});
+  std::map<OpId, size_t> position;
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    position[schedule[i]->id] = i;
+  }
+
+  const size_t n = schedule.size();
+  std::vector<double> compute(n);
+  std::vector<int64_t> memory(n);
+  // The bytes produced before, and consumed at or after, each position
+  std::vector<int64_t> cutBytes(n + 1, 0);
+  for (size_t i = 0; i < n; ++i) {
+    Op *op = schedule[i];
+    if (op->toLoss != PathToLoss::Undefined) {
+      throw internal_error(
+          "Op {} has been annotated with PathToLoss "
+          "information, AutoVirtualGraph::apply should be applied "
+          "before the final loss is grown though",
+          op->str());
+    }
+    compute[i] = model.computeCost(op, train);
+    memory[i]  = static_cast<int64_t>(costFn(op, train, w_weights));
+
+    for (Tensor *t : op->output->tensors()) {
+      size_t lastConsumer = i;
+      for (Op *consumer : t->consumers.getOps()) {
+        auto found = position.find(consumer->id);
+        if (found != position.end()) {
+          lastConsumer = std::max(lastConsumer, found->second);
+        }
+      }
+      if (lastConsumer > i) {
+        cutBytes[i + 1] += t->info.nbytes();
+        cutBytes[lastConsumer + 1] -= t->info.nbytes();
+      }
+    }
+  }
+  for (size_t i = 1; i <= n; ++i) {
+    cutBytes[i] += cutBytes[i - 1];
+  }
+  std::vector<double> cutCost(n + 1);
+  for (size_t i = 0; i <= n; ++i) {
+    cutCost[i] = model.copyCost(cutBytes[i]);
+  }
+
+  auto partition = autovirtualgraph::partitionStages(
+      compute, memory, cutCost, num_ipus, opts.autoVirtualGraphMemoryCap);
+
+  // The balance report
+  double meanTime = 0.0;
+  for (auto time : partition.stageTime) {
+    meanTime += time / static_cast<double>(num_ipus);
+  }
+  for (int64_t stage = 0; stage < num_ipus; ++stage) {
+    auto begin = partition.stageStarts[stage];
+    auto end   = partition.stageStarts[stage + 1];
+    for (size_t i = begin; i < end; ++i) {
+      schedule[i]->setVirtualGraphId(stage);
+    }
+    logging::transform::info(
+        "[AutoVirtualGraph]   IPU {}: {} Ops from {}, time {} ({}% of the "
+        "max), memory {} bytes, copies out {} bytes",
+        stage,
+        end - begin,
+        schedule[begin]->debugName(),
+        partition.stageTime[stage],
+        partition.maxStageTime > 0.0
+            ? 100.0 * partition.stageTime[stage] / partition.maxStageTime
+            : 100.0,
+        partition.stageMemory[stage],
+        end < n ? cutBytes[end] : 0);
+  }
+  logging::transform::info("[AutoVirtualGraph] Max stage time {}, mean {}, "
+                           "total copy cost {}",
+                           partition.maxStageTime,
+                           meanTime,
+                           partition.totalCopyCost);
+}
+
 namespace {
 bool init = Transform::registerTransform(new AutoVirtualGraph);
 }
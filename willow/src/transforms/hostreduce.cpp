@@ -181,6 +181,14 @@ void HostReduce::verifySessionOptions(const SessionOptions &options) const {
   if (options.hostAllReduceRemoteBuffer && options.enableReplicatedGraphs) {
     throw error("RemoteBuffer with replicated graphs not supported");
   }
+
+  if (options.hostAllReduceEngine && options.hostWeightUpdate) {
+    throw error("hostAllReduceEngine with host weight update not supported");
+  }
+
+  if (options.hostAllReduceEngine && options.hostAllReduceRemoteBuffer) {
+    throw error("hostAllReduceEngine with RemoteBuffer not supported");
+  }
 }
 
 bool HostReduce::apply(Graph &graph) const {
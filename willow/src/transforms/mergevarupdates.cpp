@@ -3,6 +3,7 @@
 #include <tuple>
 #include <popart/graph.hpp>
 #include <popart/ir.hpp>
+#include <popart/op/adamcombo.hpp>
 #include <popart/op/concat.hpp>
 #include <popart/op/copyvarupdate.hpp>
 #include <popart/op/reshape.hpp>
@@ -95,6 +96,28 @@ MergeVarUpdates::PartitionId MergeVarUpdates::getPartitionId(Op *op) const {
     }
   }
 
+  else if (op->isConvertibleTo<AdamComboOp>()) {
+    auto avu = dynamic_cast<AdamComboOp *>(op);
+    ss << "_Adam_" << static_cast<int>(avu->mode) << "_reduction_"
+       << static_cast<int>(avu->reductionType);
+
+    auto append = [avu, &ss](const std::string &name,
+                             const OptimizerValue &v,
+                             InIndex index) {
+      if (v.isConst()) {
+        ss << "_const" << name << "_" << v.val();
+      } else {
+        ss << "_nonConst" << name << "_" << avu->inId(index);
+      }
+    };
+    append("Lr", avu->initLr, avu->getLrInIndex());
+    append("Wd", avu->initWd, avu->getWdInIndex());
+    append("B1", avu->initB1, avu->getBeta1InIndex());
+    append("B2", avu->initB2, avu->getBeta2InIndex());
+    append("Eps", avu->initEps, avu->getEpsInIndex());
+    append("Gs", avu->initGs, avu->getGsInIndex());
+  }
+
   // 2) CopyVarUpdate settings
   else if (op->isConvertibleTo<CopyVarUpdateOp>()) {
     // there are no attributes to sub-partition CopyVarUpdatOps by
@@ -118,6 +141,12 @@ MergeVarUpdates::getLargestGroupTargetsMap(const Graph &graph) const {
   for (auto &id_upop : graph.getOps()) {
     auto op   = id_upop.second.get();
     auto vuop = dynamic_cast<VarUpdateOp *>(op);
+    // The LAMB trust ratio is computed from the norms of each individual
+    // weight, so these updates cannot be merged
+    auto lamb = dynamic_cast<AdamComboOp *>(op);
+    if (lamb && lamb->mode == AdamMode::Lamb) {
+      vuop = nullptr;
+    }
     if (vuop) {
       auto partitionId = getPartitionId(vuop);
       int64_t start    = 0;
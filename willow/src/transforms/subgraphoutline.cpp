@@ -798,7 +798,8 @@ static std::vector<Replacement> applyMatch(const Match &match, Graph &graph) {
 // sorted so the smallest matches are at the back
 std::vector<Match> getRinseMatches(const std::vector<Op *> &ops,
                                    float threshold,
-                                   bool copyCostPruning) {
+                                   bool copyCostPruning,
+                                   bool hierarchical) {
 
   if (logging::shouldLog(logging::Module::transform, logging::Level::Trace)) {
     std::vector<int> intSchedule = fwtools::subgraph::getIntSchedule(ops);
@@ -820,7 +821,10 @@ std::vector<Match> getRinseMatches(const std::vector<Op *> &ops,
   }
 
   auto fw_matches = fwtools::subgraph::getRinseMatches(
-      ops, threshold, fwtools::subgraph::getDefaultOutlinerAlgorithm());
+      ops,
+      threshold,
+      hierarchical ? fwtools::subgraph::OutlinerAlgorithm::ALGO2
+                   : fwtools::subgraph::getDefaultOutlinerAlgorithm());
   int64_t num_matches_0 = fw_matches.size();
 
   // TODO: T Copy cost pruning can cause crossing matches,
@@ -909,7 +913,8 @@ bool SubgraphOutline::apply(Graph &graph) const {
   auto matches =
       getRinseMatches(schedule,
                       ir.getSessionOptions().outlineThreshold,
-                      ir.getSessionOptions().enableOutliningCopyCostPruning);
+                      ir.getSessionOptions().enableOutliningCopyCostPruning,
+                      ir.getSessionOptions().enableHierarchicalOutlining);
 
   if (logging::shouldLog(logging::Module::none, logging::Level::Trace)) {
     unsigned i = 0;
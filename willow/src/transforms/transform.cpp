@@ -19,6 +19,10 @@ void Transform::applyTransform(std::size_t transformId, Graph &graph) {
   transform->apply(graph);
 }
 
+std::string Transform::getTransformName(std::size_t transformId) {
+  return getTransformMap().at(transformId)->getName();
+}
+
 bool Transform::registerTransform(Transform *transform) {
   getTransformMap().emplace(transform->getId(), transform);
   return true;